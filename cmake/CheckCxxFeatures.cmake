@@ -38,6 +38,101 @@ CHECK_CXX_SOURCE_COMPILES(
 	HAVE_CXX17_ANY
 )
 
+# The C++17 standard is only used if std::any is available (see below)
+if (HAVE_CXX17_ANY)
+	CHECK_CXX_SOURCE_COMPILES(
+		"#include <string_view>
+
+		int main() {
+			std::string_view view(\"abc\");
+			return static_cast<int>(view.size()) - 3;
+		}"
+		HAVE_CXX17_STRING_VIEW
+	)
+endif()
+
+#
+# --------------------------------------------------------------------
+#
+
+# Kernels compiled for extended instruction sets, which are selected at runtime
+# depending on the capabilities of the CPU
+set(CMAKE_REQUIRED_FLAGS "-mavx2 -mfma -mpopcnt")
+CHECK_CXX_SOURCE_COMPILES(
+	"#include <immintrin.h>
+
+	int main() {
+		__builtin_cpu_init();
+		__m256d x = _mm256_set1_pd(1.0);
+		return __builtin_cpu_supports(\"avx2\") ? static_cast<int>(x[0]) : 0;
+	}"
+	HAVE_AVX2_DISPATCH
+)
+
+set(CMAKE_REQUIRED_FLAGS "-mavx512f -mpopcnt")
+CHECK_CXX_SOURCE_COMPILES(
+	"#include <immintrin.h>
+
+	int main() {
+		__builtin_cpu_init();
+		__m512d x = _mm512_set1_pd(1.0);
+		return __builtin_cpu_supports(\"avx512f\") ? static_cast<int>(x[0]) : 0;
+	}"
+	HAVE_AVX512_DISPATCH
+)
+
+#
+# --------------------------------------------------------------------
+#
+
+# Mapping large buffers directly with transparent huge pages and placing
+# their pages on NUMA nodes (using the raw system call, i.e. without libnuma)
+set(CMAKE_REQUIRED_FLAGS "${ORIGINAL_FLAGS}")
+CHECK_CXX_SOURCE_COMPILES(
+	"#include <sys/mman.h>
+
+	int main() {
+		void* p = mmap(nullptr, 4096, PROT_READ | PROT_WRITE,
+		               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		madvise(p, 4096, MADV_HUGEPAGE);
+		return munmap(p, 4096);
+	}"
+	HAVE_MMAP_HUGEPAGE
+)
+
+CHECK_CXX_SOURCE_COMPILES(
+	"#include <sys/syscall.h>
+	#include <unistd.h>
+
+	int main() {
+		unsigned long nodes = 1;
+		return static_cast<int>(syscall(SYS_mbind, nullptr, 0, 0, &nodes, 64, 0)
+		                        + syscall(SYS_get_mempolicy, nullptr, &nodes, 64,
+		                                  nullptr, 0));
+	}"
+	HAVE_SYS_MBIND
+)
+
+# Reading blocks of files with pread or from a read-only mapping
+# (see ChunkedArray)
+CHECK_CXX_SOURCE_COMPILES(
+	"#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+
+	int main() {
+		char buffer[1];
+		struct stat info;
+		int fd = open(\"data\", O_RDONLY);
+		fstat(fd, &info);
+		void* p = mmap(nullptr, 1, PROT_READ, MAP_SHARED, fd, 0);
+		munmap(p, 1);
+		return static_cast<int>(pread(fd, buffer, 1, 0)) + close(fd);
+	}"
+	HAVE_POSIX_MAPPED_FILES
+)
+
 #
 # --------------------------------------------------------------------
 #
@@ -106,15 +106,44 @@ def to_cpp_arraytype(dtype, full=False):
         return "ArrayView<" + to_cpp_type(dtype, full=False) + ">"
 
 
+# Sparse matrix view templates (with value and index type as template arguments)
+# and the types they are supported for. The index types agree with the ones
+# used by scipy.sparse.
+SPARSE_MATRIX_TEMPLATES = ["CsrMatrixView", "CooMatrixView"]
+SPARSE_VALUE_TYPES = ["Float", "Complex"]
+SPARSE_INDEX_TYPES = ["Integer32", "Integer"]
+
+# Element types of the out-of-core ChunkedArray template
+CHUNKED_ARRAY_TYPES = ["Float", "Complex", "Integer"]
+
+# Scalar types, which can be gathered from and scattered to a PamMap
+GATHER_TYPES = ["Float", "Complex", "Integer"]
+
+
 def make_supported_cpp_types(dtypes):
     """Convert the dtypes to cpp_types using to_cpp_type
        and also build derived types like ArrayView<ccptype>
-       and return the full lot as a list.
+       and Array<cpptype> (also for the ARRAY_DTYPES), the bit-packed
+       BitArrayView and BitArray, the string arrays StringArrayView and
+       StringArray, the sparse matrix views (see SPARSE_MATRIX_TEMPLATES)
+       as well as the ChunkedArrays (see CHUNKED_ARRAY_TYPES) and return
+       the full lot as a list.
     """
-    supported_types = [to_cpp_type(dtype) for dtype in constants.cpp.underlying_type]
-    supported_types += [
-        "ArrayView<" + cpptype + ">" for cpptype in supported_types
-    ]
+    scalar_types = [to_cpp_type(dtype) for dtype in constants.cpp.underlying_type
+                    if dtype not in constants.ARRAY_DTYPES]
+    element_types = scalar_types + [to_cpp_type(dtype)
+                                    for dtype in constants.ARRAY_DTYPES]
+    supported_types = list(scalar_types)
+    supported_types += ["ArrayView<" + cpptype + ">" for cpptype in element_types]
+    supported_types += ["Array<" + cpptype + ">" for cpptype in element_types]
+    supported_types += ["BitArrayView", "BitArray"]
+    supported_types += ["StringArrayView", "StringArray"]
+    supported_types += [sparse + "<" + cpptype + ", " + index + ">"
+                        for sparse in SPARSE_MATRIX_TEMPLATES
+                        for cpptype in SPARSE_VALUE_TYPES
+                        for index in SPARSE_INDEX_TYPES]
+    supported_types += ["ChunkedArray<" + cpptype + ">"
+                        for cpptype in CHUNKED_ARRAY_TYPES]
     return supported_types
 
 
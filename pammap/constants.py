@@ -30,6 +30,16 @@ DTYPES = [
     "bool",
 ]
 
+# Additional data types, which are only supported as elements of arrays.
+# They allow to pass e.g. single-precision numpy arrays without a copy.
+ARRAY_DTYPES = [
+    "float32",
+    "complex64",
+    "integer32",
+    "integer8",
+    "unsigned8",
+]
+
 
 class cpp:
     """Constants for C++"""
@@ -44,6 +54,11 @@ class cpp:
         "complex": "std::complex<double>",
         "string": "std::string",
         "bool": "bool",
+        "float32": "float",
+        "complex64": "std::complex<float>",
+        "integer32": "int32_t",
+        "integer8": "int8_t",
+        "unsigned8": "uint8_t",
     }
 
 
@@ -63,4 +78,9 @@ class python:
         "float": "NPY_DOUBLE",
         "complex": "NPY_CDOUBLE",
         "bool": "NPY_BOOL",
+        "float32": "NPY_FLOAT",
+        "complex64": "NPY_CFLOAT",
+        "integer32": "NPY_INT32",
+        "integer8": "NPY_INT8",
+        "unsigned8": "NPY_UINT8",
     }
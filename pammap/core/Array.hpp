@@ -0,0 +1,282 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "BufferPool.hpp"
+#include "copy_into.hpp"
+#include "exceptions.hpp"
+#include "parallel.hpp"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pammap {
+
+namespace detail {
+/** Header in front of the elements of an Array.
+ *
+ * Header and elements are allocated as one block from BufferPool::global(),
+ * such that creating an Array takes no allocation apart from the buffer.
+ * The header occupies one alignment unit, so the elements start aligned.
+ * The base of the views handed out by an Array points to this header
+ * (with base kind ArrayViewBase::ARRAY), such that code knowing only the
+ * view may keep the data alive using acquire() and release().
+ */
+struct alignas(BufferPool::alignment) ArrayBuffer {
+  /** Number of Arrays (or other owners) referring to the buffer */
+  std::atomic<size_t> refcount;
+
+  /** Number of elements */
+  size_t size;
+
+  /** Number of bytes requested from the pool including the header */
+  size_t bytes;
+
+  /** Destroy the elements (without knowing their type) */
+  void (*destroy_elements)(ArrayBuffer* buffer);
+
+  /** Pointer to the first element */
+  template <typename T>
+  T* elements() {
+    return reinterpret_cast<T*>(this + 1);
+  }
+
+  /** Add an owner */
+  void acquire() { refcount.fetch_add(1, std::memory_order_relaxed); }
+
+  /** Remove an owner and free the buffer if it was the last one */
+  void release() {
+    if (refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      destroy_elements(this);
+      const size_t total = bytes;
+      this->~ArrayBuffer();
+      BufferPool::global().deallocate(this, total);
+    }
+  }
+
+  /** Allocate a buffer for ``size`` uninitialised elements of type T
+   *  with a reference count of one */
+  template <typename T>
+  static ArrayBuffer* create(size_t size) {
+    const size_t max_size = (static_cast<size_t>(-1) - sizeof(ArrayBuffer)) / sizeof(T);
+    pammap_throw(size <= max_size, ValueError,
+                 "Array of " + std::to_string(size) + " elements is too large.");
+    const size_t total  = sizeof(ArrayBuffer) + size * sizeof(T);
+    ArrayBuffer* buffer = new (BufferPool::global().allocate(total)) ArrayBuffer;
+    buffer->refcount    = 1;
+    buffer->size        = size;
+    buffer->bytes       = total;
+    buffer->destroy_elements = [](ArrayBuffer* b) {
+      if (std::is_trivially_destructible<T>::value) return;
+      T* data = b->elements<T>();
+      for (size_t i = 0; i < b->size; ++i) data[i].~T();
+    };
+    return buffer;
+  }
+};
+}  // namespace detail
+
+/** An array, which owns its data.
+ *
+ * The elements are stored C contiguous in a 64-byte aligned buffer taken
+ * from a BufferPool, such that repeatedly creating arrays of similar size
+ * reuses memory instead of calling the system allocator. Large arrays are
+ * initialised in parallel by the threads of the global ThreadPool, such
+ * that on NUMA systems the pages end up close to the threads which process
+ * the same parts of the array in the parallel algorithms. The buffer is
+ * reference counted: Copies of an Array refer to the same data (much like
+ * copies of an ArrayView or a std::shared_ptr) and the buffer is returned
+ * to the pool once the last Array referring to it is gone. Use
+ * ``Array<T>(other.view())`` for an independent copy of the data.
+ *
+ * Arrays can be stored inside a PamMap, which then owns the data. Such an
+ * entry can be obtained both as ``Array<T>`` and as ``ArrayView<T>``.
+ * Views obtained with view() (and their slices) do not keep the data alive,
+ * but carry a pointer to the buffer header as their base.
+ *
+ * Arrays returned by map_array refer to a file mapped into memory instead
+ * (which is Fortran contiguous for .npy files in Fortran order).
+ */
+template <typename T>
+class Array {
+ public:
+  /** The type of the Array data */
+  typedef T value_type;
+
+  /** An Array without data */
+  Array() = default;
+
+  //@{
+  /** Construct a C contiguous array of the given shape
+   *  with all elements set to ``value`` */
+  explicit Array(const std::vector<size_t>& shape, const T& value = T())
+        : Array(span<const size_t>(shape.data(), shape.size()), value) {}
+
+  explicit Array(std::initializer_list<size_t> shape, const T& value = T())
+        : Array(span<const size_t>(shape.begin(), shape.size()), value) {}
+
+  explicit Array(span<const size_t> shape, const T& value = T()) {
+    allocate(shape);
+    if (std::is_trivial<T>::value && size() >= parallel_min_size) {
+      // Initialise in parallel, such that the pages of large buffers are
+      // placed close to the threads processing them later (first touch)
+      fill(m_view, value);
+      return;
+    }
+    try {
+      std::uninitialized_fill_n(m_buffer->elements<T>(), m_buffer->size, value);
+    } catch (...) {
+      free_uninitialised();
+      throw;
+    }
+  }
+  //@}
+
+  /** Construct a C contiguous array holding a copy of the data of a view */
+  template <size_t N>
+  explicit Array(const ArrayView<T, N>& view) : Array(view.shape(), ForOverwrite{}) {
+    copy_into(m_view, view);
+  }
+
+  /** Take over one reference to ``buffer``, whose data is viewed by ``view``.
+   *  Used for buffers, which do not hold the elements themselves,
+   *  e.g. the mappings of files created by map_array. */
+  Array(detail::ArrayBuffer* buffer, const ArrayView<T>& view)
+        : m_view(view), m_buffer(buffer) {}
+
+  /** Copies refer to the same data */
+  Array(const Array& other) : m_view(other.m_view), m_buffer(other.m_buffer) {
+    if (m_buffer != nullptr) m_buffer->acquire();
+  }
+
+  Array(Array&& other) noexcept : m_view(other.m_view), m_buffer(other.m_buffer) {
+    other.m_view   = ArrayView<T>();
+    other.m_buffer = nullptr;
+  }
+
+  Array& operator=(Array other) {
+    std::swap(m_view, other.m_view);
+    std::swap(m_buffer, other.m_buffer);
+    return *this;
+  }
+
+  ~Array() {
+    if (m_buffer != nullptr) m_buffer->release();
+  }
+
+  //@{
+  /** A view onto the data of the array.
+   *
+   * \note The view does not keep the data alive.
+   */
+  ArrayView<T>& view() { return m_view; }
+  const ArrayView<T>& view() const { return m_view; }
+  //@}
+
+  /** The size, i.e. total number of elements */
+  size_t size() const { return m_view.size(); }
+
+  /** The number of dimensions */
+  size_t ndim() const { return m_view.ndim(); }
+
+  /** The shape in each dimension */
+  span<const size_t> shape() const { return m_view.shape(); }
+
+  /** The strides in each dimension */
+  span<const ptrdiff_t> strides() const { return m_view.strides(); }
+
+  //@{
+  /** Pointer to the first element (64-byte aligned) */
+  T* data() { return m_view.data(); }
+  const T* data() const { return m_view.data(); }
+  //@}
+
+  //@{
+  /** Access to the elements in memory order, i.e. C order */
+  const T& operator[](size_t i) const { return data()[i]; }
+  T& operator[](size_t i) { return data()[i]; }
+  //@}
+
+  //@{
+  /** Multidimensional access (see ArrayView::operator()) */
+  template <typename... Indices>
+  const T& operator()(Indices... idcs) const {
+    return m_view(idcs...);
+  }
+  template <typename... Indices>
+  T& operator()(Indices... idcs) {
+    return m_view(idcs...);
+  }
+  //@}
+
+  /** Number of owners of the data, i.e. Arrays sharing the buffer
+   *  (0 for an Array without data) */
+  size_t use_count() const { return m_buffer == nullptr ? 0 : m_buffer->refcount.load(); }
+
+ private:
+  /** Tag for the construction of an array, whose elements are about
+   *  to be overwritten */
+  struct ForOverwrite {};
+
+  /** Construct an array, whose elements are left uninitialised if possible
+   *  (i.e. for trivial types) and default-constructed otherwise */
+  Array(span<const size_t> shape, ForOverwrite) {
+    if (std::is_trivial<T>::value) {
+      allocate(shape);
+    } else {
+      *this = Array(shape);
+    }
+  }
+
+  /** Allocate a buffer of uninitialised elements for the given shape
+   *  and set up the view */
+  void allocate(span<const size_t> shape) {
+    pammap_throw(shape.size() <= max_dynamic_rank, ValueError,
+                 "Number of dimensions (== " + std::to_string(shape.size()) +
+                       ") exceeds the maximal number of dimensions of an Array (== " +
+                       std::to_string(max_dynamic_rank) + ").");
+    std::array<ptrdiff_t, max_dynamic_rank> strides{};
+    size_t size = 1;
+    for (size_t d = shape.size(); d-- > 0;) {
+      strides[d] = static_cast<ptrdiff_t>(size);
+      size *= shape[d];
+    }
+
+    m_buffer = detail::ArrayBuffer::create<T>(size);
+    m_view   = ArrayView<T>(m_buffer->elements<T>(), shape.data(), strides.data(),
+                          shape.size());
+    m_view.reset_base(m_buffer, ArrayViewBase::ARRAY);
+  }
+
+  /** Give back a buffer, whose elements have not been constructed */
+  void free_uninitialised() {
+    BufferPool::global().deallocate(m_buffer, m_buffer->bytes);
+    m_buffer = nullptr;
+    m_view   = ArrayView<T>();
+  }
+
+  ArrayView<T> m_view;
+  detail::ArrayBuffer* m_buffer = nullptr;
+};
+
+}  // namespace pammap
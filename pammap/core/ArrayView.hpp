@@ -18,9 +18,18 @@
 //
 
 #pragma once
-#include "Slice.hpp"
+#include "ArrayViewIterator.hpp"
+#include "SlicePlan.hpp"
+#include "StridedIndexer.hpp"
+#include "demangle.hpp"
+#include "dynamic_rank.hpp"
 #include "exceptions.hpp"
+#include "span.hpp"
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -38,28 +47,18 @@ class ArrayViewBase {
   enum BASE_KIND {
     NONE  = 0,
     NUMPY = 1,
+    ARRAY = 2,  //!< detail::ArrayBuffer of a pammap::Array
+    MMAP  = 3,  //!< detail::ArrayBuffer owning a mapped file (see map_array)
   };
 
-  ArrayViewBase() = default;
-  ArrayViewBase(const std::vector<size_t>& shape, std::vector<ptrdiff_t> strides);
-
-  /** The number of elements */
-  size_t size() const { return m_size; }
-
-  /** The number of dimensions */
-  size_t ndim() const { return m_shape.size(); }
-
-  /** The shape in each dimension */
-  const std::vector<size_t>& shape() const { return m_shape; }
-
-  /** The strides in each dimension */
-  const std::vector<ptrdiff_t>& strides() const { return m_strides; }
-
   /** Reset the base object, i.e. replace it by a new one */
-  void reset_base(void* base, BASE_KIND base_kind);
+  void reset_base(void* base, BASE_KIND base_kind) {
+    m_base      = base;
+    m_base_kind = base_kind;
+  }
 
   /** Reset the base object, i.e. purge the current reference */
-  void reset_base();
+  void reset_base() { reset_base(nullptr, NONE); }
 
   /** Obtain the pointer to the current base object */
   void* base() const { return m_base; }
@@ -67,25 +66,7 @@ class ArrayViewBase {
   /** Type of the base object */
   BASE_KIND base_kind() const { return m_base_kind; }
 
-  /** Is the striding Fortran contiguous */
-  bool is_fortran_contiguous() const;
-
-  /** Is the striding C contiguous */
-  bool is_c_contiguous() const;
-
  protected:
-  /** The size, i.e. total number of elements */
-  size_t m_size = 0;
-
-  /** The shape in each dimension */
-  std::vector<size_t> m_shape;
-
-  /** The strides in each dimension */
-  std::vector<ptrdiff_t> m_strides;
-
-  /** Unit stride, i.e. the offset needed to got to the next element */
-  ptrdiff_t m_unit = 1;
-
   /** Some extra pointer to additional structure,
    *  e.g. the original numpy PyArrayObject, to which the data belongs */
   void* m_base = nullptr;
@@ -94,12 +75,63 @@ class ArrayViewBase {
   BASE_KIND m_base_kind = NONE;
 };
 
-/** Light-weight class to view some array data. */
-template <typename T>
-struct ArrayView : public ArrayViewBase {
+namespace detail {
+/** Number of dimensions of an ArrayView with a rank fixed at compile time */
+template <size_t N>
+struct ArrayRank {
+  /** Number of entries needed to store shape and strides */
+  static constexpr size_t capacity = N;
+
+  /** The number of dimensions */
+  static constexpr size_t ndim() { return N; }
+
+  void set_ndim(size_t ndim) {
+    pammap_throw(ndim == N, ValueError,
+                 "Number of dimensions (== " + std::to_string(ndim) +
+                       ") does not agree with the rank of the ArrayView (== " +
+                       std::to_string(N) + ").");
+  }
+};
+
+/** Number of dimensions of an ArrayView with DynamicRank */
+template <>
+struct ArrayRank<DynamicRank> {
+  static constexpr size_t capacity = max_dynamic_rank;
+
+  size_t ndim() const { return m_ndim; }
+
+  void set_ndim(size_t ndim) {
+    pammap_throw(ndim <= capacity, ValueError,
+                 "Number of dimensions (== " + std::to_string(ndim) +
+                       ") exceeds the maximal number of dimensions of an ArrayView (== " +
+                       std::to_string(capacity) + ").");
+    m_ndim = ndim;
+  }
+
+  size_t m_ndim = 0;
+};
+}  // namespace detail
+
+/** Light-weight class to view some array data.
+ *
+ * Shape and strides are stored inline, such that constructing and copying
+ * views does not allocate. If the number of dimensions ``N`` is given at
+ * compile time, multi-dimensional indexing using ``operator()`` is fully
+ * unrolled. With ``N == DynamicRank`` (the default) the number of dimensions
+ * is only known at runtime, but limited by max_dynamic_rank.
+ */
+template <typename T, size_t N = DynamicRank>
+struct ArrayView : public ArrayViewBase, protected detail::ArrayRank<N> {
   /** The type of the ArrayView data */
   typedef T value_type;
 
+  /** The number of dimensions or DynamicRank */
+  static constexpr size_t rank = N;
+
+  /** Iterators over all elements in the order of operator[] */
+  typedef ArrayViewIterator<T, detail::ArrayRank<N>::capacity> iterator;
+  typedef ArrayViewIterator<const T, detail::ArrayRank<N>::capacity> const_iterator;
+
   ArrayView() = default;
 
   /** Construct a ArrayView object.
@@ -110,20 +142,100 @@ struct ArrayView : public ArrayViewBase {
    * \note If some of the stride values are negative data might *not* point
    *       to the beginning of the data!
    */
-  ArrayView(T* data, std::vector<size_t> shape, std::vector<ptrdiff_t> strides)
-        : ArrayViewBase{shape, strides}, m_data(data) {}
+  ArrayView(T* data, const size_t* shape, const ptrdiff_t* strides, size_t ndim)
+        : m_data(data) {
+    assign_layout(shape, strides, ndim);
+  }
+
+  //@{
+  /** Construct a ArrayView object from shape and strides given
+   *  as lists, std::vector or std::array objects (see above). */
+  ArrayView(T* data, std::initializer_list<size_t> shape,
+            std::initializer_list<ptrdiff_t> strides)
+        : m_data(data) {
+    check_layout_sizes(shape.size(), strides.size());
+    assign_layout(shape.begin(), strides.begin(), shape.size());
+  }
+
+  ArrayView(T* data, const std::vector<size_t>& shape,
+            const std::vector<ptrdiff_t>& strides)
+        : m_data(data) {
+    check_layout_sizes(shape.size(), strides.size());
+    assign_layout(shape.data(), strides.data(), shape.size());
+  }
+
+  template <size_t M>
+  ArrayView(T* data, const std::array<size_t, M>& shape,
+            const std::array<ptrdiff_t, M>& strides)
+        : m_data(data) {
+    assign_layout(shape.data(), strides.data(), M);
+  }
+  //@}
 
   /** Constructor from a std::vector, which is only active for a non-bool std::vector
+   *
+   * \note The view does not keep the vector alive. For data which should be
+   *       owned by a PamMap use a pammap::Array instead.
    *
    * The reason for explicitly excluding std::vector<bool> is that the memory layout is
    * different.
    *
    * TODO Think if there is a nicer way to achieve this.
    */
-  template <typename U = T>
+  template <typename U = T,
+            typename = typename std::enable_if<N == 1 || N == DynamicRank, U>::type>
   ArrayView(std::vector<typename std::enable_if<!std::is_same<U, bool>::value, T>::type>&
                   vector)
-        : ArrayViewBase{{vector.size()}, {1}}, m_data{vector.data()} {}
+        : m_data{vector.data()} {
+    const size_t shape     = vector.size();
+    const ptrdiff_t stride = 1;
+    assign_layout(&shape, &stride, 1);
+  }
+
+  //@{
+  /** Conversion between ArrayViews of different rank.
+   *
+   * Conversion to a view of DynamicRank is implicit, conversion to a view of
+   * fixed rank needs to be explicit and throws a ValueError if the number of
+   * dimensions does not agree.
+   */
+  template <size_t M,
+            typename std::enable_if<M != N && N == DynamicRank, int>::type = 0>
+  ArrayView(const ArrayView<T, M>& other)
+        : ArrayViewBase(other), m_data(other.m_data) {
+    assign_layout(other.m_shape.data(), other.m_strides.data(), other.ndim());
+  }
+
+  template <size_t M,
+            typename std::enable_if<M != N && N != DynamicRank, int>::type = 0>
+  explicit ArrayView(const ArrayView<T, M>& other)
+        : ArrayViewBase(other), m_data(other.m_data) {
+    assign_layout(other.m_shape.data(), other.m_strides.data(), other.ndim());
+  }
+  //@}
+
+  /** The size, i.e. total number of elements */
+  size_t size() const { return m_size; }
+
+  /** The number of dimensions */
+  using detail::ArrayRank<N>::ndim;
+
+  /** The shape in each dimension */
+  span<const size_t> shape() const { return {m_shape.data(), ndim()}; }
+
+  /** The strides in each dimension */
+  span<const ptrdiff_t> strides() const { return {m_strides.data(), ndim()}; }
+
+  /** The axes in the order in which operator[] and the iterators
+   *  traverse them, i.e. sorted by increasing absolute stride
+   *  (only the first ndim() entries are used) */
+  std::array<unsigned char, detail::ArrayRank<N>::capacity> axis_order() const;
+
+  /** Is the striding Fortran contiguous */
+  bool is_fortran_contiguous() const;
+
+  /** Is the striding C contiguous */
+  bool is_c_contiguous() const;
 
   ///@{
   /** Obtain pointer relative to which data is indexed
@@ -138,28 +250,135 @@ struct ArrayView : public ArrayViewBase {
   ///@{
   /** Linearised access into the data
    *
-   * This function does not perform bound checks in Release builds
-   * and furthermore plainly returns the data at the memory locations.
-   * For arrays larger than one dimension you should know what you
-   * are doing because the order of the elements depends on the
-   * underlying memory layout.
+   * The elements are enumerated with the axis of smallest absolute stride
+   * varying fastest (similar to numpy's order 'K'), i.e. for C or Fortran
+   * contiguous views the linear index is the offset in memory. Views
+   * with arbitrary strides (e.g. transposed or sliced views) map the linear
+   * index to the memory offset by dividing by the extent of each axis. For
+   * loops over the linear index of such views use indexer(), which avoids
+   * the divisions, and for traversing all elements the iterators.
+   *
+   * This function does not perform bound checks in Release builds.
    * */
-  T operator[](size_t i) const;
-  T& operator[](size_t i);
+  T operator[](size_t i) const { return m_data[linear_offset(i)]; }
+  T& operator[](size_t i) { return m_data[linear_offset(i)]; }
+  ///@}
+
+  ///@{
+  /** Obtain a StridedIndexer for repeated linearised access into the data
+   *  in the order of operator[] without integer divisions. */
+  StridedIndexer<T, detail::ArrayRank<N>::capacity> indexer() {
+    return make_indexer<T>();
+  }
+  StridedIndexer<const T, detail::ArrayRank<N>::capacity> indexer() const {
+    return make_indexer<const T>();
+  }
+  ///@}
+
+  ///@{
+  /** Iterate over all elements in the order of operator[] */
+  iterator begin() { return make_iterator<T>(0); }
+  iterator end() { return make_iterator<T>(m_size); }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+  const_iterator cbegin() const { return make_iterator<const T>(0); }
+  const_iterator cend() const { return make_iterator<const T>(m_size); }
+  ///@}
+
+  ///@{
+  /** Multi-dimensional access into the data, i.e. ``view(i, j, k)``
+   *  for a three-dimensional view.
+   *
+   * The number of indices needs to agree with the number of dimensions.
+   * No bound checks are performed in Release builds.
+   */
+  template <typename... Indices>
+  const T& operator()(Indices... idcs) const {
+    return m_data[offset(idcs...)];
+  }
+  template <typename... Indices>
+  T& operator()(Indices... idcs) {
+    return m_data[offset(idcs...)];
+  }
   ///@}
 
   ///@{
-  /** Get a slice of an array
+  /** Get a slice of an array without copying any data
+   *
+   * The semantics follow numpy's basic slicing: Each Slice object
+   * selects a range along the next axis (also with negative steps),
+   * a Slice::index drops the axis and a NewAxis inserts an axis of
+   * length one. If fewer slices than dimensions are given the
+   * remaining axes are taken in full. As in numpy the bounds of a range
+   * are clipped to the axis, such that a range outside of it yields an
+   * empty axis, whereas a Slice::index out of range throws an IndexError.
+   * Since the number of dimensions may change the result always has
+   * DynamicRank.
    *
    * \note For simplicity const ArrayView objects also return a
    *       *writable*, i.e. non-const ArrayView if sliced.
    * */
-  ArrayView slice(std::initializer_list<Slice> idcs) { return slice_view(idcs); }
-  ArrayView slice(std::initializer_list<Slice> idcs) const { return slice_view(idcs); }
+  ArrayView<T> slice(std::initializer_list<Slice> idcs) const {
+    return slice(SlicePlan(idcs.begin(), idcs.size(), m_shape.data(), ndim()));
+  }
+
+  /** Get a slice of an array using a SlicePlan compiled for its shape.
+   *
+   * Throws a ValueError if the plan has been compiled for a different shape.
+   */
+  ArrayView<T> slice(const SlicePlan& plan) const;
+  ///@}
+
+  ///@{
+  /** View the data with a larger shape without copying, following numpy's
+   *  broadcasting rules: Missing leading axes are added and axes of length
+   *  one are repeated, both by a stride of zero. All other axes need to
+   *  agree with the requested shape, otherwise a ValueError is thrown.
+   *
+   * \note Elements of a broadcast view alias each other, so such views
+   *       should only be read from, in particular by parallel operations.
+   */
+  ArrayView<T> broadcast_to(std::initializer_list<size_t> shape) const {
+    return broadcast_view({shape.begin(), shape.size()});
+  }
+  ArrayView<T> broadcast_to(span<const size_t> shape) const {
+    return broadcast_view(shape);
+  }
+  ///@}
+
+  ///@{
+  /** View the data with a different shape (with the same number of elements)
+   *  without copying. As in numpy the elements are taken in C order, i.e.
+   *  the result enumerates the elements in the same sequence as the view
+   *  with its last axis varying fastest.
+   *
+   * This is possible for all contiguous views and for strided views as
+   * long as each group of axes which is merged or split has compatible
+   * strides. If the data would need to be copied, a ValueError is thrown.
+   */
+  ArrayView<T> reshape(std::initializer_list<size_t> shape) const {
+    return reshape_view({shape.begin(), shape.size()});
+  }
+  ArrayView<T> reshape(span<const size_t> shape) const { return reshape_view(shape); }
+  ///@}
+
+  ///@{
+  /** View with permuted axes without copying, where axis ``k`` of the result
+   *  is axis ``axes[k]`` of this view. Without arguments the order of the
+   *  axes is reversed (the matrix transpose for two-dimensional views).
+   *  Throws a ValueError if ``axes`` is no permutation of the axes.
+   */
+  ArrayView transpose() const;
+  ArrayView transpose(std::initializer_list<size_t> axes) const {
+    return transpose({axes.begin(), axes.size()});
+  }
+  ArrayView transpose(span<const size_t> axes) const;
+  ///@}
 
   /** Compare two ArrayView objects for equality.
    *
-   * They are considered equal if their data and shape/strides are equal
+   * They are considered equal if their shape/strides are equal
+   * and the elements compare equal.
    */
   bool operator==(const ArrayView& other) const;
 
@@ -170,35 +389,326 @@ struct ArrayView : public ArrayViewBase {
   bool operator!=(const ArrayView& other) const { return !operator==(other); }
 
  protected:
+  template <typename U, size_t M>
+  friend struct ArrayView;
+
+  /** Storage type for shape and strides */
+  typedef std::array<size_t, detail::ArrayRank<N>::capacity> shape_type;
+  typedef std::array<ptrdiff_t, detail::ArrayRank<N>::capacity> strides_type;
+
+  /** Set the shape and the strides and precompute the data for operator[] */
+  void assign_layout(const size_t* shape, const ptrdiff_t* strides, size_t ndim);
+
+  /** Compute the memory offset of the element with linear index i */
+  ptrdiff_t linear_offset(size_t i) const {
+#ifndef NDEBUG
+    pammap_throw(i < m_size, IndexError,
+                 "ArrayView index out of range: " + std::to_string(i));
+#endif
+    return m_contiguous ? static_cast<ptrdiff_t>(i) : strided_offset(i);
+  }
+
+  /** Compute the memory offset of the element with linear index i
+   *  for views, which are not contiguous */
+  ptrdiff_t strided_offset(size_t i) const;
+
+  /** Make an iterator pointing to the element with linear index 0 or m_size */
+  template <typename U>
+  ArrayViewIterator<U, detail::ArrayRank<N>::capacity> make_iterator(size_t index) const {
+    const auto order = axis_order();
+    return {m_data, m_shape.data(), m_strides.data(), order.data(),
+            ndim(),  m_contiguous,   index};
+  }
+
+  /** Make an indexer for the linear index of operator[] */
+  template <typename U>
+  StridedIndexer<U, detail::ArrayRank<N>::capacity> make_indexer() const {
+    const auto order = axis_order();
+    return {m_data, m_shape.data(), m_strides.data(), order.data(), ndim(), m_contiguous};
+  }
+
+  /** Check that shape and strides have the same number of dimensions */
+  static void check_layout_sizes(size_t shape_size, size_t strides_size) {
+    pammap_throw(shape_size == strides_size, ValueError,
+                 "Size of shape vector (== " + std::to_string(shape_size) +
+                       ") does not agree with the size of the strides vector "
+                       "(== " +
+                       std::to_string(strides_size) + ").");
+  }
+
+  //@{
+  /** Compute the memory offset of a multi-index */
+  template <typename... Indices>
+  ptrdiff_t offset(Indices... idcs) const {
+    static_assert(N == DynamicRank || sizeof...(Indices) == N,
+                  "Number of indices needs to agree with the rank of the ArrayView.");
+#ifndef NDEBUG
+    pammap_throw(sizeof...(Indices) == ndim(), IndexError,
+                 "Number of indices (== " + std::to_string(sizeof...(Indices)) +
+                       ") does not agree with the number of dimensions of the "
+                       "ArrayView (== " +
+                       std::to_string(ndim()) + ").");
+#endif
+    return offset_from(0, idcs...);
+  }
+
+  ptrdiff_t offset_from(size_t) const { return 0; }
+
+  template <typename Index, typename... Indices>
+  ptrdiff_t offset_from(size_t d, Index i, Indices... rest) const {
+    static_assert(std::is_integral<Index>::value,
+                  "ArrayView indices need to be integers.");
+    const ptrdiff_t idx = static_cast<ptrdiff_t>(i);
+#ifndef NDEBUG
+    pammap_throw(0 <= idx && idx < static_cast<ptrdiff_t>(m_shape[d]), IndexError,
+                 "ArrayView index " + std::to_string(idx) +
+                       " out of range in dimension " + std::to_string(d) + ".");
+#endif
+    return idx * m_strides[d] + offset_from(d + 1, rest...);
+  }
+  //@}
+
   /** The pointer to the beginning of the data block */
   T* m_data = nullptr;
 
-  /** The pointer to the end of the data block */
-  T* m_data_end = nullptr;
+  /** The size, i.e. total number of elements */
+  size_t m_size = 0;
+
+  /** The shape in each dimension */
+  shape_type m_shape{};
+
+  /** The strides in each dimension */
+  strides_type m_strides{};
 
-  /** Helper function to make a slice */
-  ArrayView slice_view(std::initializer_list<Slice> idcs) const;
+  /** Is the data C or Fortran contiguous, such that linear index
+   *  and memory offset agree */
+  bool m_contiguous = true;
+
+  /** Helper functions for broadcast_to and reshape */
+  ArrayView<T> broadcast_view(span<const size_t> shape) const;
+  ArrayView<T> reshape_view(span<const size_t> shape) const;
+};
+
+/** ArrayViews of DynamicRank (the default) are named without their rank */
+template <typename T>
+struct TypeName<ArrayView<T, DynamicRank>> {
+  static std::string get() {
+    const char* qualifier = std::is_const<T>::value ? " const" : "";
+    return "pammap::ArrayView<" + TypeName<typename std::remove_const<T>::type>::get() +
+           qualifier + ">";
+  }
 };
 
 //
 // Inlineable definitions
 //
 
-template <typename T>
-T ArrayView<T>::operator[](size_t i) const {
-#ifndef NDEBUG
-  pammap_throw(i < m_size, IndexError,
-               "ArrayView index out of range: " + std::to_string(i));
-#endif
-  return m_data[static_cast<ptrdiff_t>(i) * m_unit];
+template <typename T, size_t N>
+std::array<unsigned char, detail::ArrayRank<N>::capacity> ArrayView<T, N>::axis_order()
+      const {
+  // Stable insertion sort of the axes by absolute stride (std::stable_sort
+  // would allocate a temporary buffer, which dominates for so few axes)
+  std::array<unsigned char, detail::ArrayRank<N>::capacity> order{};
+  for (size_t d = 0; d < ndim(); ++d) {
+    size_t k = d;
+    for (; k > 0 && std::abs(m_strides[order[k - 1]]) > std::abs(m_strides[d]); --k) {
+      order[k] = order[k - 1];
+    }
+    order[k] = static_cast<unsigned char>(d);
+  }
+  return order;
 }
-template <typename T>
-T& ArrayView<T>::operator[](size_t i) {
-#ifndef NDEBUG
-  pammap_throw(i < m_size, IndexError,
-               "ArrayView index out of range: " + std::to_string(i));
-#endif
-  return m_data[static_cast<ptrdiff_t>(i) * m_unit];
+
+template <typename T, size_t N>
+ptrdiff_t ArrayView<T, N>::strided_offset(size_t i) const {
+  // Peel off the index along each axis, fastest axis first. The quotient
+  // is the linear index with respect to the remaining axes.
+  const auto order = axis_order();
+  ptrdiff_t offset = 0;
+  for (size_t k = 0; k + 1 < ndim(); ++k) {
+    const size_t axis = order[k];
+    const size_t rest = i / m_shape[axis];
+    offset += static_cast<ptrdiff_t>(i - rest * m_shape[axis]) * m_strides[axis];
+    i = rest;
+  }
+  if (ndim() > 0) offset += static_cast<ptrdiff_t>(i) * m_strides[order[ndim() - 1]];
+  return offset;
+}
+
+template <typename T, size_t N>
+void ArrayView<T, N>::assign_layout(const size_t* shape, const ptrdiff_t* strides,
+                                    size_t ndim) {
+  this->set_ndim(ndim);
+  std::copy(shape, shape + ndim, m_shape.begin());
+  std::copy(strides, strides + ndim, m_strides.begin());
+
+  m_size = 1;
+  for (size_t d = 0; d < ndim; ++d) m_size *= shape[d];
+  m_contiguous = is_c_contiguous() || is_fortran_contiguous();
+}
+
+template <typename T, size_t N>
+bool ArrayView<T, N>::is_fortran_contiguous() const {
+  ptrdiff_t acc = 1;
+  for (size_t i = 0; i < ndim(); ++i) {
+    if (m_strides[i] != acc) return false;
+    acc *= static_cast<ptrdiff_t>(m_shape[i]);
+  }
+  return true;
+}
+
+template <typename T, size_t N>
+bool ArrayView<T, N>::is_c_contiguous() const {
+  ptrdiff_t acc = 1;
+  for (size_t i = 0; i < ndim(); ++i) {
+    if (m_strides[ndim() - i - 1] != acc) return false;
+    acc *= static_cast<ptrdiff_t>(m_shape[ndim() - i - 1]);
+  }
+  return true;
+}
+
+template <typename T, size_t N>
+bool ArrayView<T, N>::operator==(const ArrayView& other) const {
+  if (m_size != other.m_size) return false;
+  if (shape() != other.shape()) return false;
+  if (strides() != other.strides()) return false;
+  if (m_data == other.m_data) return true;
+  return std::equal(begin(), end(), other.begin());
+}
+
+template <typename T, size_t N>
+ArrayView<T> ArrayView<T, N>::slice(const SlicePlan& plan) const {
+  pammap_throw(plan.applies_to(shape()), ValueError,
+               "The SlicePlan has been compiled for arrays of a different shape.");
+  typename ArrayView<T>::strides_type strides{};
+  plan.strides(m_strides.data(), strides.data());
+  ArrayView<T> ret(m_data + plan.offset(m_strides.data()),  // NOLINT
+                   plan.shape().data(), strides.data(), plan.ndim());
+  ret.reset_base(m_base, m_base_kind);
+  return ret;
+}
+
+template <typename T, size_t N>
+ArrayView<T> ArrayView<T, N>::broadcast_view(span<const size_t> shape) const {
+  pammap_throw(shape.size() >= ndim() && shape.size() <= max_dynamic_rank, ValueError,
+               "Cannot broadcast an ArrayView of " + std::to_string(ndim()) +
+                     " dimensions to " + std::to_string(shape.size()) + " dimensions.");
+
+  // Align the axes at the end, new leading axes get a zero stride
+  typename ArrayView<T>::strides_type strides{};
+  const size_t lead = shape.size() - ndim();
+  for (size_t d = 0; d < ndim(); ++d) {
+    const bool repeat = m_shape[d] == 1 && shape[lead + d] != 1;
+    pammap_throw(repeat || m_shape[d] == shape[lead + d], ValueError,
+                 "Cannot broadcast axis " + std::to_string(d) + " of length " +
+                       std::to_string(m_shape[d]) + " to length " +
+                       std::to_string(shape[lead + d]) + ".");
+    strides[lead + d] = repeat ? 0 : m_strides[d];
+  }
+
+  ArrayView<T> ret(m_data, shape.data(), strides.data(), shape.size());
+  ret.reset_base(m_base, m_base_kind);
+  return ret;
+}
+
+template <typename T, size_t N>
+ArrayView<T> ArrayView<T, N>::reshape_view(span<const size_t> shape) const {
+  size_t size = 1;
+  for (size_t extent : shape) size *= extent;
+  pammap_throw(size == m_size, ValueError,
+               "Cannot reshape an ArrayView of " + std::to_string(m_size) +
+                     " elements into a shape of " + std::to_string(size) +
+                     " elements.");
+  pammap_throw(shape.size() <= max_dynamic_rank, ValueError,
+               "Reshaping results in more than " + std::to_string(max_dynamic_rank) +
+                     " dimensions.");
+
+  typename ArrayView<T>::strides_type strides{};
+  if (m_size == 0) {
+    // No element is ever accessed, so any strides will do
+    ptrdiff_t acc = 1;
+    for (size_t d = shape.size(); d-- > 0;) {
+      strides[d] = acc;
+      acc *= static_cast<ptrdiff_t>(std::max<size_t>(shape[d], 1));
+    }
+  } else {
+    // Axes of length one do not matter for the layout
+    shape_type old_shape{};
+    strides_type old_strides{};
+    size_t old_ndim = 0;
+    for (size_t d = 0; d < ndim(); ++d) {
+      if (m_shape[d] == 1) continue;
+      old_shape[old_ndim]   = m_shape[d];
+      old_strides[old_ndim] = m_strides[d];
+      ++old_ndim;
+    }
+
+    // Match groups of old and new axes with the same number of elements
+    // (as numpy's _attempt_nocopy_reshape). Within each old group the axes
+    // need to be contiguous with respect to each other, the new group
+    // then inherits the stride of the last old axis.
+    size_t oi = 0, oj = 1, ni = 0, nj = 1;
+    while (ni < shape.size() && oi < old_ndim) {
+      size_t np = shape[ni], op = old_shape[oi];
+      while (np != op) {
+        if (np < op) {
+          np *= shape[nj++];
+        } else {
+          op *= old_shape[oj++];
+        }
+      }
+      for (size_t ok = oi; ok + 1 < oj; ++ok) {
+        pammap_throw(old_strides[ok] == static_cast<ptrdiff_t>(old_shape[ok + 1]) *
+                                              old_strides[ok + 1],
+                     ValueError,
+                     "The ArrayView cannot be reshaped without copying, since its "
+                     "strides are incompatible with the requested shape.");
+      }
+      strides[nj - 1] = old_strides[oj - 1];
+      for (size_t nk = nj - 1; nk > ni; --nk) {
+        strides[nk - 1] = strides[nk] * static_cast<ptrdiff_t>(shape[nk]);
+      }
+      ni = nj++;
+      oi = oj++;
+    }
+
+    // Remaining new axes have length one
+    const ptrdiff_t last = ni > 0 ? strides[ni - 1] : 1;
+    for (; ni < shape.size(); ++ni) strides[ni] = last;
+  }
+
+  ArrayView<T> ret(m_data, shape.data(), strides.data(), shape.size());
+  ret.reset_base(m_base, m_base_kind);
+  return ret;
+}
+
+template <typename T, size_t N>
+ArrayView<T, N> ArrayView<T, N>::transpose() const {
+  shape_type axes{};
+  for (size_t d = 0; d < ndim(); ++d) axes[d] = ndim() - 1 - d;
+  return transpose({axes.data(), ndim()});
+}
+
+template <typename T, size_t N>
+ArrayView<T, N> ArrayView<T, N>::transpose(span<const size_t> axes) const {
+  pammap_throw(axes.size() == ndim(), ValueError,
+               "Number of axes passed to transpose (== " + std::to_string(axes.size()) +
+                     ") does not agree with the number of dimensions (== " +
+                     std::to_string(ndim()) + ").");
+  shape_type shape{};
+  strides_type strides{};
+  std::array<bool, detail::ArrayRank<N>::capacity> used{};
+  for (size_t d = 0; d < ndim(); ++d) {
+    pammap_throw(axes[d] < ndim() && !used[axes[d]], ValueError,
+                 "The axes passed to transpose need to be a permutation of the axes.");
+    used[axes[d]] = true;
+    shape[d]      = m_shape[axes[d]];
+    strides[d]    = m_strides[axes[d]];
+  }
+
+  ArrayView ret(m_data, shape.data(), strides.data(), ndim());
+  ret.reset_base(m_base, m_base_kind);
+  return ret;
 }
 
 }  // namespace pammap
@@ -31,5 +31,10 @@ template struct ArrayView<Integer>;
 template struct ArrayView<Float>;
 template struct ArrayView<String>;
 template struct ArrayView<Bool>;
+template struct ArrayView<Float32>;
+template struct ArrayView<Complex64>;
+template struct ArrayView<Integer32>;
+template struct ArrayView<Integer8>;
+template struct ArrayView<Unsigned8>;
 
 }  // namespace pammap
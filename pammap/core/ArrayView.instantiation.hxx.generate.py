@@ -30,7 +30,7 @@ def generate():
     output += ["#include \"typedefs.hxx\""]
 
     output += NAMESPACE_OPEN
-    for dtype in constants.DTYPES:
+    for dtype in constants.DTYPES + constants.ARRAY_DTYPES:
         output.append("template struct ArrayView<{0:}>;".format(to_cpp_type(dtype)))
     output += NAMESPACE_CLOSE
     return "\n".join(output)
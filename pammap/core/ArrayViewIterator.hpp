@@ -0,0 +1,124 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace pammap {
+
+/** Forward iterator over all elements of an ArrayView.
+ *
+ * The elements are visited in the order of ArrayView::operator[], i.e.
+ * with the axis of smallest absolute stride varying fastest. For C or
+ * Fortran contiguous views this simply increments a pointer, otherwise a
+ * counter per axis is kept and incremented like an odometer, such that
+ * no division is needed at all.
+ *
+ * \tparam T         The (possibly const-qualified) element type
+ * \tparam Capacity  The maximal number of axes
+ */
+template <typename T, size_t Capacity>
+class ArrayViewIterator {
+ public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef typename std::remove_const<T>::type value_type;
+  typedef ptrdiff_t difference_type;
+  typedef T* pointer;
+  typedef T& reference;
+
+  /** Default constructor, leaves the iterator in an invalid state */
+  ArrayViewIterator() = default;
+
+  /** Construct an iterator pointing to the element with linear index
+   *  ``index``, which needs to be 0 or ``size`` (the end iterator).
+   *
+   * \param data        Pointer to the element with multi-index zero
+   * \param shape       Shape of the axes
+   * \param strides     Strides of the axes
+   * \param order       Axes in iteration order (fastest first)
+   * \param ndim        Number of axes
+   * \param contiguous  Are the elements stored contiguously in iteration order
+   */
+  ArrayViewIterator(T* data, const size_t* shape, const ptrdiff_t* strides,
+                    const unsigned char* order, size_t ndim, bool contiguous,
+                    size_t index)
+        : m_ptr(data), m_index(index), m_contiguous(contiguous), m_ndim(ndim) {
+    for (size_t k = 0; k < ndim; ++k) {
+      m_shape[k]   = shape[order[k]];
+      m_strides[k] = strides[order[k]];
+      m_counter[k] = 0;
+    }
+  }
+
+  reference operator*() const { return *m_ptr; }
+  pointer operator->() const { return m_ptr; }
+
+  ArrayViewIterator& operator++() {
+    ++m_index;
+    if (m_contiguous) {
+      ++m_ptr;
+      return *this;
+    }
+
+    for (size_t k = 0; k < m_ndim; ++k) {
+      m_ptr += m_strides[k];  // NOLINT  Pointer arithmetic required
+      if (++m_counter[k] < m_shape[k]) return *this;
+
+      // Wrap around this axis and carry over to the next one
+      m_ptr -= m_strides[k] * static_cast<ptrdiff_t>(m_shape[k]);  // NOLINT
+      m_counter[k] = 0;
+    }
+    return *this;
+  }
+
+  ArrayViewIterator operator++(int) {
+    ArrayViewIterator copy(*this);
+    ++(*this);
+    return copy;
+  }
+
+  /** Iterators are compared by their linear index */
+  bool operator==(const ArrayViewIterator& other) const {
+    return m_index == other.m_index;
+  }
+  bool operator!=(const ArrayViewIterator& other) const { return !operator==(other); }
+
+ private:
+  /** The current element */
+  T* m_ptr = nullptr;
+
+  /** The linear index of the current element */
+  size_t m_index = 0;
+
+  /** Can we just increment the pointer */
+  bool m_contiguous = true;
+
+  /** Number of axes */
+  size_t m_ndim = 0;
+
+  /** Shape, strides and current multi-index (fastest axis first) */
+  std::array<size_t, Capacity> m_shape;
+  std::array<ptrdiff_t, Capacity> m_strides;
+  std::array<size_t, Capacity> m_counter;
+};
+
+}  // namespace pammap
@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "Array.hpp"
+#include "BitArrayView.hpp"
+
+namespace pammap {
+
+/** A one-dimensional array of bits, which owns its data.
+ *
+ * The words are stored in an Array<BitArrayView::word_type>, such that the
+ * same pooled and reference-counted buffers are used and copies of a
+ * BitArray refer to the same bits. Use ``BitArray(other.view())`` for an
+ * independent copy. Like Arrays, BitArrays can be stored inside a PamMap
+ * and such entries can be obtained both as ``BitArray`` and as
+ * ``BitArrayView``.
+ */
+class BitArray {
+ public:
+  typedef BitArrayView::word_type word_type;
+
+  /** A BitArray without data */
+  BitArray() = default;
+
+  /** Construct an array of ``size`` bits all set to ``value`` */
+  explicit BitArray(size_t size, bool value = false)
+        : m_words({BitArrayView::n_words_for(size)}, value ? ~word_type(0) : 0),
+          m_view(m_words.data(), size) {
+    m_view.reset_base(m_words.view().base(), ArrayViewBase::ARRAY);
+  }
+
+  /** Construct an array holding a copy of the bits of a view */
+  explicit BitArray(const BitArrayView& view) : BitArray(view.size()) {
+    const size_t n = view.n_words();
+    std::copy(view.words(), view.words() + n, m_words.data());
+  }
+
+  /** Construct an array with the bits taken from an ArrayView<Bool>
+   *  (see BitArrayView::from_bools) */
+  static BitArray from_bools(const ArrayView<Bool>& bools) {
+    BitArray ret(bools.size());
+    ret.m_view.from_bools(bools);
+    return ret;
+  }
+
+  /** Construct an array of ``size`` bits from the layout of numpy.packbits
+   *  (see BitArrayView::from_packbits) */
+  static BitArray from_packbits(const uint8_t* bytes, size_t size) {
+    BitArray ret(size);
+    ret.m_view.from_packbits(bytes);
+    return ret;
+  }
+
+  //@{
+  /** A view onto the bits of the array.
+   *
+   * \note The view does not keep the data alive.
+   */
+  BitArrayView& view() { return m_view; }
+  const BitArrayView& view() const { return m_view; }
+  //@}
+
+  /** The number of bits */
+  size_t size() const { return m_view.size(); }
+
+  //@{
+  /** Access to individual bits */
+  bool test(size_t i) const { return m_view.test(i); }
+  bool operator[](size_t i) const { return m_view.test(i); }
+  void set(size_t i, bool value = true) { m_view.set(i, value); }
+  void reset(size_t i) { m_view.reset(i); }
+  void flip(size_t i) { m_view.flip(i); }
+  //@}
+
+  /** The number of set bits */
+  size_t count() const { return m_view.count(); }
+
+  /** Number of owners of the data (0 for a BitArray without data) */
+  size_t use_count() const { return m_words.use_count(); }
+
+ private:
+  Array<word_type> m_words;
+  BitArrayView m_view;
+};
+
+}  // namespace pammap
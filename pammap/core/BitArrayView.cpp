@@ -0,0 +1,237 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "BitArrayView.hpp"
+#include "reductions.hpp"
+#include <cstring>
+
+namespace pammap {
+namespace {
+typedef BitArrayView::word_type word_type;
+constexpr size_t word_bits = BitArrayView::word_bits;
+
+/** For each byte value the eight Bools of its bits, least significant first */
+struct BoolTable {
+  BoolTable() {
+    for (size_t v = 0; v < 256; ++v) {
+      for (size_t j = 0; j < 8; ++j) bools[v][j] = ((v >> j) & 1u) != 0;
+    }
+  }
+  Bool bools[256][8];
+};
+const BoolTable bool_table;
+
+/** For each byte value the byte with the bit order reversed */
+struct ReverseTable {
+  ReverseTable() {
+    for (size_t v = 0; v < 256; ++v) {
+      size_t r = 0;
+      for (size_t j = 0; j < 8; ++j) r |= ((v >> j) & 1u) << (7 - j);
+      bytes[v] = static_cast<uint8_t>(r);
+    }
+  }
+  uint8_t bytes[256];
+};
+const ReverseTable reverse_table;
+
+/** Pack 64 contiguous Bools into a word */
+word_type pack_word(const Bool* bools) {
+  static_assert(sizeof(Bool) == 1, "Bool is expected to take one byte");
+  word_type word = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // Each group of 8 Bools (bytes 0 or 1) is moved to the top byte of the
+  // product, where the Bool at byte j ends up at bit j.
+  for (size_t k = 0; k < 8; ++k) {
+    uint64_t group;
+    std::memcpy(&group, bools + 8 * k, 8);
+    word |= ((group * 0x0102040810204080ull) >> 56) << (8 * k);
+  }
+#else
+  for (size_t j = 0; j < word_bits; ++j) word |= word_type(bools[j] ? 1 : 0) << j;
+#endif
+  return word;
+}
+}  // namespace
+
+constexpr size_t BitArrayView::word_bits;
+constexpr size_t BitArrayView::npos;
+
+void BitArrayView::check_size(size_t other_size) const {
+  pammap_throw(other_size == m_size, ValueError,
+               "Size of the other view (== " + std::to_string(other_size) +
+                     ") does not agree with the size of the BitArrayView (== " +
+                     std::to_string(m_size) + ").");
+}
+
+void BitArrayView::fill(bool value) {
+  if (m_size == 0) return;
+  const size_t n          = n_words();
+  const word_type pattern = value ? ~word_type(0) : 0;
+  for (size_t w = 0; w + 1 < n; ++w) m_words[w] = pattern;
+  m_words[n - 1] = (m_words[n - 1] & ~last_mask()) | (pattern & last_mask());
+}
+
+void BitArrayView::flip() {
+  if (m_size == 0) return;
+  const size_t n = n_words();
+  for (size_t w = 0; w + 1 < n; ++w) m_words[w] = ~m_words[w];
+  m_words[n - 1] ^= last_mask();
+}
+
+size_t BitArrayView::count() const {
+  if (m_size == 0) return 0;
+  const size_t n = n_words();
+  return detail::count_bits(m_words, n - 1) +
+         static_cast<size_t>(__builtin_popcountll(m_words[n - 1] & last_mask()));
+}
+
+bool BitArrayView::any() const {
+  if (m_size == 0) return false;
+  const size_t n = n_words();
+  word_type acc  = m_words[n - 1] & last_mask();
+  for (size_t w = 0; w + 1 < n; ++w) acc |= m_words[w];
+  return acc != 0;
+}
+
+bool BitArrayView::all() const {
+  if (m_size == 0) return true;
+  const size_t n = n_words();
+  word_type acc  = m_words[n - 1] | ~last_mask();
+  for (size_t w = 0; w + 1 < n; ++w) acc &= m_words[w];
+  return acc == ~word_type(0);
+}
+
+size_t BitArrayView::find_next(size_t pos) const {
+  if (pos >= m_size) return npos;
+  const size_t n = n_words();
+  size_t w       = pos / word_bits;
+
+  // Mask out the bits before pos in the first word inspected
+  word_type word = m_words[w] & (~word_type(0) << (pos % word_bits));
+  while (true) {
+    if (w + 1 == n) word &= last_mask();
+    if (word != 0) return w * word_bits + static_cast<size_t>(__builtin_ctzll(word));
+    if (++w == n) return npos;
+    word = m_words[w];
+  }
+}
+
+template <typename Op>
+void BitArrayView::combine(const BitArrayView& other, Op op) {
+  check_size(other.m_size);
+  if (m_size == 0) return;
+  const size_t n                   = n_words();
+  word_type* __restrict__ out      = m_words;
+  const word_type* __restrict__ in = other.m_words;
+  if (out == in) {
+    for (size_t w = 0; w + 1 < n; ++w) out[w] = op(out[w], out[w]);
+  } else {
+    for (size_t w = 0; w + 1 < n; ++w) out[w] = op(out[w], in[w]);
+  }
+  const word_type last = op(m_words[n - 1], other.m_words[n - 1]);
+  m_words[n - 1] = (m_words[n - 1] & ~last_mask()) | (last & last_mask());
+}
+
+BitArrayView& BitArrayView::operator&=(const BitArrayView& other) {
+  combine(other, [](word_type a, word_type b) { return a & b; });
+  return *this;
+}
+
+BitArrayView& BitArrayView::operator|=(const BitArrayView& other) {
+  combine(other, [](word_type a, word_type b) { return a | b; });
+  return *this;
+}
+
+BitArrayView& BitArrayView::operator^=(const BitArrayView& other) {
+  combine(other, [](word_type a, word_type b) { return a ^ b; });
+  return *this;
+}
+
+BitArrayView& BitArrayView::and_not(const BitArrayView& other) {
+  combine(other, [](word_type a, word_type b) { return a & ~b; });
+  return *this;
+}
+
+bool BitArrayView::operator==(const BitArrayView& other) const {
+  if (m_size != other.m_size) return false;
+  if (m_size == 0 || m_words == other.m_words) return true;
+  const size_t n = n_words();
+  for (size_t w = 0; w + 1 < n; ++w) {
+    if (m_words[w] != other.m_words[w]) return false;
+  }
+  return ((m_words[n - 1] ^ other.m_words[n - 1]) & last_mask()) == 0;
+}
+
+void BitArrayView::to_bools(ArrayView<Bool> out) const {
+  check_size(out.size());
+  if (!(out.is_c_contiguous() || out.is_fortran_contiguous())) {
+    for (size_t i = 0; i < m_size; ++i) out[i] = test(i);
+    return;
+  }
+
+  Bool* data          = out.data();
+  const size_t nbytes = m_size / 8;
+  for (size_t k = 0; k < nbytes; ++k) {
+    const size_t byte = (m_words[k / 8] >> (8 * (k % 8))) & 0xffu;
+    std::memcpy(data + 8 * k, bool_table.bools[byte], 8);
+  }
+  for (size_t i = 8 * nbytes; i < m_size; ++i) data[i] = test(i);
+}
+
+void BitArrayView::from_bools(const ArrayView<Bool>& in) {
+  check_size(in.size());
+  if (!(in.is_c_contiguous() || in.is_fortran_contiguous())) {
+    for (size_t i = 0; i < m_size; ++i) set(i, in[i]);
+    return;
+  }
+
+  const Bool* data   = in.data();
+  const size_t nfull  = m_size / word_bits;
+  for (size_t w = 0; w < nfull; ++w) m_words[w] = pack_word(data + w * word_bits);
+  for (size_t i = nfull * word_bits; i < m_size; ++i) set(i, data[i]);
+}
+
+void BitArrayView::to_packbits(uint8_t* bytes) const {
+  const size_t nbytes = (m_size + 7) / 8;
+  for (size_t k = 0; k < nbytes; ++k) {
+    const size_t byte = (m_words[k / 8] >> (8 * (k % 8))) & 0xffu;
+    bytes[k]          = reverse_table.bytes[byte];
+  }
+
+  // Zero the padding bits (the least significant ones in numpy's bit order)
+  if (m_size % 8 != 0) {
+    bytes[nbytes - 1] &= static_cast<uint8_t>(0xffu << (8 - m_size % 8));
+  }
+}
+
+void BitArrayView::from_packbits(const uint8_t* bytes) {
+  const size_t nfull = m_size / word_bits;
+  for (size_t w = 0; w < nfull; ++w) {
+    word_type word = 0;
+    for (size_t k = 0; k < 8; ++k) {
+      word |= word_type(reverse_table.bytes[bytes[8 * w + k]]) << (8 * k);
+    }
+    m_words[w] = word;
+  }
+  for (size_t i = nfull * word_bits; i < m_size; ++i) {
+    set(i, ((bytes[i / 8] >> (7 - i % 8)) & 1u) != 0);
+  }
+}
+
+}  // namespace pammap
@@ -0,0 +1,186 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "exceptions.hpp"
+#include "typedefs.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pammap {
+
+/** Light-weight class to view a one-dimensional array of bits.
+ *
+ * The bits are packed into 64-bit words, where bit ``i`` is stored in bit
+ * ``i % 64`` of word ``i / 64``, such that a mask takes an eighth of the
+ * memory of an ArrayView<Bool>. Counting, searching and the bitwise
+ * operations work on whole words. The unused bits of the last word are
+ * ignored by all operations and never modified.
+ *
+ * Like ArrayView the view does not own the data, see BitArray for that.
+ */
+class BitArrayView : public ArrayViewBase {
+ public:
+  /** The type of the words holding the bits */
+  typedef uint64_t word_type;
+
+  /** Number of bits per word */
+  static constexpr size_t word_bits = 64;
+
+  /** Returned by the find functions if no bit is set */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  BitArrayView() = default;
+
+  /** Construct a view of ``size`` bits stored in the words pointed to
+   *  by ``words`` (i.e. n_words_for(size) words) */
+  BitArrayView(word_type* words, size_t size) : m_words(words), m_size(size) {}
+
+  /** Number of words needed to store ``size`` bits */
+  static size_t n_words_for(size_t size) { return (size + word_bits - 1) / word_bits; }
+
+  /** The number of bits */
+  size_t size() const { return m_size; }
+
+  /** The number of words */
+  size_t n_words() const { return n_words_for(m_size); }
+
+  ///@{
+  /** Pointer to the words */
+  word_type* words() { return m_words; }
+  const word_type* words() const { return m_words; }
+  ///@}
+
+  ///@{
+  /** Access to individual bits.
+   *
+   * These functions do not perform bound checks in Release builds.
+   */
+  bool test(size_t i) const {
+    check_index(i);
+    return ((m_words[i / word_bits] >> (i % word_bits)) & 1u) != 0;
+  }
+  bool operator[](size_t i) const { return test(i); }
+
+  void set(size_t i, bool value = true) {
+    check_index(i);
+    const word_type bit = word_type(1) << (i % word_bits);
+    if (value) {
+      m_words[i / word_bits] |= bit;
+    } else {
+      m_words[i / word_bits] &= ~bit;
+    }
+  }
+  void reset(size_t i) { set(i, false); }
+  void flip(size_t i) {
+    check_index(i);
+    m_words[i / word_bits] ^= word_type(1) << (i % word_bits);
+  }
+  ///@}
+
+  /** Set all bits to a value */
+  void fill(bool value);
+
+  /** Invert all bits */
+  void flip();
+
+  /** The number of set bits */
+  size_t count() const;
+
+  /** Is any bit set (false for an empty view) */
+  bool any() const;
+
+  /** Are all bits set (true for an empty view) */
+  bool all() const;
+
+  /** Is no bit set */
+  bool none() const { return !any(); }
+
+  /** Index of the first set bit or npos */
+  size_t find_first() const { return find_next(0); }
+
+  /** Index of the first set bit at or after ``pos`` or npos */
+  size_t find_next(size_t pos) const;
+
+  //@{
+  /** Elementwise bitwise operations with a view of the same size.
+   *  Throws a ValueError if the sizes differ. */
+  BitArrayView& operator&=(const BitArrayView& other);
+  BitArrayView& operator|=(const BitArrayView& other);
+  BitArrayView& operator^=(const BitArrayView& other);
+  //@}
+
+  /** Clear all bits, which are set in ``other``. Throws a ValueError
+   *  if the sizes differ. */
+  BitArrayView& and_not(const BitArrayView& other);
+
+  /** Do the two views have the same size and the same bits set */
+  bool operator==(const BitArrayView& other) const;
+
+  /** Do the two views differ in size or bits set */
+  bool operator!=(const BitArrayView& other) const { return !operator==(other); }
+
+  //@{
+  /** Conversion to and from an ArrayView<Bool> with one Bool per bit, where
+   *  the bits are taken in the order of ArrayView::operator[]. Throws a
+   *  ValueError if the sizes differ. */
+  void to_bools(ArrayView<Bool> out) const;
+  void from_bools(const ArrayView<Bool>& in);
+  //@}
+
+  //@{
+  /** Conversion to and from the layout of numpy.packbits, i.e. bytes with
+   *  the first bit in the most significant position (bitorder "big").
+   *  The (size() + 7) / 8 bytes are written to or read from ``bytes``,
+   *  padding bits are written as zero. */
+  void to_packbits(uint8_t* bytes) const;
+  void from_packbits(const uint8_t* bytes);
+  //@}
+
+ private:
+  void check_index(size_t i) const {
+#ifndef NDEBUG
+    pammap_throw(i < m_size, IndexError, "BitArrayView index out of range: " +
+                                               std::to_string(i));
+#else
+    (void)i;
+#endif
+  }
+
+  /** Throw a ValueError if the other view has a different size */
+  void check_size(size_t other_size) const;
+
+  /** Mask of the used bits in the last word */
+  word_type last_mask() const {
+    const size_t rest = m_size % word_bits;
+    return rest == 0 ? ~word_type(0) : (word_type(1) << rest) - 1;
+  }
+
+  /** Combine all words with those of ``other`` using ``op``, leaving
+   *  the unused bits of the last word untouched */
+  template <typename Op>
+  void combine(const BitArrayView& other, Op op);
+
+  word_type* m_words = nullptr;
+  size_t m_size      = 0;
+};
+
+}  // namespace pammap
@@ -0,0 +1,208 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "BufferPool.hpp"
+#include "config.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef HAVE_MMAP_HUGEPAGE
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_SYS_MBIND
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pammap {
+namespace {
+/** Index of the size class for a request of ``bytes`` bytes
+ *  (n_classes if the request is beyond the largest class) */
+size_t size_class(size_t bytes) {
+  if (bytes <= BufferPool::alignment) return 0;
+
+  // The class sizes in (2^e, 2^(e+1)] are 2^e * {5, 6, 7, 8} / 4
+  size_t e = 0;
+  while ((bytes - 1) >> (e + 1)) ++e;
+  const size_t quarter = (size_t(1) << e) / 4;
+  const size_t q       = (bytes + quarter - 1) / quarter - 4;
+  return std::min(4 * (e - 6) + q, BufferPool::n_classes);
+}
+
+/** Number of bytes of a size class */
+size_t class_bytes(size_t index) {
+  const size_t power = BufferPool::alignment << (index / 4);
+  return power / 4 * (4 + index % 4);
+}
+
+#ifdef HAVE_MMAP_HUGEPAGE
+/** Size of a (transparent) huge page */
+constexpr size_t huge_page_bytes = size_t(2) << 20;
+
+/** Length of the mapping for a large buffer */
+size_t mapping_bytes(size_t bytes) {
+  return (bytes + huge_page_bytes - 1) / huge_page_bytes * huge_page_bytes;
+}
+#endif
+
+#ifdef HAVE_SYS_MBIND
+/** Apply the NUMA placement of the policy to a mapping. The placement is only
+ *  a hint, so failures (e.g. if mbind is not permitted) are ignored. */
+void place_pages(void* buffer, size_t bytes, const LargeBufferPolicy& policy) {
+  if (policy.numa == LargeBufferPolicy::FIRST_TOUCH) return;
+
+  // Values from <numaif.h>, which is only available with libnuma
+  const int mpol_bind = 2, mpol_interleave = 3;
+  const unsigned long mpol_f_mems_allowed = 1 << 2;
+  const unsigned long maxnode = 8 * sizeof(unsigned long);
+
+  unsigned long nodes = policy.nodes;
+  if (nodes == 0) {
+    syscall(SYS_get_mempolicy, nullptr, &nodes, maxnode, nullptr, mpol_f_mems_allowed);
+  }
+  const int mode = policy.numa == LargeBufferPolicy::BIND ? mpol_bind : mpol_interleave;
+  syscall(SYS_mbind, buffer, bytes, mode, &nodes, maxnode, 0);
+}
+#endif
+
+/** Obtain a buffer from the system */
+void* system_allocate(size_t bytes, const BufferPool& pool) {
+#ifdef HAVE_MMAP_HUGEPAGE
+  if (bytes >= BufferPool::large_buffer_bytes) {
+    // Map one huge page more than needed and cut off the unaligned ends,
+    // such that the buffer is aligned to huge pages.
+    const size_t length = mapping_bytes(bytes);
+    void* mapping = mmap(nullptr, length + huge_page_bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) throw std::bad_alloc();
+    const auto address = reinterpret_cast<uintptr_t>(mapping);
+    const size_t head  = (huge_page_bytes - address % huge_page_bytes) % huge_page_bytes;
+    char* buffer       = static_cast<char*>(mapping) + head;
+    if (head > 0) munmap(mapping, head);
+    munmap(buffer + length, huge_page_bytes - head);
+
+    const LargeBufferPolicy policy = pool.large_buffer_policy();
+    madvise(buffer, length, policy.huge_pages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#ifdef HAVE_SYS_MBIND
+    place_pages(buffer, length, policy);
+#endif
+    return buffer;
+  }
+#else
+  (void)pool;
+#endif
+
+  void* buffer = nullptr;
+  if (posix_memalign(&buffer, BufferPool::alignment, bytes) != 0) {
+    throw std::bad_alloc();
+  }
+  return buffer;
+}
+
+/** Give a buffer obtained from system_allocate back to the system */
+void system_free(void* buffer, size_t bytes) {
+#ifdef HAVE_MMAP_HUGEPAGE
+  if (bytes >= BufferPool::large_buffer_bytes) {
+    munmap(buffer, mapping_bytes(bytes));
+    return;
+  }
+#else
+  (void)bytes;
+#endif
+  std::free(buffer);
+}
+}  // namespace
+
+constexpr size_t BufferPool::alignment;
+constexpr size_t BufferPool::n_classes;
+constexpr size_t BufferPool::large_buffer_bytes;
+
+BufferPool::BufferPool(size_t max_cached_bytes) : m_max_cached_bytes(max_cached_bytes) {}
+
+BufferPool::~BufferPool() { release(); }
+
+size_t BufferPool::size_class_bytes(size_t bytes) {
+  const size_t index = size_class(bytes);
+  return index < n_classes ? class_bytes(index) : bytes;
+}
+
+void* BufferPool::allocate(size_t bytes) {
+  const size_t index = size_class(bytes);
+  if (index >= n_classes) return system_allocate(bytes, *this);
+
+  FreeList& list = m_free[index];
+  {
+    std::lock_guard<std::mutex> lock(list.mutex);
+    if (!list.buffers.empty()) {
+      void* buffer = list.buffers.back();
+      list.buffers.pop_back();
+      m_cached_bytes -= class_bytes(index);
+      return buffer;
+    }
+  }
+  return system_allocate(class_bytes(index), *this);
+}
+
+void BufferPool::deallocate(void* buffer, size_t bytes) {
+  if (buffer == nullptr) return;
+  const size_t index = size_class(bytes);
+  if (index < n_classes) {
+    const size_t size = class_bytes(index);
+    if (m_cached_bytes.fetch_add(size) + size <= m_max_cached_bytes) {
+      FreeList& list = m_free[index];
+      std::lock_guard<std::mutex> lock(list.mutex);
+      list.buffers.push_back(buffer);
+      return;
+    }
+    m_cached_bytes -= size;
+    bytes = size;
+  }
+  system_free(buffer, bytes);
+}
+
+void BufferPool::release() {
+  for (size_t index = 0; index < n_classes; ++index) {
+    FreeList& list = m_free[index];
+    std::lock_guard<std::mutex> lock(list.mutex);
+    for (void* buffer : list.buffers) system_free(buffer, class_bytes(index));
+    m_cached_bytes -= list.buffers.size() * class_bytes(index);
+    list.buffers.clear();
+  }
+}
+
+LargeBufferPolicy BufferPool::large_buffer_policy() const {
+  std::lock_guard<std::mutex> lock(m_policy_mutex);
+  return m_policy;
+}
+
+void BufferPool::set_large_buffer_policy(const LargeBufferPolicy& policy) {
+  std::lock_guard<std::mutex> lock(m_policy_mutex);
+  m_policy = policy;
+}
+
+BufferPool& BufferPool::global() {
+  // Never destroyed, since Arrays in other static objects
+  // may still give back their buffers during program exit.
+  static BufferPool* pool = new BufferPool();
+  return *pool;
+}
+
+}  // namespace pammap
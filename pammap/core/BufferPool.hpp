@@ -0,0 +1,148 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace pammap {
+
+/** How a BufferPool obtains large buffers from the operating system */
+struct LargeBufferPolicy {
+  /** Placement of the pages of a buffer on the NUMA nodes */
+  enum NUMA_PLACEMENT {
+    /** Operating system default, i.e. usually the node of the thread
+     *  writing to a page first */
+    FIRST_TOUCH = 0,
+    /** Spread the pages round-robin over the nodes */
+    INTERLEAVE = 1,
+    /** Only use the nodes given in ``nodes`` */
+    BIND = 2,
+  };
+
+  /** Back the buffers by transparent huge pages, which reduces the number
+   *  of TLB misses when sweeping through a large buffer. If false huge pages
+   *  are explicitly disabled for the buffer. */
+  bool huge_pages = true;
+
+  /** Placement of the pages */
+  NUMA_PLACEMENT numa = FIRST_TOUCH;
+
+  /** Bitmask of the NUMA nodes to use for INTERLEAVE or BIND,
+   *  zero means all nodes available to the process */
+  unsigned long nodes = 0;
+};
+
+/** Allocator for aligned memory buffers, which keeps freed buffers for reuse.
+ *
+ * Requested sizes are rounded up to a size class. Starting from the
+ * alignment there are four size classes per power of two (e.g. 64, 80, 96,
+ * 112, 128, 160, ... bytes), such that at most 25% of the memory is
+ * wasted by the rounding. A freed buffer is kept in a free list of its size
+ * class as long as the total number of cached bytes stays below
+ * max_cached_bytes(), such that a later allocation of the same class (e.g.
+ * the result of the next iteration of some algorithm) does not need to go
+ * to the system allocator. Buffers beyond the largest size class (448 MiB)
+ * are never cached.
+ *
+ * Buffers of at least large_buffer_bytes are mapped directly from the
+ * operating system (using ``mmap``) according to the large_buffer_policy(),
+ * i.e. aligned to huge pages, advised to use transparent huge pages and
+ * optionally bound or interleaved across NUMA nodes (using ``mbind``).
+ * Where this is not supported they are allocated like all other buffers.
+ * Since the pages of such buffers are only placed once they are written
+ * to, the data should be initialised by the threads which use it later
+ * (as done by pammap::Array using the parallel pammap::fill).
+ *
+ * All functions are thread-safe. Each size class has its own lock, such
+ * that threads working on different sizes do not contend.
+ */
+class BufferPool {
+ public:
+  /** Alignment of all buffers in bytes (one cache line, a full AVX-512 register) */
+  static constexpr size_t alignment = 64;
+
+  /** Number of size classes */
+  static constexpr size_t n_classes = 4 * 23;
+
+  /** Size from which on buffers are treated as large */
+  static constexpr size_t large_buffer_bytes = size_t(4) << 20;
+
+  /** Construct an empty pool caching at most ``max_cached_bytes`` bytes */
+  explicit BufferPool(size_t max_cached_bytes = size_t(256) << 20);
+
+  /** Return all cached buffers to the system */
+  ~BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  /** Allocate an aligned buffer of at least ``bytes`` bytes.
+   *  Throws std::bad_alloc if no memory is available. */
+  void* allocate(size_t bytes);
+
+  /** Give back a buffer obtained from allocate(bytes) with the same ``bytes`` */
+  void deallocate(void* buffer, size_t bytes);
+
+  /** Return all cached buffers to the system */
+  void release();
+
+  /** The number of bytes currently held in the free lists */
+  size_t cached_bytes() const { return m_cached_bytes.load(); }
+
+  //@{
+  /** Maximal number of bytes held in the free lists. Lowering the value does
+   *  not free any buffers, call release() for that. */
+  size_t max_cached_bytes() const { return m_max_cached_bytes.load(); }
+  void set_max_cached_bytes(size_t bytes) { m_max_cached_bytes = bytes; }
+  //@}
+
+  //@{
+  /** The way large buffers are allocated. Changing the policy does not
+   *  affect the buffers already in the free lists, call release() for that. */
+  LargeBufferPolicy large_buffer_policy() const;
+  void set_large_buffer_policy(const LargeBufferPolicy& policy);
+  //@}
+
+  /** The number of bytes actually reserved for a request of ``bytes`` bytes */
+  static size_t size_class_bytes(size_t bytes);
+
+  /** The pool used by pammap::Array */
+  static BufferPool& global();
+
+ private:
+  /** Free list of one size class */
+  struct FreeList {
+    std::mutex mutex;
+    std::vector<void*> buffers;
+  };
+
+  std::array<FreeList, n_classes> m_free{};
+  std::atomic<size_t> m_cached_bytes{0};
+  std::atomic<size_t> m_max_cached_bytes;
+
+  /** Protects the large buffer policy */
+  mutable std::mutex m_policy_mutex;
+  LargeBufferPolicy m_policy;
+};
+
+}  // namespace pammap
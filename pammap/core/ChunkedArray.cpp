@@ -0,0 +1,171 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ChunkedArray.hpp"
+#include "config.hpp"
+#include "map_array.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#ifdef HAVE_POSIX_MAPPED_FILES
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace pammap {
+namespace detail {
+
+namespace {
+/** Call ``function(source, destination, count)`` for the contiguous runs of
+ *  elements making up a block of an array in C order, where ``source``
+ *  is the linear index in the array, ``destination`` the one in the
+ *  (C contiguous) block and ``count`` the number of elements of the run. */
+template <typename Function>
+void for_each_run(span<const size_t> shape, span<const size_t> offset,
+                  span<const size_t> extent, Function function) {
+  const size_t ndim = shape.size();
+  for (size_t d = 0; d < ndim; ++d) {
+    pammap_throw(offset[d] + extent[d] <= shape[d], IndexError,
+                 "Block exceeds the extent of the stored array along axis " +
+                       std::to_string(d) + ".");
+    if (extent[d] == 0) return;
+  }
+
+  // Trailing axes, which the block covers completely, and the
+  // axis before them make up the contiguous runs.
+  size_t run   = 1;
+  size_t inner = ndim;
+  while (inner > 0) {
+    --inner;
+    run *= extent[inner];
+    if (extent[inner] != shape[inner]) break;
+  }
+
+  std::vector<size_t> strides(ndim, 1);
+  for (size_t d = ndim; d-- > 1;) strides[d - 1] = strides[d] * shape[d];
+  size_t base = 0;
+  for (size_t d = 0; d < ndim; ++d) base += offset[d] * strides[d];
+
+  // Odometer over the axes before ``inner``
+  std::vector<size_t> index(inner, 0);
+  for (size_t destination = 0;; destination += run) {
+    size_t source = base;
+    for (size_t d = 0; d < inner; ++d) source += index[d] * strides[d];
+    function(source, destination, run);
+
+    size_t d = inner;
+    while (d > 0 && ++index[d - 1] == extent[d - 1]) index[--d] = 0;
+    if (d == 0) return;
+  }
+}
+}  // namespace
+
+BlockFile::BlockFile(const std::string& path, std::vector<size_t> shape,
+                     size_t element_size, size_t offset, bool mapped)
+      : m_path(path),
+        m_shape(std::move(shape)),
+        m_element_size(element_size),
+        m_offset(offset) {
+  size_t bytes = m_element_size;
+  for (size_t extent : m_shape) bytes *= extent;
+
+#ifdef HAVE_POSIX_MAPPED_FILES
+  size_t file_bytes = 0;
+  m_fd              = open_file(path, m_offset + bytes, file_bytes);
+
+  if (mapped && file_bytes > 0) {
+    void* mapping = ::mmap(nullptr, file_bytes, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (mapping == MAP_FAILED) {
+      const std::string message = with_reason("Could not map '" + path + "'");
+      ::close(m_fd);
+      pammap_throw(false, IOError, message);
+    }
+    m_mapping       = static_cast<const char*>(mapping);
+    m_mapping_bytes = file_bytes;
+  }
+#else
+  pammap_throw(!mapped, NotImplementedError,
+               "Mapping files is not supported on this platform.");
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  pammap_throw(file.good(), IOError, "Could not open '" + path + "'.");
+  pammap_throw(static_cast<size_t>(file.tellg()) >= m_offset + bytes, IOError,
+               "File '" + path + "' is too small for the array it should contain.");
+#endif
+}
+
+BlockFile::~BlockFile() {
+#ifdef HAVE_POSIX_MAPPED_FILES
+  if (m_mapping != nullptr) {
+    ::munmap(const_cast<char*>(m_mapping), m_mapping_bytes);
+  }
+  ::close(m_fd);
+#endif
+}
+
+void BlockFile::read(span<const size_t> offset, span<const size_t> extent,
+                     void* buffer) const {
+  pammap_throw(offset.size() == m_shape.size() && extent.size() == m_shape.size(),
+               ValueError, "Block and stored array differ in the number of dimensions.");
+  const span<const size_t> shape(m_shape.data(), m_shape.size());
+  char* out = static_cast<char*>(buffer);
+
+  if (m_mapping != nullptr) {
+    auto copy_run = [&](size_t source, size_t destination, size_t count) {
+      std::memcpy(out + destination * m_element_size,
+                  m_mapping + m_offset + source * m_element_size, count * m_element_size);
+    };
+    for_each_run(shape, offset, extent, copy_run);
+    return;
+  }
+
+#ifdef HAVE_POSIX_MAPPED_FILES
+  auto read_run = [&](size_t source, size_t destination, size_t count) {
+    // pread may return less than requested, e.g. for very large runs
+    char* target         = out + destination * m_element_size;
+    size_t remaining     = count * m_element_size;
+    size_t file_position = m_offset + source * m_element_size;
+    while (remaining > 0) {
+      const ssize_t n =
+            ::pread(m_fd, target, remaining, static_cast<off_t>(file_position));
+      if (n < 0 && errno == EINTR) continue;
+      pammap_throw(n > 0, IOError,
+                   n < 0 ? with_reason("Could not read from '" + m_path + "'")
+                         : "Unexpected end of file '" + m_path + "'.");
+      target += n;
+      remaining -= static_cast<size_t>(n);
+      file_position += static_cast<size_t>(n);
+    }
+  };
+  for_each_run(shape, offset, extent, read_run);
+#else
+  // Each read opens the file, such that concurrent reads do not interfere
+  std::ifstream file(m_path, std::ios::binary);
+  auto read_run = [&](size_t source, size_t destination, size_t count) {
+    file.seekg(static_cast<std::streamoff>(m_offset + source * m_element_size));
+    file.read(out + destination * m_element_size,
+              static_cast<std::streamsize>(count * m_element_size));
+    pammap_throw(file.good(), IOError, "Could not read from '" + m_path + "'.");
+  };
+  for_each_run(shape, offset, extent, read_run);
+#endif
+}
+
+}  // namespace detail
+}  // namespace pammap
@@ -0,0 +1,530 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "Array.hpp"
+#include "ArrayView.hpp"
+#include "exceptions.hpp"
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace pammap {
+
+/** Source of the elements of a ChunkedArray.
+ *
+ * Implementations provide access to the (conceptual) array in blocks,
+ * e.g. by reading them from a file. read is called concurrently from
+ * several threads when tiles are prefetched.
+ */
+template <typename T>
+class ChunkStore {
+ public:
+  virtual ~ChunkStore() = default;
+
+  /** Fill ``block``, a C contiguous view, with the elements of the array
+   *  starting at the multi-index ``offset`` */
+  virtual void read(span<const size_t> offset, ArrayView<T> block) const = 0;
+};
+
+namespace detail {
+/** An array of fixed-size elements stored in C order in a file,
+ *  from which blocks are read (see FileChunkStore) */
+class BlockFile {
+ public:
+  BlockFile(const std::string& path, std::vector<size_t> shape, size_t element_size,
+            size_t offset, bool mapped);
+  ~BlockFile();
+
+  BlockFile(const BlockFile&) = delete;
+  BlockFile& operator=(const BlockFile&) = delete;
+
+  /** Read the block with the given ``offset`` and ``extent`` into the
+   *  C contiguous buffer. Throws an IOError if reading fails. */
+  void read(span<const size_t> offset, span<const size_t> extent, void* buffer) const;
+
+ private:
+  std::string m_path;
+  std::vector<size_t> m_shape;
+  size_t m_element_size;
+
+  /** Byte offset of the first element in the file */
+  size_t m_offset;
+
+  /** The file descriptor */
+  int m_fd = -1;
+
+  /** The mapping of the whole file (or nullptr if blocks are read) */
+  const char* m_mapping = nullptr;
+  size_t m_mapping_bytes = 0;
+};
+}  // namespace detail
+
+/** Store reading the tiles of a ChunkedArray from a binary file holding the
+ *  elements in C order (e.g. the data section of a .npy file). */
+template <typename T>
+class FileChunkStore : public ChunkStore<T> {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable types can be read from files.");
+
+ public:
+  /** How the file is accessed */
+  enum ACCESS {
+    /** Read each block with one system call per contiguous run */
+    READ = 0,
+    /** Map the file into memory and copy the blocks from the mapping,
+     *  such that the operating system caches and reads ahead the pages */
+    MAP = 1,
+  };
+
+  /** Open the file holding an array of the given ``shape`` starting at byte
+   *  ``offset``. Throws an IOError if the file cannot be opened or is too
+   *  small. */
+  FileChunkStore(const std::string& path, std::vector<size_t> shape, size_t offset = 0,
+                 ACCESS access = READ)
+        : m_file(path, std::move(shape), sizeof(T), offset, access == MAP) {}
+
+  void read(span<const size_t> offset, ArrayView<T> block) const override {
+    m_file.read(offset, block.shape(), block.data());
+  }
+
+ private:
+  detail::BlockFile m_file;
+};
+
+/** An array, which is split into tiles loaded on demand from a ChunkStore,
+ *  such that arrays larger than the main memory can be processed.
+ *
+ * The array of the given shape is split into tiles of ``tile_shape``
+ * (smaller at the upper edges), which are numbered in C order. Loaded tiles
+ * are kept in a cache, from which the least recently used tiles are dropped
+ * once the tiles together exceed the memory budget (the most recently used
+ * tile is always kept). Tiles still being loaded in the background are
+ * never dropped, such that the cache may exceed the budget until they are
+ * ready, and prefetches, for which there is no room in the budget, are
+ * skipped. Tiles are handed out as Arrays, i.e. the data stays alive as
+ * long as the caller holds on to it, even if the tile has been dropped from
+ * the cache. Modifications of the tiles are not written back to the store.
+ *
+ * Streaming algorithms usually process all tiles in order using blocks(),
+ * which requests the next tiles to be loaded in the background while the
+ * current one is processed.
+ *
+ * Copies of a ChunkedArray share the store and the cache. All functions
+ * are thread-safe. Like Arrays, ChunkedArrays can be stored inside a PamMap.
+ */
+template <typename T>
+class ChunkedArray {
+ public:
+  typedef T value_type;
+
+  /** Default memory budget of the tile cache in bytes */
+  static constexpr size_t default_memory_budget = size_t(256) << 20;
+
+  /** A tile handed out by the block iterator */
+  struct Block {
+    /** The index of the tile */
+    size_t tile;
+
+    /** The multi-index of the first element of the tile in the array */
+    std::vector<size_t> offset;
+
+    /** The elements of the tile (C contiguous) */
+    Array<T> data;
+
+    /** A view onto the elements of the tile */
+    const ArrayView<T>& view() const { return data.view(); }
+  };
+
+  /** Input iterator over the tiles in order (see blocks) */
+  class BlockIterator {
+   public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef Block value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const Block* pointer;
+    typedef const Block& reference;
+
+    BlockIterator(const ChunkedArray* array, size_t tile, size_t prefetch)
+          : m_array(array), m_prefetch(prefetch) {
+      load(tile);
+    }
+
+    reference operator*() const { return m_block; }
+    pointer operator->() const { return &m_block; }
+
+    BlockIterator& operator++() {
+      load(m_block.tile + 1);
+      return *this;
+    }
+
+    bool operator==(const BlockIterator& other) const {
+      return m_block.tile == other.m_block.tile;
+    }
+    bool operator!=(const BlockIterator& other) const { return !(*this == other); }
+
+   private:
+    /** Move to the given tile, which is loaded unless it is past the end */
+    void load(size_t tile) {
+      const size_t n_tiles = m_array->n_tiles();
+      m_block.tile         = std::min(tile, n_tiles);
+      if (m_block.tile == n_tiles) {
+        m_block.data = Array<T>();
+        return;
+      }
+      // The current tile goes first, such that the prefetched tiles
+      // do not push it out of the cache.
+      m_block.offset = m_array->tile_offset(tile);
+      m_block.data   = m_array->tile(tile);
+      for (size_t i = 1; i <= m_prefetch && tile + i < n_tiles; ++i) {
+        m_array->prefetch(tile + i);
+      }
+    }
+
+    const ChunkedArray* m_array;
+    size_t m_prefetch;
+    Block m_block;
+  };
+
+  /** Range of all tiles in order (see blocks) */
+  struct BlockRange {
+    BlockIterator begin() const { return BlockIterator(array, 0, prefetch); }
+    BlockIterator end() const { return BlockIterator(array, array->n_tiles(), 0); }
+
+    const ChunkedArray* array;
+    size_t prefetch;
+  };
+
+  /** A ChunkedArray without data */
+  ChunkedArray() = default;
+
+  /** Construct an array of the given shape split into tiles of ``tile_shape``
+   *  and loaded from ``store``. Throws a ValueError if the number of
+   *  dimensions differ or a tile has extent zero. */
+  ChunkedArray(std::vector<size_t> shape, std::vector<size_t> tile_shape,
+               std::shared_ptr<const ChunkStore<T>> store,
+               size_t memory_budget = default_memory_budget);
+
+  /** The shape of the array */
+  span<const size_t> shape() const {
+    return m_state ? as_span(m_state->shape) : span<const size_t>();
+  }
+
+  /** The (maximal) shape of the tiles */
+  span<const size_t> tile_shape() const {
+    return m_state ? as_span(m_state->tile_shape) : span<const size_t>();
+  }
+
+  /** The number of tiles along each axis */
+  span<const size_t> tile_grid() const {
+    return m_state ? as_span(m_state->grid) : span<const size_t>();
+  }
+
+  /** The number of dimensions */
+  size_t ndim() const { return m_state ? m_state->shape.size() : 0; }
+
+  /** The total number of elements */
+  size_t size() const;
+
+  /** The total number of tiles */
+  size_t n_tiles() const;
+
+  /** The multi-index of the first element of a tile */
+  std::vector<size_t> tile_offset(size_t tile) const;
+
+  /** The shape of a tile, which is smaller than tile_shape() at the edges */
+  std::vector<size_t> tile_extent(size_t tile) const;
+
+  /** The elements of a tile, which is loaded unless it is cached.
+   *  Errors of the store are passed on. */
+  Array<T> tile(size_t tile) const;
+
+  /** Hint that the tile is needed soon, such that it is loaded in the
+   *  background unless it is cached already or does not fit into the
+   *  memory budget. */
+  void prefetch(size_t tile) const;
+
+  /** The tiles in order, where the ``prefetch`` tiles after the current one
+   *  are loaded in the background */
+  BlockRange blocks(size_t prefetch = 1) const { return BlockRange{this, prefetch}; }
+
+  //@{
+  /** Memory budget of the tile cache in bytes. Lowering the budget drops
+   *  tiles from the cache on the next access. */
+  size_t memory_budget() const;
+  void set_memory_budget(size_t bytes);
+  //@}
+
+  /** The number of bytes of the tiles currently in the cache
+   *  (including the ones still being loaded) */
+  size_t cached_bytes() const;
+
+  /** The number of tiles currently in the cache */
+  size_t cached_tiles() const;
+
+ private:
+  /** A tile in the cache */
+  struct Entry {
+    size_t tile;
+    size_t bytes;
+    std::shared_future<Array<T>> data;
+  };
+
+  /** State shared between copies */
+  struct State {
+    std::vector<size_t> shape;
+    std::vector<size_t> tile_shape;
+    std::vector<size_t> grid;
+    std::shared_ptr<const ChunkStore<T>> store;
+
+    /** Protects all members below */
+    mutable std::mutex mutex;
+    size_t memory_budget;
+    size_t cached_bytes = 0;
+
+    /** The cached tiles, most recently used first */
+    std::list<Entry> lru;
+    std::unordered_map<size_t, typename std::list<Entry>::iterator> index;
+  };
+
+  static span<const size_t> as_span(const std::vector<size_t>& v) {
+    return {v.data(), v.size()};
+  }
+
+  /** Check that the array has data and the tile index is valid */
+  void check_tile(size_t tile) const;
+
+  /** Look up a tile in the cache or start loading it (in the background
+   *  if ``async``, in which case an invalid future is returned if the tile
+   *  does not fit into the budget). Dropped tiles are moved to ``dropped``.
+   *  Expects the mutex to be locked. */
+  std::shared_future<Array<T>> lookup(size_t tile, bool async,
+                                      std::list<Entry>& dropped) const;
+
+  /** Drop the least recently used tiles, which have finished loading, until
+   *  the budget leaves room for ``extra`` bytes. Unless extra is non-zero,
+   *  the most recently used tile is kept. The tiles are moved to
+   *  ``dropped``, which the caller destroys after releasing the mutex, since
+   *  destroying the last reference to a background load waits for it.
+   *  Returns whether the budget is met. Expects the mutex to be locked. */
+  bool evict(size_t extra, std::list<Entry>& dropped) const;
+
+  std::shared_ptr<State> m_state;
+};
+
+template <typename T>
+constexpr size_t ChunkedArray<T>::default_memory_budget;
+
+template <typename T>
+ChunkedArray<T>::ChunkedArray(std::vector<size_t> shape, std::vector<size_t> tile_shape,
+                              std::shared_ptr<const ChunkStore<T>> store,
+                              size_t memory_budget)
+      : m_state(std::make_shared<State>()) {
+  pammap_throw(shape.size() == tile_shape.size(), ValueError,
+               "Shape and tile shape of a ChunkedArray need to have the same number "
+               "of dimensions.");
+  pammap_throw(shape.size() <= max_dynamic_rank, ValueError,
+               "Number of dimensions (== " + std::to_string(shape.size()) +
+                     ") exceeds the maximal number of dimensions of an Array (== " +
+                     std::to_string(max_dynamic_rank) + ").");
+  pammap_throw(store != nullptr, ValueError, "A ChunkedArray needs a store.");
+  for (size_t d = 0; d < shape.size(); ++d) {
+    pammap_throw(tile_shape[d] > 0, ValueError,
+                 "The extent of the tiles needs to be positive along all axes.");
+    m_state->grid.push_back((shape[d] + tile_shape[d] - 1) / tile_shape[d]);
+  }
+  m_state->shape         = std::move(shape);
+  m_state->tile_shape    = std::move(tile_shape);
+  m_state->store         = std::move(store);
+  m_state->memory_budget = memory_budget;
+}
+
+template <typename T>
+size_t ChunkedArray<T>::size() const {
+  if (!m_state) return 0;
+  size_t ret = 1;
+  for (size_t extent : m_state->shape) ret *= extent;
+  return ret;
+}
+
+template <typename T>
+size_t ChunkedArray<T>::n_tiles() const {
+  if (!m_state) return 0;
+  size_t ret = 1;
+  for (size_t extent : m_state->grid) ret *= extent;
+  return ret;
+}
+
+template <typename T>
+void ChunkedArray<T>::check_tile(size_t tile) const {
+  pammap_throw(tile < n_tiles(), IndexError,
+               "Tile index " + std::to_string(tile) + " is out of range for " +
+                     std::to_string(n_tiles()) + " tiles.");
+}
+
+template <typename T>
+std::vector<size_t> ChunkedArray<T>::tile_offset(size_t tile) const {
+  check_tile(tile);
+  std::vector<size_t> ret(ndim());
+  for (size_t d = ndim(); d-- > 0;) {
+    ret[d] = tile % m_state->grid[d] * m_state->tile_shape[d];
+    tile /= m_state->grid[d];
+  }
+  return ret;
+}
+
+template <typename T>
+std::vector<size_t> ChunkedArray<T>::tile_extent(size_t tile) const {
+  std::vector<size_t> ret = tile_offset(tile);
+  for (size_t d = 0; d < ret.size(); ++d) {
+    ret[d] = std::min(m_state->tile_shape[d], m_state->shape[d] - ret[d]);
+  }
+  return ret;
+}
+
+template <typename T>
+std::shared_future<Array<T>> ChunkedArray<T>::lookup(size_t tile, bool async,
+                                                     std::list<Entry>& dropped) const {
+  State& state = *m_state;
+  auto it      = state.index.find(tile);
+  if (it != state.index.end()) {
+    state.lru.splice(state.lru.begin(), state.lru, it->second);
+    return it->second->data;
+  }
+
+  // The loader only captures the store, such that a pending load
+  // does not keep the cache (and thus itself) alive.
+  const std::vector<size_t> offset = tile_offset(tile);
+  const std::vector<size_t> extent = tile_extent(tile);
+  std::shared_ptr<const ChunkStore<T>> store = state.store;
+  auto loader = [store, offset, extent]() {
+    Array<T> ret(extent);
+    store->read(as_span(offset), ret.view());
+    return ret;
+  };
+  const auto policy = async ? std::launch::async : std::launch::deferred;
+
+  Entry entry;
+  entry.tile  = tile;
+  entry.bytes = sizeof(T);
+  for (size_t e : extent) entry.bytes *= e;
+  if (async && !evict(entry.bytes, dropped)) return {};
+
+  entry.data = std::async(policy, loader).share();
+  state.lru.push_front(entry);
+  state.index[tile] = state.lru.begin();
+  state.cached_bytes += entry.bytes;
+  if (!async) evict(0, dropped);
+  return entry.data;
+}
+
+template <typename T>
+bool ChunkedArray<T>::evict(size_t extra, std::list<Entry>& dropped) const {
+  State& state      = *m_state;
+  const size_t keep = extra == 0 ? 1 : 0;
+  size_t remaining  = state.lru.size();
+  auto it           = state.lru.end();
+  while (state.cached_bytes + extra > state.memory_budget && remaining > keep) {
+    --it;
+    --remaining;
+    // Deferred loads are run by the thread requesting the tile and
+    // can be dropped, pending background loads cannot
+    if (it->data.wait_for(std::chrono::seconds(0)) == std::future_status::timeout) {
+      continue;
+    }
+    auto next = std::next(it);
+    state.cached_bytes -= it->bytes;
+    state.index.erase(it->tile);
+    dropped.splice(dropped.end(), state.lru, it);
+    it = next;
+  }
+  return state.cached_bytes + extra <= state.memory_budget;
+}
+
+template <typename T>
+Array<T> ChunkedArray<T>::tile(size_t tile) const {
+  check_tile(tile);
+  std::shared_future<Array<T>> data;
+  {
+    std::list<Entry> dropped;  // Destroyed after releasing the mutex
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    data = lookup(tile, false, dropped);
+  }
+
+  try {
+    // Loads deferred tiles outside of the lock
+    return data.get();
+  } catch (...) {
+    // Do not cache failures, such that the next access tries again
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    State& state = *m_state;
+    auto it      = state.index.find(tile);
+    if (it != state.index.end()) {
+      state.cached_bytes -= it->second->bytes;
+      state.lru.erase(it->second);
+      state.index.erase(it);
+    }
+    throw;
+  }
+}
+
+template <typename T>
+void ChunkedArray<T>::prefetch(size_t tile) const {
+  check_tile(tile);
+  std::list<Entry> dropped;  // Destroyed after releasing the mutex
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  lookup(tile, true, dropped);
+}
+
+template <typename T>
+size_t ChunkedArray<T>::memory_budget() const {
+  if (!m_state) return 0;
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->memory_budget;
+}
+
+template <typename T>
+void ChunkedArray<T>::set_memory_budget(size_t bytes) {
+  pammap_throw(m_state != nullptr, InvalidStateError, "ChunkedArray without data.");
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  m_state->memory_budget = bytes;
+}
+
+template <typename T>
+size_t ChunkedArray<T>::cached_bytes() const {
+  if (!m_state) return 0;
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->cached_bytes;
+}
+
+template <typename T>
+size_t ChunkedArray<T>::cached_tiles() const {
+  if (!m_state) return 0;
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->lru.size();
+}
+
+}  // namespace pammap
@@ -0,0 +1,73 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ConvertingView.hpp"
+
+namespace pammap {
+
+namespace {
+/** Stores the size of the element type a kind is visited with */
+struct SizeOf {
+  size_t& size;
+  template <typename S>
+  void operator()(S*) const {
+    size = sizeof(S);
+  }
+};
+}  // namespace
+
+std::string SourceType::name(KIND kind) {
+  switch (kind) {
+    case BOOL:
+      return "bool";
+    case INT8:
+      return "int8";
+    case INT16:
+      return "int16";
+    case INT32:
+      return "int32";
+    case INT64:
+      return "int64";
+    case UINT8:
+      return "uint8";
+    case UINT16:
+      return "uint16";
+    case UINT32:
+      return "uint32";
+    case UINT64:
+      return "uint64";
+    case FLOAT32:
+      return "float32";
+    case FLOAT64:
+      return "float64";
+    case COMPLEX64:
+      return "complex64";
+    case COMPLEX128:
+      return "complex128";
+  }
+  return "unknown";
+}
+
+size_t SourceType::size(KIND kind) {
+  size_t ret = 0;
+  detail::visit_source_kind(kind, SizeOf{ret});
+  return ret;
+}
+
+}  // namespace pammap
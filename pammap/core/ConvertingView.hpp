@@ -0,0 +1,482 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "exceptions.hpp"
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace pammap {
+
+/** Element types of foreign data, which can be viewed through a
+ *  ConvertingView (named like the corresponding numpy dtypes) */
+struct SourceType {
+  enum KIND {
+    BOOL       = 0,
+    INT8       = 1,
+    INT16      = 2,
+    INT32      = 3,
+    INT64      = 4,
+    UINT8      = 5,
+    UINT16     = 6,
+    UINT32     = 7,
+    UINT64     = 8,
+    FLOAT32    = 9,
+    FLOAT64    = 10,
+    COMPLEX64  = 11,
+    COMPLEX128 = 12,
+  };
+
+  /** The name of a kind, e.g. "int32" */
+  static std::string name(KIND kind);
+
+  /** The number of bytes of an element of a kind */
+  static size_t size(KIND kind);
+};
+
+namespace detail {
+template <typename T>
+struct is_complex : std::false_type {};
+template <typename T>
+struct is_complex<std::complex<T>> : std::true_type {};
+
+/** Index of an integer size among 1, 2, 4 and 8 bytes */
+constexpr int integer_size_index(size_t size) {
+  return size == 1 ? 0 : size == 2 ? 1 : size == 4 ? 2 : 3;
+}
+
+/** The SourceType::KIND of an arithmetic or complex C++ type */
+template <typename S>
+constexpr SourceType::KIND source_kind() {
+  return std::is_same<S, bool>::value ? SourceType::BOOL
+         : is_complex<S>::value
+               ? (sizeof(S) == 8 ? SourceType::COMPLEX64 : SourceType::COMPLEX128)
+         : std::is_floating_point<S>::value
+               ? (sizeof(S) == 4 ? SourceType::FLOAT32 : SourceType::FLOAT64)
+               : static_cast<SourceType::KIND>(
+                       (std::is_signed<S>::value ? SourceType::INT8 : SourceType::UINT8) +
+                       integer_size_index(sizeof(S)));
+}
+
+/** Is every value of the arithmetic or complex type S exactly representable
+ *  as a T, i.e. can S be converted to T without loss */
+template <typename S, typename T, typename = void>
+struct is_widening
+      : std::integral_constant<
+              bool, std::is_same<S, T>::value || std::is_same<S, bool>::value ||
+                          (std::is_integral<S>::value && std::is_integral<T>::value &&
+                           !std::is_same<T, bool>::value &&
+                           (std::is_signed<S>::value == std::is_signed<T>::value
+                                  ? sizeof(S) <= sizeof(T)
+                                  : std::is_unsigned<S>::value &&
+                                          sizeof(S) < sizeof(T))) ||
+                          (std::is_arithmetic<S>::value &&
+                           std::is_floating_point<T>::value &&
+                           std::numeric_limits<S>::digits <=
+                                 std::numeric_limits<T>::digits)> {};
+
+template <typename S, typename T>
+struct is_widening<S, std::complex<T>,
+                   typename std::enable_if<!is_complex<S>::value>::type>
+      : is_widening<S, T> {};
+
+template <typename S, typename T>
+struct is_widening<std::complex<S>, std::complex<T>> : is_widening<S, T> {};
+
+template <typename S, typename T>
+struct is_widening<std::complex<S>, T,
+                   typename std::enable_if<!is_complex<T>::value>::type>
+      : std::false_type {};
+
+/** Call ``visitor(static_cast<S*>(nullptr))`` with the C++ type S of a kind */
+template <typename Visitor>
+void visit_source_kind(SourceType::KIND kind, Visitor&& visitor) {
+  switch (kind) {
+    case SourceType::BOOL:
+      return visitor(static_cast<bool*>(nullptr));
+    case SourceType::INT8:
+      return visitor(static_cast<int8_t*>(nullptr));
+    case SourceType::INT16:
+      return visitor(static_cast<int16_t*>(nullptr));
+    case SourceType::INT32:
+      return visitor(static_cast<int32_t*>(nullptr));
+    case SourceType::INT64:
+      return visitor(static_cast<int64_t*>(nullptr));
+    case SourceType::UINT8:
+      return visitor(static_cast<uint8_t*>(nullptr));
+    case SourceType::UINT16:
+      return visitor(static_cast<uint16_t*>(nullptr));
+    case SourceType::UINT32:
+      return visitor(static_cast<uint32_t*>(nullptr));
+    case SourceType::UINT64:
+      return visitor(static_cast<uint64_t*>(nullptr));
+    case SourceType::FLOAT32:
+      return visitor(static_cast<float*>(nullptr));
+    case SourceType::FLOAT64:
+      return visitor(static_cast<double*>(nullptr));
+    case SourceType::COMPLEX64:
+      return visitor(static_cast<std::complex<float>*>(nullptr));
+    case SourceType::COMPLEX128:
+      return visitor(static_cast<std::complex<double>*>(nullptr));
+  }
+}
+
+//@{
+/** Reverse the byte order of an unsigned integer */
+inline uint8_t byteswap(uint8_t x) { return x; }
+inline uint16_t byteswap(uint16_t x) { return __builtin_bswap16(x); }
+inline uint32_t byteswap(uint32_t x) { return __builtin_bswap32(x); }
+inline uint64_t byteswap(uint64_t x) { return __builtin_bswap64(x); }
+//@}
+
+/** Unsigned integer type of the size of one component of S (the real or
+ *  imaginary part for complex numbers), which are byte-swapped separately */
+template <typename S>
+using swap_unit_t = typename std::conditional<
+      sizeof(S) / (is_complex<S>::value ? 2 : 1) == 1, uint8_t,
+      typename std::conditional<
+            sizeof(S) / (is_complex<S>::value ? 2 : 1) == 2, uint16_t,
+            typename std::conditional<sizeof(S) / (is_complex<S>::value ? 2 : 1) == 4,
+                                      uint32_t, uint64_t>::type>::type>::type;
+
+/** Load an element of type S from possibly unaligned memory */
+template <typename S, bool Swap>
+S load(const char* bytes) {
+  S value;
+  if (Swap) {
+    typedef swap_unit_t<S> U;
+    U units[sizeof(S) / sizeof(U)];
+    std::memcpy(units, bytes, sizeof(S));
+    for (U& unit : units) unit = byteswap(unit);
+    std::memcpy(&value, units, sizeof(S));
+  } else {
+    std::memcpy(&value, bytes, sizeof(S));
+  }
+  return value;
+}
+
+/** Convert a value of type S to T, if this is lossless */
+template <typename S, typename T, bool Lossless = is_widening<S, T>::value,
+          bool Same = std::is_same<S, T>::value>
+struct Widen {
+  static T apply(const S& value) { return static_cast<T>(value); }
+};
+
+template <typename S, typename T>
+struct Widen<S, T, true, true> {
+  static T apply(const S& value) { return value; }
+};
+
+template <typename S, typename T, bool Same>
+struct Widen<S, T, false, Same> {
+  // Never called: ConvertingView rejects lossy conversions on construction
+  static T apply(const S&) { return T{}; }
+};
+
+/** Convert ``count`` elements of type S, which are ``stride`` bytes apart,
+ *  to T and store them in ``out`` with a stride of ``out_stride`` elements */
+template <typename S, bool Swap, typename T>
+void convert_row(const char* bytes, ptrdiff_t stride, size_t count, T* out,
+                 ptrdiff_t out_stride) {
+  if (stride == static_cast<ptrdiff_t>(sizeof(S)) && out_stride == 1) {
+    // Separate loop for the common contiguous case, which vectorises
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = Widen<S, T>::apply(load<S, Swap>(bytes + i * sizeof(S)));
+    }
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    *out = Widen<S, T>::apply(load<S, Swap>(bytes));
+    bytes += stride;
+    out += out_stride;
+  }
+}
+
+/** Call ``function(a, b, count, stride_a, stride_b)`` for the rows of
+ *  elements along the innermost axis of two layouts of the same shape, in C
+ *  order of the multi-indices. ``a`` and ``b`` are the offsets of the first
+ *  element of the row in both layouts. Trailing axes, which are contiguous
+ *  with respect to each other in both layouts, are merged into longer rows. */
+template <typename Function>
+void for_each_row(span<const size_t> shape, span<const ptrdiff_t> strides_a,
+                  span<const ptrdiff_t> strides_b, Function function) {
+  const size_t ndim = shape.size();
+  for (size_t d = 0; d < ndim; ++d) {
+    if (shape[d] == 0) return;
+  }
+  if (ndim == 0) {
+    function(0, 0, 1, 0, 0);
+    return;
+  }
+
+  const ptrdiff_t stride_a = strides_a[ndim - 1];
+  const ptrdiff_t stride_b = strides_b[ndim - 1];
+  size_t inner             = ndim - 1;
+  size_t count             = shape[inner];
+  while (inner > 0) {
+    const auto extent = static_cast<ptrdiff_t>(count);
+    if (strides_a[inner - 1] != extent * stride_a ||
+        strides_b[inner - 1] != extent * stride_b) {
+      break;
+    }
+    count *= shape[--inner];
+  }
+
+  // Odometer over the axes before ``inner``
+  std::array<size_t, max_dynamic_rank> index{};
+  ptrdiff_t a = 0, b = 0;
+  while (true) {
+    function(a, b, count, stride_a, stride_b);
+
+    size_t d = inner;
+    while (d > 0) {
+      --d;
+      a += strides_a[d];
+      b += strides_b[d];
+      if (++index[d] < shape[d]) break;
+      a -= static_cast<ptrdiff_t>(shape[d]) * strides_a[d];
+      b -= static_cast<ptrdiff_t>(shape[d]) * strides_b[d];
+      index[d] = 0;
+      if (d == 0) return;
+    }
+    if (inner == 0) return;
+  }
+}
+}  // namespace detail
+
+/** Read-only view of foreign data, which converts the elements to T lazily.
+ *
+ * The viewed elements may be stored as any of the SourceType kinds and in
+ * either byte order, e.g. a big-endian int32 numpy array can be viewed as
+ * ConvertingView<Integer>. Only conversions which are lossless (widening
+ * integers, integers to floating point types with enough digits, real to
+ * complex numbers, ...) are allowed, others are rejected with a TypeError
+ * on construction. The strides are given in bytes, such that the elements
+ * need not even be aligned.
+ *
+ * Single elements are converted on access with operator(). For processing
+ * all elements copy_to converts into an ArrayView<T> and for_each_block
+ * hands out the converted elements in C order in blocks of a fixed size,
+ * such that a large foreign array can be consumed without materialising a
+ * converted copy. Both convert whole rows at a time, which for contiguous
+ * rows compiles to vectorised loops.
+ *
+ * Like ArrayView the ConvertingView does not own its data.
+ */
+template <typename T>
+class ConvertingView {
+ public:
+  static_assert(std::is_arithmetic<T>::value || detail::is_complex<T>::value,
+                "ConvertingView only supports arithmetic and complex element types.");
+
+  /** Number of elements per block in for_each_block if not specified */
+  static constexpr size_t default_block_size = 4096;
+
+  ConvertingView() = default;
+
+  /** Construct from the address of the elements, their kind, whether they
+   *  are stored in the opposite byte order, the shape and the strides in
+   *  bytes. Throws a TypeError if the elements cannot be converted to T
+   *  without loss. */
+  ConvertingView(const void* data, SourceType::KIND kind, bool swap_bytes,
+                 const std::vector<size_t>& shape,
+                 const std::vector<ptrdiff_t>& byte_strides) {
+    init(data, kind, swap_bytes, {shape.data(), shape.size()},
+         {byte_strides.data(), byte_strides.size()});
+  }
+
+  /** View the elements of an ArrayView in native byte order */
+  template <typename S>
+  explicit ConvertingView(const ArrayView<S>& view) {
+    std::array<ptrdiff_t, max_dynamic_rank> byte_strides{};
+    for (size_t d = 0; d < view.ndim(); ++d) {
+      byte_strides[d] = view.strides()[d] * static_cast<ptrdiff_t>(sizeof(S));
+    }
+    init(view.data(), detail::source_kind<typename std::remove_const<S>::type>(), false,
+         view.shape(), {byte_strides.data(), view.ndim()});
+  }
+
+  /** The kind of the viewed elements */
+  SourceType::KIND source_kind() const { return m_kind; }
+
+  /** Are the viewed elements stored in the opposite byte order */
+  bool swaps_bytes() const { return m_swap; }
+
+  /** The number of elements */
+  size_t size() const { return m_bytes.size(); }
+
+  /** The number of dimensions */
+  size_t ndim() const { return m_bytes.ndim(); }
+
+  /** The shape in each dimension */
+  span<const size_t> shape() const { return m_bytes.shape(); }
+
+  /** The strides in each dimension in bytes */
+  span<const ptrdiff_t> byte_strides() const { return m_bytes.strides(); }
+
+  /** The element with multi-index ``idcs``, converted to T */
+  template <typename... Indices>
+  T operator()(Indices... idcs) const {
+    T ret{};
+    const RowConverter convert{&m_bytes(idcs...), 0, 1, &ret, 1, m_swap};
+    detail::visit_source_kind(m_kind, convert);
+    return ret;
+  }
+
+  /** Get a slice without copying any data (see ArrayView::slice) */
+  ConvertingView slice(std::initializer_list<Slice> idcs) const {
+    ConvertingView ret(*this);
+    ret.m_bytes = m_bytes.slice(idcs);
+    return ret;
+  }
+
+  /** Convert all elements into a view of the same shape. Throws a ValueError
+   *  if the shapes differ. */
+  void copy_to(ArrayView<T> out) const;
+
+  /** Convert all elements in C order of their multi-indices and call
+   *  ``function(const T* values, size_t count)`` for consecutive blocks of
+   *  ``block_size`` elements (the last one may be shorter). */
+  template <typename Function>
+  void for_each_block(Function function, size_t block_size = default_block_size) const;
+
+ private:
+  /** Sets the flag if the conversion from S to T is lossless */
+  struct LosslessCheck {
+    bool& lossless;
+    template <typename S>
+    void operator()(S*) const {
+      lossless = detail::is_widening<S, T>::value;
+    }
+  };
+
+  /** Converts a row of elements of type S */
+  struct RowConverter {
+    const char* bytes;
+    ptrdiff_t stride;
+    size_t count;
+    T* out;
+    ptrdiff_t out_stride;
+    bool swap;
+
+    template <typename S>
+    void operator()(S*) const {
+      if (swap) {
+        detail::convert_row<S, true>(bytes, stride, count, out, out_stride);
+      } else {
+        detail::convert_row<S, false>(bytes, stride, count, out, out_stride);
+      }
+    }
+  };
+
+  void init(const void* data, SourceType::KIND kind, bool swap_bytes,
+            span<const size_t> shape, span<const ptrdiff_t> byte_strides);
+
+  /** The elements with strides in bytes */
+  ArrayView<const char> m_bytes;
+  SourceType::KIND m_kind = detail::source_kind<T>();
+  bool m_swap = false;
+};
+
+template <typename T>
+void ConvertingView<T>::init(const void* data, SourceType::KIND kind, bool swap_bytes,
+                             span<const size_t> shape,
+                             span<const ptrdiff_t> byte_strides) {
+  pammap_throw(shape.size() == byte_strides.size(), ValueError,
+               "Size of shape (== " + std::to_string(shape.size()) +
+                     ") does not agree with the size of the strides (== " +
+                     std::to_string(byte_strides.size()) + ").");
+  bool lossless = false;
+  detail::visit_source_kind(kind, LosslessCheck{lossless});
+  pammap_throw(lossless, TypeError,
+               "Elements of type " + SourceType::name(kind) +
+                     " cannot be converted without loss to the element type of the "
+                     "ConvertingView (" +
+                     SourceType::name(detail::source_kind<T>()) + ").");
+
+  m_bytes = ArrayView<const char>(static_cast<const char*>(data), shape.data(),
+                                  byte_strides.data(), shape.size());
+  m_kind  = kind;
+  m_swap  = swap_bytes && SourceType::size(kind) > 1;
+}
+
+template <typename T>
+constexpr size_t ConvertingView<T>::default_block_size;
+
+template <typename T>
+void ConvertingView<T>::copy_to(ArrayView<T> out) const {
+  pammap_throw(ndim() == out.ndim() &&
+                     std::equal(shape().begin(), shape().end(), out.shape().begin()),
+               ValueError, "Shape of the output does not agree with the ConvertingView.");
+  const char* bytes = m_bytes.data();
+  T* data           = out.data();
+  auto convert      = [&](ptrdiff_t a, ptrdiff_t b, size_t count, ptrdiff_t stride_a,
+                     ptrdiff_t stride_b) {
+    detail::visit_source_kind(
+          m_kind, RowConverter{bytes + a, stride_a, count, data + b, stride_b, m_swap});
+  };
+  detail::for_each_row(shape(), byte_strides(), out.strides(), convert);
+}
+
+template <typename T>
+template <typename Function>
+void ConvertingView<T>::for_each_block(Function function, size_t block_size) const {
+  pammap_throw(block_size > 0, ValueError, "Block size needs to be positive.");
+  if (size() == 0) return;
+
+  // Strides of a C contiguous layout, such that rows are merged if the
+  // elements are stored in C order
+  std::array<ptrdiff_t, max_dynamic_rank> c_strides{};
+  ptrdiff_t stride = 1;
+  for (size_t d = ndim(); d-- > 0;) {
+    c_strides[d] = stride;
+    stride *= static_cast<ptrdiff_t>(shape()[d]);
+  }
+
+  std::vector<T> block(std::min(block_size, size()));
+  size_t filled = 0;
+  auto convert  = [&](ptrdiff_t a, ptrdiff_t, size_t count, ptrdiff_t stride_a,
+                     ptrdiff_t) {
+    const char* bytes = m_bytes.data() + a;
+    while (count > 0) {
+      const size_t n = std::min(count, block.size() - filled);
+      detail::visit_source_kind(
+            m_kind, RowConverter{bytes, stride_a, n, block.data() + filled, 1, m_swap});
+      bytes += static_cast<ptrdiff_t>(n) * stride_a;
+      count -= n;
+      filled += n;
+      if (filled == block.size()) {
+        function(block.data(), filled);
+        filled = 0;
+      }
+    }
+  };
+  detail::for_each_row(shape(), byte_strides(), {c_strides.data(), ndim()}, convert);
+  if (filled > 0) function(block.data(), filled);
+}
+
+}  // namespace pammap
@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SIZEOF_INT128__) && SIZE_MAX == UINT64_MAX
+#define PAMMAP_FAST_DIVISOR_INT128
+#endif
+
+namespace pammap {
+
+/** Division of unsigned integers by a divisor fixed at runtime, which avoids
+ *  the integer division instruction on the hot path.
+ *
+ * The divisor is represented by a magic multiplier and two shifts
+ * following T. Granlund and P. L. Montgomery, "Division by invariant
+ * integers using multiplication", PLDI 1994 (Figure 4.1). The quotient
+ * is then obtained by a 64x64 -> 128 bit multiplication, an addition and
+ * two shifts. If the compiler has no 128 bit integer type, a plain
+ * division is used instead.
+ */
+class FastDivisor {
+ public:
+  /** Prepare the division by one */
+  FastDivisor() : FastDivisor(1) {}
+
+  /** Prepare the division by ``divisor``. A divisor of zero is
+   *  treated like one (it is only used for empty extents). */
+  explicit FastDivisor(size_t divisor);
+
+  /** Compute ``n / divisor`` */
+  size_t divide(size_t n) const {
+#ifdef PAMMAP_FAST_DIVISOR_INT128
+    const size_t t = static_cast<size_t>((static_cast<uint128>(m_multiplier) * n) >> 64);
+    return (t + ((n - t) >> m_shift1)) >> m_shift2;
+#else
+    return n / m_divisor;
+#endif
+  }
+
+ private:
+#ifdef PAMMAP_FAST_DIVISOR_INT128
+  __extension__ typedef unsigned __int128 uint128;
+
+  /** The magic multiplier */
+  size_t m_multiplier;
+
+  /** The shifts applied before and after adding */
+  unsigned char m_shift1;
+  unsigned char m_shift2;
+#else
+  size_t m_divisor;
+#endif
+};
+
+//
+// -----------------------------------------------
+//
+
+inline FastDivisor::FastDivisor(size_t divisor) {
+  if (divisor == 0) divisor = 1;
+#ifdef PAMMAP_FAST_DIVISOR_INT128
+  // l = ceil(log2(divisor))
+  unsigned l = 0;
+  while (l < 64 && (static_cast<uint128>(1) << l) < divisor) ++l;
+
+  // m = floor(2^64 * (2^l - divisor) / divisor) + 1, which fits into 64 bits
+  const uint128 diff = (static_cast<uint128>(1) << l) - divisor;
+  m_multiplier       = static_cast<size_t>((diff << 64) / divisor + 1);
+  m_shift1           = static_cast<unsigned char>(l < 1 ? l : 1);
+  m_shift2           = static_cast<unsigned char>(l < 1 ? 0 : l - 1);
+#else
+  m_divisor = divisor;
+#endif
+}
+
+}  // namespace pammap
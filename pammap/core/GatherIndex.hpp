@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "Array.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pammap {
+
+class PamMap;
+
+/** The slots of the entries of type T gathered from a PamMap
+ *  (see PamMap::gather).
+ *
+ * The index refers to the stored values directly, such that PamMap::scatter
+ * and gathering again copy the values without any lookup of keys. Using it
+ * throws an InvalidStateError once it is outdated, which is the case after
+ * any of the following operations on the map (or on a map sharing its
+ * container):
+ *  - update, insert_default (if a key is inserted), mount and unmount,
+ *  - erase, erase_recursive and clear,
+ *  - obtaining a reference, through which a value could be replaced, i.e.
+ *    at_raw_value and value_raw of a mutable accessor (from the iterators
+ *    of begin(), find(), etc.), even if no value is actually replaced.
+ *
+ * Modifying the values in place, i.e. through at, the value method of an
+ * accessor or scatter, keeps the index valid.
+ */
+template <typename T>
+class GatherIndex {
+ public:
+  /** The number of gathered entries */
+  size_t size() const { return m_slots.size(); }
+
+  /** The keys of the gathered entries (as returned by PamMap::find) in the
+   *  order of the gathered values */
+  const std::vector<std::string>& keys() const { return m_keys; }
+
+ private:
+  friend class PamMap;
+
+  /** Pointers to the stored values */
+  std::vector<T*> m_slots;
+  std::vector<std::string> m_keys;
+
+  /** Identifier and version of the container at the time of gathering */
+  uint64_t m_container = 0;
+  uint64_t m_version   = 0;
+};
+
+/** Values gathered from a PamMap into one contiguous Array together with
+ *  the index of the entries they originate from (see PamMap::gather) */
+template <typename T>
+struct Gathered {
+  Array<T> values;
+  GatherIndex<T> index;
+};
+
+}  // namespace pammap
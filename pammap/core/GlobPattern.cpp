@@ -0,0 +1,186 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "GlobPattern.hpp"
+#include "exceptions.hpp"
+
+namespace pammap {
+
+namespace {
+/** Match a single character against the bracket expression starting at
+ *  pattern[ip] (which is the '['). Updates ip to point past the closing ']'.
+ *  Returns false in matched if the character does not match. If the bracket
+ *  is not closed, it is treated as a literal '[' and false is returned. */
+bool match_bracket(const std::string& pattern, size_t& ip, char c, bool& matched) {
+  size_t i     = ip + 1;
+  bool negated = false;
+  if (i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^')) {
+    negated = true;
+    ++i;
+  }
+
+  matched    = false;
+  bool first = true;
+  for (; i < pattern.size() && (first || pattern[i] != ']'); ++i, first = false) {
+    if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+      if (pattern[i] <= c && c <= pattern[i + 2]) matched = true;
+      i += 2;
+    } else if (pattern[i] == c) {
+      matched = true;
+    }
+  }
+  if (i >= pattern.size()) return false;  // Unterminated
+
+  matched = (matched != negated);
+  ip      = i + 1;
+  return true;
+}
+}  // namespace
+
+bool glob_match_component(const std::string& pattern, const std::string& text) {
+  // Iterative matching, which backtracks to the most recent '*'
+  size_t ip = 0, it = 0;
+  size_t star_ip = std::string::npos, star_it = 0;
+
+  while (it < text.size()) {
+    if (ip < pattern.size()) {
+      const char p = pattern[ip];
+      if (p == '*') {
+        star_ip = ip++;
+        star_it = it;
+        continue;
+      } else if (p == '?') {
+        ++ip;
+        ++it;
+        continue;
+      } else if (p == '[') {
+        size_t ip_next = ip;
+        bool matched   = false;
+        if (match_bracket(pattern, ip_next, text[it], matched)) {
+          if (matched) {
+            ip = ip_next;
+            ++it;
+            continue;
+          }
+        } else if (text[it] == '[') {  // Literal '['
+          ++ip;
+          ++it;
+          continue;
+        }
+      } else if (p == text[it]) {
+        ++ip;
+        ++it;
+        continue;
+      }
+    }
+
+    // Mismatch: Backtrack or fail
+    if (star_ip == std::string::npos) return false;
+    ip = star_ip + 1;
+    it = ++star_it;
+  }
+
+  // Text consumed, only '*' may remain in the pattern
+  while (ip < pattern.size() && pattern[ip] == '*') ++ip;
+  return ip == pattern.size();
+}
+
+GlobPattern::GlobPattern(const std::string& pattern) {
+  for (size_t start = 0; start < pattern.size(); ++start) {
+    const size_t end = pattern.find('/', start);
+    if (start == end) continue;
+    std::string part = pattern.substr(start, end - start);
+    start += part.length();
+
+    if (part == ".") {
+      continue;
+    } else if (part == "..") {
+      if (!m_components.empty()) m_components.pop_back();
+    } else if (part == "**") {
+      // Consecutive "**" are equivalent to a single one
+      if (m_components.empty() || m_components.back().kind != RECURSIVE) {
+        m_components.push_back(Component{RECURSIVE, std::move(part)});
+      }
+    } else if (part.find_first_of("*?[") != std::string::npos) {
+      m_components.push_back(Component{WILDCARD, std::move(part)});
+    } else {
+      m_components.push_back(Component{LITERAL, std::move(part)});
+    }
+  }
+
+  pammap_throw(m_components.size() < 64, ValueError,
+               "Glob patterns with more than 63 components are not supported.");
+}
+
+GlobPattern::state_type GlobPattern::closure(state_type state) const {
+  // A "**" may match zero components, so we may skip it.
+  // Since the components are processed in order, one pass suffices.
+  for (size_t i = 0; i < m_components.size(); ++i) {
+    const state_type bit = state_type(1) << i;
+    if ((state & bit) && m_components[i].kind == RECURSIVE) state |= bit << 1;
+  }
+  return state;
+}
+
+GlobPattern::state_type GlobPattern::advance(state_type state,
+                                             const std::string& component) const {
+  state_type next = 0;
+  for (size_t i = 0; i < m_components.size(); ++i) {
+    const state_type bit = state_type(1) << i;
+    if (!(state & bit)) continue;
+
+    const Component& pc = m_components[i];
+    switch (pc.kind) {
+      case LITERAL:
+        if (pc.text == component) next |= bit << 1;
+        break;
+      case WILDCARD:
+        if (glob_match_component(pc.text, component)) next |= bit << 1;
+        break;
+      case RECURSIVE:
+        next |= bit;  // Consume the component and stay
+        break;
+    }
+  }
+  return closure(next);
+}
+
+const std::string* GlobPattern::sole_literal(state_type state) const {
+  const std::string* ret = nullptr;
+  for (size_t i = 0; i < m_components.size(); ++i) {
+    if (!(state & (state_type(1) << i))) continue;
+    if (ret != nullptr || m_components[i].kind != LITERAL) return nullptr;
+    ret = &m_components[i].text;
+  }
+  return ret;
+}
+
+bool GlobPattern::matches(const std::string& path) const {
+  state_type state = initial_state();
+  for (size_t start = 0; start < path.size() && state != 0; ++start) {
+    const size_t end = path.find('/', start);
+    if (start == end) continue;
+    const std::string part = path.substr(start, end - start);
+    start += part.length();
+    state = advance(state, part);
+  }
+  return is_match(state);
+}
+
+}  // namespace pammap
@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pammap {
+
+/** A compiled glob-style pattern for matching PamMap keys.
+ *
+ * The pattern is split at '/' into components, each of which matches exactly
+ * one component of a key path, with the following exceptions:
+ *   - ``*`` matches any sequence of characters inside a component,
+ *     ``?`` matches a single character and ``[abc]``, ``[a-z]`` or ``[!abc]``
+ *     match a single character from (or not from) the listed set.
+ *   - A component consisting only of ``**`` matches zero or more full components.
+ *
+ * The pattern is normalised like keys of the PamMap are, i.e. empty and "."
+ * components are ignored and ".." removes the preceding component.
+ *
+ * For example the pattern made up of the components "solvers", "*" and "tol"
+ * matches "/solvers/scf/tol", but not "/solvers/scf/diis/tol". The pattern made up
+ * of the components "**" and "basis" matches "/basis" as well as "/atoms/1/basis".
+ *
+ * Matching works component by component on a set of states, such that
+ * one can detect early that no key below a certain path can match.
+ */
+class GlobPattern {
+ public:
+  /** A set of matching states, represented as a bitmask */
+  typedef uint64_t state_type;
+
+  /** Compile the pattern. Throws a ValueError if the pattern
+   *  has more than 63 components. */
+  explicit GlobPattern(const std::string& pattern);
+
+  /** The set of states before the first key component has been matched */
+  state_type initial_state() const { return closure(1); }
+
+  /** Advance a set of states by matching a key component.
+   *  If the result is zero, no key below this component can match. */
+  state_type advance(state_type state, const std::string& component) const;
+
+  /** Does a set of states represent a full match */
+  bool is_match(state_type state) const {
+    return (state & (state_type(1) << m_components.size())) != 0;
+  }
+
+  /** If a set of states can only be advanced by a single literal component
+   *  (i.e. one not containing any wildcard), return a pointer to it,
+   *  else return nullptr. */
+  const std::string* sole_literal(state_type state) const;
+
+  /** Check whether a path (using '/' to separate components) matches */
+  bool matches(const std::string& path) const;
+
+ private:
+  /** The kinds of pattern components */
+  enum ComponentKind {
+    LITERAL   = 0,  //< Component without wildcards
+    WILDCARD  = 1,  //< Component with wildcards
+    RECURSIVE = 2,  //< The "**" component
+  };
+
+  struct Component {
+    ComponentKind kind;
+    std::string text;
+  };
+
+  /** Add all states reachable by skipping over "**" components */
+  state_type closure(state_type state) const;
+
+  std::vector<Component> m_components;
+};
+
+/** Match a single path component against a glob pattern containing
+ *  ``*``, ``?`` and ``[...]`` wildcards, but no '/'. */
+bool glob_match_component(const std::string& pattern, const std::string& text);
+
+}  // namespace pammap
@@ -0,0 +1,236 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "InternedKeyMap.hpp"
+#include "exceptions.hpp"
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+namespace pammap {
+
+constexpr ComponentTable::id_type ComponentTable::npos;
+
+ComponentTable::ComponentTable(const ComponentTable& other)
+      : m_ids(other.m_ids), m_strings(other.m_strings.size(), nullptr) {
+  for (const auto& kv : m_ids) m_strings[kv.second] = &kv.first;
+}
+
+ComponentTable::id_type ComponentTable::intern(const std::string& component) {
+  auto it = m_ids.find(component);
+  if (it != m_ids.end()) return it->second;
+
+  pammap_throw(m_strings.size() < static_cast<size_t>(npos), ValueError,
+               "Too many distinct key components in a PamMap.");
+  const id_type id = static_cast<id_type>(m_strings.size());
+  it               = m_ids.emplace(component, id).first;
+  m_strings.push_back(&it->first);
+  return id;
+}
+
+//
+// -----------------------------------------------
+//
+
+InternedKey::InternedKey(size_t n, bool past_subtree) : m_data(nullptr) {
+  if (n == 0 && !past_subtree) return;
+  pammap_assert(n < std::numeric_limits<id_type>::max() / 2);
+  m_data    = new id_type[n + 1];
+  m_data[0] = static_cast<id_type>(2 * n + (past_subtree ? 1 : 0));
+}
+
+InternedKey::InternedKey(const InternedKey& other) : m_data(nullptr) {
+  if (other.m_data == nullptr) return;
+  const size_t n = other.size() + 1;
+  m_data         = new id_type[n];
+  std::memcpy(m_data, other.m_data, n * sizeof(id_type));
+}
+
+InternedKey InternedKey::prefix(size_t n, bool past_subtree) const {
+  pammap_assert(n <= size());
+  InternedKey ret(n, past_subtree);
+  for (size_t i = 0; i < n; ++i) ret[i] = (*this)[i];
+  return ret;
+}
+
+InternedKey InternedKey::append(id_type id) const {
+  InternedKey ret(size() + 1);
+  for (size_t i = 0; i < size(); ++i) ret[i] = (*this)[i];
+  ret[size()] = id;
+  return ret;
+}
+
+//
+// -----------------------------------------------
+//
+
+namespace {
+/** A new identifier for a container */
+uint64_t next_container_id() {
+  static std::atomic<uint64_t> counter{0};
+  return ++counter;
+}
+}  // namespace
+
+InternedKeyMap::InternedKeyMap()
+      : m_table(new ComponentTable),
+        m_map(InternedKeyLess{m_table.get()}),
+        m_mount_keys(InternedKeyLess{m_table.get()}),
+        m_id(next_container_id()) {}
+
+InternedKeyMap::InternedKeyMap(const InternedKeyMap& other)
+      : m_table(new ComponentTable(*other.m_table)),
+        m_map(InternedKeyLess{m_table.get()}),
+        m_mount_keys(InternedKeyLess{m_table.get()}),
+        m_id(next_container_id()) {
+  // The component ids are the same in both tables, so the keys can be
+  // copied verbatim. The input is sorted, so this takes linear time.
+  m_map.insert(other.m_map.begin(), other.m_map.end());
+  m_mount_keys.insert(other.m_mount_keys.begin(), other.m_mount_keys.end());
+}
+
+size_t InternedKeyMap::depth(const std::string& full_key) {
+  pammap_assert(full_key.empty() || full_key[0] == '/');
+  return static_cast<size_t>(std::count(full_key.begin(), full_key.end(), '/'));
+}
+
+bool InternedKeyMap::lookup_key(const std::string& full_key, InternedKey& key) const {
+  InternedKey ret(depth(full_key));
+
+  // Split the full key at the '/', skipping the leading one.
+  std::string component;
+  size_t start = 1;
+  for (size_t i = 0; i < ret.size(); ++i) {
+    const size_t end = std::min(full_key.find('/', start), full_key.size());
+    component.assign(full_key, start, end - start);
+    ret[i] = m_table->find(component);
+    if (ret[i] == ComponentTable::npos) return false;
+    start = end + 1;
+  }
+  key = std::move(ret);
+  return true;
+}
+
+InternedKey InternedKeyMap::intern_key(const std::string& full_key) {
+  InternedKey ret(depth(full_key));
+  std::string component;
+  size_t start = 1;
+  for (size_t i = 0; i < ret.size(); ++i) {
+    const size_t end = std::min(full_key.find('/', start), full_key.size());
+    component.assign(full_key, start, end - start);
+    ret[i] = m_table->intern(component);
+    start  = end + 1;
+  }
+  return ret;
+}
+
+std::string InternedKeyMap::key_string(const InternedKey& key, size_t skip) const {
+  pammap_assert(skip <= key.size());
+  std::string ret;
+  for (size_t i = skip; i < key.size(); ++i) {
+    ret.push_back('/');
+    ret.append(m_table->str(key[i]));
+  }
+  return ret;
+}
+
+InternedKeyMap::iterator InternedKeyMap::find(const std::string& full_key) {
+  InternedKey key;
+  return lookup_key(full_key, key) ? m_map.find(key) : m_map.end();
+}
+
+InternedKeyMap::const_iterator InternedKeyMap::find(const std::string& full_key) const {
+  InternedKey key;
+  return lookup_key(full_key, key) ? m_map.find(key) : m_map.end();
+}
+
+size_t InternedKeyMap::erase(const std::string& full_key) {
+  InternedKey key;
+  if (!lookup_key(full_key, key)) return 0;
+  ++m_version;
+  m_mount_keys.erase(key);
+  return m_map.erase(key);
+}
+
+InternedKeyMap::iterator InternedKeyMap::erase(iterator first, iterator last) {
+  ++m_version;
+  if (!m_mount_keys.empty() && first != last) {
+    auto mfirst = m_mount_keys.lower_bound(first->first);
+    auto mlast  = last == m_map.end() ? m_mount_keys.end()
+                                      : m_mount_keys.lower_bound(last->first);
+    m_mount_keys.erase(mfirst, mlast);
+  }
+  return m_map.erase(first, last);
+}
+
+void InternedKeyMap::note_mount(const std::string& full_key) {
+  InternedKey key;
+  const bool known = lookup_key(full_key, key);
+  pammap_assert(known && m_map.count(key) > 0);
+  m_mount_keys.insert(std::move(key));
+}
+
+std::pair<InternedKeyMap::key_set_type::const_iterator,
+          InternedKeyMap::key_set_type::const_iterator>
+InternedKeyMap::mounts_below(const std::string& path) const {
+  InternedKey key;
+  if (m_mount_keys.empty() || !lookup_key(path, key)) {
+    return {m_mount_keys.end(), m_mount_keys.end()};
+  }
+  if (path.empty()) return {m_mount_keys.begin(), m_mount_keys.end()};
+  return {m_mount_keys.lower_bound(key),
+          m_mount_keys.lower_bound(key.prefix(key.size(), /* past_subtree = */ true))};
+}
+
+// If the path contains an unknown component, the subtree is empty
+// and both subtree_begin and subtree_end return end().
+
+InternedKeyMap::iterator InternedKeyMap::subtree_begin(const std::string& path) {
+  InternedKey key;
+  return lookup_key(path, key) ? m_map.lower_bound(key) : m_map.end();
+}
+
+InternedKeyMap::const_iterator InternedKeyMap::subtree_begin(
+      const std::string& path) const {
+  InternedKey key;
+  return lookup_key(path, key) ? m_map.lower_bound(key) : m_map.end();
+}
+
+InternedKeyMap::iterator InternedKeyMap::subtree_end(const std::string& path) {
+  InternedKey key;
+  if (path.empty() || !lookup_key(path, key)) return m_map.end();
+  return m_map.lower_bound(key.prefix(key.size(), /* past_subtree = */ true));
+}
+
+InternedKeyMap::const_iterator InternedKeyMap::subtree_end(
+      const std::string& path) const {
+  InternedKey key;
+  if (path.empty() || !lookup_key(path, key)) return m_map.end();
+  return m_map.lower_bound(key.prefix(key.size(), /* past_subtree = */ true));
+}
+
+void InternedKeyMap::clear() {
+  ++m_version;
+  m_map.clear();
+  m_table.reset(new ComponentTable);
+  m_map        = map_type(InternedKeyLess{m_table.get()});
+  m_mount_keys = key_set_type(InternedKeyLess{m_table.get()});
+}
+
+}  // namespace pammap
@@ -0,0 +1,309 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "PamMapValue.hxx"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pammap {
+
+/** Table of the distinct path components (the names between the '/')
+ *  used in the keys of a container. Each component is stored only once
+ *  and identified by an integer id.
+ *
+ * Components are never removed from the table, since ids may still be
+ * in use by other keys. Lookups (find, str) do not modify the table and
+ * can hence be done concurrently.
+ */
+class ComponentTable {
+ public:
+  typedef uint32_t id_type;
+
+  /** Id returned by find if a component is not in the table */
+  static constexpr id_type npos = static_cast<id_type>(-1);
+
+  /** Return the id of a component, adding it to the table if needed */
+  id_type intern(const std::string& component);
+
+  /** Return the id of a component or npos if it is not in the table */
+  id_type find(const std::string& component) const {
+    auto it = m_ids.find(component);
+    return it == m_ids.end() ? npos : it->second;
+  }
+
+  /** Return the component string of an id */
+  const std::string& str(id_type id) const { return *m_strings[id]; }
+
+  /** Number of distinct components in the table */
+  size_t size() const { return m_strings.size(); }
+
+  ComponentTable() = default;
+  ComponentTable(const ComponentTable& other);
+  ComponentTable& operator=(const ComponentTable& other) = delete;
+
+ private:
+  /** Map from the component to its id */
+  std::unordered_map<std::string, id_type> m_ids;
+
+  /** Map from the id to the component (pointing into the keys of m_ids) */
+  std::vector<const std::string*> m_strings;
+};
+
+/** A key of the container represented as a sequence of component ids.
+ *
+ * The key takes only the space of a single pointer, the ids are stored
+ * in a heap array prefixed by their number. The full key "" (the root)
+ * has no components and needs no array at all.
+ *
+ * Apart from stored keys this class is also used as a search probe
+ * for the container. Probes may be flagged to be ``past_subtree``,
+ * in which case they compare larger than all keys in the subtree they
+ * denote, but smaller than all keys following the subtree.
+ */
+class InternedKey {
+ public:
+  typedef ComponentTable::id_type id_type;
+
+  /** Number of components of the key */
+  size_t size() const { return m_data == nullptr ? 0 : m_data[0] >> 1; }
+
+  /** Is this a probe denoting the position past the subtree of the key */
+  bool past_subtree() const { return m_data != nullptr && (m_data[0] & 1u) != 0; }
+
+  /** Access to the component ids */
+  id_type operator[](size_t i) const { return m_data[i + 1]; }
+  id_type& operator[](size_t i) { return m_data[i + 1]; }
+  const id_type* begin() const { return m_data == nullptr ? nullptr : m_data + 1; }
+  const id_type* end() const { return begin() + size(); }
+
+  /** Return a new key with the first ``n`` components of this one */
+  InternedKey prefix(size_t n, bool past_subtree = false) const;
+
+  /** Return a new key with an extra component appended */
+  InternedKey append(id_type id) const;
+
+  /** Construct a key of ``n`` components. The component ids are
+   *  not initialised. */
+  explicit InternedKey(size_t n, bool past_subtree = false);
+
+  InternedKey() : m_data(nullptr) {}
+  InternedKey(const InternedKey& other);
+  InternedKey(InternedKey&& other) noexcept : m_data(other.m_data) {
+    other.m_data = nullptr;
+  }
+  InternedKey& operator=(InternedKey other) {
+    std::swap(m_data, other.m_data);
+    return *this;
+  }
+  ~InternedKey() { delete[] m_data; }
+
+ private:
+  /** Number of components times two (plus one for past_subtree probes),
+   *  followed by the component ids. */
+  id_type* m_data;
+};
+
+/** Ordering of the keys inside the PamMap container.
+ *
+ * Keys are compared component by component. Equal components are detected
+ * by their id alone, for the others the component strings are compared
+ * lexicographically. A key sorts directly before the keys of its subtree.
+ * This makes sure that all keys of a subtree form a contiguous range in the
+ * container, e.g. the order is "/a", "/a/b", "/a/c", "/a-b", "/ab".
+ */
+struct InternedKeyLess {
+  bool operator()(const InternedKey& lhs, const InternedKey& rhs) const {
+    const size_t len = std::min(lhs.size(), rhs.size());
+    for (size_t i = 0; i < len; ++i) {
+      if (lhs[i] == rhs[i]) continue;
+      return table->str(lhs[i]) < table->str(rhs[i]);
+    }
+    // One is a prefix of the other
+    if (lhs.past_subtree()) return false;
+    if (rhs.past_subtree()) return true;
+    return lhs.size() < rhs.size();
+  }
+
+  /** The table to resolve the component ids */
+  const ComponentTable* table;
+};
+
+/** The container behind PamMap.
+ *
+ * A std::map from InternedKey to PamMapValue, which owns the component table
+ * for the keys. The interface is in terms of full keys (see
+ * PamMap::make_full_key), which are translated to or from component ids.
+ * Translating a full key for lookup never modifies the table, such that a
+ * key with an unknown component can be reported as not present right away.
+ */
+class InternedKeyMap {
+ public:
+  typedef std::map<InternedKey, PamMapValue, InternedKeyLess> map_type;
+  typedef map_type::iterator iterator;
+  typedef map_type::const_iterator const_iterator;
+  typedef map_type::value_type value_type;
+  typedef ComponentTable::id_type id_type;
+  typedef std::set<InternedKey, InternedKeyLess> key_set_type;
+
+  /** \name Element access using full keys */
+  ///@{
+  /** Return the value at a full key, inserting an empty one if needed */
+  PamMapValue& operator[](const std::string& full_key) {
+    ++m_version;  // The value is about to be replaced
+    InternedKey key = intern_key(full_key);
+    if (!m_mount_keys.empty()) m_mount_keys.erase(key);
+    return m_map[std::move(key)];
+  }
+
+  /** Find the entry of a full key or return end() */
+  iterator find(const std::string& full_key);
+  const_iterator find(const std::string& full_key) const;
+
+  /** Find the entry of an interned key or return end() */
+  iterator find(const InternedKey& key) { return m_map.find(key); }
+  const_iterator find(const InternedKey& key) const { return m_map.find(key); }
+
+  /** Remove the entry of a full key, returns the number of removed elements */
+  size_t erase(const std::string& full_key);
+  iterator erase(iterator position) {
+    ++m_version;
+    if (!m_mount_keys.empty()) m_mount_keys.erase(position->first);
+    return m_map.erase(position);
+  }
+  iterator erase(iterator first, iterator last);
+  ///@}
+
+  /** \name Subtrees */
+  ///@{
+  /** Return an iterator to the first entry of the subtree below the full path
+   *  ``path``, i.e. the entry of the path itself or the first below it.
+   *  Together with subtree_end this allows to iterate over the subtree. */
+  iterator subtree_begin(const std::string& path);
+  const_iterator subtree_begin(const std::string& path) const;
+
+  /** Return an iterator to the first entry past the subtree below the
+   *  full path ``path``. */
+  iterator subtree_end(const std::string& path);
+  const_iterator subtree_end(const std::string& path) const;
+  ///@}
+
+  /** \name Access to the interned representation */
+  ///@{
+  /** Translate a full key to an InternedKey without modifying the table.
+   *  Returns false if any component is unknown, i.e. if no entry at or
+   *  below the full key can exist. */
+  bool lookup_key(const std::string& full_key, InternedKey& key) const;
+
+  /** Build the string of a key, leaving out the first ``skip`` components.
+   *  The result is "" for an empty key and starts with a '/' otherwise. */
+  std::string key_string(const InternedKey& key, size_t skip = 0) const;
+
+  /** Number of components in a normalised full key */
+  static size_t depth(const std::string& full_key);
+
+  /** The table of components */
+  const ComponentTable& table() const { return *m_table; }
+
+  /** Raw lower_bound in terms of interned keys and probes */
+  iterator lower_bound(const InternedKey& key) { return m_map.lower_bound(key); }
+  const_iterator lower_bound(const InternedKey& key) const {
+    return m_map.lower_bound(key);
+  }
+
+  /** Ordering of the keys */
+  InternedKeyLess key_comp() const { return m_map.key_comp(); }
+  ///@}
+
+  /** \name Plain container interface */
+  ///@{
+  iterator begin() { return m_map.begin(); }
+  const_iterator begin() const { return m_map.begin(); }
+  iterator end() { return m_map.end(); }
+  const_iterator end() const { return m_map.end(); }
+  size_t size() const { return m_map.size(); }
+  bool empty() const { return m_map.empty(); }
+
+  /** Remove all entries and reset the component table */
+  void clear();
+  ///@}
+
+  /** \name Mounts */
+  ///@{
+  /** Record that a map has been mounted at a full key of this container
+   *  (see PamMap::mount). Only if the container has mount points, lookups
+   *  of missing keys search for them on the way to the key.
+   *  Replacing or erasing the entry removes the mount point again. */
+  void note_mount(const std::string& full_key);
+
+  /** Are there any maps mounted into this container */
+  bool has_mounts() const { return !m_mount_keys.empty(); }
+
+  /** Return the range of keys of the mount points at or below
+   *  the full path ``path`` */
+  std::pair<key_set_type::const_iterator, key_set_type::const_iterator> mounts_below(
+        const std::string& path) const;
+  ///@}
+
+  /** \name Modification tracking */
+  ///@{
+  /** Identifier of this container, which is unique within the process */
+  uint64_t id() const { return m_id; }
+
+  /** Counter, which changes whenever entries are inserted, replaced or
+   *  removed. Modifying values in place (e.g. through PamMap::at) does
+   *  not change it. */
+  uint64_t version() const { return m_version; }
+
+  /** Change the version, since a reference, through which a value could be
+   *  replaced, has been handed out */
+  void note_replacement() { ++m_version; }
+  ///@}
+
+  InternedKeyMap();
+  InternedKeyMap(const InternedKeyMap& other);
+  InternedKeyMap& operator=(const InternedKeyMap& other) = delete;
+
+ private:
+  /** Translate a full key to an InternedKey, interning unknown components */
+  InternedKey intern_key(const std::string& full_key);
+
+  /** The component table (heap-allocated, since the comparator of m_map
+   *  refers to it) */
+  std::unique_ptr<ComponentTable> m_table;
+
+  /** The actual entries */
+  map_type m_map;
+
+  /** The keys of the entries holding a mounted map */
+  key_set_type m_mount_keys;
+
+  /** The unique identifier and the modification counter */
+  uint64_t m_id;
+  uint64_t m_version = 0;
+};
+
+}  // namespace pammap
@@ -27,6 +27,17 @@
 
 namespace pammap {
 
+class BitArrayView;
+class BitArray;
+class StringArrayView;
+class StringArray;
+template <typename T, typename Index>
+class CsrMatrixView;
+template <typename T, typename Index>
+class CooMatrixView;
+template <typename T>
+class ChunkedArray;
+
 /** Is the type T supported by pammap for storage. */
 template <typename T>
 struct IsSupportedType : public std::false_type {};
@@ -71,4 +82,124 @@ struct IsSupportedType<ArrayView<String>> : public std::true_type {};
 template <>
 struct IsSupportedType<ArrayView<Bool>> : public std::true_type {};
 
+/** Specialisation of IsSupportedType<T> for ArrayView<Float32>.*/
+template <>
+struct IsSupportedType<ArrayView<Float32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for ArrayView<Complex64>.*/
+template <>
+struct IsSupportedType<ArrayView<Complex64>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for ArrayView<Integer32>.*/
+template <>
+struct IsSupportedType<ArrayView<Integer32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for ArrayView<Integer8>.*/
+template <>
+struct IsSupportedType<ArrayView<Integer8>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for ArrayView<Unsigned8>.*/
+template <>
+struct IsSupportedType<ArrayView<Unsigned8>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Integer>.*/
+template <>
+struct IsSupportedType<Array<Integer>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Float>.*/
+template <>
+struct IsSupportedType<Array<Float>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Complex>.*/
+template <>
+struct IsSupportedType<Array<Complex>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<String>.*/
+template <>
+struct IsSupportedType<Array<String>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Bool>.*/
+template <>
+struct IsSupportedType<Array<Bool>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Float32>.*/
+template <>
+struct IsSupportedType<Array<Float32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Complex64>.*/
+template <>
+struct IsSupportedType<Array<Complex64>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Integer32>.*/
+template <>
+struct IsSupportedType<Array<Integer32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Integer8>.*/
+template <>
+struct IsSupportedType<Array<Integer8>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for Array<Unsigned8>.*/
+template <>
+struct IsSupportedType<Array<Unsigned8>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for BitArrayView.*/
+template <>
+struct IsSupportedType<BitArrayView> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for BitArray.*/
+template <>
+struct IsSupportedType<BitArray> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for StringArrayView.*/
+template <>
+struct IsSupportedType<StringArrayView> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for StringArray.*/
+template <>
+struct IsSupportedType<StringArray> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CsrMatrixView<Float, Integer32>.*/
+template <>
+struct IsSupportedType<CsrMatrixView<Float, Integer32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CsrMatrixView<Float, Integer>.*/
+template <>
+struct IsSupportedType<CsrMatrixView<Float, Integer>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CsrMatrixView<Complex, Integer32>.*/
+template <>
+struct IsSupportedType<CsrMatrixView<Complex, Integer32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CsrMatrixView<Complex, Integer>.*/
+template <>
+struct IsSupportedType<CsrMatrixView<Complex, Integer>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CooMatrixView<Float, Integer32>.*/
+template <>
+struct IsSupportedType<CooMatrixView<Float, Integer32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CooMatrixView<Float, Integer>.*/
+template <>
+struct IsSupportedType<CooMatrixView<Float, Integer>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CooMatrixView<Complex, Integer32>.*/
+template <>
+struct IsSupportedType<CooMatrixView<Complex, Integer32>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for CooMatrixView<Complex, Integer>.*/
+template <>
+struct IsSupportedType<CooMatrixView<Complex, Integer>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for ChunkedArray<Float>.*/
+template <>
+struct IsSupportedType<ChunkedArray<Float>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for ChunkedArray<Complex>.*/
+template <>
+struct IsSupportedType<ChunkedArray<Complex>> : public std::true_type {};
+
+/** Specialisation of IsSupportedType<T> for ChunkedArray<Integer>.*/
+template <>
+struct IsSupportedType<ChunkedArray<Integer>> : public std::true_type {};
+
 }  // namespace pammap
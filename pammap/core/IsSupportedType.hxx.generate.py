@@ -22,7 +22,7 @@
 ## ---------------------------------------------------------------------
 
 from common import licence_header_cpp, NAMESPACE_OPEN, NAMESPACE_CLOSE
-from common import make_supported_cpp_types
+from common import make_supported_cpp_types, to_cpp_type, SPARSE_MATRIX_TEMPLATES
 import constants
 
 
@@ -32,13 +32,24 @@ def generate():
     output += ["#include <type_traits>"]
 
     output += NAMESPACE_OPEN
+
+    # Forward-declare the supported (non-template) classes
+    supported_types = make_supported_cpp_types(constants.DTYPES)
+    scalar_types = [to_cpp_type(dtype) for dtype in constants.DTYPES]
+    output += ["class " + cpptype + ";" for cpptype in supported_types
+               if cpptype not in scalar_types and "<" not in cpptype]
+    for template in SPARSE_MATRIX_TEMPLATES:
+        output += ["template <typename T, typename Index>", "class " + template + ";"]
+    output += ["template <typename T>", "class ChunkedArray;"]
+    output += [""]
+
     output += [
         "/** Is the type T supported by pammap for storage. */",
         "template <typename T>",
         "struct IsSupportedType : public std::false_type {};",
     ]
 
-    for cpptype in make_supported_cpp_types(constants.DTYPES):
+    for cpptype in supported_types:
         output += [
             "",
             "/** Specialisation of IsSupportedType<T> for " + cpptype + ".*/",
@@ -18,45 +18,13 @@
 //
 
 #include "PamMap.hpp"
+#include "PamMapOverride.hpp"
 #include "exceptions.hpp"
+#include <set>
+#include <utility>
 #include <vector>
 
 namespace pammap {
-namespace {
-/** Return an iterator which points to the first key-value pair where the
- * key begins with the provided string ``start``.
- *
- * Together with map_starting_keys_end this allows to iterate over a range
- * of values in the map, where the keys start with ``start``.
- */
-template <typename Map>
-static auto starting_keys_begin(Map& map, const std::string& start)
-      -> decltype(std::begin(map)) {
-  return map.lower_bound(start);
-}
-
-/** Return an iterator which points to the first key-value pair where the
- * key does not begin with the with the provided string ``start``.
- *
- * Together with map_starting_keys_begin this allows to iterate over a range
- * of values in the map, where the keys start with ``start``.
- */
-template <typename Map>
-auto starting_keys_end(Map& map, const std::string& start) -> decltype(std::end(map)) {
-  // If start is empty, then we iterate over the full map:
-  if (start.length() == 0) return std::end(map);
-
-  // Seek to the first key-value pair which is no longer part
-  // of the range we care about, i.e. which does not start with the
-  // provided start string.
-  auto it = starting_keys_begin(map, start);
-  for (; it != std::end(map); ++it) {
-    if (0 != it->first.compare(0, start.length(), start)) break;
-  }
-  return it;
-}
-}  // namespace
-
 PamMap& PamMap::operator=(PamMap other) {
   m_location      = std::move(other.m_location);
   m_container_ptr = std::move(other.m_container_ptr);
@@ -74,28 +42,151 @@ PamMap::PamMap(const PamMap& other) : PamMap() {
 
 template <typename T>
 T& PamMap::at(const std::string& key, T& default_value) {
-  auto itkey = m_container_ptr->find(make_full_key(key));
-  if (itkey == std::end(*m_container_ptr)) {
+  PamMapValue* value = find_value(make_full_key(key));
+  if (value == nullptr) {
     return default_value;
   } else {
-    return value_cast<T&>(key, itkey->second);
+    return value_cast<T&>(key, *value);
   }
 }
 
 template <typename T>
 const T& PamMap::at(const std::string& key, const T& default_value) const {
-  auto itkey = m_container_ptr->find(make_full_key(key));
-  if (itkey == std::end(*m_container_ptr)) {
+  const PamMapValue* value = find_value(make_full_key(key));
+  if (value == nullptr) {
     return default_value;
   } else {
-    return value_cast<const T&>(key, itkey->second);
+    return value_cast<const T&>(key, *value);
+  }
+}
+
+PamMapValue* PamMap::find_override(const std::string& full_key) const {
+  return PamMapOverride::find(m_container_ptr.get(), full_key);
+}
+
+PamMap* PamMap::find_mount(const std::string& full_key, std::string& rest) const {
+  const map_type& map = *m_container_ptr;
+  if (!map.has_mounts()) return nullptr;
+
+  // Nothing is stored below a mount point in this container, so the first
+  // proper prefix of the key which is a mount point is the one we want.
+  // We stop as soon as a component is unknown to the container, since
+  // then no key with this prefix exists.
+  const size_t depth = map_type::depth(full_key);
+  InternedKey prefix(depth);
+  std::string component;
+  size_t start = 1;
+  for (size_t i = 0; i + 1 < depth; ++i) {
+    const size_t end = full_key.find('/', start);
+    component.assign(full_key, start, end - start);
+    prefix[i] = map.table().find(component);
+    if (prefix[i] == ComponentTable::npos) return nullptr;
+
+    auto it = map.find(prefix.prefix(i + 1));
+    if (it != map.end()) {
+      auto* mounted = any_cast<std::shared_ptr<PamMap>>(&it->second);
+      if (mounted != nullptr) {
+        rest = full_key.substr(end);
+        return mounted->get();
+      }
+    }
+    start = end + 1;
+  }
+  return nullptr;
+}
+
+PamMapValue* PamMap::find_mounted(const std::string& full_key) const {
+  std::string rest;
+  PamMap* mounted = find_mount(full_key, rest);
+  if (mounted == nullptr) return nullptr;
+  return mounted->find_value(mounted->make_full_key(rest));
+}
+
+PamMapValue& PamMap::value_slot(const std::string& full_key) const {
+  std::string rest;
+  PamMap* mounted = find_mount(full_key, rest);
+  if (mounted == nullptr) return (*m_container_ptr)[full_key];
+  return mounted->value_slot(mounted->make_full_key(rest));
+}
+
+void PamMap::note_replacement(const std::string& full_key) {
+  m_container_ptr->note_replacement();
+  std::string rest;
+  PamMap* mounted = find_mount(full_key, rest);
+  if (mounted != nullptr) mounted->note_replacement(mounted->make_full_key(rest));
+}
+
+size_t PamMap::erase(const std::string& key) {
+  const std::string full_key = make_full_key(key);
+  std::string rest;
+  PamMap* mounted = find_mount(full_key, rest);
+  if (mounted == nullptr) return m_container_ptr->erase(full_key);
+  return mounted->erase(rest);
+}
+
+void PamMap::mount(const std::string& path, const PamMap& other) {
+  const std::string full_path = make_full_key(path);
+  pammap_throw(!full_path.empty(), ValueError, "Cannot mount a map at the root.");
+  pammap_throw(other.m_container_ptr != m_container_ptr, ValueError,
+               "Cannot mount a map into itself.");
+  pammap_throw(!other.reaches(m_container_ptr.get()), ValueError,
+               "Cannot mount a map, which has this map mounted, since this would "
+               "create a cycle.");
+
+  std::string rest;
+  PamMap* mounted = find_mount(full_path, rest);
+  if (mounted != nullptr) {
+    // Mount inside the map already mounted on the way
+    mounted->mount(rest, other);
+    return;
   }
+
+  erase_recursive(path);
+  // The mounted map is held by a shared pointer, such that copies of the value
+  // (e.g. when copying this map) refer to the same mounted map.
+  PamMapValue& slot       = (*m_container_ptr)[full_path];
+  static_cast<any&>(slot) = any(std::shared_ptr<PamMap>(new PamMap(other, "/")));
+  m_container_ptr->note_mount(full_path);
+}
+
+bool PamMap::reaches(const map_type* container) const {
+  std::set<std::pair<const map_type*, std::string>> visited;
+  return reaches(container, visited);
+}
+
+bool PamMap::reaches(const map_type* container,
+                     std::set<std::pair<const map_type*, std::string>>& visited) const {
+  if (m_container_ptr.get() == container) return true;
+  if (!m_container_ptr->has_mounts()) return false;
+
+  // Only the mount points are visited, not the entries. A container mounted
+  // at several places is visited once per location, since different locations
+  // see different mount points of the container.
+  if (!visited.emplace(m_container_ptr.get(), m_location).second) return false;
+  const auto range = m_container_ptr->mounts_below(m_location);
+  for (auto key = range.first; key != range.second; ++key) {
+    auto it = m_container_ptr->find(*key);
+    pammap_assert(it != m_container_ptr->end());
+    const auto* mounted = any_cast<std::shared_ptr<PamMap>>(&it->second);
+    if (mounted != nullptr && (*mounted)->reaches(container, visited)) return true;
+  }
+  return false;
+}
+
+void PamMap::unmount(const std::string& path) {
+  pammap_throw(is_mount(path), KeyError, "No map is mounted at '" + path + "'.");
+  erase(path);
+}
+
+bool PamMap::is_mount(const std::string& path) const {
+  const PamMapValue* value = find_stored(make_full_key(path));
+  return value != nullptr && any_cast<std::shared_ptr<PamMap>>(value) != nullptr;
 }
 
 void PamMap::update(std::initializer_list<entry_type> il) {
   // Make each key a full path key and append/modify entry in map
   for (entry_type t : il) {
-    (*m_container_ptr)[make_full_key(t.first)] = std::move(t.second);
+    value_slot(make_full_key(t.first)) = std::move(t.second);
   }
 }
 
@@ -114,7 +205,12 @@ void PamMap::update(const std::string& key, const PamMap& other) {
     // The iterator truncates the other key relative to the builtin
     // location of other for us. We then make it full for our location
     // and update.
-    (*m_container_ptr)[make_full_key(key + "/" + it->key())] = it->value_raw();
+    const auto* mounted = any_cast<std::shared_ptr<PamMap>>(&it->value_raw());
+    if (mounted != nullptr) {
+      mount(key + "/" + it->key(), **mounted);
+    } else {
+      value_slot(make_full_key(key + "/" + it->key())) = it->value_raw();
+    }
   }
 }
 
@@ -123,7 +219,12 @@ void PamMap::update(const std::string& key, PamMap&& other) {
     // The iterator truncates the other key relative to the builtin
     // location of other for us. We then make it full for our location
     // and update.
-    (*m_container_ptr)[make_full_key(key + "/" + it->key())] = std::move(it->value_raw());
+    const auto* mounted = any_cast<std::shared_ptr<PamMap>>(&it->value_raw());
+    if (mounted != nullptr) {
+      mount(key + "/" + it->key(), **mounted);
+    } else {
+      value_slot(make_full_key(key + "/" + it->key())) = std::move(it->value_raw());
+    }
   }
 }
 
@@ -175,31 +276,130 @@ std::string PamMap::make_full_key(const std::string& key) const {
 }
 
 typename PamMap::iterator PamMap::begin(const std::string& path) {
-  // Obtain iterator to the first key-value pair, which has a
-  // key starting with the full path.
+  // Obtain iterator to the first key-value pair, which is
+  // part of the subtree below the full path.
   //
-  // (since the keys are sorted alphabetically in the map
+  // (since the keys are sorted such that subtrees are contiguous
   //  the ones which follow next must all be below our current
   //  location or already well past it.)
   const std::string path_full = make_full_key(path);
-  return iterator(starting_keys_begin(*m_container_ptr, path_full), path_full);
+  map_type& map               = *m_container_ptr;
+  return iterator(map.subtree_begin(path_full), map, path_full);
 }
 
 typename PamMap::const_iterator PamMap::cbegin(const std::string& path) const {
+  const map_type& map         = *m_container_ptr;
   const std::string path_full = make_full_key(path);
-  return const_iterator(starting_keys_begin(*m_container_ptr, path_full), path_full);
+  return const_iterator(map.subtree_begin(path_full), map, path_full);
 }
 
 typename PamMap::iterator PamMap::end(const std::string& path) {
-  // Obtain the first key which does no longer start with the pull path,
-  // i.e. where we are done processing the subpath.
+  // Obtain the first key which is no longer part of the subtree below
+  // the full path, i.e. where we are done processing the subpath.
   const std::string path_full = make_full_key(path);
-  return iterator(starting_keys_end(*m_container_ptr, path_full), path_full);
+  map_type& map               = *m_container_ptr;
+  return iterator(map.subtree_end(path_full), map, path_full);
 }
 
 typename PamMap::const_iterator PamMap::cend(const std::string& path) const {
+  const map_type& map         = *m_container_ptr;
   const std::string path_full = make_full_key(path);
-  return const_iterator(starting_keys_end(*m_container_ptr, path_full), path_full);
+  return const_iterator(map.subtree_end(path_full), map, path_full);
+}
+
+PamMapChildIterator PamMap::child_begin(const std::string& path) const {
+  const map_type& map         = *m_container_ptr;
+  const std::string path_full = make_full_key(path);
+  const auto end              = map.subtree_end(path_full);
+
+  // Skip the key of the path itself (if present), since it is no child
+  auto begin = map.subtree_begin(path_full);
+  if (begin != end && begin->first.size() == map_type::depth(path_full)) ++begin;
+  return PamMapChildIterator(map, begin, end, path_full);
+}
+
+PamMapChildIterator PamMap::child_end(const std::string& path) const {
+  const map_type& map         = *m_container_ptr;
+  const std::string path_full = make_full_key(path);
+  const auto end              = map.subtree_end(path_full);
+  return PamMapChildIterator(map, end, end, path_full);
+}
+
+std::vector<std::string> PamMap::children(const std::string& path) const {
+  return std::vector<std::string>(child_begin(path), child_end(path));
+}
+
+IteratorRange<PamMapFindIterator<false>> PamMap::find(const std::string& pattern) {
+  typedef PamMapFindIterator<false> find_iterator;
+  map_type& map   = *m_container_ptr;
+  auto compiled   = std::make_shared<const GlobPattern>(pattern);
+  const auto last = map.subtree_end(m_location);
+  return {find_iterator(map, map.subtree_begin(m_location), last, compiled, m_location),
+          find_iterator(map, last, last, compiled, m_location)};
+}
+
+IteratorRange<PamMapFindIterator<true>> PamMap::find(const std::string& pattern) const {
+  typedef PamMapFindIterator<true> find_iterator;
+  const map_type& map = *m_container_ptr;
+  auto compiled       = std::make_shared<const GlobPattern>(pattern);
+  const auto last     = map.subtree_end(m_location);
+  return {find_iterator(map, map.subtree_begin(m_location), last, compiled, m_location),
+          find_iterator(map, last, last, compiled, m_location)};
+}
+
+template <typename T>
+Gathered<T> PamMap::gather(const std::string& pattern) {
+  // Look at the values through const accessors, since the mutable raw
+  // values count as replaced (see PamMapAccessor::value_raw)
+  Gathered<T> ret;
+  const PamMap& self = *this;
+  for (const auto& entry : self.find(pattern)) {
+    const T* value = any_cast<T>(&entry.value_raw());
+    if (value == nullptr) continue;
+    ret.index.m_slots.push_back(const_cast<T*>(value));
+    ret.index.m_keys.push_back(entry.key());
+  }
+  ret.index.m_container = m_container_ptr->id();
+  ret.index.m_version   = m_container_ptr->version();
+
+  ret.values = Array<T>({ret.index.size()});
+  gather(ret.index, ret.values.view());
+  return ret;
+}
+
+template <typename T>
+void PamMap::gather(const GatherIndex<T>& index, ArrayView<T> values) const {
+  check_gather_index(index, values);
+  const ptrdiff_t stride = values.strides()[0];
+  T* out                 = values.data();
+  for (T* slot : index.m_slots) {
+    *out = *slot;
+    out += stride;
+  }
+}
+
+template <typename T>
+void PamMap::scatter(const GatherIndex<T>& index, const ArrayView<T>& values) {
+  check_gather_index(index, values);
+  const ptrdiff_t stride = values.strides()[0];
+  const T* in            = values.data();
+  for (T* slot : index.m_slots) {
+    *slot = *in;
+    in += stride;
+  }
+}
+
+template <typename T>
+void PamMap::check_gather_index(const GatherIndex<T>& index,
+                                const ArrayView<T>& values) const {
+  pammap_throw(index.m_container == m_container_ptr->id(), InvalidStateError,
+               "The GatherIndex has been obtained from a different PamMap.");
+  pammap_throw(index.m_version == m_container_ptr->version(), InvalidStateError,
+               "Entries of the PamMap have been inserted, replaced or removed since the "
+               "GatherIndex has been obtained. Gather the values again.");
+  pammap_throw(values.ndim() == 1 && values.size() == index.size(), ValueError,
+               "Expected a one-dimensional view of " + std::to_string(index.size()) +
+                     " values.");
 }
 
 }  // namespace pammap
@@ -18,10 +18,26 @@
 //
 
 #pragma once
+#include "GatherIndex.hpp"
+#include "PamMapChildIterator.hpp"
+#include "PamMapFindIterator.hpp"
 #include "PamMapIterator.hpp"
 #include "value_cast.hpp"
+#include <set>
+#include <utility>
+#include <vector>
 
 namespace pammap {
+#ifndef SWIG
+class PamMapOverride;
+
+namespace detail {
+/** The innermost PamMapOverride layer active in the calling thread
+ *  or nullptr if no override layer is active. */
+extern thread_local PamMapOverride* override_top;
+}  // namespace detail
+#endif  // SWIG not defined
+
 /** GenMap implements a map from a std::string to objects of a range
  *  of types, including std::string, int, double, vector<double>, ...
  *
@@ -108,7 +124,7 @@ class PamMap {
    *   - Shared pointers
    */
   void update(const std::string& key, PamMapValue e) {
-    (*m_container_ptr)[make_full_key(key)] = std::move(e);
+    value_slot(make_full_key(key)) = std::move(e);
   }
 
   /** \brief Update many entries using an initialiser list
@@ -131,6 +147,9 @@ class PamMap {
    * Roughly speaking modification of entries via ``at`` affects both
    * ``this`` and ``map``, wherease modification of entries via ``update``
    * only effects the GenMap object on which the method is called.
+   *
+   * Maps mounted into \t other are mounted at the corresponding paths
+   * below \t key (see mount).
    * */
   void update(const std::string& key, const PamMap& other);
 
@@ -158,10 +177,10 @@ class PamMap {
    * only new ones inserted (That's why the method is still const)
    */
   void insert_default(const std::string& key, PamMapValue e) const {
-    auto itkey = m_container_ptr->find(make_full_key(key));
-    if (itkey == std::end(*m_container_ptr)) {
+    const std::string full_key = make_full_key(key);
+    if (find_stored(full_key) == nullptr) {
       // Key not found, hence insert default.
-      (*m_container_ptr)[make_full_key(key)] = std::move(e);
+      value_slot(full_key) = std::move(e);
     }
   }
 
@@ -182,9 +201,7 @@ class PamMap {
    *
    *  \return The number of removed elements (i.e. 0 or 1)
    **/
-  size_t erase(const std::string& key) {
-    return m_container_ptr->erase(make_full_key(key));
-  }
+  size_t erase(const std::string& key);
 
   /** \brief Try to remove an element referenced by a key iterator
    *
@@ -196,7 +213,7 @@ class PamMap {
     typedef map_type::iterator mapiter;
     auto pos_conv = static_cast<typename map_type::iterator>(position);
     mapiter res   = m_container_ptr->erase(pos_conv);
-    return iterator(std::move(res), m_location);
+    return iterator(std::move(res), *m_container_ptr, m_location);
   }
 
   /** \brief Try to remove a range of elements
@@ -210,7 +227,7 @@ class PamMap {
     auto first_conv = static_cast<typename map_type::iterator>(first);
     auto last_conv  = static_cast<typename map_type::iterator>(last);
     mapiter res     = m_container_ptr->erase(first_conv, last_conv);
-    return iterator(std::move(res), m_location);
+    return iterator(std::move(res), *m_container_ptr, m_location);
   }
 
   /** \brief Try to remove a full submap path including all
@@ -246,7 +263,10 @@ class PamMap {
    */
   template <typename T>
   T& at(const std::string& key) {
-    return value_cast<T&>(key, at_raw_value(key));
+    // Not via at_raw_value, since modifying in place replaces no entry
+    PamMapValue* value = find_value(make_full_key(key));
+    pammap_throw(value != nullptr, KeyError, key);
+    return value_cast<T&>(key, *value);
   }
 
   /** \brief Return a reference to the value at a given key
@@ -275,13 +295,18 @@ class PamMap {
   /** Return an GenMapValue object representing the data behind the specified
    * key
    *
+   * Since the value may be replaced through the reference, this counts as
+   * replacing the entry, i.e. GatherIndex objects become invalid.
+   *
    * \note This is an advanced method. Use only if you know what you are
    * doing.
    * */
   PamMapValue& at_raw_value(const std::string& key) {
-    auto itkey = m_container_ptr->find(make_full_key(key));
-    pammap_throw(itkey != std::end(*m_container_ptr), KeyError, key);
-    return itkey->second;
+    const std::string full_key = make_full_key(key);
+    PamMapValue* value         = find_value(full_key);
+    pammap_throw(value != nullptr, KeyError, key);
+    note_replacement(full_key);
+    return *value;
   }
 
   /** Return an GenMapValue object representing the data behind the specified
@@ -291,15 +316,15 @@ class PamMap {
    * doing.
    * */
   const PamMapValue& at_raw_value(const std::string& key) const {
-    auto itkey = m_container_ptr->find(make_full_key(key));
-    pammap_throw(itkey != std::end(*m_container_ptr), KeyError, key);
-    return itkey->second;
+    const PamMapValue* value = find_value(make_full_key(key));
+    pammap_throw(value != nullptr, KeyError, key);
+    return *value;
   }
   ///@}
 
   /** Check weather a key exists */
   bool exists(const std::string& key) const {
-    return m_container_ptr->find(make_full_key(key)) != std::end(*m_container_ptr);
+    return find_value(make_full_key(key)) != nullptr;
   }
 
   /** Return a string which describes the type of the
@@ -396,11 +421,109 @@ class PamMap {
   const_iterator cend(const std::string& path = "/") const;
   //@}
 
+  //@{
+  /** Return an iterator over the names of the direct children of a path
+   *  and the matching end iterator.
+   *
+   * For a map containing the keys "/a", "/a/b/c", "/a/b/d" and "/a/e"
+   * the children of "a" are "b" and "e". See PamMapChildIterator for details.
+   */
+  PamMapChildIterator child_begin(const std::string& path = "/") const;
+  PamMapChildIterator child_end(const std::string& path = "/") const;
+  //@}
+
+  /** Return the names of the direct children of a path.
+   *
+   * Only the children themselves are visited, not the keys below them,
+   * so this is cheap even for huge subtrees.
+   */
+  std::vector<std::string> children(const std::string& path = "/") const;
+
+  //@{
+  /** Find all keys matching a glob-style pattern.
+   *
+   * The pattern is interpreted relative to the location of this map.
+   * Within a path component "*", "?" and bracket expressions like "[a-z]"
+   * may be used, a component "**" matches zero or more components (see
+   * GlobPattern for details). The returned range is lazy, i.e. matching
+   * keys are only searched for while iterating. Whole subtrees, which
+   * cannot contain a match, are skipped without visiting their keys.
+   */
+  IteratorRange<PamMapFindIterator<false>> find(const std::string& pattern);
+  IteratorRange<PamMapFindIterator<true>> find(const std::string& pattern) const;
+  //@}
+
+  /** \name Gathering and scattering values */
+  ///@{
+  /** Copy the values of all entries of type T, whose keys match a
+   *  glob-style pattern (see find), into one contiguous Array in the order
+   *  of the keys. Entries of other types are skipped.
+   *
+   * Together with the values an index of the entries is returned, which
+   * allows to write modified values back with scatter (or to gather them
+   * again) in a single pass without looking up any key, e.g.
+   * ```
+   * Gathered<Float> weights = map.gather<Float>("model/weights/[a-z]*");
+   * optimise(weights.values.data(), weights.values.size());
+   * map.scatter(weights.index, weights.values.view());
+   * ```
+   * Like find this does not take mounted maps and override layers into
+   * account. See GatherIndex for how long the index stays valid.
+   */
+  template <typename T>
+  Gathered<T> gather(const std::string& pattern);
+
+  /** Copy the values of the entries of an index into a one-dimensional
+   *  view of matching size. Throws an InvalidStateError if the index does
+   *  not belong to this map or is outdated. */
+  template <typename T>
+  void gather(const GatherIndex<T>& index, ArrayView<T> values) const;
+
+  /** Write values back to the entries of an index obtained from gather.
+   *  The values are taken from a one-dimensional view of matching size.
+   *  Throws an InvalidStateError if the index does not belong to this map
+   *  or is outdated. */
+  template <typename T>
+  void scatter(const GatherIndex<T>& index, const ArrayView<T>& values);
+  ///@}
+
+  /** \name Mounts */
+  ///@{
+  /** \brief Mount another map at a path.
+   *
+   * Afterwards all keys of ``other`` are available below ``path``, e.g.
+   * after ``map.mount("basis", other)`` the lookup ``map.at<Float>("basis/cutoff")``
+   * returns ``other.at<Float>("cutoff")``. Mounting does not copy or visit
+   * any entries, so its cost does not depend on the size of ``other``.
+   * Apart from the lookup of the path it only takes time proportional to
+   * the number of maps mounted (directly or indirectly) into ``other``,
+   * which are checked to rule out cycles.
+   * Much like a filesystem mount the maps are linked, i.e. modifications
+   * through ``update``, ``at`` or ``erase`` below the path affect ``other``
+   * and vice versa. This holds also for deep copies of this map, which refer
+   * to the same mounted map.
+   *
+   * Any entries at or below ``path`` are removed by mounting.
+   * Iteration (begin(), end(), find(), children()) does not descend
+   * into mounted maps, but only visits the mount point itself.
+   *
+   * \note Like submap this may remove the constness of ``other``.
+   *       Cyclic mounts are not allowed.
+   */
+  void mount(const std::string& path, const PamMap& other);
+
+  /** Remove a map mounted at a path. Throws a KeyError if nothing is mounted
+   *  there. Takes constant time as well (apart from the lookup of the path). */
+  void unmount(const std::string& path);
+
+  /** Is there a map mounted at the given path */
+  bool is_mount(const std::string& path) const;
+  ///@}
+
   // TODO alias names, i.e. link one name to a different one.
   //      but be careful not to get a cyclic graph.
   //
   // TODO other map operations like
-  //        - find ?
   //        - access to data using iterators ?
   //        - erase using iterators ?
 
@@ -429,11 +552,62 @@ class PamMap {
           m_location{other.make_full_key(newlocation)} {}
 
  private:
+  friend class PamMapOverride;
+
   /** Make the actual container key from a key supplied by the user
    *  Care is taken such that we cannot escape the subtree.
    * */
   std::string make_full_key(const std::string& key) const;
 
+  /** Find the value stored under a full key taking the override layers
+   *  active in this thread into account. Returns nullptr if the key
+   *  cannot be found. */
+  PamMapValue* find_value(const std::string& full_key) const {
+    if (detail::override_top != nullptr) {
+      PamMapValue* value = find_override(full_key);
+      if (value != nullptr) return value;
+    }
+    return find_stored(full_key);
+  }
+
+  /** Find the value stored under a full key in the container or in
+   *  the mounted maps. Returns nullptr if the key cannot be found. */
+  PamMapValue* find_stored(const std::string& full_key) const {
+    auto itkey = m_container_ptr->find(full_key);
+    if (itkey != std::end(*m_container_ptr)) return &itkey->second;
+    if (!m_container_ptr->has_mounts()) return nullptr;
+    return find_mounted(full_key);
+  }
+
+  /** Search the override layers active in this thread for a full key */
+  PamMapValue* find_override(const std::string& full_key) const;
+
+  /** Search for a full key in the map mounted on the way to it */
+  PamMapValue* find_mounted(const std::string& full_key) const;
+
+  /** Return the map mounted at a proper prefix of a full key (or nullptr)
+   *  and set ``rest`` to the remainder of the key. */
+  PamMap* find_mount(const std::string& full_key, std::string& rest) const;
+
+  /** Does this map or any map mounted below it (directly or indirectly)
+   *  store its entries in the given container */
+  bool reaches(const map_type* container) const;
+  bool reaches(const map_type* container,
+               std::set<std::pair<const map_type*, std::string>>& visited) const;
+
+  /** Return the value stored under a full key, inserting an empty one if
+   *  needed. Takes mounted maps into account. */
+  PamMapValue& value_slot(const std::string& full_key) const;
+
+  /** Change the version of the container storing a full key (and of the
+   *  containers of the maps mounted on the way to it) */
+  void note_replacement(const std::string& full_key);
+
+  /** Check that an index can be used with this map and that the view
+   *  of values has the right size */
+  template <typename T>
+  void check_gather_index(const GatherIndex<T>& index, const ArrayView<T>& values) const;
+
   std::shared_ptr<map_type> m_container_ptr;
 
   /** The location we are currently on in the tree
@@ -61,5 +61,147 @@ template const ArrayView<Bool>& PamMap::at<ArrayView<Bool>>(
       const std::string& key, const ArrayView<Bool>& default_value) const;
 template ArrayView<Bool>& PamMap::at<ArrayView<Bool>>(const std::string& key,
                                                       ArrayView<Bool>& default_value);
+template const ArrayView<Float32>& PamMap::at<ArrayView<Float32>>(
+      const std::string& key, const ArrayView<Float32>& default_value) const;
+template ArrayView<Float32>& PamMap::at<ArrayView<Float32>>(
+      const std::string& key, ArrayView<Float32>& default_value);
+template const ArrayView<Complex64>& PamMap::at<ArrayView<Complex64>>(
+      const std::string& key, const ArrayView<Complex64>& default_value) const;
+template ArrayView<Complex64>& PamMap::at<ArrayView<Complex64>>(
+      const std::string& key, ArrayView<Complex64>& default_value);
+template const ArrayView<Integer32>& PamMap::at<ArrayView<Integer32>>(
+      const std::string& key, const ArrayView<Integer32>& default_value) const;
+template ArrayView<Integer32>& PamMap::at<ArrayView<Integer32>>(
+      const std::string& key, ArrayView<Integer32>& default_value);
+template const ArrayView<Integer8>& PamMap::at<ArrayView<Integer8>>(
+      const std::string& key, const ArrayView<Integer8>& default_value) const;
+template ArrayView<Integer8>& PamMap::at<ArrayView<Integer8>>(
+      const std::string& key, ArrayView<Integer8>& default_value);
+template const ArrayView<Unsigned8>& PamMap::at<ArrayView<Unsigned8>>(
+      const std::string& key, const ArrayView<Unsigned8>& default_value) const;
+template ArrayView<Unsigned8>& PamMap::at<ArrayView<Unsigned8>>(
+      const std::string& key, ArrayView<Unsigned8>& default_value);
+template const Array<Integer>& PamMap::at<Array<Integer>>(
+      const std::string& key, const Array<Integer>& default_value) const;
+template Array<Integer>& PamMap::at<Array<Integer>>(const std::string& key,
+                                                    Array<Integer>& default_value);
+template const Array<Float>& PamMap::at<Array<Float>>(
+      const std::string& key, const Array<Float>& default_value) const;
+template Array<Float>& PamMap::at<Array<Float>>(const std::string& key,
+                                                Array<Float>& default_value);
+template const Array<Complex>& PamMap::at<Array<Complex>>(
+      const std::string& key, const Array<Complex>& default_value) const;
+template Array<Complex>& PamMap::at<Array<Complex>>(const std::string& key,
+                                                    Array<Complex>& default_value);
+template const Array<String>& PamMap::at<Array<String>>(
+      const std::string& key, const Array<String>& default_value) const;
+template Array<String>& PamMap::at<Array<String>>(const std::string& key,
+                                                  Array<String>& default_value);
+template const Array<Bool>& PamMap::at<Array<Bool>>(
+      const std::string& key, const Array<Bool>& default_value) const;
+template Array<Bool>& PamMap::at<Array<Bool>>(const std::string& key,
+                                              Array<Bool>& default_value);
+template const Array<Float32>& PamMap::at<Array<Float32>>(
+      const std::string& key, const Array<Float32>& default_value) const;
+template Array<Float32>& PamMap::at<Array<Float32>>(const std::string& key,
+                                                    Array<Float32>& default_value);
+template const Array<Complex64>& PamMap::at<Array<Complex64>>(
+      const std::string& key, const Array<Complex64>& default_value) const;
+template Array<Complex64>& PamMap::at<Array<Complex64>>(const std::string& key,
+                                                        Array<Complex64>& default_value);
+template const Array<Integer32>& PamMap::at<Array<Integer32>>(
+      const std::string& key, const Array<Integer32>& default_value) const;
+template Array<Integer32>& PamMap::at<Array<Integer32>>(const std::string& key,
+                                                        Array<Integer32>& default_value);
+template const Array<Integer8>& PamMap::at<Array<Integer8>>(
+      const std::string& key, const Array<Integer8>& default_value) const;
+template Array<Integer8>& PamMap::at<Array<Integer8>>(const std::string& key,
+                                                      Array<Integer8>& default_value);
+template const Array<Unsigned8>& PamMap::at<Array<Unsigned8>>(
+      const std::string& key, const Array<Unsigned8>& default_value) const;
+template Array<Unsigned8>& PamMap::at<Array<Unsigned8>>(const std::string& key,
+                                                        Array<Unsigned8>& default_value);
+template const BitArrayView& PamMap::at<BitArrayView>(
+      const std::string& key, const BitArrayView& default_value) const;
+template BitArrayView& PamMap::at<BitArrayView>(const std::string& key,
+                                                BitArrayView& default_value);
+template const BitArray& PamMap::at<BitArray>(const std::string& key,
+                                              const BitArray& default_value) const;
+template BitArray& PamMap::at<BitArray>(const std::string& key, BitArray& default_value);
+template const StringArrayView& PamMap::at<StringArrayView>(
+      const std::string& key, const StringArrayView& default_value) const;
+template StringArrayView& PamMap::at<StringArrayView>(const std::string& key,
+                                                      StringArrayView& default_value);
+template const StringArray& PamMap::at<StringArray>(
+      const std::string& key, const StringArray& default_value) const;
+template StringArray& PamMap::at<StringArray>(const std::string& key,
+                                              StringArray& default_value);
+template const CsrMatrixView<Float, Integer32>&
+PamMap::at<CsrMatrixView<Float, Integer32>>(
+      const std::string& key, const CsrMatrixView<Float, Integer32>& default_value) const;
+template CsrMatrixView<Float, Integer32>& PamMap::at<CsrMatrixView<Float, Integer32>>(
+      const std::string& key, CsrMatrixView<Float, Integer32>& default_value);
+template const CsrMatrixView<Float, Integer>& PamMap::at<CsrMatrixView<Float, Integer>>(
+      const std::string& key, const CsrMatrixView<Float, Integer>& default_value) const;
+template CsrMatrixView<Float, Integer>& PamMap::at<CsrMatrixView<Float, Integer>>(
+      const std::string& key, CsrMatrixView<Float, Integer>& default_value);
+template const CsrMatrixView<Complex, Integer32>&
+PamMap::at<CsrMatrixView<Complex, Integer32>>(
+      const std::string& key,
+      const CsrMatrixView<Complex, Integer32>& default_value) const;
+template CsrMatrixView<Complex, Integer32>& PamMap::at<CsrMatrixView<Complex, Integer32>>(
+      const std::string& key, CsrMatrixView<Complex, Integer32>& default_value);
+template const CsrMatrixView<Complex, Integer>&
+PamMap::at<CsrMatrixView<Complex, Integer>>(
+      const std::string& key, const CsrMatrixView<Complex, Integer>& default_value) const;
+template CsrMatrixView<Complex, Integer>& PamMap::at<CsrMatrixView<Complex, Integer>>(
+      const std::string& key, CsrMatrixView<Complex, Integer>& default_value);
+template const CooMatrixView<Float, Integer32>&
+PamMap::at<CooMatrixView<Float, Integer32>>(
+      const std::string& key, const CooMatrixView<Float, Integer32>& default_value) const;
+template CooMatrixView<Float, Integer32>& PamMap::at<CooMatrixView<Float, Integer32>>(
+      const std::string& key, CooMatrixView<Float, Integer32>& default_value);
+template const CooMatrixView<Float, Integer>& PamMap::at<CooMatrixView<Float, Integer>>(
+      const std::string& key, const CooMatrixView<Float, Integer>& default_value) const;
+template CooMatrixView<Float, Integer>& PamMap::at<CooMatrixView<Float, Integer>>(
+      const std::string& key, CooMatrixView<Float, Integer>& default_value);
+template const CooMatrixView<Complex, Integer32>&
+PamMap::at<CooMatrixView<Complex, Integer32>>(
+      const std::string& key,
+      const CooMatrixView<Complex, Integer32>& default_value) const;
+template CooMatrixView<Complex, Integer32>& PamMap::at<CooMatrixView<Complex, Integer32>>(
+      const std::string& key, CooMatrixView<Complex, Integer32>& default_value);
+template const CooMatrixView<Complex, Integer>&
+PamMap::at<CooMatrixView<Complex, Integer>>(
+      const std::string& key, const CooMatrixView<Complex, Integer>& default_value) const;
+template CooMatrixView<Complex, Integer>& PamMap::at<CooMatrixView<Complex, Integer>>(
+      const std::string& key, CooMatrixView<Complex, Integer>& default_value);
+template const ChunkedArray<Float>& PamMap::at<ChunkedArray<Float>>(
+      const std::string& key, const ChunkedArray<Float>& default_value) const;
+template ChunkedArray<Float>& PamMap::at<ChunkedArray<Float>>(
+      const std::string& key, ChunkedArray<Float>& default_value);
+template const ChunkedArray<Complex>& PamMap::at<ChunkedArray<Complex>>(
+      const std::string& key, const ChunkedArray<Complex>& default_value) const;
+template ChunkedArray<Complex>& PamMap::at<ChunkedArray<Complex>>(
+      const std::string& key, ChunkedArray<Complex>& default_value);
+template const ChunkedArray<Integer>& PamMap::at<ChunkedArray<Integer>>(
+      const std::string& key, const ChunkedArray<Integer>& default_value) const;
+template ChunkedArray<Integer>& PamMap::at<ChunkedArray<Integer>>(
+      const std::string& key, ChunkedArray<Integer>& default_value);
+template Gathered<Float> PamMap::gather<Float>(const std::string& pattern);
+template void PamMap::gather<Float>(const GatherIndex<Float>& index,
+                                    ArrayView<Float> values) const;
+template void PamMap::scatter<Float>(const GatherIndex<Float>& index,
+                                     const ArrayView<Float>& values);
+template Gathered<Complex> PamMap::gather<Complex>(const std::string& pattern);
+template void PamMap::gather<Complex>(const GatherIndex<Complex>& index,
+                                      ArrayView<Complex> values) const;
+template void PamMap::scatter<Complex>(const GatherIndex<Complex>& index,
+                                       const ArrayView<Complex>& values);
+template Gathered<Integer> PamMap::gather<Integer>(const std::string& pattern);
+template void PamMap::gather<Integer>(const GatherIndex<Integer>& index,
+                                      ArrayView<Integer> values) const;
+template void PamMap::scatter<Integer>(const GatherIndex<Integer>& index,
+                                       const ArrayView<Integer>& values);
 
 }  // namespace pammap
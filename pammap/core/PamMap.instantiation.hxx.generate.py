@@ -23,7 +23,7 @@
 
 
 from common import licence_header_cpp, NAMESPACE_OPEN, NAMESPACE_CLOSE
-from common import make_supported_cpp_types, clang_format
+from common import make_supported_cpp_types, clang_format, GATHER_TYPES
 import constants
 
 
@@ -39,6 +39,16 @@ def generate():
         output.append("template {0:}& PamMap::at<{0:}>(const std::string& key, "
                       "{0:}& default_value);".format(cpptype))
 
+    for cpptype in GATHER_TYPES:
+        output.append("template Gathered<{0:}> PamMap::gather<{0:}>("
+                      "const std::string& pattern);".format(cpptype))
+        output.append("template void PamMap::gather<{0:}>("
+                      "const GatherIndex<{0:}>& index, ArrayView<{0:}> values) "
+                      "const;".format(cpptype))
+        output.append("template void PamMap::scatter<{0:}>("
+                      "const GatherIndex<{0:}>& index, "
+                      "const ArrayView<{0:}>& values);".format(cpptype))
+
     output += NAMESPACE_CLOSE
 
     return clang_format("\n".join(output))
@@ -18,6 +18,7 @@
 //
 
 #pragma once
+#include "InternedKeyMap.hpp"
 #include "PamMapValue.hxx"
 #include "value_cast.hpp"
 #include <string>
@@ -57,8 +58,8 @@ class PamMapAccessor {
   const PamMapValue& value_raw() const { return m_value; }
 
   /** Construct an accessor */
-  PamMapAccessor(const std::string key, const PamMapValue& value)
-        : m_key(key), m_value(value) {}
+  PamMapAccessor(std::string key, const PamMapValue& value)
+        : m_key(std::move(key)), m_value(value) {}
 
  protected:
   const std::string m_key;
@@ -85,18 +86,25 @@ class PamMapAccessor<false> : public PamMapAccessor<true> {
   }
 
   /** Return a reference to the raw value object the accessor holds.
+   *
+   * Since the value may be replaced through the reference, this counts as
+   * replacing the entry, i.e. GatherIndex objects of the map become invalid.
    *
    * \note This is an advanced method.
    *        Use only if you know what you are doing.
    **/
-  PamMapValue& value_raw() { return m_value; }
+  PamMapValue& value_raw() {
+    m_map.note_replacement();
+    return m_value;
+  }
 
-  /** Construct an accessor */
-  PamMapAccessor(const std::string key, PamMapValue& value)
-        : base_type(key, value), m_value(value) {}
+  /** Construct an accessor to a value stored in the map */
+  PamMapAccessor(std::string key, PamMapValue& value, InternedKeyMap& map)
+        : base_type(std::move(key), value), m_value(value), m_map(map) {}
 
  private:
   PamMapValue& m_value;
+  InternedKeyMap& m_map;
 };
 
 }  // namespace pammap
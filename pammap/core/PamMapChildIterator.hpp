@@ -0,0 +1,125 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "PamMapIterator.hpp"
+#include <cstddef>
+#include <iterator>
+#include <string>
+
+namespace pammap {
+
+/** Iterator over the names of the direct children of a path in a PamMap.
+ *
+ * A child is every name ``c``, such that either ``path + "/" + c`` is a key
+ * or there are keys below ``path + "/" + c``. Each child is reported once
+ * and in the order of the keys in the map.
+ *
+ * Since the keys of a subtree are contiguous in the container, incrementing
+ * the iterator seeks past the full subtree of the current child. Hence the cost
+ * of enumerating the children only depends on their number and not on the number
+ * of keys further below.
+ */
+class PamMapChildIterator {
+ public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef std::string value_type;
+  typedef ptrdiff_t difference_type;
+  typedef const std::string* pointer;
+  typedef const std::string& reference;
+
+  typedef PamMapIterator<true>::map_type map_type;
+
+  /** Name of the current child */
+  const std::string& operator*() const { return m_child; }
+
+  /** Pointer to the name of the current child */
+  const std::string* operator->() const { return &m_child; }
+
+  /** Prefix increment to the next child */
+  PamMapChildIterator& operator++() {
+    // Seek to the first key past the subtree of the current child
+    const bool past_subtree = true;
+    m_iter = m_map->lower_bound(m_iter->first.prefix(m_depth + 1, past_subtree));
+    update_child();
+    return *this;
+  }
+
+  /** Postfix increment to the next child */
+  PamMapChildIterator operator++(int) {
+    PamMapChildIterator copy(*this);
+    this->operator++();
+    return copy;
+  }
+
+  bool operator==(const PamMapChildIterator& other) const {
+    return m_iter == other.m_iter;
+  }
+  bool operator!=(const PamMapChildIterator& other) const {
+    return m_iter != other.m_iter;
+  }
+
+  /** Construct an iterator over the children of a full path.
+   *
+   * \param map    The container to iterate over
+   * \param iter   The key to start with (strictly below the full path)
+   * \param end    The end of the subtree below the full path
+   * \param path   The full path
+   */
+  PamMapChildIterator(const map_type& map, map_type::const_iterator iter,
+                      map_type::const_iterator end, const std::string& path)
+        : m_map(&map),
+          m_iter(iter),
+          m_end(end),
+          m_depth(map_type::depth(path)),
+          m_child() {
+    update_child();
+  }
+
+  PamMapChildIterator() : m_map(nullptr), m_iter(), m_end(), m_depth(0), m_child() {}
+
+ private:
+  /** Extract the child name from the key m_iter points to */
+  void update_child() {
+    if (m_iter == m_end) {
+      m_child.clear();
+      return;
+    }
+    const InternedKey& key = m_iter->first;
+    pammap_assert(key.size() > m_depth);
+    m_child = m_map->table().str(key[m_depth]);
+  }
+
+  /** The map we iterate over */
+  const map_type* m_map;
+
+  /** Iterator to the first key of the current child's subtree */
+  map_type::const_iterator m_iter;
+
+  /** Iterator past the subtree we enumerate the children of */
+  map_type::const_iterator m_end;
+
+  /** Number of components of the parent path */
+  size_t m_depth;
+
+  /** Name of the current child */
+  std::string m_child;
+};
+
+}  // namespace pammap
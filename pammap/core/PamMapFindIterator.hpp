@@ -0,0 +1,200 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "GlobPattern.hpp"
+#include "PamMapIterator.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+namespace pammap {
+
+/** Iterator over all keys of a PamMap matching a GlobPattern.
+ *
+ * The iterator exploits that the keys of the map are sorted such that
+ * subtrees are contiguous (see InternedKeyLess): As soon as a prefix of a key
+ * can no longer lead to a match, it seeks past the full subtree of this
+ * prefix. If the pattern only allows a single literal component next,
+ * it seeks directly to it. Hence only a small part of the map is visited
+ * if the pattern starts with literal components.
+ *
+ * Dereferencing yields the same accessors as PamMapIterator.
+ */
+template <bool Const>
+class PamMapFindIterator {
+ public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef PamMapAccessor<Const> value_type;
+  typedef ptrdiff_t difference_type;
+  typedef PamMapAccessor<Const>* pointer;
+  typedef PamMapAccessor<Const>& reference;
+
+  typedef typename PamMapIterator<Const>::map_type map_type;
+  typedef typename PamMapIterator<Const>::inner_iter_type inner_iter_type;
+  typedef typename std::conditional<Const, const map_type, map_type>::type
+        container_type;
+
+  /** Dereference to the accessor of the current key */
+  PamMapAccessor<Const>& operator*() const { return *m_current; }
+
+  /** Obtain pointer to the accessor of the current key */
+  PamMapAccessor<Const>* operator->() const { return m_current.operator->(); }
+
+  /** Prefix increment to the next matching key */
+  PamMapFindIterator& operator++() {
+    ++m_iter;
+    seek_match();
+    return *this;
+  }
+
+  /** Postfix increment to the next matching key */
+  PamMapFindIterator operator++(int) {
+    PamMapFindIterator copy(*this);
+    this->operator++();
+    return copy;
+  }
+
+  bool operator==(const PamMapFindIterator& other) const {
+    return m_iter == other.m_iter;
+  }
+  bool operator!=(const PamMapFindIterator& other) const {
+    return m_iter != other.m_iter;
+  }
+
+  /** Construct an iterator, which visits all keys of a subtree, which match
+   *  the pattern relative to the subtree location
+   *
+   * \param map       The container
+   * \param begin     The iterator to start from (a key inside the subtree)
+   * \param end       The end of the subtree
+   * \param pattern   The compiled pattern
+   * \param location  Full path of the subtree (keys are matched relative to it)
+   */
+  PamMapFindIterator(container_type& map, inner_iter_type begin, inner_iter_type end,
+                     std::shared_ptr<const GlobPattern> pattern, std::string location)
+        : m_map(&map),
+          m_iter(begin),
+          m_end(end),
+          m_pattern(std::move(pattern)),
+          m_location(std::move(location)),
+          m_depth(map_type::depth(m_location)),
+          m_current() {
+    seek_match();
+  }
+
+  PamMapFindIterator()
+        : m_map(nullptr), m_iter(), m_end(), m_pattern(), m_location(), m_depth(0) {}
+
+ private:
+  /** Advance m_iter until it points to a matching key or m_end */
+  void seek_match();
+
+  /** The container */
+  container_type* m_map;
+
+  /** The current position and the end of the subtree */
+  inner_iter_type m_iter;
+  inner_iter_type m_end;
+
+  /** The pattern we match against */
+  std::shared_ptr<const GlobPattern> m_pattern;
+
+  /** Subtree location relative to which keys are matched */
+  std::string m_location;
+
+  /** Number of components of the subtree location */
+  size_t m_depth;
+
+  /** Iterator providing accessor to the current key */
+  PamMapIterator<Const> m_current;
+};
+
+/** Simple range of iterators to be used in range-based for loops */
+template <typename Iterator>
+class IteratorRange {
+ public:
+  IteratorRange(Iterator begin, Iterator end)
+        : m_begin(std::move(begin)), m_end(std::move(end)) {}
+  Iterator begin() const { return m_begin; }
+  Iterator end() const { return m_end; }
+
+ private:
+  Iterator m_begin;
+  Iterator m_end;
+};
+
+//
+// -----------------------------------------------
+//
+
+template <bool Const>
+void PamMapFindIterator<Const>::seek_match() {
+  const GlobPattern& pattern  = *m_pattern;
+  const ComponentTable& table = m_map->table();
+  const InternedKeyLess less  = m_map->key_comp();
+
+  while (m_iter != m_end) {
+    const InternedKey& key = m_iter->first;
+    pammap_assert(key.size() >= m_depth);
+
+    // Match the key component by component.
+    GlobPattern::state_type state = pattern.initial_state();
+    bool seeked                   = false;
+    for (size_t i = m_depth; i < key.size(); ++i) {
+      const std::string& component = table.str(key[i]);
+      GlobPattern::state_type next = pattern.advance(state, component);
+      if (next == 0) {
+        // Nothing below the first i + 1 components can match. If the pattern
+        // requires a single literal which would come later, jump to it
+        // directly. Else skip all keys starting with the first i + 1 components
+        // or all remaining keys of the parent if nothing of it could match
+        // anymore (which includes the case that the literal is no component
+        // of any key).
+        const std::string* literal = pattern.sole_literal(state);
+        const ComponentTable::id_type literal_id =
+              literal == nullptr ? ComponentTable::npos : table.find(*literal);
+        if (literal_id != ComponentTable::npos && component < *literal) {
+          m_iter = m_map->lower_bound(key.prefix(i).append(literal_id));
+        } else if (literal != nullptr) {
+          m_iter = m_map->lower_bound(key.prefix(i, /* past_subtree = */ true));
+        } else {
+          m_iter = m_map->lower_bound(key.prefix(i + 1, /* past_subtree = */ true));
+        }
+
+        // Never leave the subtree we iterate over
+        if (m_iter != m_end && m_end != m_map->end() &&
+            !less(m_iter->first, m_end->first)) {
+          m_iter = m_end;
+        }
+        seeked = true;
+        break;
+      }
+      state = next;
+    }
+
+    if (seeked) continue;
+    if (pattern.is_match(state)) break;
+    ++m_iter;
+  }
+
+  m_current = PamMapIterator<Const>(m_iter, *m_map, m_location);
+}
+
+}  // namespace pammap
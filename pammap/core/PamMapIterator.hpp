@@ -18,10 +18,10 @@
 //
 
 #pragma once
+#include "InternedKeyMap.hpp"
 #include "PamMapAccessor.hpp"
 #include "exceptions.hpp"
 #include <iterator>
-#include <map>
 #include <memory>
 #include <type_traits>
 
@@ -32,12 +32,16 @@ class PamMapIterator
       : std::iterator<std::bidirectional_iterator_tag, PamMapAccessor<Const>> {
  public:
   /** The map type we assume */
-  typedef typename std::map<std::string, PamMapValue> map_type;
+  typedef InternedKeyMap map_type;
 
   /** The resulting inner iterator type */
   typedef typename std::conditional<Const, typename map_type::const_iterator,
                                     typename map_type::iterator>::type inner_iter_type;
 
+  /** The map as seen by the iterator */
+  typedef typename std::conditional<Const, const map_type, map_type>::type
+        container_type;
+
   /** Dereference PamMap iterator */
   PamMapAccessor<Const>& operator*() const { return *operator->(); }
 
@@ -78,15 +82,34 @@ class PamMapIterator
   /** Explicit conversion to the inner iterator type */
   explicit operator inner_iter_type() { return m_iter; }
 
-  PamMapIterator(inner_iter_type iter, std::string location)
-        : m_acc_ptr(nullptr), m_iter(iter), m_location(std::move(location)) {}
+  /** Construct from an iterator into the map and the full path
+   *  of the subtree location relative to which keys are reported */
+  PamMapIterator(inner_iter_type iter, container_type& map, const std::string& location)
+        : m_acc_ptr(nullptr),
+          m_iter(iter),
+          m_map(&map),
+          m_depth(map_type::depth(location)) {}
 
-  PamMapIterator() : m_acc_ptr(nullptr), m_iter(), m_location() {}
+  PamMapIterator() : m_acc_ptr(nullptr), m_iter(), m_map(nullptr), m_depth(0) {}
 
  private:
   /** Undo the operation of PamMap::make_full_key, i.e. strip off the
-   * first location part and get a relative path to it*/
-  std::string strip_location_prefix(const std::string& key) const;
+   * location components and get a relative path to it*/
+  std::string strip_location_prefix(const InternedKey& key) const;
+
+  //@{
+  /** Build the accessor to a value of the map */
+  static std::shared_ptr<PamMapAccessor<true>> make_accessor(std::string key,
+                                                             const PamMapValue& value,
+                                                             const map_type&) {
+    return std::make_shared<PamMapAccessor<true>>(std::move(key), value);
+  }
+  static std::shared_ptr<PamMapAccessor<false>> make_accessor(std::string key,
+                                                              PamMapValue& value,
+                                                              map_type& map) {
+    return std::make_shared<PamMapAccessor<false>>(std::move(key), value, map);
+  }
+  //@}
 
   /** Cache for the accessor of the current value.
    *  A stored nullptr implies that the accessor needs to rebuild
@@ -96,8 +119,11 @@ class PamMapIterator
   /** Iterator to the current key,value pair */
   inner_iter_type m_iter;
 
-  /** Subtree location we iterate over */
-  std::string m_location;
+  /** The map we iterate over (to translate the keys and note replacements) */
+  container_type* m_map;
+
+  /** Number of components of the subtree location we iterate over */
+  size_t m_depth;
 };
 
 //
@@ -108,26 +134,22 @@ template <bool Const>
 PamMapAccessor<Const>* PamMapIterator<Const>::operator->() const {
   if (m_acc_ptr == nullptr) {
     // Generate accessor for current state
-    const std::string key_stripped = strip_location_prefix(m_iter->first);
-    m_acc_ptr = std::make_shared<PamMapAccessor<Const>>(key_stripped, m_iter->second);
+    std::string key_stripped = strip_location_prefix(m_iter->first);
+    m_acc_ptr = make_accessor(std::move(key_stripped), m_iter->second, *m_map);
   }
 
   return m_acc_ptr.get();
 }
 
 template <bool Const>
-std::string PamMapIterator<Const>::strip_location_prefix(const std::string& key) const {
-  // The first part needs to be exactly the location:
-  pammap_assert(key.size() >= m_location.size());
-  pammap_assert(0 == key.compare(0, m_location.size(), m_location));
+std::string PamMapIterator<Const>::strip_location_prefix(const InternedKey& key) const {
+  // The key needs to be in the subtree at the location:
+  pammap_assert(key.size() >= m_depth);
 
-  if (key.size() <= m_location.size()) {
+  if (key.size() == m_depth) {
     return "/";
   } else {
-    std::string res = key.substr(m_location.size());
-    pammap_assert(res[0] == '/' || res.length() == 0);
-    pammap_assert(res.back() != '/');
-    return res;
+    return m_map->key_string(key, m_depth);
   }
 }
 
@@ -0,0 +1,53 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PamMapOverride.hpp"
+
+namespace pammap {
+namespace detail {
+thread_local PamMapOverride* override_top = nullptr;
+}  // namespace detail
+
+PamMapOverride::PamMapOverride(const PamMap& map)
+      : m_map{map, "/"}, m_entries{}, m_previous{detail::override_top} {
+  detail::override_top = this;
+}
+
+PamMapOverride::~PamMapOverride() {
+  // Unlink ourselves from the stack of layers. Usually we are the top,
+  // but be forgiving if guards are destroyed out of order.
+  PamMapOverride** link = &detail::override_top;
+  while (*link != nullptr && *link != this) link = &(*link)->m_previous;
+  if (*link == this) *link = m_previous;
+}
+
+PamMapValue* PamMapOverride::find(const PamMap::map_type* container,
+                                  const std::string& full_key) {
+  // Walk from the innermost to the outermost layer
+  for (PamMapOverride* layer = detail::override_top; layer != nullptr;
+       layer = layer->m_previous) {
+    if (layer->m_map.m_container_ptr.get() != container) continue;
+
+    auto itkey = layer->m_entries.find(full_key);
+    if (itkey != std::end(layer->m_entries)) return &itkey->second;
+  }
+  return nullptr;
+}
+
+}  // namespace pammap
@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "PamMap.hpp"
+
+namespace pammap {
+
+/** RAII guard which installs a thread-local override layer on top of a PamMap.
+ *
+ * While the guard is alive, all lookups via ``at``, ``at_raw_value`` and ``exists``,
+ * which are issued from the thread that constructed the guard, first consult the
+ * entries of the override layer and only then the shared container.
+ * This affects all PamMap objects sharing the container of the map passed upon
+ * construction (i.e. the map itself and all its submaps), but neither deep copies
+ * nor other threads. Since the layer is only visible to its own thread, no
+ * synchronisation between threads is needed.
+ *
+ * Example:
+ * ```
+ * PamMap shared{{"solver/tol", 1e-6}, {"seed", 0}};
+ *
+ * // In each worker thread:
+ * PamMapOverride local(shared);
+ * local.update("seed", worker_id);
+ * run(shared);  // Sees its own seed, but the shared tolerance
+ * ```
+ *
+ * Layers may be nested, in which case the innermost layer takes precedence.
+ * A guard needs to be destroyed on the thread it was created on.
+ *
+ * \note Updates, erasures and iteration always act on the shared container
+ *       and are not affected by override layers. Without any active layer in a
+ *       thread the lookup costs just an extra check of a thread-local pointer.
+ */
+class PamMapOverride {
+ public:
+  /** Push a new, empty override layer for the container of the given map.
+   *  Keys passed to ``update`` are interpreted relative to the location of
+   *  ``map``. */
+  explicit PamMapOverride(const PamMap& map);
+
+  /** Push a new override layer and fill it with the given entries */
+  PamMapOverride(const PamMap& map, std::initializer_list<PamMap::entry_type> il)
+        : PamMapOverride(map) {
+    update(il);
+  }
+
+  /** Pop the override layer again */
+  ~PamMapOverride();
+
+  PamMapOverride(const PamMapOverride&) = delete;
+  PamMapOverride& operator=(const PamMapOverride&) = delete;
+
+  /** Insert or update a key in this override layer */
+  void update(const std::string& key, PamMapValue e) {
+    m_entries[m_map.make_full_key(key)] = std::move(e);
+  }
+
+  /** Insert or update many keys in this override layer */
+  void update(std::initializer_list<PamMap::entry_type> il) {
+    for (PamMap::entry_type t : il) update(t.first, std::move(t.second));
+  }
+
+  /** Remove a key from this override layer, such that the shared value
+   *  (or the value of an enclosing layer) becomes visible again.
+   *
+   *  \return The number of removed elements (i.e. 0 or 1)
+   */
+  size_t erase(const std::string& key) {
+    return m_entries.erase(m_map.make_full_key(key));
+  }
+
+  /** Check whether a key is overridden by this layer */
+  bool exists(const std::string& key) const {
+    return m_entries.count(m_map.make_full_key(key)) > 0;
+  }
+
+ private:
+  friend class PamMap;
+
+  /** Search all layers active in this thread, which refer to the
+   *  given container, for a full key. Returns nullptr if not found. */
+  static PamMapValue* find(const PamMap::map_type* container,
+                           const std::string& full_key);
+
+  /** Shallow view to the map we override keys in */
+  PamMap m_map;
+
+  /** The overridden entries (using full keys) */
+  std::map<std::string, PamMapValue> m_entries;
+
+  /** The next outer layer active in this thread */
+  PamMapOverride* m_previous;
+};
+
+}  // namespace pammap
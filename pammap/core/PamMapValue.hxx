@@ -23,9 +23,15 @@
 // Instead edit the script and rerun it.
 //
 #pragma once
+#include "Array.hpp"
 #include "ArrayView.hpp"
+#include "BitArray.hpp"
+#include "ChunkedArray.hpp"
 #include "IsSupportedType.hxx"
+#include "SparseMatrixView.hpp"
+#include "StringArray.hpp"
 #include "any.hpp"
+#include "demangle.hpp"
 #include "typedefs.hxx"
 
 namespace pammap {
@@ -77,6 +83,96 @@ class PamMapValue : public any {
   /** Construction from ArrayView<Bool> */
   PamMapValue(ArrayView<Bool> val) : any(std::move(val)) {}
 
+  /** Construction from ArrayView<Float32> */
+  PamMapValue(ArrayView<Float32> val) : any(std::move(val)) {}
+
+  /** Construction from ArrayView<Complex64> */
+  PamMapValue(ArrayView<Complex64> val) : any(std::move(val)) {}
+
+  /** Construction from ArrayView<Integer32> */
+  PamMapValue(ArrayView<Integer32> val) : any(std::move(val)) {}
+
+  /** Construction from ArrayView<Integer8> */
+  PamMapValue(ArrayView<Integer8> val) : any(std::move(val)) {}
+
+  /** Construction from ArrayView<Unsigned8> */
+  PamMapValue(ArrayView<Unsigned8> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Integer> */
+  PamMapValue(Array<Integer> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Float> */
+  PamMapValue(Array<Float> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Complex> */
+  PamMapValue(Array<Complex> val) : any(std::move(val)) {}
+
+  /** Construction from Array<String> */
+  PamMapValue(Array<String> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Bool> */
+  PamMapValue(Array<Bool> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Float32> */
+  PamMapValue(Array<Float32> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Complex64> */
+  PamMapValue(Array<Complex64> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Integer32> */
+  PamMapValue(Array<Integer32> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Integer8> */
+  PamMapValue(Array<Integer8> val) : any(std::move(val)) {}
+
+  /** Construction from Array<Unsigned8> */
+  PamMapValue(Array<Unsigned8> val) : any(std::move(val)) {}
+
+  /** Construction from BitArrayView */
+  PamMapValue(BitArrayView val) : any(std::move(val)) {}
+
+  /** Construction from BitArray */
+  PamMapValue(BitArray val) : any(std::move(val)) {}
+
+  /** Construction from StringArrayView */
+  PamMapValue(StringArrayView val) : any(std::move(val)) {}
+
+  /** Construction from StringArray */
+  PamMapValue(StringArray val) : any(std::move(val)) {}
+
+  /** Construction from CsrMatrixView<Float, Integer32> */
+  PamMapValue(CsrMatrixView<Float, Integer32> val) : any(std::move(val)) {}
+
+  /** Construction from CsrMatrixView<Float, Integer> */
+  PamMapValue(CsrMatrixView<Float, Integer> val) : any(std::move(val)) {}
+
+  /** Construction from CsrMatrixView<Complex, Integer32> */
+  PamMapValue(CsrMatrixView<Complex, Integer32> val) : any(std::move(val)) {}
+
+  /** Construction from CsrMatrixView<Complex, Integer> */
+  PamMapValue(CsrMatrixView<Complex, Integer> val) : any(std::move(val)) {}
+
+  /** Construction from CooMatrixView<Float, Integer32> */
+  PamMapValue(CooMatrixView<Float, Integer32> val) : any(std::move(val)) {}
+
+  /** Construction from CooMatrixView<Float, Integer> */
+  PamMapValue(CooMatrixView<Float, Integer> val) : any(std::move(val)) {}
+
+  /** Construction from CooMatrixView<Complex, Integer32> */
+  PamMapValue(CooMatrixView<Complex, Integer32> val) : any(std::move(val)) {}
+
+  /** Construction from CooMatrixView<Complex, Integer> */
+  PamMapValue(CooMatrixView<Complex, Integer> val) : any(std::move(val)) {}
+
+  /** Construction from ChunkedArray<Float> */
+  PamMapValue(ChunkedArray<Float> val) : any(std::move(val)) {}
+
+  /** Construction from ChunkedArray<Complex> */
+  PamMapValue(ChunkedArray<Complex> val) : any(std::move(val)) {}
+
+  /** Construction from ChunkedArray<Integer> */
+  PamMapValue(ChunkedArray<Integer> val) : any(std::move(val)) {}
+
   //
   // The int type gets special treatment because it is the default for raw numbers
   //
@@ -91,8 +187,21 @@ class PamMapValue : public any {
    *  This behaves like the equivalent GenMapValue of a std::string */
   PamMapValue(const char* s) : PamMapValue(std::string(s)) {}
 
-  /** Return the demangled typename of the type of the internal object. */
-  std::string type_name() const;
+  /** Return the typename of the type of the internal object,
+   *  i.e. the demangled name or the name given by TypeName. */
+  std::string type_name() const {
+    if (type() == typeid(ArrayView<Integer>)) return TypeName<ArrayView<Integer>>::get();
+    if (type() == typeid(ArrayView<Float>)) return TypeName<ArrayView<Float>>::get();
+    if (type() == typeid(ArrayView<Complex>)) return TypeName<ArrayView<Complex>>::get();
+    if (type() == typeid(ArrayView<String>)) return TypeName<ArrayView<String>>::get();
+    if (type() == typeid(ArrayView<Bool>)) return TypeName<ArrayView<Bool>>::get();
+    if (type() == typeid(ArrayView<Float32>)) return TypeName<ArrayView<Float32>>::get();
+    if (type() == typeid(ArrayView<Complex64>)) return TypeName<ArrayView<Complex64>>::get();
+    if (type() == typeid(ArrayView<Integer32>)) return TypeName<ArrayView<Integer32>>::get();
+    if (type() == typeid(ArrayView<Integer8>)) return TypeName<ArrayView<Integer8>>::get();
+    if (type() == typeid(ArrayView<Unsigned8>)) return TypeName<ArrayView<Unsigned8>>::get();
+    return demangle(type());
+  }
 };
 
 }  // namespace pammap
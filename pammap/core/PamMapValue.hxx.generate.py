@@ -30,9 +30,15 @@ def generate():
     output = licence_header_cpp(__file__)
     output += [
         r"#pragma once",
+        r'#include "Array.hpp"',
         r'#include "ArrayView.hpp"',
+        r'#include "BitArray.hpp"',
+        r'#include "ChunkedArray.hpp"',
         r'#include "IsSupportedType.hxx"',
+        r'#include "SparseMatrixView.hpp"',
+        r'#include "StringArray.hpp"',
         r'#include "any.hpp"',
+        r'#include "demangle.hpp"',
         r'#include "typedefs.hxx"',
     ]
     output += NAMESPACE_OPEN
@@ -88,11 +94,22 @@ def generate():
     """)
     output.append("")
 
-    # Add type_name() method
-    output += clean_block(r"""
-      /** Return the demangled typename of the type of the internal object. */
-      std::string type_name() const;
-    """)
+    # Add type_name() method, which names the ArrayViews without their rank
+    output += [
+        "  /** Return the typename of the type of the internal object,",
+        "   *  i.e. the demangled name or the name given by TypeName. */",
+        "  std::string type_name() const {",
+    ]
+    for cpptype in make_supported_cpp_types(constants.DTYPES):
+        if cpptype.startswith("ArrayView<"):
+            output += [
+                "    if (type() == typeid(" + cpptype + ")) return TypeName<" + cpptype +
+                ">::get();"
+            ]
+    output += [
+        "    return demangle(type());",
+        "  }",
+    ]
 
     # Close class and namespace
     output += ["};"]
@@ -74,6 +74,9 @@ std::ostream& operator<<(std::ostream& o, const Slice& s) {
 }
 
 std::string to_string(const Slice& s) {
+  if (s.kind == Slice::NEWAXIS) return "NewAxis";
+  if (s.kind == Slice::INDEX) return std::to_string(s.begin);
+
   std::stringstream ss;
   ss << "(";
   if (s.begin == Auto) {
@@ -29,6 +29,16 @@ static constexpr size_t Auto = static_cast<size_t>(-1);
 
 /** Class defining slicing along a particular axis. */
 struct Slice {
+  /** The kind of slicing operation */
+  enum Kind {
+    /** Select a range of indices, keeping the axis */
+    RANGE = 0,
+    /** Select a single index, dropping the axis */
+    INDEX = 1,
+    /** Insert a new axis of length one */
+    NEWAXIS = 2,
+  };
+
   ///@{
   /** Construct a slice
    *
@@ -42,6 +52,21 @@ struct Slice {
   Slice() : begin(Auto), end(Auto), step(1) {}
   ///@}
 
+  /** Construct a slice selecting a single index and dropping the axis,
+   *  unlike Slice(i), which selects the range {i} and keeps the axis. */
+  static Slice index(size_t i) {
+    Slice ret(i);
+    ret.kind = INDEX;
+    return ret;
+  }
+
+  /** Construct a slice inserting a new axis of length one */
+  static Slice new_axis() {
+    Slice ret;
+    ret.kind = NEWAXIS;
+    return ret;
+  }
+
   /** Assuming an extent of length len, compute the start and stop
    *  indices as well as the stride length of the slice described by
    *  this object.
@@ -58,11 +83,15 @@ struct Slice {
   size_t begin;
   size_t end;
   ptrdiff_t step;
+  Kind kind = RANGE;
 };
 
 /** Special Slice, which selects all members along a particular axis */
 const Slice All{Auto, Auto, 1};
 
+/** Special Slice, which inserts a new axis of length one */
+const Slice NewAxis = Slice::new_axis();
+
 std::ostream& operator<<(std::ostream& o, const Slice& s);
 
 /** Transform slice into a human readable string */
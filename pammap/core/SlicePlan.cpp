@@ -0,0 +1,120 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SlicePlan.hpp"
+#include "exceptions.hpp"
+#include <algorithm>
+#include <string>
+#include <tuple>
+
+namespace pammap {
+
+namespace {
+/** Resolve a range slice along an axis of length len like numpy does: begin
+ *  and end are clipped to the axis, such that ranges reaching beyond it are
+ *  shortened and ranges outside of it are empty. Returns the first index,
+ *  the step and the number of selected elements. */
+std::tuple<ptrdiff_t, ptrdiff_t, size_t> resolve_range(const Slice& sl, size_t len) {
+  const auto plen = static_cast<ptrdiff_t>(len);
+  const auto clip = [](size_t idx, ptrdiff_t upper) {
+    return idx > static_cast<size_t>(upper) ? upper : static_cast<ptrdiff_t>(idx);
+  };
+
+  ptrdiff_t begin, end;
+  if (sl.step > 0) {
+    begin = sl.begin == Auto ? 0 : clip(sl.begin, plen);
+    end   = sl.end == Auto ? plen : clip(sl.end, plen);
+  } else {
+    begin = sl.begin == Auto ? plen - 1 : clip(sl.begin, plen - 1);
+    end   = sl.end == Auto ? -1 : clip(sl.end, plen - 1);
+  }
+
+  // Number of elements selected: ceil((end - begin) / step)
+  const ptrdiff_t step  = sl.step;
+  const ptrdiff_t count = step > 0 ? (end - begin + step - 1) / step
+                                   : (begin - end - step - 1) / (-step);
+  if (count <= 0) return std::make_tuple(ptrdiff_t(0), step, size_t(0));
+  return std::make_tuple(begin, step, static_cast<size_t>(count));
+}
+}  // namespace
+
+SlicePlan::SlicePlan(const Slice* slices, size_t n_slices, const size_t* shape,
+                     size_t ndim)
+      : m_source_ndim(ndim) {
+  pammap_throw(ndim <= max_dynamic_rank, ValueError,
+               "Number of dimensions (== " + std::to_string(ndim) +
+                     ") exceeds the maximal number of dimensions of an ArrayView (== " +
+                     std::to_string(max_dynamic_rank) + ").");
+  std::copy(shape, shape + ndim, m_source_shape.begin());
+
+  size_t d = 0;  // Next dimension of the source
+  for (const Slice* sl = slices; sl != slices + n_slices; ++sl) {
+    pammap_throw(m_ndim < max_dynamic_rank || sl->kind == Slice::INDEX, ValueError,
+                 "Slicing results in more than " + std::to_string(max_dynamic_rank) +
+                       " dimensions.");
+    if (sl->kind == Slice::NEWAXIS) {
+      m_shape[m_ndim] = 1;
+      m_axis[m_ndim]  = new_axis;
+      ++m_ndim;
+      continue;
+    }
+
+    pammap_throw(d < ndim, IndexError,
+                 "More slice objects provided to 'slice()' than the ArrayView has "
+                 "dimensions (== " +
+                       std::to_string(ndim) + ").");
+    if (sl->kind == Slice::INDEX) {
+      pammap_throw(sl->begin < shape[d], IndexError,
+                   "Index " + std::to_string(sl->begin) + " out of range for axis " +
+                         std::to_string(d) + " of length " + std::to_string(shape[d]) +
+                         ".");
+      m_begin[d] = static_cast<ptrdiff_t>(sl->begin);
+      ++d;
+      continue;
+    }
+
+    ptrdiff_t begin, step;
+    size_t count;
+    std::tie(begin, step, count) = resolve_range(*sl, shape[d]);
+
+    m_begin[d]      = begin;
+    m_shape[m_ndim] = count;
+    m_axis[m_ndim]  = static_cast<unsigned char>(d);
+    m_step[m_ndim]  = step;
+    ++m_ndim;
+    ++d;
+  }
+
+  // The remaining dimensions are taken in full
+  for (; d < ndim; ++d, ++m_ndim) {
+    pammap_throw(m_ndim < max_dynamic_rank, ValueError,
+                 "Slicing results in more than " + std::to_string(max_dynamic_rank) +
+                       " dimensions.");
+    m_shape[m_ndim] = shape[d];
+    m_axis[m_ndim]  = static_cast<unsigned char>(d);
+    m_step[m_ndim]  = 1;
+  }
+}
+
+bool SlicePlan::applies_to(span<const size_t> shape) const {
+  return shape.size() == m_source_ndim &&
+         std::equal(shape.begin(), shape.end(), m_source_shape.begin());
+}
+
+}  // namespace pammap
@@ -0,0 +1,108 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "Slice.hpp"
+#include "dynamic_rank.hpp"
+#include "span.hpp"
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace pammap {
+
+/** A sequence of Slice objects compiled for arrays of a particular shape.
+ *
+ * Indices are checked and ranges clipped to the shape once on construction,
+ * such that applying the plan to an ArrayView of this shape (see
+ * ArrayView::slice) only needs to combine the precomputed offsets and steps
+ * with the strides of the view. This pays off if the same slices are taken from many arrays
+ * of the same shape:
+ * ```
+ * const SlicePlan plan({Slice(1, 9, 2), Slice::index(0)}, {10, 3});
+ * for (const Array<Float>& array : arrays) process(array.view().slice(plan));
+ * ```
+ * The semantics of the slices are the same as for
+ * ArrayView::slice(std::initializer_list<Slice>).
+ */
+class SlicePlan {
+ public:
+  ///@{
+  /** Compile the slices for arrays of the given shape.
+   *
+   * Throws a ValueError if the result has more than max_dynamic_rank
+   * dimensions and an IndexError if more slices than dimensions are given
+   * or a Slice::index is out of range. The bounds of ranges are clipped
+   * to the shape as in numpy.
+   */
+  SlicePlan(std::initializer_list<Slice> slices, const std::vector<size_t>& shape)
+        : SlicePlan(slices.begin(), slices.size(), shape.data(), shape.size()) {}
+  SlicePlan(const Slice* slices, size_t n_slices, const size_t* shape, size_t ndim);
+  ///@}
+
+  /** The shape of the arrays the plan applies to */
+  span<const size_t> source_shape() const {
+    return {m_source_shape.data(), m_source_ndim};
+  }
+
+  /** Does the plan apply to arrays of the given shape */
+  bool applies_to(span<const size_t> shape) const;
+
+  /** The number of dimensions of the slice */
+  size_t ndim() const { return m_ndim; }
+
+  /** The shape of the slice */
+  span<const size_t> shape() const { return {m_shape.data(), m_ndim}; }
+
+  /** The offset of the first element of the slice into an array with the
+   *  given strides (in units of elements) */
+  ptrdiff_t offset(const ptrdiff_t* source_strides) const {
+    ptrdiff_t ret = 0;
+    for (size_t d = 0; d < m_source_ndim; ++d) ret += m_begin[d] * source_strides[d];
+    return ret;
+  }
+
+  /** Compute the strides of the slice into an array with the given strides */
+  void strides(const ptrdiff_t* source_strides, ptrdiff_t* out) const {
+    for (size_t k = 0; k < m_ndim; ++k) {
+      out[k] = m_axis[k] == new_axis ? 0 : m_step[k] * source_strides[m_axis[k]];
+    }
+  }
+
+ private:
+  /** Marker in m_axis for axes inserted by NewAxis */
+  static constexpr unsigned char new_axis = 0xff;
+
+  size_t m_source_ndim = 0;
+  std::array<size_t, max_dynamic_rank> m_source_shape{};
+
+  /** Index of the first selected element along each axis of the source */
+  std::array<ptrdiff_t, max_dynamic_rank> m_begin{};
+
+  size_t m_ndim = 0;
+  std::array<size_t, max_dynamic_rank> m_shape{};
+
+  /** The axis of the source for each axis of the slice (or new_axis)
+   *  and the step along it */
+  std::array<unsigned char, max_dynamic_rank> m_axis{};
+  std::array<ptrdiff_t, max_dynamic_rank> m_step{};
+};
+
+}  // namespace pammap
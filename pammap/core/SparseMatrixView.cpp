@@ -0,0 +1,185 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SparseMatrixView.hpp"
+#include "ThreadPool.hpp"
+#include "parallel.hpp"
+
+namespace pammap {
+namespace {
+
+/** A dense vector or matrix operand of a sparse product */
+template <typename T>
+struct Dense {
+  T* data;
+
+  /** Stride between rows and between columns (zero for a vector) */
+  ptrdiff_t row_stride;
+  ptrdiff_t col_stride;
+
+  /** Number of columns (one for a vector) */
+  size_t n_cols;
+
+  template <typename U>
+  Dense(T* data_, const ArrayView<U>& view)
+        : data(data_),
+          row_stride(view.strides()[0]),
+          col_stride(view.ndim() == 2 ? view.strides()[1] : 0),
+          n_cols(view.ndim() == 2 ? view.shape()[1] : 1) {}
+
+  /** Pointer to the first element of a row */
+  T* row(ptrdiff_t i) const { return data + i * row_stride; }  // NOLINT
+};
+
+/** Check the shapes of the operands of a product with a matrix of the
+ *  given size */
+template <typename T>
+void check_operands(size_t n_rows, size_t n_cols, const ArrayView<T>& x,
+                    const ArrayView<T>& y) {
+  pammap_throw((x.ndim() == 1 || x.ndim() == 2) && x.ndim() == y.ndim(), ValueError,
+               "The dense operands of a sparse product need to be both vectors or both "
+               "matrices.");
+  pammap_throw(x.shape()[0] == n_cols && y.shape()[0] == n_rows, ValueError,
+               "The dense operands of a sparse product have " +
+                     std::to_string(x.shape()[0]) + " and " +
+                     std::to_string(y.shape()[0]) + " rows, but " +
+                     std::to_string(n_cols) + " and " + std::to_string(n_rows) +
+                     " were expected.");
+  pammap_throw(x.ndim() == 1 || x.shape()[1] == y.shape()[1], ValueError,
+               "The dense operands of a sparse product need to have the same number "
+               "of columns.");
+}
+
+/** Set a row of ``y`` to ``beta`` times itself (or zero if beta is zero) */
+template <typename T>
+void scale_row(T* yi, const Dense<T>& y, T beta) {
+  for (size_t j = 0; j < y.n_cols; ++j) {
+    T& elem = yi[static_cast<ptrdiff_t>(j) * y.col_stride];  // NOLINT
+    elem    = beta == T(0) ? T(0) : beta * elem;
+  }
+}
+
+/** Process the rows ``[begin, end)`` of a CSR product */
+template <typename T, typename Index>
+void csr_rows(const CsrMatrixView<T, Index>& matrix, const Dense<const T>& x,
+              const Dense<T>& y, T alpha, T beta, size_t begin, size_t end) {
+  const Index* indptr  = matrix.indptr().data();
+  const Index* indices = matrix.indices().data();
+  const T* values      = matrix.data().data();
+
+  for (size_t i = begin; i < end; ++i) {
+    T* yi = y.row(static_cast<ptrdiff_t>(i));
+    if (y.n_cols == 1) {
+      T acc = T(0);
+      for (ptrdiff_t p = indptr[i]; p < indptr[i + 1]; ++p) {
+        acc += values[p] * *x.row(indices[p]);
+      }
+      *yi = beta == T(0) ? alpha * acc : alpha * acc + beta * *yi;
+    } else {
+      scale_row(yi, y, beta);
+      for (ptrdiff_t p = indptr[i]; p < indptr[i + 1]; ++p) {
+        const T factor = alpha * values[p];
+        const T* xr    = x.row(indices[p]);
+        for (size_t j = 0; j < y.n_cols; ++j) {
+          const ptrdiff_t sj = static_cast<ptrdiff_t>(j);
+          yi[sj * y.col_stride] += factor * xr[sj * x.col_stride];  // NOLINT
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T, typename Index>
+void multiply(const CsrMatrixView<T, Index>& matrix, const ArrayView<T>& x,
+              ArrayView<T> y, T alpha, T beta) {
+  check_operands(matrix.n_rows(), matrix.n_cols(), x, y);
+  const Dense<const T> dx(x.data(), x);
+  const Dense<T> dy(y.data(), y);
+  const size_t n_rows = matrix.n_rows();
+
+  // Balance the work by the number of non-zeros plus one per row
+  // (for the writes to y), which is strictly increasing along the rows.
+  const Index* indptr = matrix.indptr().data();
+  const size_t work   = matrix.nnz() + n_rows;
+  ThreadPool& pool    = ThreadPool::global();
+  const size_t chunks = work * dy.n_cols < parallel_min_size ? 1 : pool.size();
+  if (chunks == 1) {
+    csr_rows(matrix, dx, dy, alpha, beta, 0, n_rows);
+    return;
+  }
+
+  auto boundary = [=](size_t chunk) -> size_t {
+    // First row at which the work done so far reaches the share of the chunk
+    const size_t target = work / chunks * chunk + std::min(chunk, work % chunks);
+    size_t lo = 0, hi = n_rows;
+    while (lo < hi) {
+      const size_t mid = lo + (hi - lo) / 2;
+      if (static_cast<size_t>(indptr[mid]) + mid < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return chunk == chunks ? n_rows : lo;
+  };
+  pool.run([&](size_t chunk) {
+    csr_rows(matrix, dx, dy, alpha, beta, boundary(chunk), boundary(chunk + 1));
+  });
+}
+
+template <typename T, typename Index>
+void multiply(const CooMatrixView<T, Index>& matrix, const ArrayView<T>& x,
+              ArrayView<T> y, T alpha, T beta) {
+  check_operands(matrix.n_rows(), matrix.n_cols(), x, y);
+  const Dense<const T> dx(x.data(), x);
+  const Dense<T> dy(y.data(), y);
+
+  for (size_t i = 0; i < matrix.n_rows(); ++i) {
+    scale_row(dy.row(static_cast<ptrdiff_t>(i)), dy, beta);
+  }
+
+  const Index* rows = matrix.row().data();
+  const Index* cols = matrix.col().data();
+  const T* values   = matrix.data().data();
+  for (size_t p = 0; p < matrix.nnz(); ++p) {
+    const T factor = alpha * values[p];
+    const T* xr    = dx.row(cols[p]);
+    T* yr          = dy.row(rows[p]);
+    for (size_t j = 0; j < dy.n_cols; ++j) {
+      const ptrdiff_t sj = static_cast<ptrdiff_t>(j);
+      yr[sj * dy.col_stride] += factor * xr[sj * dx.col_stride];  // NOLINT
+    }
+  }
+}
+
+#define PAMMAP_INSTANTIATE_MULTIPLY(T, Index)                                          \
+  template void multiply(const CsrMatrixView<T, Index>&, const ArrayView<T>&,          \
+                         ArrayView<T>, T, T);                                          \
+  template void multiply(const CooMatrixView<T, Index>&, const ArrayView<T>&,          \
+                         ArrayView<T>, T, T);
+
+PAMMAP_INSTANTIATE_MULTIPLY(Float, Integer32)
+PAMMAP_INSTANTIATE_MULTIPLY(Float, Integer)
+PAMMAP_INSTANTIATE_MULTIPLY(Complex, Integer32)
+PAMMAP_INSTANTIATE_MULTIPLY(Complex, Integer)
+#undef PAMMAP_INSTANTIATE_MULTIPLY
+
+}  // namespace pammap
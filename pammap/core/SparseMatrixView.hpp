@@ -0,0 +1,224 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "exceptions.hpp"
+#include "typedefs.hxx"
+#include <string>
+
+namespace pammap {
+
+namespace detail {
+/** Check that a view is one-dimensional with unit stride and
+ *  (if ``size`` is not npos) has the expected size */
+template <typename T>
+void check_sparse_component(const ArrayView<T>& view, const std::string& name,
+                            size_t size = static_cast<size_t>(-1)) {
+  pammap_throw(view.ndim() == 1 && (view.size() <= 1 || view.strides()[0] == 1),
+               ValueError,
+               "The " + name + " array of a sparse matrix needs to be one-dimensional "
+                                "and contiguous.");
+  pammap_throw(size == static_cast<size_t>(-1) || view.size() == size, ValueError,
+               "The " + name + " array of a sparse matrix has size " +
+                     std::to_string(view.size()) + ", but " + std::to_string(size) +
+                     " was expected.");
+}
+
+/** Check that all indices are in [0, bound) */
+template <typename Index>
+void check_sparse_indices(const ArrayView<Index>& view, size_t bound,
+                          const std::string& name) {
+  const Index* idx = view.data();
+  for (size_t i = 0; i < view.size(); ++i) {
+    pammap_throw(idx[i] >= 0 && static_cast<size_t>(idx[i]) < bound, ValueError,
+                 "Sparse matrix " + name + " index " + std::to_string(idx[i]) +
+                       " is out of range.");
+  }
+}
+}  // namespace detail
+
+/** View of a sparse matrix in compressed sparse row (CSR) format.
+ *
+ * The layout agrees with scipy.sparse.csr_matrix: The column indices and
+ * values of the non-zero entries of row ``i`` are stored in the entries
+ * ``indptr[i]`` up to (excluding) ``indptr[i + 1]`` of ``indices`` and
+ * ``data``. The three arrays are one-dimensional contiguous ArrayViews,
+ * which do not own their data. The index type (Integer32 or Integer)
+ * follows scipy, which uses 32-bit indices unless there are too many
+ * non-zeros.
+ *
+ * The constructor checks the sizes of the arrays, validate() in addition
+ * checks the range of all indices.
+ */
+template <typename T, typename Index>
+class CsrMatrixView {
+ public:
+  typedef T value_type;
+  typedef Index index_type;
+
+  CsrMatrixView() = default;
+
+  /** Construct from the row pointers (n_rows + 1 entries) and the column
+   *  indices and values of the non-zero entries */
+  CsrMatrixView(size_t n_rows, size_t n_cols, ArrayView<Index> indptr,
+                ArrayView<Index> indices, ArrayView<T> data)
+        : m_n_rows(n_rows),
+          m_n_cols(n_cols),
+          m_indptr(indptr),
+          m_indices(indices),
+          m_data(data) {
+    detail::check_sparse_component(m_indptr, "indptr", n_rows + 1);
+    detail::check_sparse_component(m_indices, "indices");
+    detail::check_sparse_component(m_data, "data", m_indices.size());
+    pammap_throw(m_indptr[0] == 0 && static_cast<size_t>(m_indptr[n_rows]) == nnz(),
+                 ValueError,
+                 "Row pointers of a CSR matrix need to range from 0 to the number "
+                 "of non-zeros.");
+  }
+
+  /** The number of rows */
+  size_t n_rows() const { return m_n_rows; }
+
+  /** The number of columns */
+  size_t n_cols() const { return m_n_cols; }
+
+  /** The number of stored (non-zero) entries */
+  size_t nnz() const { return m_data.size(); }
+
+  //@{
+  /** The arrays making up the matrix */
+  const ArrayView<Index>& indptr() const { return m_indptr; }
+  const ArrayView<Index>& indices() const { return m_indices; }
+  const ArrayView<T>& data() const { return m_data; }
+  ArrayView<T>& data() { return m_data; }
+  //@}
+
+  /** The entry in row ``i`` and column ``j`` (zero if not stored),
+   *  found by a linear search through the row */
+  T operator()(size_t i, size_t j) const {
+    pammap_throw(i < m_n_rows && j < m_n_cols, IndexError,
+                 "Index (" + std::to_string(i) + ", " + std::to_string(j) +
+                       ") out of range for the sparse matrix.");
+    const Index* idx = m_indices.data();
+    T ret            = T(0);
+    for (Index k = m_indptr.data()[i]; k < m_indptr.data()[i + 1]; ++k) {
+      if (static_cast<size_t>(idx[k]) == j) ret += m_data.data()[k];
+    }
+    return ret;
+  }
+
+  /** Check that the row pointers are non-decreasing and all column
+   *  indices are in range. Throws a ValueError otherwise. */
+  void validate() const {
+    const Index* ptr = m_indptr.data();
+    for (size_t i = 0; i < m_n_rows; ++i) {
+      pammap_throw(ptr[i] <= ptr[i + 1], ValueError,
+                   "Row pointers of a CSR matrix need to be non-decreasing.");
+    }
+    detail::check_sparse_indices(m_indices, m_n_cols, "column");
+  }
+
+ private:
+  size_t m_n_rows = 0;
+  size_t m_n_cols = 0;
+  ArrayView<Index> m_indptr;
+  ArrayView<Index> m_indices;
+  ArrayView<T> m_data;
+};
+
+/** View of a sparse matrix in coordinate (COO) format.
+ *
+ * The layout agrees with scipy.sparse.coo_matrix: The k-th non-zero entry
+ * has value ``data[k]`` and is located at row ``row[k]`` and column
+ * ``col[k]``. Entries may be in any order and duplicate entries are summed.
+ * The three arrays are one-dimensional contiguous ArrayViews, which do
+ * not own their data.
+ */
+template <typename T, typename Index>
+class CooMatrixView {
+ public:
+  typedef T value_type;
+  typedef Index index_type;
+
+  CooMatrixView() = default;
+
+  /** Construct from the row indices, column indices and values
+   *  of the non-zero entries */
+  CooMatrixView(size_t n_rows, size_t n_cols, ArrayView<Index> row, ArrayView<Index> col,
+                ArrayView<T> data)
+        : m_n_rows(n_rows), m_n_cols(n_cols), m_row(row), m_col(col), m_data(data) {
+    detail::check_sparse_component(m_data, "data");
+    detail::check_sparse_component(m_row, "row", m_data.size());
+    detail::check_sparse_component(m_col, "col", m_data.size());
+  }
+
+  /** The number of rows */
+  size_t n_rows() const { return m_n_rows; }
+
+  /** The number of columns */
+  size_t n_cols() const { return m_n_cols; }
+
+  /** The number of stored (non-zero) entries */
+  size_t nnz() const { return m_data.size(); }
+
+  //@{
+  /** The arrays making up the matrix */
+  const ArrayView<Index>& row() const { return m_row; }
+  const ArrayView<Index>& col() const { return m_col; }
+  const ArrayView<T>& data() const { return m_data; }
+  ArrayView<T>& data() { return m_data; }
+  //@}
+
+  /** Check that all indices are in range. Throws a ValueError otherwise. */
+  void validate() const {
+    detail::check_sparse_indices(m_row, m_n_rows, "row");
+    detail::check_sparse_indices(m_col, m_n_cols, "column");
+  }
+
+ private:
+  size_t m_n_rows = 0;
+  size_t m_n_cols = 0;
+  ArrayView<Index> m_row;
+  ArrayView<Index> m_col;
+  ArrayView<T> m_data;
+};
+
+//@{
+/** Sparse-times-dense product ``y = alpha * A * x + beta * y``.
+ *
+ * Either ``x`` and ``y`` are vectors with ``A.n_cols()`` and ``A.n_rows()``
+ * elements or they are matrices with as many rows and the same number of
+ * columns. Arbitrary strides are supported, but ``x`` and ``y`` may not
+ * overlap. If ``beta`` is zero, ``y`` is overwritten without being read.
+ *
+ * For CSR matrices the rows are split between the workers of
+ * ThreadPool::global(), such that each worker processes about the same
+ * number of non-zeros. COO matrices are processed on the calling thread,
+ * since entries on different threads could update the same element of ``y``.
+ */
+template <typename T, typename Index>
+void multiply(const CsrMatrixView<T, Index>& matrix, const ArrayView<T>& x,
+              ArrayView<T> y, T alpha = T(1), T beta = T(0));
+template <typename T, typename Index>
+void multiply(const CooMatrixView<T, Index>& matrix, const ArrayView<T>& x,
+              ArrayView<T> y, T alpha = T(1), T beta = T(0));
+//@}
+
+}  // namespace pammap
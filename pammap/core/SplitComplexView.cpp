@@ -0,0 +1,140 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SplitComplexView.hpp"
+#include "exceptions.hpp"
+#include "parallel.hpp"
+#include "reduction_kernels.hpp"
+#include <vector>
+
+namespace pammap {
+
+namespace {
+/** Contiguous copy of the parts of a view in C order, used by the kernels
+ *  if the parts of a view are strided */
+struct ContiguousParts {
+  explicit ContiguousParts(const SplitComplexView& view)
+        : real(view.size()), imag(view.size()) {
+    std::vector<size_t> shape(view.shape().begin(), view.shape().end());
+    std::vector<ptrdiff_t> strides(shape.size(), 1);
+    for (size_t k = shape.size(); k-- > 1;) {
+      strides[k - 1] = strides[k] * static_cast<ptrdiff_t>(shape[k]);
+    }
+    copy(ArrayView<Float>(real.data(), shape, strides), view.real());
+    copy(ArrayView<Float>(imag.data(), shape, strides), view.imag());
+  }
+
+  std::vector<Float> real;
+  std::vector<Float> imag;
+};
+
+/** Do two views have contiguous parts with the same layout */
+bool same_contiguous_layout(const SplitComplexView& lhs, const SplitComplexView& rhs) {
+  return lhs.is_contiguous() && rhs.is_contiguous() &&
+         lhs.real().strides() == rhs.real().strides();
+}
+
+void check_same_shape(const SplitComplexView& lhs, const SplitComplexView& rhs) {
+  pammap_throw(lhs.shape() == rhs.shape(), ValueError,
+               "The shapes of the SplitComplexViews need to agree.");
+}
+}  // namespace
+
+SplitComplexView::SplitComplexView(ArrayView<Float> real, ArrayView<Float> imag)
+      : m_real(real), m_imag(imag) {
+  pammap_throw(m_real.shape() == m_imag.shape(), ValueError,
+               "Real and imaginary part of a SplitComplexView need to have the same "
+               "shape.");
+}
+
+SplitComplexView SplitComplexView::of(ArrayView<Complex> interleaved) {
+  // std::complex<double> is layout-compatible with an array of two doubles
+  Float* data = reinterpret_cast<Float*>(interleaved.data());
+  std::vector<ptrdiff_t> strides(interleaved.strides().begin(),
+                                 interleaved.strides().end());
+  for (ptrdiff_t& stride : strides) stride *= 2;
+  std::vector<size_t> shape(interleaved.shape().begin(), interleaved.shape().end());
+  return SplitComplexView(ArrayView<Float>(data, shape, strides),
+                          ArrayView<Float>(data + 1, shape, strides));
+}
+
+bool SplitComplexView::is_contiguous() const {
+  return (m_real.is_c_contiguous() || m_real.is_fortran_contiguous()) &&
+         m_real.strides() == m_imag.strides();
+}
+
+void SplitComplexView::copy_from(const ArrayView<Complex>& interleaved) {
+  pammap_throw(interleaved.shape() == shape(), ValueError,
+               "Shapes of the interleaved view and the SplitComplexView need to agree.");
+  for_each(
+        [](const Complex& c, Float& re, Float& im) {
+          re = c.real();
+          im = c.imag();
+        },
+        interleaved, m_real, m_imag);
+}
+
+void SplitComplexView::copy_to(ArrayView<Complex> interleaved) const {
+  pammap_throw(interleaved.shape() == shape(), ValueError,
+               "Shapes of the interleaved view and the SplitComplexView need to agree.");
+  for_each([](Complex& c, const Float& re, const Float& im) { c = Complex(re, im); },
+           interleaved, m_real, m_imag);
+}
+
+Complex dot(const SplitComplexView& lhs, const SplitComplexView& rhs) {
+  check_same_shape(lhs, rhs);
+  auto kernel  = detail::active_reduction_kernels().dot_split;
+  Float ret[2] = {0, 0};
+  if (same_contiguous_layout(lhs, rhs)) {
+    kernel(lhs.real().data(), lhs.imag().data(), rhs.real().data(), rhs.imag().data(),
+           lhs.size(), ret);
+  } else {
+    const ContiguousParts l(lhs), r(rhs);
+    kernel(l.real.data(), l.imag.data(), r.real.data(), r.imag.data(), lhs.size(), ret);
+  }
+  return {ret[0], ret[1]};
+}
+
+Float sum_abs2(const SplitComplexView& view) {
+  auto kernel = detail::active_reduction_kernels().sum_squares;
+  if (view.is_contiguous()) {
+    return kernel(view.real().data(), view.size()) +
+           kernel(view.imag().data(), view.size());
+  }
+  const ContiguousParts parts(view);
+  return kernel(parts.real.data(), view.size()) + kernel(parts.imag.data(), view.size());
+}
+
+void axpy(Complex alpha, const SplitComplexView& x, SplitComplexView y) {
+  check_same_shape(x, y);
+  if (same_contiguous_layout(x, y)) {
+    detail::active_reduction_kernels().axpy_split(
+          alpha.real(), alpha.imag(), x.real().data(), x.imag().data(),
+          y.real().data(), y.imag().data(), x.size());
+    return;
+  }
+  for_each(
+        [alpha](const Float& xr, const Float& xi, Float& yr, Float& yi) {
+          yr += alpha.real() * xr - alpha.imag() * xi;
+          yi += alpha.real() * xi + alpha.imag() * xr;
+        },
+        x.real(), x.imag(), y.real(), y.imag());
+}
+
+}  // namespace pammap
@@ -0,0 +1,107 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "typedefs.hxx"
+
+namespace pammap {
+
+/** View of complex numbers in split layout, i.e. with the real and the
+ *  imaginary parts in two separate (strided) ArrayView<Float>s of the
+ *  same shape.
+ *
+ * Unlike the interleaved layout of ArrayView<Complex> the split layout lets
+ * the complex kernels below process both parts with plain SIMD
+ * instructions and producers, which keep the parts in separate buffers
+ * anyway, can pass them without building an interleaved copy first.
+ * Interleaved data can be viewed in split layout without copying (see
+ * ``of``), but only with a stride of two, such that the fast kernels
+ * need contiguous parts obtained e.g. by ``copy_from``.
+ *
+ * Like ArrayView the SplitComplexView does not own its data.
+ */
+class SplitComplexView {
+ public:
+  SplitComplexView() = default;
+
+  /** Construct from the views of the real and imaginary parts,
+   *  which need to have the same shape */
+  SplitComplexView(ArrayView<Float> real, ArrayView<Float> imag);
+
+  /** View the parts of interleaved complex numbers without copying */
+  static SplitComplexView of(ArrayView<Complex> interleaved);
+
+  //@{
+  /** The views of the real and imaginary parts */
+  const ArrayView<Float>& real() const { return m_real; }
+  const ArrayView<Float>& imag() const { return m_imag; }
+  ArrayView<Float>& real() { return m_real; }
+  ArrayView<Float>& imag() { return m_imag; }
+  //@}
+
+  /** The shape (common to both parts) */
+  span<const size_t> shape() const { return m_real.shape(); }
+
+  /** The number of dimensions */
+  size_t ndim() const { return m_real.ndim(); }
+
+  /** The number of complex elements */
+  size_t size() const { return m_real.size(); }
+
+  /** The element with multi-index ``idx`` */
+  template <typename... Ts>
+  Complex operator()(Ts... idx) const {
+    return {m_real(idx...), m_imag(idx...)};
+  }
+
+  /** Set the element with multi-index ``idx`` */
+  template <typename... Ts>
+  void set(Complex value, Ts... idx) {
+    m_real(idx...) = value.real();
+    m_imag(idx...) = value.imag();
+  }
+
+  /** Are both parts contiguous with the same strides, such that the
+   *  kernels can process them directly */
+  bool is_contiguous() const;
+
+  /** Copy interleaved complex numbers of the same shape into the parts */
+  void copy_from(const ArrayView<Complex>& interleaved);
+
+  /** Copy the parts into interleaved complex numbers of the same shape */
+  void copy_to(ArrayView<Complex> interleaved) const;
+
+ private:
+  ArrayView<Float> m_real;
+  ArrayView<Float> m_imag;
+};
+
+/** Sum of the products of the elements of two views of the same shape,
+ *  where elements with the same multi-index are multiplied (without
+ *  complex conjugation). Throws a ValueError if the shapes differ. */
+Complex dot(const SplitComplexView& lhs, const SplitComplexView& rhs);
+
+/** Sum of the squared absolute values of all elements */
+Float sum_abs2(const SplitComplexView& view);
+
+/** Add ``alpha * x`` to ``y``, which need to have the same shape */
+void axpy(Complex alpha, const SplitComplexView& x, SplitComplexView y);
+
+}  // namespace pammap
@@ -0,0 +1,107 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "FastDivisor.hpp"
+#include <array>
+#include <cstddef>
+
+namespace pammap {
+
+/** Linearised access into the elements of an ArrayView with arbitrary
+ *  strides, which is cheap enough for loops over the linear index.
+ *
+ * The elements are enumerated like ArrayView::operator[] does. Unlike
+ * operator[] the axis order and a FastDivisor per axis are computed once
+ * when the indexer is created (see ArrayView::indexer), such that mapping
+ * a linear index to the memory offset needs no integer division:
+ * ```
+ * const auto idx = view.indexer();
+ * for (size_t i = 0; i < view.size(); ++i) sum += idx[i];
+ * ```
+ * For visiting all elements in order the iterators of ArrayView are still
+ * cheaper. The indexer does not keep the view alive and no bound checks
+ * are performed.
+ *
+ * \tparam T         The (possibly const-qualified) element type
+ * \tparam Capacity  The maximal number of axes
+ */
+template <typename T, size_t Capacity>
+class StridedIndexer {
+ public:
+  /** Default constructor, leaves the indexer in an invalid state */
+  StridedIndexer() = default;
+
+  /** Construct an indexer.
+   *
+   * \param data        Pointer to the element with multi-index zero
+   * \param shape       Shape of the axes
+   * \param strides     Strides of the axes
+   * \param order       Axes in the order of the linear index (fastest first)
+   * \param ndim        Number of axes
+   * \param contiguous  Are the elements stored contiguously in this order
+   */
+  StridedIndexer(T* data, const size_t* shape, const ptrdiff_t* strides,
+                 const unsigned char* order, size_t ndim, bool contiguous)
+        : m_data(data), m_contiguous(contiguous), m_ndim(ndim) {
+    if (contiguous) return;
+    for (size_t k = 0; k < ndim; ++k) {
+      m_shape[k]    = shape[order[k]];
+      m_strides[k]  = strides[order[k]];
+      m_divisors[k] = FastDivisor(m_shape[k]);
+    }
+  }
+
+  /** The memory offset of the element with linear index i */
+  ptrdiff_t offset(size_t i) const {
+    if (m_contiguous) return static_cast<ptrdiff_t>(i);
+
+    // Peel off the index along each axis, fastest axis first. The quotient
+    // is the linear index with respect to the remaining axes.
+    ptrdiff_t ret = 0;
+    for (size_t k = 0; k + 1 < m_ndim; ++k) {
+      const size_t rest = m_divisors[k].divide(i);
+      ret += static_cast<ptrdiff_t>(i - rest * m_shape[k]) * m_strides[k];
+      i = rest;
+    }
+    if (m_ndim > 0) ret += static_cast<ptrdiff_t>(i) * m_strides[m_ndim - 1];
+    return ret;
+  }
+
+  /** The element with linear index i */
+  T& operator[](size_t i) const { return m_data[offset(i)]; }
+
+ private:
+  /** Pointer to the element with multi-index zero */
+  T* m_data = nullptr;
+
+  /** Can the linear index be used as the offset */
+  bool m_contiguous = true;
+
+  /** Number of axes */
+  size_t m_ndim = 0;
+
+  /** Shape, strides and divisors by the shape (fastest axis first,
+   *  only set up for views which are not contiguous) */
+  std::array<size_t, Capacity> m_shape{};
+  std::array<ptrdiff_t, Capacity> m_strides{};
+  std::array<FastDivisor, Capacity> m_divisors{};
+};
+
+}  // namespace pammap
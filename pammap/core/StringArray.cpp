@@ -0,0 +1,251 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "StringArray.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace pammap {
+namespace {
+/** Number of bytes of the UTF-8 encoding of a code point */
+size_t utf8_length(uint32_t code_point) {
+  pammap_throw(code_point < 0x110000 && (code_point < 0xD800 || code_point > 0xDFFF),
+               ValueError, "Invalid unicode code point " + std::to_string(code_point) +
+                                 ".");
+  if (code_point < 0x80) return 1;
+  if (code_point < 0x800) return 2;
+  if (code_point < 0x10000) return 3;
+  return 4;
+}
+
+/** Encode a valid code point as UTF-8 and return the position after it */
+char* utf8_encode(uint32_t code_point, char* out) {
+  auto byte = [](uint32_t value) { return static_cast<char>(value & 0xFFu); };
+  if (code_point < 0x80) {
+    *out++ = byte(code_point);
+  } else if (code_point < 0x800) {
+    *out++ = byte(0xC0 | (code_point >> 6));
+    *out++ = byte(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    *out++ = byte(0xE0 | (code_point >> 12));
+    *out++ = byte(0x80 | ((code_point >> 6) & 0x3F));
+    *out++ = byte(0x80 | (code_point & 0x3F));
+  } else {
+    *out++ = byte(0xF0 | (code_point >> 18));
+    *out++ = byte(0x80 | ((code_point >> 12) & 0x3F));
+    *out++ = byte(0x80 | ((code_point >> 6) & 0x3F));
+    *out++ = byte(0x80 | (code_point & 0x3F));
+  }
+  return out;
+}
+
+/** Is the byte a UTF-8 continuation byte */
+bool is_continuation(char c) { return (static_cast<unsigned char>(c) & 0xC0u) == 0x80u; }
+
+/** Number of code points of a UTF-8 string */
+size_t count_code_points(string_view str) {
+  size_t ret = 0;
+  for (char c : str) {
+    if (!is_continuation(c)) ++ret;
+  }
+  return ret;
+}
+
+/** Decode a UTF-8 string into UCS4 code points, return the number of
+ *  code points. Throws a ValueError if the string is invalid. */
+size_t utf8_decode(string_view str, uint32_t* out) {
+  size_t n = 0;
+  for (size_t i = 0; i < str.size(); ++n) {
+    const uint32_t lead = static_cast<unsigned char>(str[i]);
+    size_t length       = 1;
+    uint32_t code_point = lead;
+    if (lead >= 0xF0 && lead < 0xF8) {
+      length     = 4;
+      code_point = lead & 0x07;
+    } else if (lead >= 0xE0) {
+      length     = 3;
+      code_point = lead & 0x0F;
+    } else if (lead >= 0xC0) {
+      length     = 2;
+      code_point = lead & 0x1F;
+    } else {
+      pammap_throw(lead < 0x80, ValueError, "String is no valid UTF-8.");
+    }
+    pammap_throw(i + length <= str.size() && lead < 0xF8, ValueError,
+                 "String is no valid UTF-8.");
+    for (size_t k = 1; k < length; ++k) {
+      pammap_throw(is_continuation(str[i + k]), ValueError, "String is no valid UTF-8.");
+      code_point = (code_point << 6) | (static_cast<unsigned char>(str[i + k]) & 0x3Fu);
+    }
+
+    // Reject overlong encodings, surrogates and values beyond the unicode range
+    static const uint32_t min_code_point[] = {0, 0, 0x80, 0x800, 0x10000};
+    pammap_throw(code_point >= min_code_point[length] && code_point < 0x110000 &&
+                       (code_point < 0xD800 || code_point > 0xDFFF),
+                 ValueError, "String is no valid UTF-8.");
+    out[n] = code_point;
+    i += length;
+  }
+  return n;
+}
+
+/** Length of a fixed-width string without its trailing zeros */
+template <typename Char>
+size_t trimmed_length(const Char* str, size_t width) {
+  while (width > 0 && str[width - 1] == 0) --width;
+  return width;
+}
+}  // namespace
+
+//
+// StringArrayView
+//
+
+size_t StringArrayView::max_length() const {
+  size_t ret = 0;
+  for (size_t i = 0; i < m_size; ++i) {
+    ret = std::max(ret, m_offsets[i + 1] - m_offsets[i]);
+  }
+  return ret;
+}
+
+size_t StringArrayView::max_code_points() const {
+  size_t ret = 0;
+  for (size_t i = 0; i < m_size; ++i) {
+    ret = std::max(ret, count_code_points((*this)[i]));
+  }
+  return ret;
+}
+
+bool StringArrayView::operator==(const StringArrayView& other) const {
+  if (m_size != other.m_size) return false;
+  for (size_t i = 0; i < m_size; ++i) {
+    if ((*this)[i] != other[i]) return false;
+  }
+  return true;
+}
+
+void StringArrayView::to_fixed_width(char* out, size_t width) const {
+  for (size_t i = 0; i < m_size; ++i, out += width) {
+    const string_view str = (*this)[i];
+    pammap_throw(str.size() <= width, ValueError,
+                 "String " + std::to_string(i) + " is longer than " +
+                       std::to_string(width) + " bytes.");
+    std::memcpy(out, str.data(), str.size());
+    std::memset(out + str.size(), 0, width - str.size());
+  }
+}
+
+void StringArrayView::to_ucs4(uint32_t* out, size_t width) const {
+  for (size_t i = 0; i < m_size; ++i, out += width) {
+    const string_view str = (*this)[i];
+    pammap_throw(count_code_points(str) <= width, ValueError,
+                 "String " + std::to_string(i) + " has more than " +
+                       std::to_string(width) + " code points.");
+    const size_t n = utf8_decode(str, out);
+    std::fill(out + n, out + width, 0u);
+  }
+}
+
+//
+// StringArray
+//
+
+StringArray::StringArray(size_t size) : m_buffer({size + 1}) {}
+
+char* StringArray::allocate_chars() {
+  // Move the offsets to a buffer large enough to hold the characters behind them
+  const size_t n_strings = m_buffer.size() - 1;
+  const size_t n_chars   = m_buffer[n_strings];
+  const size_t n_words   = (n_chars + sizeof(offset_type) - 1) / sizeof(offset_type);
+  Array<offset_type> buffer({n_strings + 1 + n_words});
+  std::copy(m_buffer.data(), m_buffer.data() + n_strings + 1, buffer.data());
+  m_buffer = buffer;
+
+  char* chars = reinterpret_cast<char*>(m_buffer.data() + n_strings + 1);
+  m_view      = StringArrayView(chars, m_buffer.data(), n_strings);
+  m_view.reset_base(m_buffer.view().base(), ArrayViewBase::ARRAY);
+  return chars;
+}
+
+StringArray::StringArray(const std::vector<std::string>& strings)
+      : StringArray(strings.size()) {
+  for (size_t i = 0; i < strings.size(); ++i) {
+    m_buffer[i + 1] = m_buffer[i] + strings[i].size();
+  }
+  char* chars = allocate_chars();
+  for (size_t i = 0; i < strings.size(); ++i) {
+    std::memcpy(chars + m_buffer[i], strings[i].data(), strings[i].size());
+  }
+}
+
+StringArray::StringArray(const ArrayView<String>& strings) : StringArray(strings.size()) {
+  for (size_t i = 0; i < strings.size(); ++i) {
+    m_buffer[i + 1] = m_buffer[i] + strings[i].size();
+  }
+  char* chars = allocate_chars();
+  for (size_t i = 0; i < strings.size(); ++i) {
+    std::memcpy(chars + m_buffer[i], strings[i].data(), strings[i].size());
+  }
+}
+
+StringArray::StringArray(const StringArrayView& view) : StringArray(view.size()) {
+  // The view may refer to a part of a larger buffer, so the offsets
+  // are shifted to start at zero
+  const offset_type first = view.empty() ? 0 : view.offsets()[0];
+  if (!view.empty()) {
+    for (size_t i = 0; i <= view.size(); ++i) m_buffer[i] = view.offsets()[i] - first;
+  }
+  char* chars = allocate_chars();
+  if (!view.empty()) std::memcpy(chars, view.chars() + first, view.total_chars());
+}
+
+StringArray StringArray::from_fixed_width(const char* data, size_t size, size_t width) {
+  StringArray ret(size);
+  for (size_t i = 0; i < size; ++i) {
+    ret.m_buffer[i + 1] = ret.m_buffer[i] + trimmed_length(data + i * width, width);
+  }
+  char* chars = ret.allocate_chars();
+  for (size_t i = 0; i < size; ++i) {
+    std::memcpy(chars + ret.m_buffer[i], data + i * width,
+                ret.m_buffer[i + 1] - ret.m_buffer[i]);
+  }
+  return ret;
+}
+
+StringArray StringArray::from_ucs4(const uint32_t* data, size_t size, size_t width) {
+  StringArray ret(size);
+  for (size_t i = 0; i < size; ++i) {
+    const uint32_t* str = data + i * width;
+    const size_t length = trimmed_length(str, width);
+    size_t bytes        = 0;
+    for (size_t k = 0; k < length; ++k) bytes += utf8_length(str[k]);
+    ret.m_buffer[i + 1] = ret.m_buffer[i] + bytes;
+  }
+  char* chars = ret.allocate_chars();
+  for (size_t i = 0; i < size; ++i) {
+    const uint32_t* str = data + i * width;
+    const size_t length = trimmed_length(str, width);
+    char* out           = chars + ret.m_buffer[i];
+    for (size_t k = 0; k < length; ++k) out = utf8_encode(str[k], out);
+  }
+  return ret;
+}
+
+}  // namespace pammap
@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "Array.hpp"
+#include "StringArrayView.hpp"
+#include "typedefs.hxx"
+#include <vector>
+
+namespace pammap {
+
+/** A one-dimensional array of strings, which owns its data.
+ *
+ * The offsets (see StringArrayView) followed by the characters are stored
+ * in one Array, such that the pooled and reference-counted buffers are
+ * used, copies of a StringArray refer to the same strings and the base of
+ * the view keeps both offsets and characters alive. Like
+ * Arrays, StringArrays can be stored inside a PamMap and such entries
+ * can be obtained both as ``StringArray`` and as ``StringArrayView``.
+ */
+class StringArray {
+ public:
+  typedef StringArrayView::offset_type offset_type;
+
+  /** A StringArray without data */
+  StringArray() = default;
+
+  //@{
+  /** Construct an array holding a copy of the strings */
+  explicit StringArray(const std::vector<std::string>& strings);
+  explicit StringArray(const ArrayView<String>& strings);
+  explicit StringArray(const StringArrayView& view);
+  //@}
+
+  /** Construct from the layout of a numpy array of dtype ``S<width>``,
+   *  i.e. ``size`` strings of ``width`` bytes, where trailing zero bytes
+   *  are not part of the string. */
+  static StringArray from_fixed_width(const char* data, size_t size, size_t width);
+
+  /** Construct from the layout of a numpy array of dtype ``U<width>``,
+   *  i.e. ``size`` strings of ``width`` UCS4 code points, where trailing zeros
+   *  are not part of the string. The strings are encoded as UTF-8.
+   *  Throws a ValueError if a value is no valid code point. */
+  static StringArray from_ucs4(const uint32_t* data, size_t size, size_t width);
+
+  //@{
+  /** A view onto the strings.
+   *
+   * \note The view does not keep the data alive.
+   */
+  StringArrayView& view() { return m_view; }
+  const StringArrayView& view() const { return m_view; }
+  //@}
+
+  /** The number of strings */
+  size_t size() const { return m_view.size(); }
+
+  /** Access to a string */
+  string_view operator[](size_t i) const { return m_view[i]; }
+
+  /** Number of owners of the data (0 for a StringArray without data) */
+  size_t use_count() const { return m_buffer.use_count(); }
+
+ private:
+  /** Allocate the offsets for ``size`` strings, which are set by the caller */
+  explicit StringArray(size_t size);
+
+  /** Allocate the space for the characters once the offsets are set
+   *  and set up the view */
+  char* allocate_chars();
+
+  /** The offsets of the strings followed by the characters */
+  Array<offset_type> m_buffer;
+  StringArrayView m_view;
+};
+
+}  // namespace pammap
@@ -0,0 +1,161 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "exceptions.hpp"
+#include "string_view.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+namespace pammap {
+
+/** Light-weight class to view a one-dimensional array of strings stored
+ *  in a single character buffer.
+ *
+ * The characters of all strings are stored back to back in one buffer
+ * and an offsets array with size() + 1 entries marks where each string
+ * starts: String ``i`` consists of the characters ``chars()[offsets()[i]]``
+ * up to (excluding) ``chars()[offsets()[i + 1]]``. This is the layout of
+ * the string arrays of Apache Arrow. Compared to an ArrayView<String> no
+ * std::string objects (each with its own heap buffer) are involved, such
+ * that large arrays of short strings take a fraction of the memory and can
+ * be passed around or converted without touching the heap.
+ *
+ * The strings are read-only. The view does not own the data,
+ * see StringArray for that.
+ */
+class StringArrayView : public ArrayViewBase {
+ public:
+  /** The type of the offsets */
+  typedef uint64_t offset_type;
+
+  /** Iterator over the strings of the view */
+  class const_iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef string_view value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const string_view* pointer;
+    typedef string_view reference;
+
+    const_iterator(const StringArrayView* view, size_t index)
+          : m_view(view), m_index(index) {}
+    string_view operator*() const { return (*m_view)[m_index]; }
+    const_iterator& operator++() {
+      ++m_index;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator copy(*this);
+      ++m_index;
+      return copy;
+    }
+    bool operator==(const const_iterator& other) const {
+      return m_view == other.m_view && m_index == other.m_index;
+    }
+    bool operator!=(const const_iterator& other) const { return !operator==(other); }
+
+   private:
+    const StringArrayView* m_view;
+    size_t m_index;
+  };
+
+  StringArrayView() = default;
+
+  /** Construct a view of ``size`` strings from the character buffer ``chars``
+   *  and the ``size + 1`` offsets into it. */
+  StringArrayView(const char* chars, const offset_type* offsets, size_t size)
+        : m_chars(chars), m_offsets(offsets), m_size(size) {}
+
+  /** The number of strings */
+  size_t size() const { return m_size; }
+
+  /** Is the view empty */
+  bool empty() const { return m_size == 0; }
+
+  /** Access to a string. Does not perform bound checks in Release builds. */
+  string_view operator[](size_t i) const {
+#ifndef NDEBUG
+    pammap_throw(i < m_size, IndexError,
+                 "StringArrayView index out of range: " + std::to_string(i));
+#endif
+    return string_view(m_chars + m_offsets[i],
+                       m_offsets[i + 1] - m_offsets[i]);
+  }
+
+  /** The character buffer */
+  const char* chars() const { return m_chars; }
+
+  /** The offsets of the strings into the character buffer */
+  const offset_type* offsets() const { return m_offsets; }
+
+  /** The number of characters of all strings together */
+  size_t total_chars() const {
+    return m_size == 0 ? 0 : m_offsets[m_size] - m_offsets[0];
+  }
+
+  /** The length of the longest string in bytes */
+  size_t max_length() const;
+
+  /** The length of the longest string in unicode code points,
+   *  assuming the strings are encoded in UTF-8 */
+  size_t max_code_points() const;
+
+  /** A view of the strings ``first`` up to (excluding) ``last``,
+   *  which shares the character buffer */
+  StringArrayView slice(size_t first, size_t last) const {
+    pammap_throw(first <= last && last <= m_size, IndexError,
+                 "Invalid range [" + std::to_string(first) + ", " +
+                       std::to_string(last) + ") for a StringArrayView of size " +
+                       std::to_string(m_size) + ".");
+    StringArrayView ret(m_chars, m_offsets + first, last - first);
+    ret.reset_base(m_base, m_base_kind);
+    return ret;
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, m_size); }
+
+  /** Do both views contain the same strings */
+  bool operator==(const StringArrayView& other) const;
+
+  /** Do the two views differ in any string */
+  bool operator!=(const StringArrayView& other) const { return !operator==(other); }
+
+  /** Write the strings to the layout of a numpy array of dtype ``S<width>``,
+   *  i.e. each string padded with zero bytes to ``width`` bytes. Throws a
+   *  ValueError if a string is longer than ``width`` bytes. */
+  void to_fixed_width(char* out, size_t width) const;
+
+  /** Write the strings to the layout of a numpy array of dtype ``U<width>``,
+   *  i.e. each string decoded from UTF-8 to ``width`` UCS4 code points padded
+   *  with zeros. Throws a ValueError if a string has more than ``width``
+   *  code points or is no valid UTF-8. */
+  void to_ucs4(uint32_t* out, size_t width) const;
+
+ private:
+  const char* m_chars          = nullptr;
+  const offset_type* m_offsets = nullptr;
+  size_t m_size                = 0;
+};
+
+}  // namespace pammap
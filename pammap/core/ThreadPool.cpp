@@ -0,0 +1,122 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ThreadPool.hpp"
+#include <cstdlib>
+
+namespace pammap {
+namespace {
+/** Are we currently executing a task of some pool */
+thread_local bool inside_task = false;
+
+/** Number of threads to use for the global pool */
+size_t default_pool_size() {
+  const char* env = std::getenv("PAMMAP_NUM_THREADS");
+  if (env != nullptr) {
+    const long value = std::strtol(env, nullptr, 10);
+    if (value > 0) return static_cast<size_t>(value);
+  }
+  const unsigned hardware = std::thread::hardware_concurrency();
+  return hardware > 0 ? hardware : 1;
+}
+}  // namespace
+
+ThreadPool::ThreadPool(size_t size) {
+  for (size_t i = 1; i < size; ++i) m_threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_task_ready.notify_all();
+  for (std::thread& thread : m_threads) thread.join();
+}
+
+ThreadPool& ThreadPool::global() {
+  static ThreadPool pool(default_pool_size());
+  return pool;
+}
+
+void ThreadPool::run(const std::function<void(size_t)>& task) {
+  if (inside_task || m_threads.empty()) {
+    // Nested parallelism or no threads: Just do everything here
+    for (size_t i = 0; i < size(); ++i) task(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> run_lock(m_run_mutex);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task    = &task;
+    m_pending = m_threads.size();
+    m_error   = nullptr;
+    ++m_generation;
+  }
+  m_task_ready.notify_all();
+
+  // Our own share
+  std::exception_ptr error;
+  inside_task = true;
+  try {
+    task(0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  inside_task = false;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_task_done.wait(lock, [this] { return m_pending == 0; });
+  m_task = nullptr;
+  if (error == nullptr) error = m_error;
+  if (error != nullptr) std::rethrow_exception(error);
+}
+
+void ThreadPool::work(size_t index) {
+  inside_task       = true;
+  size_t generation = 0;
+  while (true) {
+    const std::function<void(size_t)>* task = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_task_ready.wait(lock, [&] { return m_stop || m_generation != generation; });
+      if (m_stop) return;
+      generation = m_generation;
+      task       = m_task;
+    }
+
+    std::exception_ptr error;
+    try {
+      (*task)(index);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    bool last = false;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (error != nullptr && m_error == nullptr) m_error = error;
+      last = (--m_pending == 0);
+    }
+    if (last) m_task_done.notify_one();
+  }
+}
+
+}  // namespace pammap
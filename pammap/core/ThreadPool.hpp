@@ -0,0 +1,104 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pammap {
+
+/** A fixed set of worker threads, which jointly execute one task at a time.
+ *
+ * ``run(task)`` calls ``task(i)`` for each worker ``i`` in ``[0, size())``,
+ * where worker 0 is the calling thread, and returns once all calls have
+ * finished. Since the same index always ends up on the same thread, data
+ * which is first written by worker ``i`` (and thus placed on the NUMA node
+ * of that thread by the operating system) is processed by the same thread
+ * in later calls with the same partitioning.
+ *
+ * If a task calls ``run`` again (on any pool) the inner calls are executed
+ * sequentially on the calling thread. Exceptions thrown by the task are
+ * passed on to the caller of ``run`` (if several tasks throw, one of the
+ * exceptions is rethrown).
+ */
+class ThreadPool {
+ public:
+  /** Construct a pool of ``size`` workers, i.e. ``size - 1`` extra threads */
+  explicit ThreadPool(size_t size);
+
+  /** Join all threads */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /** The number of workers including the calling thread */
+  size_t size() const { return m_threads.size() + 1; }
+
+  /** Call task(i) for all workers i and wait for completion */
+  void run(const std::function<void(size_t)>& task);
+
+  /** The pool used by the parallel algorithms of pammap.
+   *
+   * Its size is taken from the environment variable ``PAMMAP_NUM_THREADS``
+   * and defaults to the number of hardware threads.
+   */
+  static ThreadPool& global();
+
+ private:
+  /** Main loop of the extra thread executing the tasks for worker ``index`` */
+  void work(size_t index);
+
+  /** The extra threads */
+  std::vector<std::thread> m_threads;
+
+  /** Serialises calls to run from different threads */
+  std::mutex m_run_mutex;
+
+  /** Protects all members below */
+  std::mutex m_mutex;
+
+  /** Signals a new task (or the shutdown) to the threads */
+  std::condition_variable m_task_ready;
+
+  /** Signals the completion of a task to the caller of run */
+  std::condition_variable m_task_done;
+
+  /** The current task */
+  const std::function<void(size_t)>* m_task = nullptr;
+
+  /** Incremented with each task, such that threads notice a new task */
+  size_t m_generation = 0;
+
+  /** Number of extra threads still working on the current task */
+  size_t m_pending = 0;
+
+  /** First exception thrown by the current task */
+  std::exception_ptr m_error;
+
+  /** Are we shutting down */
+  bool m_stop = false;
+};
+
+}  // namespace pammap
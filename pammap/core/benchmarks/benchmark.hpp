@@ -0,0 +1,56 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace pammap {
+namespace benchmark {
+
+/** Run a function a number of times and return the minimal wall time
+ *  of a single run in seconds. */
+template <typename Function>
+double time_min(Function&& function, int repeats = 5) {
+  double best = 1e99;
+  for (int i = 0; i < repeats; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto stop = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(stop - start).count());
+  }
+  return best;
+}
+
+/** Print a line of benchmark output */
+inline void report(const std::string& name, double seconds,
+                   const std::string& extra = "") {
+  std::printf("%-40s %12.3f ms  %s\n", name.c_str(), 1e3 * seconds, extra.c_str());
+}
+
+/** Make sure the compiler cannot optimise a computed value away */
+template <typename T>
+void do_not_optimise(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace benchmark
+}  // namespace pammap
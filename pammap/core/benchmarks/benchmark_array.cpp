@@ -0,0 +1,60 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "benchmark.hpp"
+#include "typedefs.hxx"
+#include <numeric>
+#include <vector>
+
+namespace {
+using namespace pammap;
+using namespace pammap::benchmark;
+
+/** Time an iteration, which creates a temporary array of ``size`` elements,
+ *  fills it and sums it up, with the array held by a std::vector or an
+ *  Array with buffers from the pool. */
+void run(size_t size, size_t iterations) {
+  const double t_vector = time_min([&] {
+    for (size_t it = 0; it < iterations; ++it) {
+      std::vector<Float> tmp(size, 1.);
+      do_not_optimise(std::accumulate(tmp.begin(), tmp.end(), 0.));
+    }
+  });
+  const double t_array = time_min([&] {
+    for (size_t it = 0; it < iterations; ++it) {
+      Array<Float> tmp({size}, 1.);
+      do_not_optimise(std::accumulate(tmp.data(), tmp.data() + size, 0.));
+    }
+  });
+
+  const std::string name = " " + std::to_string(size) + " x " +
+                           std::to_string(iterations);
+  report("std::vector temporaries" + name, t_vector);
+  report("pooled Array temporaries" + name, t_array);
+}
+}  // namespace
+
+/** Benchmark the repeated creation of temporary arrays of various sizes */
+int main() {
+  run(100, 100000);
+  run(100000, 1000);
+  run(10000000, 20);
+  return 0;
+}
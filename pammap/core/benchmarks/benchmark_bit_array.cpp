@@ -0,0 +1,92 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "BitArray.hpp"
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <random>
+
+/** Compare masks stored as BitArray against masks stored as Array<Bool>
+ *  with 1e3 to 1e8 elements: counting the set bits, combining two masks
+ *  and converting between both representations. The largest power of ten
+ *  can be passed as the first argument. */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const int max_exponent = argc > 1 ? std::atoi(argv[1]) : 8;
+  size_t max_size        = 1;
+  for (int e = 0; e < max_exponent; ++e) max_size *= 10;
+
+  for (size_t n = 1000; n <= max_size; n *= 10) {
+    const size_t repeat     = std::max<size_t>(1, 100000000 / n);
+    const std::string extra = "n = " + std::to_string(n) + "  x" + std::to_string(repeat);
+
+    std::mt19937 engine(42);
+    std::bernoulli_distribution distribution(0.5);
+    Array<Bool> bools_a({n});
+    Array<Bool> bools_b({n});
+    for (size_t i = 0; i < n; ++i) {
+      bools_a[i] = distribution(engine);
+      bools_b[i] = distribution(engine);
+    }
+    BitArray bits_a = BitArray::from_bools(bools_a.view());
+    BitArray bits_b = BitArray::from_bools(bools_b.view());
+
+    const double t_count_bools = time_min([&] {
+      for (size_t r = 0; r < repeat; ++r) {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i) count += bools_a[i];
+        do_not_optimise(count);
+      }
+    });
+    const double t_count_bits = time_min([&] {
+      for (size_t r = 0; r < repeat; ++r) do_not_optimise(bits_a.count());
+    });
+    const double t_and_bools = time_min([&] {
+      for (size_t r = 0; r < repeat; ++r) {
+        for (size_t i = 0; i < n; ++i) bools_a[i] = bools_a[i] && bools_b[i];
+        do_not_optimise(bools_a[0]);
+      }
+    });
+    const double t_and_bits = time_min([&] {
+      for (size_t r = 0; r < repeat; ++r) {
+        bits_a.view() &= bits_b.view();
+        do_not_optimise(bits_a.view().words()[0]);
+      }
+    });
+    const double t_from_bools = time_min([&] {
+      for (size_t r = 0; r < repeat; ++r) bits_b.view().from_bools(bools_b.view());
+    });
+    const double t_to_bools = time_min([&] {
+      for (size_t r = 0; r < repeat; ++r) bits_b.view().to_bools(bools_b.view());
+    });
+
+    report("count  Array<Bool>", t_count_bools, extra);
+    report("count  BitArray", t_count_bits, extra);
+    report("and    Array<Bool>", t_and_bools, extra);
+    report("and    BitArray", t_and_bits, extra);
+    report("from_bools", t_from_bools, extra);
+    report("to_bools", t_to_bools, extra);
+    std::printf("memory Array<Bool> %zu bytes, BitArray %zu bytes\n", n * sizeof(Bool),
+                bits_a.view().n_words() * sizeof(BitArrayView::word_type));
+  }
+  return 0;
+}
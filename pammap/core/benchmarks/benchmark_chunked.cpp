@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ChunkedArray.hpp"
+#include "benchmark.hpp"
+#include "reductions.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+/** Sum a matrix stored in a file once after reading it into memory and once
+ *  streaming it tile by tile through a ChunkedArray with a memory budget of
+ *  a few tiles, with and without prefetching and with both kinds of file
+ *  access. The peak memory of the tile cache is reported. The number of
+ *  rows (of 4096 doubles) can be passed as the first argument (default 4096,
+ *  i.e. a file of 128 MiB, which is written to the working directory). */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t rows = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 4096;
+  const size_t cols = 4096, tile_rows = 128;
+  const std::string path = "benchmark_chunked.bin";
+  {
+    std::vector<Float> row(cols, 0.5);
+    std::ofstream file(path, std::ios::binary);
+    for (size_t i = 0; i < rows; ++i) {
+      file.write(reinterpret_cast<const char*>(row.data()),
+                 static_cast<std::streamsize>(cols * sizeof(Float)));
+    }
+  }
+  const size_t tile_bytes = tile_rows * cols * sizeof(Float);
+  const std::string extra = std::to_string(rows) + "x" + std::to_string(cols);
+
+  const double t_memory = time_min([&] {
+    std::vector<Float> data(rows * cols);
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(data.data()),
+              static_cast<std::streamsize>(data.size() * sizeof(Float)));
+    do_not_optimise(sum(ArrayView<Float>(data)));
+  });
+  const size_t memory = rows * cols * sizeof(Float);
+  report("read all, then sum", t_memory,
+         extra + ", memory " + std::to_string(memory >> 20) + " MiB");
+
+  typedef FileChunkStore<Float> Store;
+  for (auto access : {Store::READ, Store::MAP}) {
+    for (size_t prefetch : {size_t(0), size_t(2)}) {
+      auto store =
+            std::make_shared<Store>(path, std::vector<size_t>{rows, cols}, 0, access);
+      size_t peak = 0;
+      const double time = time_min([&] {
+        const size_t budget = 4 * tile_bytes;
+        ChunkedArray<Float> array({rows, cols}, {tile_rows, cols}, store, budget);
+        Float total = 0;
+        for (const auto& block : array.blocks(prefetch)) {
+          total += sum(block.view());
+          peak = std::max(peak, array.cached_bytes());
+        }
+        do_not_optimise(total);
+      });
+      report(std::string("stream, ") + (access == Store::READ ? "pread" : "mmap ") +
+                   ", prefetch " + std::to_string(prefetch),
+             time, extra + ", cache peak " + std::to_string(peak >> 20) + " MiB");
+    }
+  }
+
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,88 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "ConvertingView.hpp"
+#include "benchmark.hpp"
+#include "typedefs.hxx"
+#include <cstdlib>
+#include <numeric>
+
+/** Sum foreign data (int32 in swapped byte order and native float32) as
+ *  Integer and Float respectively: After materialising a converted copy,
+ *  block by block with ConvertingView::for_each_block and element by element
+ *  with ConvertingView::operator(). The number of elements can be passed as
+ *  the first argument (default 2^24). */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : size_t(1) << 24;
+  const std::string extra = "n = " + std::to_string(n);
+
+  std::vector<uint32_t> swapped(n);
+  for (size_t i = 0; i < n; ++i) {
+    swapped[i] = detail::byteswap(static_cast<uint32_t>(i % 1000));
+  }
+  std::vector<Float32> floats(n, 0.5f);
+  const ConvertingView<Integer> integers(swapped.data(), SourceType::INT32, true, {n},
+                                         {4});
+  const ConvertingView<Float> as_float{ArrayView<Float32>(floats)};
+
+  const double t_copy_int = time_min([&] {
+    Array<Integer> copy({n});
+    integers.copy_to(copy.view());
+    do_not_optimise(std::accumulate(copy.data(), copy.data() + n, Integer(0)));
+  });
+  report("int32 swapped: converted copy, then sum", t_copy_int, extra);
+
+  const double t_block_int = time_min([&] {
+    Integer total = 0;
+    integers.for_each_block([&](const Integer* block, size_t count) {
+      total = std::accumulate(block, block + count, total);
+    });
+    do_not_optimise(total);
+  });
+  report("int32 swapped: for_each_block sum", t_block_int, extra);
+
+  const double t_element_int = time_min([&] {
+    Integer total = 0;
+    for (size_t i = 0; i < n; ++i) total += integers(i);
+    do_not_optimise(total);
+  });
+  report("int32 swapped: element-wise sum", t_element_int, extra);
+
+  const double t_copy_float = time_min([&] {
+    Array<Float> copy({n});
+    as_float.copy_to(copy.view());
+    do_not_optimise(std::accumulate(copy.data(), copy.data() + n, Float(0)));
+  });
+  report("float32: converted copy, then sum", t_copy_float, extra);
+
+  const double t_block_float = time_min([&] {
+    Float total = 0;
+    as_float.for_each_block([&](const Float* block, size_t count) {
+      total = std::accumulate(block, block + count, total);
+    });
+    do_not_optimise(total);
+  });
+  report("float32: for_each_block sum", t_block_float, extra);
+
+  return 0;
+}
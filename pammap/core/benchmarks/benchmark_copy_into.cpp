@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "benchmark.hpp"
+#include "copy_into.hpp"
+#include "typedefs.hxx"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+using namespace pammap;
+using namespace pammap::benchmark;
+
+/** Time the conversion of an n x n array from C to Fortran order and
+ *  compare with a memcpy of the same amount of data and a naive loop. */
+template <typename T>
+void run(const std::string& name, size_t n) {
+  const size_t size = n * n;
+  std::unique_ptr<T[]> in(new T[size]);
+  std::unique_ptr<T[]> out(new T[size]);
+  for (size_t i = 0; i < size; ++i) in[i] = T(static_cast<double>(i % 1000));
+  std::memset(static_cast<void*>(out.get()), 0, size * sizeof(T));
+
+  const auto nn = static_cast<ptrdiff_t>(n);
+  ArrayView<T, 2> c(in.get(), std::array<size_t, 2>{{n, n}},
+                    std::array<ptrdiff_t, 2>{{nn, 1}});
+  ArrayView<T, 2> f(out.get(), std::array<size_t, 2>{{n, n}},
+                    std::array<ptrdiff_t, 2>{{1, nn}});
+
+  const double t_memcpy = time_min(
+        [&] { std::memcpy(static_cast<void*>(out.get()), in.get(), size * sizeof(T)); });
+  const double t_naive = time_min([&] {
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j) f(i, j) = c(i, j);
+    }
+  });
+  const double t_serial   = time_min([&] { copy_into(f, c, false); });
+  const double t_parallel = time_min([&] { copy_into(f, c); });
+  do_not_optimise(out[size / 2]);
+
+  const double gb    = 2. * static_cast<double>(size * sizeof(T)) / 1e9;
+  auto bandwidth = [gb](double t) { return std::to_string(gb / t) + " GB/s"; };
+  const std::string shape = " " + std::to_string(n) + "x" + std::to_string(n);
+  report("memcpy " + name + shape, t_memcpy, bandwidth(t_memcpy));
+  report("naive transpose " + name + shape, t_naive, bandwidth(t_naive));
+  report("copy_into serial " + name + shape, t_serial, bandwidth(t_serial));
+  report("copy_into " + name + shape, t_parallel, bandwidth(t_parallel));
+}
+
+/** Time 10000 conversions of small n x n arrays from C to Fortran order,
+ *  where the overhead per call dominates */
+template <typename T>
+void run_small(const std::string& name, size_t n) {
+  std::vector<T> in(n * n, T(1.5)), out(n * n);
+  const auto nn = static_cast<ptrdiff_t>(n);
+  ArrayView<T, 2> c(in.data(), std::array<size_t, 2>{{n, n}},
+                    std::array<ptrdiff_t, 2>{{nn, 1}});
+  ArrayView<T, 2> f(out.data(), std::array<size_t, 2>{{n, n}},
+                    std::array<ptrdiff_t, 2>{{1, nn}});
+  const double time = time_min([&] {
+    for (size_t k = 0; k < 10000; ++k) copy_into(f, c);
+    do_not_optimise(out[1]);
+  });
+  report("10000 x copy_into " + name + " " + std::to_string(n) + "x" + std::to_string(n),
+         time);
+}
+}  // namespace
+
+/** Benchmark the conversion between C and Fortran order for Float and Complex
+ *  arrays of n x n elements (default 8192, can be passed as first argument)
+ *  and of small arrays. */
+int main(int argc, char** argv) {
+  const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8192;
+  run<pammap::Float>("Float", n);
+  run<pammap::Complex>("Complex", n);
+  for (size_t small : {size_t(8), size_t(64)}) run_small<pammap::Float>("Float", small);
+  return 0;
+}
@@ -0,0 +1,73 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "benchmark.hpp"
+#include "expressions.hpp"
+#include "typedefs.hxx"
+#include <cstdlib>
+
+/** Evaluate ``out = a * 2 + b * c - d`` over contiguous views once as a fused
+ *  expression and once operator by operator with temporaries (the way
+ *  e.g. numpy evaluates it), using the parallel transform for each step.
+ *  The memory traffic is estimated by the number of array elements read
+ *  and written. The number of elements can be passed as the first argument
+ *  (default 1e7). */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000;
+  std::vector<Float> a(n, 1.5), b(n, 0.5), c(n, -2.0), d(n, 3.0), out(n);
+  std::vector<Float> t1(n), t2(n), t3(n);
+  ArrayView<Float> va(a), vb(b), vc(c), vd(d), vout(out);
+  ArrayView<Float> v1(t1), v2(t2), v3(t3);
+
+  const double t_fused = time_min([&] {
+    assign(vout, va * 2.0 + vb * vc - vd);
+    do_not_optimise(out[0]);
+  });
+
+  const double t_temporaries = time_min([&] {
+    transform(v1, [](Float x) { return x * 2.0; }, va);
+    transform(v2, [](Float x, Float y) { return x * y; }, vb, vc);
+    transform(v3, [](Float x, Float y) { return x + y; }, v1, v2);
+    transform(vout, [](Float x, Float y) { return x - y; }, v3, vd);
+    do_not_optimise(out[0]);
+  });
+
+  const double t_hand = time_min([&] {
+    auto kernel = [](Float x, Float y, Float z, Float w) { return x * 2.0 + y * z - w; };
+    transform(vout, kernel, va, vb, vc, vd);
+    do_not_optimise(out[0]);
+  });
+
+  // Elements read plus elements written
+  const size_t mb       = n * sizeof(Float) / 1000000;
+  const size_t fused    = 5 * mb;          // read a, b, c, d, write out
+  const size_t stepwise = (1 + 1) * mb     // a * 2
+                          + (2 + 1) * mb   // b * c
+                          + (2 + 1) * mb   // sum
+                          + (2 + 1) * mb;  // difference
+  const std::string extra = "n = " + std::to_string(n) + ", traffic ";
+
+  report("fused expression", t_fused, extra + std::to_string(fused) + " MB");
+  report("operator by operator", t_temporaries, extra + std::to_string(stepwise) + " MB");
+  report("hand-written transform", t_hand, extra + std::to_string(fused) + " MB");
+  return 0;
+}
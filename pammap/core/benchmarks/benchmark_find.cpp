@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "GlobPattern.hpp"
+#include "PamMap.hpp"
+#include "benchmark.hpp"
+
+/** Compare PamMap::find against a full scan of all keys with
+ *  GlobPattern::matches on a map with about 1M keys. */
+int main() {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  // 1000 solvers with 10 parameters each and 100 * 100 * 10 atom parameters.
+  PamMap map;
+  for (int s = 0; s < 1000; ++s) {
+    const std::string solver = "/solvers/s" + std::to_string(s);
+    map.update(solver + "/tol", 1e-6);
+    for (int p = 0; p < 9; ++p) map.update(solver + "/param" + std::to_string(p), p);
+  }
+  for (int a = 0; a < 100; ++a) {
+    for (int b = 0; b < 100; ++b) {
+      const std::string atom = "/atoms/" + std::to_string(a) + "/" + std::to_string(b);
+      map.update(atom + "/basis", std::string("sto-3g"));
+      for (int p = 0; p < 98; ++p) map.update(atom + "/p" + std::to_string(p), p);
+    }
+  }
+  const PamMap& cmap = map;
+
+  for (const std::string pattern :
+       {"/solvers/*/tol", "/atoms/5/*/basis", "/*/s1*/tol", "**/basis"}) {
+    size_t n_find = 0;
+    size_t n_scan = 0;
+    const double t_find = time_min([&] {
+      n_find = 0;
+      for (const auto& acc : cmap.find(pattern)) {
+        do_not_optimise(acc.key());
+        ++n_find;
+      }
+    });
+    const double t_scan = time_min([&] {
+      n_scan = 0;
+      const GlobPattern compiled(pattern);
+      for (const auto& acc : cmap) {
+        if (compiled.matches(acc.key())) ++n_scan;
+      }
+    });
+    if (n_find != n_scan) {
+      std::printf("Mismatch for %s: %zu vs %zu\n", pattern.c_str(), n_find, n_scan);
+      return 1;
+    }
+    report("find  " + pattern, t_find, std::to_string(n_find) + " matches");
+    report("scan  " + pattern, t_scan, std::to_string(n_scan) + " matches");
+  }
+  return 0;
+}
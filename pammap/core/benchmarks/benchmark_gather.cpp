@@ -0,0 +1,75 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PamMap.hpp"
+#include "benchmark.hpp"
+
+/** Compare reading and writing the parameters of a model stored as 10000
+ *  scalar entries of a PamMap key by key (via at) against gather and scatter
+ *  through a GatherIndex obtained once. */
+int main() {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n_layers = 100, n_weights = 100;
+  PamMap map;
+  std::vector<std::string> keys;
+  for (size_t l = 0; l < n_layers; ++l) {
+    const std::string layer = "/model/layer" + std::to_string(l);
+    map.update(layer + "/name", std::string("dense"));
+    for (size_t w = 0; w < n_weights; ++w) {
+      keys.push_back(layer + "/w" + std::to_string(w));
+      map.update(keys.back(), 0.5);
+    }
+  }
+  const std::string extra = std::to_string(keys.size()) + " entries";
+  Array<Float> values({keys.size()});
+
+  const double t_at_read = time_min([&] {
+    for (size_t i = 0; i < keys.size(); ++i) values[i] = map.at<Float>(keys[i]);
+    do_not_optimise(values[0]);
+  });
+  report("read:  at per key", t_at_read, extra);
+
+  const double t_at_write = time_min([&] {
+    for (size_t i = 0; i < keys.size(); ++i) map.at<Float>(keys[i]) = values[i];
+    do_not_optimise(map);
+  });
+  report("write: at per key", t_at_write, extra);
+
+  const double t_index = time_min([&] {
+    Gathered<Float> gathered = map.gather<Float>("/model/*/w*");
+    do_not_optimise(gathered.values[0]);
+  });
+  report("gather by pattern", t_index, extra);
+
+  const Gathered<Float> gathered = map.gather<Float>("/model/*/w*");
+  const double t_gather = time_min([&] {
+    map.gather(gathered.index, values.view());
+    do_not_optimise(values[0]);
+  });
+  report("read:  gather with index", t_gather, extra);
+
+  const double t_scatter = time_min([&] {
+    map.scatter(gathered.index, values.view());
+    do_not_optimise(map);
+  });
+  report("write: scatter with index", t_scatter, extra);
+  return 0;
+}
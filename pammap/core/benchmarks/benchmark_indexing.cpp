@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ArrayView.hpp"
+#include "benchmark.hpp"
+#include <numeric>
+#include <vector>
+
+/** Compare summing the elements of strided views via operator[], via
+ *  a StridedIndexer, via the flat iterator and via an explicit loop nest
+ *  over the multi-index with plain integer divisions. */
+int main() {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  std::vector<double> data(200 * 300 * 100);
+  std::iota(data.begin(), data.end(), 0.0);
+  ArrayView<double> cc(data.data(), {200, 300, 100}, {30000, 100, 1});
+
+  struct Case {
+    std::string name;
+    ArrayView<double> view;
+  };
+  const std::vector<Case> cases{
+        {"contiguous", cc},
+        {"transposed", ArrayView<double>(data.data(), {100, 300, 200}, {1, 100, 30000})},
+        {"sliced", cc.slice({{Auto, Auto, 2}, {1, 299}, {Auto, Auto, 3}})},
+        {"reversed", cc.slice({{Auto, Auto, -1}})},
+  };
+
+  for (const Case& c : cases) {
+    const ArrayView<double>& view = c.view;
+    const auto shape              = view.shape();
+    const auto strides            = view.strides();
+
+    double sum_division = 0;
+    const double t_division = time_min([&] {
+      sum_division = 0;
+      for (size_t i = 0; i < view.size(); ++i) {
+        // C-order unravelling with integer divisions
+        size_t rest      = i;
+        ptrdiff_t offset = 0;
+        for (size_t d = view.ndim(); d-- > 0;) {
+          offset += static_cast<ptrdiff_t>(rest % shape[d]) * strides[d];
+          rest /= shape[d];
+        }
+        sum_division += view.data()[offset];
+      }
+    });
+
+    double sum_index = 0;
+    const double t_index = time_min([&] {
+      sum_index = 0;
+      for (size_t i = 0; i < view.size(); ++i) sum_index += view[i];
+    });
+
+    double sum_indexer = 0;
+    const double t_indexer = time_min([&] {
+      sum_indexer    = 0;
+      const auto idx = view.indexer();
+      for (size_t i = 0; i < view.size(); ++i) sum_indexer += idx[i];
+    });
+
+    double sum_iterator = 0;
+    const double t_iterator = time_min([&] {
+      sum_iterator = 0;
+      for (double v : view) sum_iterator += v;
+    });
+
+    if (sum_index != sum_iterator || sum_indexer != sum_iterator) {
+      std::printf("Mismatch for %s: %g vs %g vs %g\n", c.name.c_str(), sum_index,
+                  sum_indexer, sum_iterator);
+      return 1;
+    }
+    do_not_optimise(sum_division);
+    const std::string n = std::to_string(view.size()) + " elements";
+    report("division   " + c.name, t_division, n);
+    report("operator[] " + c.name, t_index, n);
+    report("indexer    " + c.name, t_indexer, n);
+    report("iterator   " + c.name, t_iterator, n);
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "benchmark.hpp"
+#include "reductions.hpp"
+#include "typedefs.hxx"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using namespace pammap;
+using namespace pammap::benchmark;
+
+/** Counter for the data TLB misses of this process (if the kernel allows it) */
+class TlbMissCounter {
+ public:
+  TlbMissCounter() {
+#ifdef __linux__
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size   = sizeof(attr);
+    attr.type   = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~TlbMissCounter() {
+#ifdef __linux__
+    if (m_fd >= 0) close(m_fd);
+#endif
+  }
+
+  /** Number of misses while running the function (or -1 if unavailable) */
+  template <typename Function>
+  long long count(Function&& function) {
+#ifdef __linux__
+    if (m_fd >= 0) {
+      ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+      function();
+      ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+      long long misses = 0;
+      if (read(m_fd, &misses, sizeof(misses)) == sizeof(misses)) return misses;
+    }
+#endif
+    function();
+    return -1;
+  }
+
+ private:
+  int m_fd = -1;
+};
+
+/** Total size of the anonymous memory of the process backed by huge pages */
+size_t anon_huge_page_bytes() {
+  std::ifstream smaps("/proc/self/smaps_rollup");
+  std::string key;
+  size_t kib = 0;
+  while (smaps >> key) {
+    if (key == "AnonHugePages:") {
+      smaps >> kib;
+      return kib * 1024;
+    }
+  }
+  return 0;
+}
+
+/** Allocate and initialise an array of ``bytes`` bytes with the given policy
+ *  and time a sequential sum over it as well as random accesses. */
+void run(const std::string& name, size_t bytes, bool huge_pages) {
+  BufferPool& pool = BufferPool::global();
+  pool.release();
+  LargeBufferPolicy policy = pool.large_buffer_policy();
+  policy.huge_pages        = huge_pages;
+  pool.set_large_buffer_policy(policy);
+
+  // Round to a power of two, such that random indices can be masked
+  size_t size = 1;
+  while (2 * size * sizeof(Float) <= bytes) size *= 2;
+  const size_t huge_before = anon_huge_page_bytes();
+  Array<Float> arr;
+  const double t_init = time_min([&] { arr = Array<Float>({size}, 1.); }, 1);
+  const size_t huge = anon_huge_page_bytes() - huge_before;
+
+  const double t_sum = time_min([&] { do_not_optimise(sum(arr.view())); });
+
+  const size_t accesses = size_t(1) << 24;
+  const size_t mask     = size - 1;
+  auto random_reads     = [&] {
+    Float acc     = 0;
+    uint64_t next = 12345;
+    for (size_t i = 0; i < accesses; ++i) {
+      next = next * 6364136223846793005ull + 1442695040888963407ull;
+      acc += arr[(next >> 20) & mask];
+    }
+    do_not_optimise(acc);
+  };
+  const double t_random = time_min(random_reads);
+  TlbMissCounter counter;
+  const long long misses = counter.count(random_reads);
+
+  const double gb = static_cast<double>(size * sizeof(Float)) / 1e9;
+  auto bandwidth  = [gb](double t) { return std::to_string(gb / t) + " GB/s"; };
+  const std::string label =
+        name + " " + std::to_string(size * sizeof(Float) >> 20) + " MiB";
+  report(label + " first touch", t_init,
+         bandwidth(t_init) + ", " + std::to_string(huge >> 20) + " MiB in huge pages");
+  report(label + " sum", t_sum, bandwidth(t_sum));
+  report(label + " random reads", t_random,
+         std::to_string(1e9 * t_random / static_cast<double>(accesses)) + " ns/read, " +
+               (misses < 0 ? std::string("dTLB misses n/a")
+                           : std::to_string(misses) + " dTLB misses"));
+}
+}  // namespace
+
+/** Compare large Arrays backed by 4 KiB pages and by transparent huge pages.
+ *  The size in MiB can be passed as first argument (default 1024). */
+int main(int argc, char** argv) {
+  const size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+  run("4 KiB pages", mib << 20, false);
+  run("huge pages", mib << 20, true);
+  return 0;
+}
@@ -0,0 +1,88 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "benchmark.hpp"
+#include "map_array.hpp"
+#include "reductions.hpp"
+#include "typedefs.hxx"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+/** Compare the time until the data of a file is available as an Array
+ *  (reading it into memory versus mapping it) and the time for summing all
+ *  elements afterwards, with and without access hints. The number of rows
+ *  (of 4096 doubles) can be passed as the first argument (default 4096,
+ *  i.e. a file of 128 MiB, which is written to the working directory). */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t rows = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 4096;
+  const size_t cols = 4096;
+  const std::string path = "benchmark_map_array.bin";
+  {
+    std::vector<Float> row(cols, 0.5);
+    std::ofstream file(path, std::ios::binary);
+    for (size_t i = 0; i < rows; ++i) {
+      file.write(reinterpret_cast<const char*>(row.data()),
+                 static_cast<std::streamsize>(cols * sizeof(Float)));
+    }
+  }
+  const std::string extra = std::to_string(rows) + "x" + std::to_string(cols);
+
+  const double t_read = time_min([&] {
+    Array<Float> array({rows, cols});
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(array.data()),
+              static_cast<std::streamsize>(array.size() * sizeof(Float)));
+    do_not_optimise(array[0]);
+  });
+  report("open: read into Array", t_read, extra);
+
+  const double t_map = time_min([&] {
+    Array<Float> array = map_array<Float>(path, {rows, cols});
+    do_not_optimise(array[0]);
+  });
+  report("open: map_array", t_map, extra);
+
+  const double t_read_sum = time_min([&] {
+    Array<Float> array({rows, cols});
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(array.data()),
+              static_cast<std::streamsize>(array.size() * sizeof(Float)));
+    do_not_optimise(sum(array.view()));
+  });
+  report("read, then sum", t_read_sum, extra);
+
+  for (auto advice : {MappedFile::NORMAL, MappedFile::SEQUENTIAL, MappedFile::WILLNEED}) {
+    const double time = time_min([&] {
+      Array<Float> array = map_array<Float>(path, {rows, cols});
+      advise(array.view(), advice);
+      do_not_optimise(sum(array.view()));
+    });
+    const char* name = advice == MappedFile::NORMAL       ? "normal"
+                       : advice == MappedFile::SEQUENTIAL ? "sequential"
+                                                          : "willneed";
+    report(std::string("map, then sum (") + name + ")", time, extra);
+  }
+
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,110 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PamMap.hpp"
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <malloc.h>
+#include <map>
+#include <new>
+
+/** Compare the heap memory of a PamMap with interned keys against
+ *  a plain std::map with full string keys on a tree with 1M leaves. */
+
+namespace {
+// Heap bytes currently allocated (as reported by the allocator)
+size_t allocated_bytes = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  void* ptr = std::malloc(size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  allocated_bytes += malloc_usable_size(ptr);
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) return;
+  allocated_bytes -= malloc_usable_size(ptr);
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+int main() {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  // 10000 atoms with 20 shells of 5 leaves each
+  const std::vector<std::string> leaves{"exponents", "coefficients", "l", "n", "centre"};
+  std::vector<std::string> keys;
+  keys.reserve(1000000);
+  for (int a = 0; a < 10000; ++a) {
+    std::string atom = std::to_string(a);
+    atom             = std::string(6 - atom.size(), '0') + atom;
+    for (int s = 0; s < 20; ++s) {
+      std::string shell = std::to_string(s);
+      shell             = std::string(3 - shell.size(), '0') + shell;
+      for (const auto& leaf : leaves) {
+        keys.push_back("/system/atoms/" + atom + "/basis/shell/" + shell + "/" + leaf);
+      }
+    }
+  }
+
+  size_t bytes_plain = 0;
+  {
+    const size_t before = allocated_bytes;
+    std::map<std::string, PamMapValue> plain;
+    const double time = time_min(
+          [&] {
+            for (const auto& key : keys) plain[key] = 1.0;
+          },
+          1);
+    bytes_plain = allocated_bytes - before;
+    report("std::map<std::string, ...> insert", time);
+  }
+
+  size_t bytes_interned = 0;
+  {
+    const size_t before = allocated_bytes;
+    PamMap map;
+    const double time = time_min(
+          [&] {
+            for (const auto& key : keys) map.update(key, 1.0);
+          },
+          1);
+    bytes_interned = allocated_bytes - before;
+    report("PamMap (interned keys) insert", time);
+
+    const double time_at = time_min([&] {
+      for (const auto& key : keys) do_not_optimise(map.at<Float>(key));
+    });
+    report("PamMap (interned keys) lookup", time_at);
+  }
+
+  const double n        = static_cast<double>(keys.size());
+  const double plain    = static_cast<double>(bytes_plain);
+  const double interned = static_cast<double>(bytes_interned);
+  std::printf("%zu leaves\n", keys.size());
+  std::printf("std::map<std::string, ...>   %8.1f MiB  %6.1f bytes/entry\n",
+              plain / 1048576., plain / n);
+  std::printf("PamMap (interned keys)       %8.1f MiB  %6.1f bytes/entry\n",
+              interned / 1048576., interned / n);
+  return 0;
+}
@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "benchmark.hpp"
+#include "parallel.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+
+/** Compare the parallel fill, copy and transform against serial loops.
+ *  The number of elements (default 1e8) can be passed as the first argument. */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000000;
+  const std::string extra =
+        std::to_string(n) + " elements, " +
+        std::to_string(ThreadPool::global().size()) + " threads";
+
+  // Allocate without touching, such that fill does the first touch.
+  std::unique_ptr<double[]> in_data(new double[n]);
+  std::unique_ptr<double[]> out_data(new double[n]);
+  ArrayView<double> in(in_data.get(), {n}, {1});
+  ArrayView<double> out(out_data.get(), {n}, {1});
+  fill(in, 1.5);
+  fill(out, 0.0);
+
+  const double t_fill_serial = time_min([&] {
+    for (size_t i = 0; i < n; ++i) out[i] = 2.5;
+  });
+  const double t_fill = time_min([&] { fill(out, 2.5); });
+
+  const double t_copy_serial = time_min([&] {
+    for (size_t i = 0; i < n; ++i) out[i] = in[i];
+  });
+  const double t_copy = time_min([&] { copy(out, in); });
+
+  auto kernel = [](double x, double y) { return std::sqrt(x * x + y); };
+  const double t_transform_serial = time_min([&] {
+    for (size_t i = 0; i < n; ++i) out[i] = kernel(in[i], out[i]);
+  });
+  const double t_transform = time_min([&] { transform(out, kernel, in, out); });
+
+  // Strided: every other element of a 2D view
+  ArrayView<double> in_strided(in_data.get(), {n / 200, 100}, {200, 2});
+  ArrayView<double> out_strided(out_data.get(), {n / 200, 100}, {100, 1});
+  const double t_strided_serial = time_min([&] {
+    for (size_t i = 0; i < n / 200; ++i) {
+      for (size_t j = 0; j < 100; ++j) out_strided(i, j) = kernel(in_strided(i, j), 1.0);
+    }
+  });
+  const double t_strided = time_min([&] {
+    transform(out_strided, [&kernel](double x) { return kernel(x, 1.0); }, in_strided);
+  });
+  do_not_optimise(out_data[n / 2]);
+
+  report("fill serial", t_fill_serial, extra);
+  report("fill", t_fill, extra);
+  report("copy serial", t_copy_serial, extra);
+  report("copy", t_copy, extra);
+  report("transform serial", t_transform_serial, extra);
+  report("transform", t_transform, extra);
+  report("transform strided serial", t_strided_serial, extra);
+  report("transform strided", t_strided, extra);
+  return 0;
+}
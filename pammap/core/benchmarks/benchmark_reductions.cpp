@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "benchmark.hpp"
+#include "reductions.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+/** Compare the reductions of reductions.hpp against naive loops over
+ *  contiguous and strided views with 1e2 to 1e8 elements. The largest
+ *  power of ten can be passed as the first argument. */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const int max_exponent = argc > 1 ? std::atoi(argv[1]) : 8;
+  size_t max_size        = 1;
+  for (int e = 0; e < max_exponent; ++e) max_size *= 10;
+
+  std::vector<Float> data(2 * max_size);
+  for (size_t i = 0; i < data.size(); ++i) data[i] = std::sin(static_cast<Float>(i));
+
+  for (const std::string& isa : available_reduction_isas()) {
+    set_reduction_isa(isa);
+    for (size_t n = 100; n <= max_size; n *= 10) {
+      // Repeat small cases to get measurable timings
+      const size_t repeat = std::max<size_t>(1, 10000000 / n);
+      const std::string extra =
+            isa + "  n = " + std::to_string(n) + "  x" + std::to_string(repeat);
+      ArrayView<Float> contiguous(data.data(), {n}, {1});
+      ArrayView<Float> strided(data.data(), {n}, {2});
+
+      for (const ArrayView<Float>* view : {&contiguous, &strided}) {
+        const std::string kind = view == &contiguous ? "contiguous" : "strided";
+        const double t_naive_sum = time_min([&] {
+          for (size_t r = 0; r < repeat; ++r) {
+            Float s = 0;
+            for (size_t i = 0; i < n; ++i) s += (*view)[i];
+            do_not_optimise(s);
+          }
+        });
+        const double t_sum = time_min([&] {
+          for (size_t r = 0; r < repeat; ++r) do_not_optimise(sum(*view));
+        });
+        const double t_naive_max = time_min([&] {
+          for (size_t r = 0; r < repeat; ++r) {
+            Float m = (*view)[0];
+            for (size_t i = 0; i < n; ++i) m = std::max(m, (*view)[i]);
+            do_not_optimise(m);
+          }
+        });
+        const double t_max = time_min([&] {
+          for (size_t r = 0; r < repeat; ++r) do_not_optimise(max(*view));
+        });
+        const double t_naive_dot = time_min([&] {
+          for (size_t r = 0; r < repeat; ++r) {
+            Float s = 0;
+            for (size_t i = 0; i < n; ++i) s += (*view)[i] * (*view)[i];
+            do_not_optimise(s);
+          }
+        });
+        const double t_dot = time_min([&] {
+          for (size_t r = 0; r < repeat; ++r) do_not_optimise(dot(*view, *view));
+        });
+
+        report("naive sum " + kind, t_naive_sum, extra);
+        report("sum       " + kind, t_sum, extra);
+        report("naive max " + kind, t_naive_max, extra);
+        report("max       " + kind, t_max, extra);
+        report("naive dot " + kind, t_naive_dot, extra);
+        report("dot       " + kind, t_dot, extra);
+      }
+    }
+  }
+  return 0;
+}
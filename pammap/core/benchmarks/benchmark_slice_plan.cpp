@@ -0,0 +1,56 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "benchmark.hpp"
+#include "typedefs.hxx"
+
+/** Compare taking the same slice 10000 times from a set of small arrays of
+ *  equal shape (which fit into the cache) with a list of Slice objects per
+ *  array against a SlicePlan compiled once. */
+int main() {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n_slices = 10000;
+  std::vector<Array<Float>> arrays;
+  for (size_t i = 0; i < 64; ++i) arrays.emplace_back(std::vector<size_t>{8, 6, 4});
+  const std::string extra = std::to_string(n_slices) + " slices of 8x6x4 arrays";
+
+  const double t_slices = time_min([&] {
+    Float total = 0;
+    for (size_t i = 0; i < n_slices; ++i) {
+      const ArrayView<Float>& view = arrays[i % arrays.size()].view();
+      total += view.slice({{1, 7, 2}, Slice::index(3), {Auto, Auto, -1}})[5];
+    }
+    do_not_optimise(total);
+  });
+  report("slice with Slice objects", t_slices, extra);
+
+  const double t_plan = time_min([&] {
+    const SlicePlan plan({{1, 7, 2}, Slice::index(3), {Auto, Auto, -1}}, {8, 6, 4});
+    Float total = 0;
+    for (size_t i = 0; i < n_slices; ++i) {
+      total += arrays[i % arrays.size()].view().slice(plan)[5];
+    }
+    do_not_optimise(total);
+  });
+  report("slice with SlicePlan", t_plan, extra);
+  return 0;
+}
@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SparseMatrixView.hpp"
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <random>
+
+/** Compare the product of a sparse matrix (CSR and COO) with a vector
+ *  and with a block of vectors against the dense product. The matrix
+ *  dimension and the fraction of non-zeros can be passed as first
+ *  and second argument (default 4000 and 0.01). */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n         = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 4000;
+  const double density   = argc > 2 ? std::atof(argv[2]) : 0.01;
+  const size_t n_vectors = 16;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<Float> dense(n * n, 0.0);
+  std::vector<Integer32> indptr{0}, indices, rows;
+  std::vector<Float> values;
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      if (uniform(gen) >= density) continue;
+      dense[i * n + j] = uniform(gen);
+      indices.push_back(static_cast<Integer32>(j));
+      rows.push_back(static_cast<Integer32>(i));
+      values.push_back(dense[i * n + j]);
+    }
+    indptr.push_back(static_cast<Integer32>(indices.size()));
+  }
+  CsrMatrixView<Float, Integer32> csr(n, n, indptr, indices, values);
+  CooMatrixView<Float, Integer32> coo(n, n, rows, indices, values);
+
+  std::vector<Float> x(n * n_vectors, 1.0), y(n * n_vectors);
+  ArrayView<Float> xv(x.data(), {n}, {1});
+  ArrayView<Float> yv(y.data(), {n}, {1});
+  ArrayView<Float> xm(x.data(), {n, n_vectors}, {static_cast<ptrdiff_t>(n_vectors), 1});
+  ArrayView<Float> ym(y.data(), {n, n_vectors}, {static_cast<ptrdiff_t>(n_vectors), 1});
+  const std::string extra = "n = " + std::to_string(n) + ", nnz = " +
+                            std::to_string(csr.nnz());
+
+  const double t_dense = time_min([&] {
+    for (size_t i = 0; i < n; ++i) {
+      Float acc = 0;
+      for (size_t j = 0; j < n; ++j) acc += dense[i * n + j] * x[j];
+      y[i] = acc;
+    }
+    do_not_optimise(y[0]);
+  });
+  const double t_csr = time_min([&] {
+    multiply(csr, xv, yv);
+    do_not_optimise(y[0]);
+  });
+  const double t_coo = time_min([&] {
+    multiply(coo, xv, yv);
+    do_not_optimise(y[0]);
+  });
+  const double t_csr_block = time_min([&] {
+    multiply(csr, xm, ym);
+    do_not_optimise(y[0]);
+  });
+  const double t_coo_block = time_min([&] {
+    multiply(coo, xm, ym);
+    do_not_optimise(y[0]);
+  });
+
+  report("dense * vector", t_dense, extra);
+  report("CSR * vector", t_csr, extra);
+  report("COO * vector", t_coo, extra);
+  report("CSR * " + std::to_string(n_vectors) + " vectors", t_csr_block, extra);
+  report("COO * " + std::to_string(n_vectors) + " vectors", t_coo_block, extra);
+  std::printf("memory dense %zu bytes, CSR %zu bytes, COO %zu bytes\n",
+              dense.size() * sizeof(Float),
+              values.size() * (sizeof(Float) + sizeof(Integer32)) +
+                    indptr.size() * sizeof(Integer32),
+              values.size() * (sizeof(Float) + 2 * sizeof(Integer32)));
+  return 0;
+}
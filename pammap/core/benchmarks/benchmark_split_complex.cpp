@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SplitComplexView.hpp"
+#include "benchmark.hpp"
+#include "reductions.hpp"
+#include <cstdlib>
+
+/** Compare complex kernels (dot, axpy and the sum of squared absolute
+ *  values) on interleaved ArrayView<Complex> data against the split layout
+ *  of SplitComplexView. The number of elements can be passed as the first
+ *  argument (default 1e6). */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000;
+  std::vector<Complex> x(n), y(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = Complex(1.0 / static_cast<Float>(i + 1), 0.5);
+    y[i] = Complex(0.25, -1.0 / static_cast<Float>(i + 2));
+  }
+  std::vector<Float> x_re(n), x_im(n), y_re(n), y_im(n);
+  SplitComplexView sx(x_re, x_im), sy(y_re, y_im);
+  sx.copy_from(ArrayView<Complex>(x));
+  sy.copy_from(ArrayView<Complex>(y));
+  const Complex alpha(1e-9, -1e-9);
+  const std::string extra = "n = " + std::to_string(n);
+
+  const double t_dot_interleaved = time_min([&] {
+    Complex acc = 0;
+    for (size_t i = 0; i < n; ++i) acc += x[i] * y[i];
+    do_not_optimise(acc);
+  });
+  const double t_dot_split = time_min([&] { do_not_optimise(dot(sx, sy)); });
+
+  const double t_axpy_interleaved = time_min([&] {
+    for (size_t i = 0; i < n; ++i) y[i] += alpha * x[i];
+    do_not_optimise(y[0]);
+  });
+  const double t_axpy_split = time_min([&] {
+    axpy(alpha, sx, sy);
+    do_not_optimise(y_re[0]);
+  });
+
+  const double t_abs2_interleaved = time_min([&] {
+    const Float norm = norm2(ArrayView<Complex>(x));
+    do_not_optimise(norm * norm);
+  });
+  const double t_abs2_split = time_min([&] { do_not_optimise(sum_abs2(sx)); });
+
+  const double t_to_split = time_min([&] {
+    sx.copy_from(ArrayView<Complex>(x));
+    do_not_optimise(x_re[0]);
+  });
+  const double t_to_interleaved = time_min([&] {
+    sx.copy_to(ArrayView<Complex>(x));
+    do_not_optimise(x[0]);
+  });
+
+  report("dot      interleaved", t_dot_interleaved, extra);
+  report("dot      split", t_dot_split, extra);
+  report("axpy     interleaved", t_axpy_interleaved, extra);
+  report("axpy     split", t_axpy_split, extra);
+  report("abs2     interleaved (norm2)", t_abs2_interleaved, extra);
+  report("abs2     split", t_abs2_split, extra);
+  report("convert  to split", t_to_split, extra);
+  report("convert  to interleaved", t_to_interleaved, extra);
+  std::printf("kernels: %s\n", reduction_isa().c_str());
+  return 0;
+}
@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "StringArray.hpp"
+#include "benchmark.hpp"
+#include <cstdlib>
+
+/** Compare label arrays stored as StringArray against Array<String>:
+ *  copying, a sweep over all strings and the conversion to the fixed-width
+ *  layout of numpy. The number of labels can be passed as the first
+ *  argument (default 1e6). */
+int main(int argc, char** argv) {
+  using namespace pammap;
+  using namespace pammap::benchmark;
+
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000;
+  const char* elements[] = {"H", "C", "N", "O", "Na", "Cl", "Fe"};
+  const char* shells[]   = {"1s", "2s", "2p_x", "2p_y", "2p_z", "3d_xy"};
+
+  Array<String> strings({n});
+  for (size_t i = 0; i < n; ++i) {
+    strings[i] = std::string(elements[i % 7]) + std::to_string(i / 50) + "_" +
+                 shells[i % 6];
+  }
+  StringArray packed(strings.view());
+  const size_t width = packed.view().max_length();
+  std::vector<char> fixed(n * width);
+  const std::string extra = "n = " + std::to_string(n);
+
+  const double t_copy_strings = time_min([&] {
+    Array<String> copy(strings.view());
+    do_not_optimise(copy[0]);
+  });
+  const double t_copy_packed = time_min([&] {
+    StringArray copy(packed.view());
+    do_not_optimise(copy.view().chars()[0]);
+  });
+  const double t_sweep_strings = time_min([&] {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) count += strings[i].back() == 'x' ? 1u : 0u;
+    do_not_optimise(count);
+  });
+  const double t_sweep_packed = time_min([&] {
+    size_t count = 0;
+    for (string_view s : packed.view()) count += s[s.size() - 1] == 'x' ? 1u : 0u;
+    do_not_optimise(count);
+  });
+  const double t_fixed_packed = time_min([&] {
+    packed.view().to_fixed_width(fixed.data(), width);
+    do_not_optimise(fixed[0]);
+  });
+  const double t_from_fixed = time_min([&] {
+    StringArray back = StringArray::from_fixed_width(fixed.data(), n, width);
+    do_not_optimise(back.view().chars()[0]);
+  });
+
+  report("copy     Array<String>", t_copy_strings, extra);
+  report("copy     StringArray", t_copy_packed, extra);
+  report("sweep    Array<String>", t_sweep_strings, extra);
+  report("sweep    StringArray", t_sweep_packed, extra);
+  report("to_fixed_width", t_fixed_packed, extra);
+  report("from_fixed_width", t_from_fixed, extra);
+
+  size_t heap_bytes = n * sizeof(String);
+  for (size_t i = 0; i < n; ++i) {
+    // Strings beyond the small string buffer have their own allocation
+    if (strings[i].capacity() > 15) heap_bytes += strings[i].capacity() + 1;
+  }
+  std::printf("memory Array<String> %zu bytes, StringArray %zu bytes\n", heap_bytes,
+              packed.view().total_chars() + (n + 1) * sizeof(StringArray::offset_type));
+  return 0;
+}
@@ -0,0 +1,371 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "exceptions.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace pammap {
+
+namespace detail {
+
+/** An axis of a copy with the strides in destination and source */
+struct CopyAxis {
+  size_t extent;
+  ptrdiff_t dst;
+  ptrdiff_t src;
+};
+
+/** Plan for copying between two views of the same shape, but arbitrary strides.
+ *
+ * Axes of length one are dropped, the remaining axes are sorted by
+ * increasing destination stride and neighbouring axes which are contiguous
+ * with respect to each other in both views are merged. Then one of two
+ * strategies is used:
+ *
+ *   - If the axis with the smallest destination stride also has the smallest
+ *     source stride, the data is copied row by row along this axis (using
+ *     std::copy if both strides are one), with the remaining axes looped
+ *     over in order of increasing destination stride.
+ *   - Otherwise the two axes with smallest destination and smallest source
+ *     stride form a 2D transpose, which is processed in square tiles, such
+ *     that both the reads and the writes of a tile stay in cache. Tiles
+ *     larger than the L1 cache are staged in a buffer (see copy_strip).
+ *
+ * The work is divided into units (chunks of rows or strips of tiles),
+ * such that it can be distributed between threads.
+ */
+template <typename T>
+class CopyPlan {
+ public:
+  CopyPlan(span<const size_t> shape, span<const ptrdiff_t> dst_strides,
+           span<const ptrdiff_t> src_strides);
+
+  /** Number of work units */
+  size_t units() const { return m_outer_count * m_inner_units; }
+
+  /** Process the work units in ``[begin, end)`` */
+  void run(T* dst, const T* src, size_t begin, size_t end) const;
+
+ private:
+  /** Edge length of the tiles for transposes. Each row of a tile should
+   *  cover a few kilobytes, such that the hardware prefetchers see long
+   *  sequential runs on both the source and the destination side. */
+  static constexpr size_t tile =
+        sizeof(T) >= 256 ? 8 : (sizeof(T) >= 8 ? 2048 / sizeof(T) : 256);
+
+  /** Number of tiles along the axis i per work unit for transposes. Processing
+   *  a few neighbouring tiles together keeps the number of pages touched in
+   *  each sweep over the axis j small enough for the TLB. */
+  static constexpr size_t strip = 8;
+
+  /** Number of elements per work unit for row copies */
+  static constexpr size_t row_chunk = 16384;
+
+  /** Tiles of up to this many bytes are transposed directly (without
+   *  staging them in a buffer), since they fit into the L1 cache anyway */
+  static constexpr size_t direct_tile_bytes = 16384;
+
+  /** Copy ``count`` elements along a row */
+  static void copy_row(T* dst, ptrdiff_t dst_stride, const T* src, ptrdiff_t src_stride,
+                       size_t count);
+
+  /** Copy the tiles of a strip of rows ``[i_begin, i_end)`` of a transpose */
+  void copy_strip(T* dst, const T* src, size_t i_begin, size_t i_end, T* buffer) const;
+
+  /** Transpose a tile of ``ni x nj`` elements, where the axis i is
+   *  contiguous in the source and the axis j in the destination. */
+  static void copy_tile(T* dst, ptrdiff_t dst_i, ptrdiff_t dst_j, const T* src,
+                        ptrdiff_t src_i, ptrdiff_t src_j, size_t ni, size_t nj);
+
+  /** The simplified axes, fastest destination axis first */
+  std::array<CopyAxis, max_dynamic_rank> m_axes{};
+  size_t m_ndim = 0;
+
+  /** The axis with the smallest source stride if a transpose is needed,
+   *  else 0. Unused if m_ndim == 0. */
+  size_t m_tile_axis = 0;
+
+  /** The axes looped over outside the row copies or tiles */
+  std::array<size_t, max_dynamic_rank> m_outer{};
+  size_t m_n_outer = 0;
+
+  /** Number of positions of the outer axes and units per position */
+  size_t m_outer_count = 1;
+  size_t m_inner_units = 1;
+
+  /** Number of elements of the buffer for staging the tiles of a transpose
+   *  (0 if no staging is needed) and the distance between its rows */
+  size_t m_buffer_size = 0;
+  size_t m_buffer_ld   = 0;
+};
+
+template <typename T>
+constexpr size_t CopyPlan<T>::tile;
+template <typename T>
+constexpr size_t CopyPlan<T>::strip;
+template <typename T>
+constexpr size_t CopyPlan<T>::row_chunk;
+template <typename T>
+constexpr size_t CopyPlan<T>::direct_tile_bytes;
+
+template <typename T>
+CopyPlan<T>::CopyPlan(span<const size_t> shape, span<const ptrdiff_t> dst_strides,
+                      span<const ptrdiff_t> src_strides) {
+  std::array<CopyAxis, max_dynamic_rank> axes{};
+  size_t n = 0;
+  for (size_t d = 0; d < shape.size(); ++d) {
+    if (shape[d] == 0) {
+      // Nothing to do at all
+      m_outer_count = 0;
+      return;
+    }
+    if (shape[d] != 1) axes[n++] = CopyAxis{shape[d], dst_strides[d], src_strides[d]};
+  }
+  std::stable_sort(axes.begin(), axes.begin() + static_cast<ptrdiff_t>(n),
+                   [](const CopyAxis& a, const CopyAxis& b) {
+                     return std::abs(a.dst) < std::abs(b.dst);
+                   });
+
+  // Merge axes which are contiguous to their predecessors in both views
+  for (size_t d = 0; d < n; ++d) {
+    if (m_ndim > 0) {
+      CopyAxis& last   = m_axes[m_ndim - 1];
+      const auto ext   = static_cast<ptrdiff_t>(last.extent);
+      const bool merge = axes[d].dst == ext * last.dst && axes[d].src == ext * last.src;
+      if (merge) {
+        last.extent *= axes[d].extent;
+        continue;
+      }
+    }
+    m_axes[m_ndim++] = axes[d];
+  }
+  if (m_ndim == 0) return;  // A single element
+
+  for (size_t d = 1; d < m_ndim; ++d) {
+    if (std::abs(m_axes[d].src) < std::abs(m_axes[m_tile_axis].src)) m_tile_axis = d;
+  }
+  for (size_t d = 1; d < m_ndim; ++d) {
+    if (d == m_tile_axis) continue;
+    m_outer[m_n_outer++] = d;
+    m_outer_count *= m_axes[d].extent;
+  }
+
+  if (m_tile_axis == 0) {
+    m_inner_units = (m_axes[0].extent + row_chunk - 1) / row_chunk;
+  } else {
+    m_inner_units = (m_axes[m_tile_axis].extent + strip * tile - 1) / (strip * tile);
+
+    // The buffer only needs to hold the largest tile which actually occurs.
+    // Staging copies the elements by assignment into uninitialised memory,
+    // hence it is restricted to trivially copyable types.
+    const size_t ni = std::min(tile, m_axes[m_tile_axis].extent);
+    const size_t nj = std::min(tile, m_axes[0].extent);
+    if (std::is_trivially_copyable<T>::value && ni * nj * sizeof(T) > direct_tile_bytes) {
+      m_buffer_size = ni * nj;
+      m_buffer_ld   = ni;
+    }
+  }
+}
+
+template <typename T>
+void CopyPlan<T>::run(T* dst, const T* src, size_t begin, size_t end) const {
+  if (begin >= end) return;
+  if (m_ndim == 0) {
+    *dst = *src;
+    return;
+  }
+
+  // Tiles are staged in a buffer too large for the stack (see copy_strip).
+  // It is left uninitialised.
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+  std::unique_ptr<Storage[]> buffer(m_buffer_size > 0 ? new Storage[m_buffer_size]
+                                                      : nullptr);
+
+  // Unravel the outer position of the first unit
+  std::array<size_t, max_dynamic_rank> index{};
+  size_t outer = begin / m_inner_units;
+  size_t inner = begin % m_inner_units;
+  for (size_t k = 0; k < m_n_outer; ++k) {
+    const CopyAxis& axis = m_axes[m_outer[k]];
+    index[k]             = outer % axis.extent;
+    outer /= axis.extent;
+    dst += static_cast<ptrdiff_t>(index[k]) * axis.dst;  // NOLINT
+    src += static_cast<ptrdiff_t>(index[k]) * axis.src;  // NOLINT
+  }
+
+  for (size_t unit = begin; unit < end; ++unit) {
+    if (m_tile_axis == 0) {
+      const size_t first = inner * row_chunk;
+      const size_t count = std::min(row_chunk, m_axes[0].extent - first);
+      const auto offset  = static_cast<ptrdiff_t>(first);
+      copy_row(dst + offset * m_axes[0].dst, m_axes[0].dst, src + offset * m_axes[0].src,
+               m_axes[0].src, count);
+    } else {
+      const size_t i_begin = inner * strip * tile;
+      const size_t i_end = std::min(i_begin + strip * tile, m_axes[m_tile_axis].extent);
+      copy_strip(dst, src, i_begin, i_end, reinterpret_cast<T*>(buffer.get()));
+    }
+
+    // Move to the next unit and (if needed) outer position
+    if (++inner < m_inner_units) continue;
+    inner = 0;
+    for (size_t k = 0; k < m_n_outer; ++k) {
+      const CopyAxis& axis = m_axes[m_outer[k]];
+      dst += axis.dst;  // NOLINT
+      src += axis.src;  // NOLINT
+      if (++index[k] < axis.extent) break;
+      dst -= static_cast<ptrdiff_t>(axis.extent) * axis.dst;  // NOLINT
+      src -= static_cast<ptrdiff_t>(axis.extent) * axis.src;  // NOLINT
+      index[k] = 0;
+    }
+  }
+}
+
+template <typename T>
+void CopyPlan<T>::copy_row(T* dst, ptrdiff_t dst_stride, const T* src,
+                           ptrdiff_t src_stride, size_t count) {
+  if (dst_stride == 1 && src_stride == 1) {
+    std::copy(src, src + count, dst);
+    return;
+  }
+  for (size_t k = 0; k < count; ++k) {
+    const auto i = static_cast<ptrdiff_t>(k);
+    dst[i * dst_stride] = src[i * src_stride];
+  }
+}
+
+template <typename T>
+void CopyPlan<T>::copy_strip(T* dst, const T* src, size_t i_begin, size_t i_end,
+                             T* buffer) const {
+  const CopyAxis& axis_i = m_axes[m_tile_axis];
+  const CopyAxis& axis_j = m_axes[0];
+
+  // Large tiles are first gathered into a buffer: With power-of-two strides
+  // the rows of a tile would otherwise compete for the same cache sets.
+  // Small tiles (buffer == nullptr) stay in the L1 cache anyway.
+  const auto ld = static_cast<ptrdiff_t>(m_buffer_ld);
+  for (size_t j = 0; j < axis_j.extent; j += tile) {
+    const auto jb   = static_cast<ptrdiff_t>(j);
+    const size_t nj = std::min(tile, axis_j.extent - j);
+    for (size_t i = i_begin; i < i_end; i += tile) {
+      const auto ib   = static_cast<ptrdiff_t>(i);
+      const size_t ni = std::min(tile, i_end - i);
+      const T* s      = src + ib * axis_i.src + jb * axis_j.src;
+      if (buffer == nullptr) {
+        copy_tile(dst + ib * axis_i.dst + jb * axis_j.dst, axis_i.dst, axis_j.dst, s,
+                  axis_i.src, axis_j.src, ni, nj);
+        continue;
+      }
+      for (size_t jj = 0; jj < nj; ++jj) {
+        const auto jo = static_cast<ptrdiff_t>(jj);
+        copy_row(buffer + jo * ld, 1, s + jo * axis_j.src, axis_i.src, ni);
+      }
+      copy_tile(dst + ib * axis_i.dst + jb * axis_j.dst, axis_i.dst, axis_j.dst, buffer,
+                1, ld, ni, nj);
+    }
+  }
+}
+
+template <typename T>
+void CopyPlan<T>::copy_tile(T* dst, ptrdiff_t dst_i, ptrdiff_t dst_j, const T* src,
+                            ptrdiff_t src_i, ptrdiff_t src_j, size_t ni, size_t nj) {
+  size_t i = 0;
+#ifdef __SSE2__
+  // 2x2 blocks of 8-byte elements with unit strides are transposed
+  // in registers: Two loads of two elements along i, two unpacks
+  // and two stores of two elements along j.
+  if (sizeof(T) == 8 && std::is_trivially_copyable<T>::value && src_i == 1 &&
+      dst_j == 1) {
+    for (; i + 2 <= ni; i += 2) {
+      const auto ii = static_cast<ptrdiff_t>(i);
+      size_t j      = 0;
+      for (; j + 2 <= nj; j += 2) {
+        const auto jj  = static_cast<ptrdiff_t>(j);
+        const T* s     = src + ii + jj * src_j;
+        T* d           = dst + ii * dst_i + jj;
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + src_j));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_unpacklo_epi64(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + dst_i), _mm_unpackhi_epi64(a, b));
+      }
+      for (; j < nj; ++j) {
+        const auto jj          = static_cast<ptrdiff_t>(j);
+        dst[ii * dst_i + jj]       = src[ii + jj * src_j];
+        dst[(ii + 1) * dst_i + jj] = src[ii + 1 + jj * src_j];
+      }
+    }
+  }
+#endif
+
+  for (; i < ni; ++i) {
+    const auto ii = static_cast<ptrdiff_t>(i);
+    for (size_t j = 0; j < nj; ++j) {
+      const auto jj                = static_cast<ptrdiff_t>(j);
+      dst[ii * dst_i + jj * dst_j] = src[ii * src_i + jj * src_j];
+    }
+  }
+}
+
+}  // namespace detail
+
+/** Copy the elements of ``src`` into ``dst``, which need to have the same shape
+ *  and must not overlap in memory.
+ *
+ * This is meant for converting between memory layouts, e.g. from the
+ * C-contiguous arrays obtained from numpy to the Fortran-contiguous arrays
+ * expected by a computational kernel. Arbitrary strides are supported: Rows
+ * with a common fastest axis are copied directly, transposes are processed
+ * in cache-sized tiles (see detail::CopyPlan). If ``parallel`` is true and
+ * the views have at least parallel_min_size elements, the work is split
+ * between the workers of ThreadPool::global().
+ */
+template <typename T, size_t N, size_t M>
+void copy_into(ArrayView<T, N> dst, const ArrayView<T, M>& src, bool parallel = true) {
+  pammap_throw(dst.shape() == src.shape(), ValueError,
+               "Source and destination passed to copy_into need to have the same shape.");
+  const detail::CopyPlan<T> plan(dst.shape(), dst.strides(), src.strides());
+  T* dst_data       = dst.data();
+  const T* src_data = src.data();
+
+  ThreadPool& pool    = ThreadPool::global();
+  const size_t units  = plan.units();
+  const size_t chunks = !parallel || dst.size() < parallel_min_size
+                              ? 1
+                              : std::min(pool.size(), units);
+  if (chunks <= 1) {
+    plan.run(dst_data, src_data, 0, units);
+    return;
+  }
+  pool.run([&](size_t chunk) {
+    if (chunk >= chunks) return;
+    plan.run(dst_data, src_data, units * chunk / chunks, units * (chunk + 1) / chunks);
+  });
+}
+
+}  // namespace pammap
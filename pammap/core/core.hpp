@@ -18,9 +18,27 @@
 //
 
 #pragma once
+#include "Array.hpp"
 #include "ArrayView.hpp"
+#include "BitArray.hpp"
+#include "BufferPool.hpp"
+#include "ChunkedArray.hpp"
+#include "ConvertingView.hpp"
+#include "GatherIndex.hpp"
+#include "GlobPattern.hpp"
 #include "PamMap.hpp"
+#include "PamMapOverride.hpp"
 #include "Slice.hpp"
+#include "SlicePlan.hpp"
+#include "SparseMatrixView.hpp"
+#include "SplitComplexView.hpp"
+#include "StringArray.hpp"
+#include "ThreadPool.hpp"
 #include "any.hpp"
+#include "copy_into.hpp"
+#include "reductions.hpp"
 #include "exceptions.hpp"
+#include "expressions.hpp"
+#include "map_array.hpp"
+#include "parallel.hpp"
 #include "typedefs.hxx"
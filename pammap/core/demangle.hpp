@@ -35,4 +35,12 @@ inline std::string demangle(const std::string& mangled_name) {
 /** Return the demangled typename of the type_info */
 inline std::string demangle(const std::type_info& type) { return demangle(type.name()); }
 
+/** The readable name of the type T as it appears in error messages,
+ *  by default the demangled name. Specialised for types, whose demangled
+ *  name carries template arguments of no interest (see ArrayView). */
+template <typename T>
+struct TypeName {
+  static std::string get() { return demangle(typeid(T)); }
+};
+
 }  // namespace pammap
@@ -0,0 +1,32 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+
+namespace pammap {
+
+/** Marker for the rank of an ArrayView, whose number of dimensions
+ *  is only known at runtime */
+constexpr size_t DynamicRank = static_cast<size_t>(-1);
+
+/** Maximal number of dimensions of an ArrayView with DynamicRank */
+constexpr size_t max_dynamic_rank = 8;
+
+}  // namespace pammap
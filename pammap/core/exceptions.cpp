@@ -46,6 +46,7 @@ define_description_error(NotImplementedError)
 define_description_error(TypeError)
 define_description_error(ValueError)
 define_description_error(IndexError)
+define_description_error(IOError)
 /* clang-format on */
 
 }  // namespace pammap
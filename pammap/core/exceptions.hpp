@@ -64,6 +64,9 @@ declare_description_error(NotImplementedError);
 /** Error to flag that and index is out of range */
 declare_description_error(IndexError);
 
+/** Error to flag that reading or writing a file failed */
+declare_description_error(IOError);
+
 #undef declare_description_error
 #undef pammap_error_constructor_args
 #undef pammap_error_constructor_vars
@@ -0,0 +1,348 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "parallel.hpp"
+#include <complex>
+#include <type_traits>
+
+namespace pammap {
+
+/** \file Lazy element-wise expressions over ArrayViews.
+ *
+ * The arithmetic operators ``+``, ``-``, ``*`` and ``/`` applied to
+ * ArrayViews (and scalars) do not compute anything, but build an expression
+ * tree, whose type encodes the operations at compile time. Only ``assign``
+ * evaluates the expression and does so in a single fused pass over the
+ * data, i.e.
+ * \code
+ *   assign(out, a * 2.0 + b * c - d);
+ * \endcode
+ * reads each element of ``a``, ``b``, ``c`` and ``d`` exactly once and
+ * writes each element of ``out`` once, without any temporary arrays.
+ * The traversal is the one of the operations in parallel.hpp: If all views
+ * share the layout of ``out`` and this is contiguous the evaluation is one
+ * flat unit-stride loop, which the compiler can vectorise, and large
+ * views are split between the threads of ThreadPool::global().
+ *
+ * All views of an expression need to have the shape of the destination
+ * (use ArrayView::broadcast_to for broadcasting). Elements are combined
+ * by multi-index, such that ``out`` may appear in the expression itself,
+ * but must not overlap with a view of a different layout.
+ * An expression only refers to the data of its views, which need to
+ * outlive it.
+ */
+
+namespace detail {
+
+/** Expression node for the elements of an ArrayView */
+template <typename T>
+class ViewExpression {
+ public:
+  typedef typename std::remove_const<T>::type value_type;
+
+  explicit ViewExpression(const ArrayView<T>& view) : m_view(view) {}
+
+  /** Check that all views of the expression have the given shape */
+  void check_shape(span<const size_t> shape) const {
+    pammap_throw(m_view.shape() == shape, ValueError,
+                 "All ArrayViews of an expression need to have the shape of the "
+                 "destination.");
+  }
+
+  /** Do all views of the expression have the given strides */
+  bool same_strides(span<const ptrdiff_t> strides) const {
+    return m_view.strides() == strides;
+  }
+
+  /** Set up the traversal (see make_cursor) */
+  void prepare(bool flat, const unsigned char* order) {
+    m_cursor = make_cursor(m_view, flat, order);
+  }
+
+  //@{
+  /** Cursor interface (see traverse_range) */
+  void seek(const Traversal& traversal, const size_t* index) {
+    m_cursor.seek(traversal, index);
+  }
+  value_type at(size_t i) const { return m_cursor.at(i); }
+  value_type get() const { return m_cursor.get(); }
+  void skip(size_t count) { m_cursor.skip(count); }
+  void step() { m_cursor.step(); }
+  //@}
+
+ private:
+  ArrayView<T> m_view;
+  Cursor<T> m_cursor;
+};
+
+/** Expression node for a scalar, which is the same for all elements */
+template <typename S>
+class ScalarExpression {
+ public:
+  typedef S value_type;
+
+  explicit ScalarExpression(S value) : m_value(value) {}
+
+  void check_shape(span<const size_t>) const {}
+  bool same_strides(span<const ptrdiff_t>) const { return true; }
+  void prepare(bool, const unsigned char*) {}
+
+  //@{
+  /** Cursor interface (see traverse_range) */
+  void seek(const Traversal&, const size_t*) {}
+  value_type at(size_t) const { return m_value; }
+  value_type get() const { return m_value; }
+  void skip(size_t) {}
+  void step() {}
+  //@}
+
+ private:
+  S m_value;
+};
+
+/** Expression node combining the elements of two expressions by ``Op`` */
+template <typename Op, typename L, typename R>
+class BinaryExpression {
+ public:
+  typedef decltype(Op::apply(std::declval<typename L::value_type>(),
+                             std::declval<typename R::value_type>())) value_type;
+
+  BinaryExpression(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs) {}
+
+  void check_shape(span<const size_t> shape) const {
+    m_lhs.check_shape(shape);
+    m_rhs.check_shape(shape);
+  }
+  bool same_strides(span<const ptrdiff_t> strides) const {
+    return m_lhs.same_strides(strides) && m_rhs.same_strides(strides);
+  }
+  void prepare(bool flat, const unsigned char* order) {
+    m_lhs.prepare(flat, order);
+    m_rhs.prepare(flat, order);
+  }
+
+  //@{
+  /** Cursor interface (see traverse_range) */
+  void seek(const Traversal& traversal, const size_t* index) {
+    m_lhs.seek(traversal, index);
+    m_rhs.seek(traversal, index);
+  }
+  value_type at(size_t i) const { return Op::apply(m_lhs.at(i), m_rhs.at(i)); }
+  value_type get() const { return Op::apply(m_lhs.get(), m_rhs.get()); }
+  void skip(size_t count) {
+    m_lhs.skip(count);
+    m_rhs.skip(count);
+  }
+  void step() {
+    m_lhs.step();
+    m_rhs.step();
+  }
+  //@}
+
+ private:
+  L m_lhs;
+  R m_rhs;
+};
+
+/** Expression node applying ``Op`` to the elements of an expression */
+template <typename Op, typename E>
+class UnaryExpression {
+ public:
+  typedef decltype(Op::apply(std::declval<typename E::value_type>())) value_type;
+
+  explicit UnaryExpression(const E& operand) : m_operand(operand) {}
+
+  void check_shape(span<const size_t> shape) const { m_operand.check_shape(shape); }
+  bool same_strides(span<const ptrdiff_t> strides) const {
+    return m_operand.same_strides(strides);
+  }
+  void prepare(bool flat, const unsigned char* order) { m_operand.prepare(flat, order); }
+
+  //@{
+  /** Cursor interface (see traverse_range) */
+  void seek(const Traversal& traversal, const size_t* index) {
+    m_operand.seek(traversal, index);
+  }
+  value_type at(size_t i) const { return Op::apply(m_operand.at(i)); }
+  value_type get() const { return Op::apply(m_operand.get()); }
+  void skip(size_t count) { m_operand.skip(count); }
+  void step() { m_operand.step(); }
+  //@}
+
+ private:
+  E m_operand;
+};
+
+/** Explicit conversion, which is a no-op for values of the target type */
+template <typename C, typename A>
+typename std::enable_if<!std::is_same<C, A>::value, C>::type promote(A a) {
+  return static_cast<C>(a);
+}
+template <typename C>
+C promote(C a) {
+  return a;
+}
+
+/** Type of the elements resulting from an operation on elements of type A
+ *  and B (like numpy, e.g. Integer and Float give Float and two Integer8
+ *  give Integer8) */
+template <typename A, typename B>
+using common_t = typename std::common_type<A, B>::type;
+
+//@{
+/** The element-wise operations */
+struct Plus {
+  template <typename A, typename B>
+  static common_t<A, B> apply(A a, B b) {
+    typedef common_t<A, B> C;
+    return promote<C>(promote<C>(a) + promote<C>(b));
+  }
+};
+struct Minus {
+  template <typename A, typename B>
+  static common_t<A, B> apply(A a, B b) {
+    typedef common_t<A, B> C;
+    return promote<C>(promote<C>(a) - promote<C>(b));
+  }
+};
+struct Multiplies {
+  template <typename A, typename B>
+  static common_t<A, B> apply(A a, B b) {
+    typedef common_t<A, B> C;
+    return promote<C>(promote<C>(a) * promote<C>(b));
+  }
+};
+struct Divides {
+  template <typename A, typename B>
+  static common_t<A, B> apply(A a, B b) {
+    typedef common_t<A, B> C;
+    return promote<C>(promote<C>(a) / promote<C>(b));
+  }
+};
+struct Negate {
+  template <typename A>
+  static A apply(A a) {
+    return promote<A>(-a);
+  }
+};
+//@}
+
+/** Is the type an expression node */
+template <typename T>
+struct IsExpression : std::false_type {};
+template <typename T>
+struct IsExpression<ViewExpression<T>> : std::true_type {};
+template <typename S>
+struct IsExpression<ScalarExpression<S>> : std::true_type {};
+template <typename Op, typename L, typename R>
+struct IsExpression<BinaryExpression<Op, L, R>> : std::true_type {};
+template <typename Op, typename E>
+struct IsExpression<UnaryExpression<Op, E>> : std::true_type {};
+
+/** Is the type a scalar, which can be combined with expressions */
+template <typename T>
+struct IsScalar : std::is_arithmetic<T> {};
+template <typename T>
+struct IsScalar<std::complex<T>> : std::true_type {};
+
+/** Conversion of the operands of the operators below to expression nodes,
+ *  only defined for ArrayViews, scalars and expressions */
+template <typename T, typename = void>
+struct Operand {};
+template <typename T, size_t N>
+struct Operand<ArrayView<T, N>> {
+  typedef ViewExpression<T> type;
+  static type make(const ArrayView<T, N>& view) { return type(ArrayView<T>(view)); }
+};
+template <typename S>
+struct Operand<S, typename std::enable_if<IsScalar<S>::value>::type> {
+  typedef ScalarExpression<S> type;
+  static type make(S value) { return type(value); }
+};
+template <typename E>
+struct Operand<E, typename std::enable_if<IsExpression<E>::value>::type> {
+  typedef E type;
+  static const E& make(const E& e) { return e; }
+};
+
+/** Binary expression node of two operands, unless both are scalars */
+template <typename Op, typename L, typename R>
+using binary_t = typename std::enable_if<
+      !(IsScalar<L>::value && IsScalar<R>::value),
+      BinaryExpression<Op, typename Operand<L>::type, typename Operand<R>::type>>::type;
+}  // namespace detail
+
+//@{
+/** Lazy element-wise arithmetic of ArrayViews, expressions and scalars,
+ *  see the description at the top of this file */
+template <typename L, typename R>
+detail::binary_t<detail::Plus, L, R> operator+(const L& lhs, const R& rhs) {
+  return {detail::Operand<L>::make(lhs), detail::Operand<R>::make(rhs)};
+}
+template <typename L, typename R>
+detail::binary_t<detail::Minus, L, R> operator-(const L& lhs, const R& rhs) {
+  return {detail::Operand<L>::make(lhs), detail::Operand<R>::make(rhs)};
+}
+template <typename L, typename R>
+detail::binary_t<detail::Multiplies, L, R> operator*(const L& lhs, const R& rhs) {
+  return {detail::Operand<L>::make(lhs), detail::Operand<R>::make(rhs)};
+}
+template <typename L, typename R>
+detail::binary_t<detail::Divides, L, R> operator/(const L& lhs, const R& rhs) {
+  return {detail::Operand<L>::make(lhs), detail::Operand<R>::make(rhs)};
+}
+template <typename E,
+          typename = typename std::enable_if<!detail::IsScalar<E>::value>::type>
+detail::UnaryExpression<detail::Negate, typename detail::Operand<E>::type> operator-(
+      const E& operand) {
+  return detail::UnaryExpression<detail::Negate, typename detail::Operand<E>::type>(
+        detail::Operand<E>::make(operand));
+}
+//@}
+
+namespace detail {
+// Make argument-dependent lookup find the operators for expression nodes
+using pammap::operator+;
+using pammap::operator-;
+using pammap::operator*;
+using pammap::operator/;
+}  // namespace detail
+
+/** Evaluate the expression and store the result in ``out`` in one fused
+ *  parallel pass. Throws a ValueError if the shapes of the views in the
+ *  expression differ from the shape of ``out``. */
+template <typename T, size_t N, typename E,
+          typename = typename std::enable_if<detail::IsExpression<E>::value>::type>
+void assign(ArrayView<T, N> out, const E& expression) {
+  ArrayView<T> destination(out);
+  E expr(expression);
+  expr.check_shape(destination.shape());
+
+  const detail::TraversalPlan plan =
+        detail::plan_traversal(destination, expr.same_strides(destination.strides()));
+  expr.prepare(plan.one_axis, plan.order.data());
+
+  auto kernel = [](T& o, const typename E::value_type& v) { o = static_cast<T>(v); };
+  detail::traverse_parallel(
+        plan.traversal, destination.size(), plan.align, plan.skew, kernel,
+        detail::make_cursor(destination, plan.one_axis, plan.order.data()), expr);
+}
+
+}  // namespace pammap
@@ -0,0 +1,227 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "map_array.hpp"
+#include "config.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#ifdef HAVE_POSIX_MAPPED_FILES
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pammap {
+namespace detail {
+
+namespace {
+/** A mapping, stored in place of the elements of its ArrayBuffer */
+struct Mapping {
+  void* address;
+  size_t length;
+};
+
+/** The value following ``'key':`` in the header dictionary of a .npy file */
+std::string npy_value(const std::string& header, const std::string& key,
+                      const std::string& path) {
+  const std::string pattern = "'" + key + "':";
+  size_t begin              = header.find(pattern);
+  pammap_throw(begin != std::string::npos, ValueError,
+               "The header of the .npy file '" + path + "' has no entry '" + key + "'.");
+  begin = header.find_first_not_of(' ', begin + pattern.size());
+
+  // The value ends at the closing quote or parenthesis or the next comma
+  const char first = begin < header.size() ? header[begin] : ',';
+  const char last  = first == '\'' ? '\'' : first == '(' ? ')' : ',';
+  const size_t end = header.find_first_of(std::string{last, '}'}, begin + 1);
+  pammap_throw(end != std::string::npos, ValueError,
+               "The header of the .npy file '" + path + "' is malformed.");
+  return header.substr(begin, end - begin + (last == ',' ? 0 : 1));
+}
+}  // namespace
+
+std::string with_reason(const std::string& message) {
+  return message + ": " + std::strerror(errno) + ".";
+}
+
+int open_file(const std::string& path, size_t min_bytes, size_t& file_bytes) {
+#ifdef HAVE_POSIX_MAPPED_FILES
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  pammap_throw(fd >= 0, IOError, with_reason("Could not open '" + path + "'"));
+
+  struct stat info;
+  file_bytes = 0;
+  if (::fstat(fd, &info) == 0) file_bytes = static_cast<size_t>(info.st_size);
+  if (file_bytes < min_bytes) {
+    ::close(fd);
+    pammap_throw(false, IOError,
+                 "File '" + path + "' is too small for the array it should contain.");
+  }
+  return fd;
+#else
+  (void)min_bytes;
+  (void)file_bytes;
+  pammap_throw(false, NotImplementedError,
+               "Opening '" + path + "' failed: Not supported on this platform.");
+  return -1;
+#endif
+}
+
+ArrayBuffer* map_file(const std::string& path, size_t offset, size_t bytes,
+                      MappedFile::MODE mode, char*& data) {
+#ifdef HAVE_POSIX_MAPPED_FILES
+  size_t file_bytes = 0;
+  const int fd      = open_file(path, offset + bytes, file_bytes);
+
+  // The mapping needs to start at a page boundary
+  const size_t page  = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  const size_t head  = offset % page;
+  const size_t length = head + bytes;
+  // Arrays hand out mutable views, so all modes are mapped writable and
+  // private, such that writes never reach the file.
+  (void)mode;
+  void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                         static_cast<off_t>(offset - head));
+  const std::string failure = with_reason("Could not map '" + path + "'");
+  ::close(fd);  // The mapping stays valid
+  pammap_throw(address != MAP_FAILED, IOError, failure);
+
+  ArrayBuffer* buffer;
+  try {
+    buffer = ArrayBuffer::create<Mapping>(1);
+  } catch (...) {
+    ::munmap(address, length);
+    throw;
+  }
+  new (buffer->elements<Mapping>()) Mapping{address, length};
+  buffer->destroy_elements = [](ArrayBuffer* b) {
+    const Mapping& mapping = *b->elements<Mapping>();
+    ::munmap(mapping.address, mapping.length);
+  };
+  data = static_cast<char*>(address) + head;
+  return buffer;
+#else
+  (void)offset;
+  (void)bytes;
+  (void)mode;
+  (void)data;
+  pammap_throw(false, NotImplementedError,
+               "Mapping '" + path + "' failed: Mapping files is not supported on "
+               "this platform.");
+  return nullptr;
+#endif
+}
+
+NpyHeader read_npy_header(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  pammap_throw(file.good(), IOError, "Could not open '" + path + "'.");
+
+  // Magic string, version and the length of the header (two bytes in
+  // version 1, four bytes in versions 2 and 3, little endian)
+  unsigned char preamble[12] = {};
+  file.read(reinterpret_cast<char*>(preamble), 10);
+  pammap_throw(file.good() && std::memcmp(preamble, "\x93NUMPY", 6) == 0, ValueError,
+               "File '" + path + "' is no .npy file.");
+  const unsigned major = preamble[6];
+  pammap_throw(major >= 1 && major <= 3, ValueError,
+               "Version " + std::to_string(major) + " of the .npy file '" + path +
+                     "' is not supported.");
+  size_t prefix = 10, header_bytes = size_t(preamble[8]) | size_t(preamble[9]) << 8;
+  if (major > 1) {
+    file.read(reinterpret_cast<char*>(preamble) + 10, 2);
+    prefix       = 12;
+    header_bytes = header_bytes | size_t(preamble[10]) << 16 | size_t(preamble[11]) << 24;
+  }
+  std::string header(header_bytes, '\0');
+  file.read(&header[0], static_cast<std::streamsize>(header_bytes));
+  pammap_throw(file.good(), ValueError,
+               "The header of the .npy file '" + path + "' is truncated.");
+
+  NpyHeader ret;
+  ret.data_offset = prefix + header_bytes;
+
+  const std::string descr = npy_value(header, "descr", path);
+  pammap_throw(descr.size() > 2 && descr.front() == '\'', ValueError,
+               "Only .npy files with a simple dtype are supported, not " + descr + ".");
+  ret.descr = descr.substr(1, descr.size() - 2);
+
+  const std::string fortran_order = npy_value(header, "fortran_order", path);
+  pammap_throw(fortran_order == "True" || fortran_order == "False", ValueError,
+               "Invalid value '" + fortran_order +
+                     "' of fortran_order in the header of '" + path + "'.");
+  ret.fortran_order = fortran_order == "True";
+
+  // The shape is a tuple like (), (3,) or (3, 4)
+  const std::string shape = npy_value(header, "shape", path);
+  pammap_throw(shape.size() >= 2 && shape.front() == '(', ValueError,
+               "Invalid shape " + shape + " in the header of '" + path + "'.");
+  size_t pos = 1;
+  while (true) {
+    pos = shape.find_first_not_of(" ,", pos);
+    if (pos == std::string::npos || shape[pos] == ')') break;
+    size_t used = 0;
+    try {
+      ret.shape.push_back(std::stoul(shape.substr(pos), &used));
+    } catch (const std::exception&) {
+      used = 0;
+    }
+    pammap_throw(used > 0, ValueError,
+                 "Invalid shape " + shape + " in the header of '" + path + "'.");
+    pos += used;
+  }
+  return ret;
+}
+
+void advise(const void* begin, size_t bytes, MappedFile::ADVICE advice) {
+#ifdef HAVE_POSIX_MAPPED_FILES
+  // madvise needs the start of a page
+  const auto address = reinterpret_cast<std::uintptr_t>(begin);
+  const auto page    = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+  const std::uintptr_t start = address / page * page;
+
+  int flag = MADV_NORMAL;
+  switch (advice) {
+    case MappedFile::NORMAL:
+      flag = MADV_NORMAL;
+      break;
+    case MappedFile::SEQUENTIAL:
+      flag = MADV_SEQUENTIAL;
+      break;
+    case MappedFile::RANDOM:
+      flag = MADV_RANDOM;
+      break;
+    case MappedFile::WILLNEED:
+      flag = MADV_WILLNEED;
+      break;
+  }
+  // Only a hint, so failures are ignored
+  ::madvise(reinterpret_cast<void*>(start), bytes + (address - start), flag);
+#else
+  (void)begin;
+  (void)bytes;
+  (void)advice;
+#endif
+}
+
+}  // namespace detail
+}  // namespace pammap
@@ -0,0 +1,199 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "Array.hpp"
+#include "ArrayView.hpp"
+#include <complex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace pammap {
+
+/** Options for mapping files into memory (see map_array) */
+struct MappedFile {
+  /** How the pages of the file are mapped */
+  enum MODE {
+    /** The elements are only meant to be read. Since an Array always hands
+     *  out writable views, the file is mapped exactly like for COPY_ON_WRITE,
+     *  such that writing to the elements (e.g. through an ArrayView obtained
+     *  from a PamMap) only modifies a private copy of the page. */
+    READ_ONLY = 0,
+    /** Private writable mapping. Modified pages are copied on the first
+     *  write, such that changes are never written back to the file. */
+    COPY_ON_WRITE = 1,
+  };
+
+  /** Hint about the expected access pattern (see advise) */
+  enum ADVICE {
+    NORMAL     = 0,
+    SEQUENTIAL = 1,
+    RANDOM     = 2,
+    /** Start reading the pages in the background */
+    WILLNEED = 3,
+  };
+};
+
+namespace detail {
+/** The message followed by the description of errno */
+std::string with_reason(const std::string& message);
+
+/** Open a file for reading, which needs to hold at least ``min_bytes`` bytes.
+ *  Returns the file descriptor and sets ``file_bytes`` to the size of the
+ *  file. Throws an IOError on failure. */
+int open_file(const std::string& path, size_t min_bytes, size_t& file_bytes);
+
+/** Map ``bytes`` bytes of a file starting at byte ``offset`` into memory.
+ *  Returns a buffer (with a reference count of one) owning the mapping,
+ *  which is released once the last reference is gone, and sets
+ *  ``data`` to the mapped bytes. Throws an IOError on failure. */
+ArrayBuffer* map_file(const std::string& path, size_t offset, size_t bytes,
+                      MappedFile::MODE mode, char*& data);
+
+/** The metadata from the header of a .npy file */
+struct NpyHeader {
+  /** The numpy dtype string, e.g. "<f8" */
+  std::string descr;
+  bool fortran_order;
+  std::vector<size_t> shape;
+
+  /** Byte offset of the data in the file */
+  size_t data_offset;
+};
+
+/** Read the header of a .npy file. Throws an IOError if the file cannot
+ *  be read and a ValueError if it is no valid .npy file. */
+NpyHeader read_npy_header(const std::string& path);
+
+/** The numpy dtype string describing T in native byte order */
+template <typename T>
+std::string npy_descr() {
+  static_assert(std::is_arithmetic<T>::value, "Only arithmetic types supported");
+  const char kind = std::is_same<T, bool>::value         ? 'b'
+                    : std::is_floating_point<T>::value   ? 'f'
+                    : std::is_signed<T>::value           ? 'i'
+                                                         : 'u';
+  const char order = sizeof(T) == 1 ? '|' : '<';
+  return std::string{order, kind} + std::to_string(sizeof(T));
+}
+template <>
+inline std::string npy_descr<std::complex<float>>() {
+  return "<c8";
+}
+template <>
+inline std::string npy_descr<std::complex<double>>() {
+  return "<c16";
+}
+
+/** Apply madvise to the pages spanned by ``bytes`` bytes from ``begin`` */
+void advise(const void* begin, size_t bytes, MappedFile::ADVICE advice);
+
+/** Map the file and wrap the mapping in an Array with the given layout */
+template <typename T>
+Array<T> map_layout(const std::string& path, const std::vector<size_t>& shape,
+                    bool fortran_order, size_t offset, MappedFile::MODE mode) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable types can be mapped from files.");
+  pammap_throw(offset % alignof(T) == 0, ValueError,
+               "Offset " + std::to_string(offset) +
+                     " of the data in the file is not aligned for the element type.");
+  pammap_throw(shape.size() <= max_dynamic_rank, ValueError,
+               "Number of dimensions (== " + std::to_string(shape.size()) +
+                     ") exceeds the maximal number of dimensions of an Array (== " +
+                     std::to_string(max_dynamic_rank) + ").");
+
+  std::vector<ptrdiff_t> strides(shape.size());
+  size_t size = 1;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    const size_t d = fortran_order ? i : shape.size() - 1 - i;
+    strides[d]     = static_cast<ptrdiff_t>(size);
+    size *= shape[d];
+  }
+  if (size == 0) return Array<T>(shape);
+
+  char* data          = nullptr;
+  ArrayBuffer* buffer = map_file(path, offset, size * sizeof(T), mode, data);
+  ArrayView<T> view(reinterpret_cast<T*>(data), shape, strides);
+  view.reset_base(buffer, ArrayViewBase::MMAP);
+  return Array<T>(buffer, view);
+}
+}  // namespace detail
+
+/** Map an array of the given shape stored in C order starting at byte
+ *  ``offset`` of a raw binary file into memory without reading it.
+ *
+ * The returned Array refers to the mapping (instead of a pooled buffer),
+ * which is unmapped once the last copy of the Array is gone. Its view has
+ * base kind ArrayViewBase::MMAP. Like any Array it can be stored inside a
+ * PamMap and obtained as ArrayView<T>. Pages are only read from the file
+ * when they are accessed, see advise to influence this.
+ *
+ * Throws an IOError if the file cannot be mapped or is too small and a
+ * ValueError if the offset is not aligned for the elements.
+ */
+template <typename T>
+Array<T> map_array(const std::string& path, const std::vector<size_t>& shape,
+                   size_t offset = 0, MappedFile::MODE mode = MappedFile::READ_ONLY) {
+  return detail::map_layout<T>(path, shape, false, offset, mode);
+}
+
+/** Map the array stored in a .npy file into memory without reading it.
+ *
+ * Shape and memory order are taken from the header (for files in Fortran
+ * order the Array has Fortran strides). Throws a TypeError if the dtype of
+ * the file does not agree with T (or is not in native byte order) and a
+ * ValueError if the file is no .npy file. See map_array above for details.
+ */
+template <typename T>
+Array<T> map_array(const std::string& path,
+                   MappedFile::MODE mode = MappedFile::READ_ONLY) {
+  const detail::NpyHeader header = detail::read_npy_header(path);
+  const std::string expected     = detail::npy_descr<T>();
+  const bool native_order = header.descr.size() > 1 && header.descr[0] == '=' &&
+                            header.descr.substr(1) == expected.substr(1);
+  pammap_throw(header.descr == expected || native_order, TypeError,
+               "The .npy file '" + path + "' holds elements of dtype '" + header.descr +
+                     "', but '" + expected + "' was requested.");
+  return detail::map_layout<T>(path, header.shape, header.fortran_order,
+                               header.data_offset, mode);
+}
+
+/** Hint the expected access pattern to the elements of a view of a mapped
+ *  file (e.g. MappedFile::WILLNEED to read them in the background). The
+ *  advice applies to all pages spanned by the view. Throws a ValueError
+ *  if the view does not refer to a mapped file. */
+template <typename T, size_t N>
+void advise(const ArrayView<T, N>& view, MappedFile::ADVICE advice) {
+  pammap_throw(view.base_kind() == ArrayViewBase::MMAP, ValueError,
+               "Only views of mapped files (see map_array) can be advised.");
+  if (view.size() == 0) return;
+
+  // Range of the elements spanned by the view
+  ptrdiff_t low = 0, high = 0;
+  for (size_t d = 0; d < view.ndim(); ++d) {
+    const ptrdiff_t extent =
+          view.strides()[d] * static_cast<ptrdiff_t>(view.shape()[d] - 1);
+    (extent < 0 ? low : high) += extent;
+  }
+  const size_t bytes = static_cast<size_t>(high - low + 1) * sizeof(T);
+  detail::advise(view.data() + low, bytes, advice);
+}
+
+}  // namespace pammap
@@ -0,0 +1,289 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "ThreadPool.hpp"
+#include "exceptions.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace pammap {
+
+/** \file Parallel element-wise operations over ArrayViews.
+ *
+ * All views passed to one operation need to have the same shape and
+ * elements with the same multi-index are processed together. The elements
+ * are traversed in the order of the first view (see ArrayView::axis_order),
+ * which is partitioned into one contiguous range of linear indices per
+ * worker of ThreadPool::global(). The partitioning only depends on the
+ * shape and the number of workers, such that memory first touched by e.g.
+ * ``fill`` is processed by the same thread (and thus NUMA node) later on.
+ * For contiguous views the range boundaries are placed on cache line
+ * boundaries of the first view, such that no two threads write to the
+ * same cache line.
+ *
+ * Views with less than parallel_min_size elements are processed on the
+ * calling thread. The function passed to for_each and transform is
+ * called concurrently from several threads.
+ */
+
+/** Minimal number of elements for which work is split between threads */
+constexpr size_t parallel_min_size = 32768;
+
+namespace detail {
+
+/** Shape of the elements to traverse, fastest axis first */
+struct Traversal {
+  /** Number of axes (at least one) */
+  size_t ndim = 1;
+
+  /** Extent of each axis */
+  std::array<size_t, max_dynamic_rank> shape{};
+
+  /** Do all views have unit stride along the (only) axis */
+  bool unit_stride = false;
+};
+
+/** Position of one view during a traversal */
+template <typename T>
+struct Cursor {
+  /** The current element */
+  T* ptr;
+
+  /** The pointer to the element with multi-index zero */
+  T* data;
+
+  /** The strides in the order of the traversal */
+  std::array<ptrdiff_t, max_dynamic_rank> strides;
+
+  /** Move to the element with the given multi-index */
+  void seek(const Traversal& traversal, const size_t* index) {
+    ptr = data;
+    for (size_t k = 0; k < traversal.ndim; ++k) {
+      ptr += static_cast<ptrdiff_t>(index[k]) * strides[k];  // NOLINT
+    }
+  }
+
+  /** The element ``i`` positions further along a unit-stride axis */
+  T& at(size_t i) const { return ptr[i]; }
+
+  /** The current element */
+  T& get() const { return *ptr; }
+
+  /** Move ``count`` elements further along a unit-stride axis */
+  void skip(size_t count) { ptr += count; }  // NOLINT
+
+  /** Move to the next element along the fastest axis */
+  void step() { ptr += strides[0]; }  // NOLINT
+};
+
+/** Evaluate the expressions of a pack expansion in order */
+inline void expand_pack(std::initializer_list<int>) {}
+
+/** Call ``function`` on the elements with linear indices in ``[begin, end)``.
+ *
+ * Besides Cursor objects any type with the same member functions
+ * (seek, at, get, skip and step) can be passed as a cursor,
+ * see e.g. the expression templates in expressions.hpp.
+ */
+template <typename Function, typename... Cursors>
+void traverse_range(const Traversal& traversal, size_t begin, size_t end,
+                    Function& function, Cursors... cursors) {
+  if (begin >= end) return;
+
+  // Unravel the first index (the only division needed)
+  std::array<size_t, max_dynamic_rank> index{};
+  size_t rest = begin;
+  for (size_t k = 0; k < traversal.ndim; ++k) {
+    index[k] = rest % traversal.shape[k];
+    rest /= traversal.shape[k];
+  }
+  expand_pack({(cursors.seek(traversal, index.data()), 0)...});
+
+  size_t remaining = end - begin;
+  while (true) {
+    // Process the remainder of the current row along the fastest axis
+    const size_t count = std::min(remaining, traversal.shape[0] - index[0]);
+    if (traversal.unit_stride) {
+      for (size_t i = 0; i < count; ++i) function(cursors.at(i)...);
+      expand_pack({(cursors.skip(count), 0)...});
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        function(cursors.get()...);
+        expand_pack({(cursors.step(), 0)...});
+      }
+    }
+    remaining -= count;
+    if (remaining == 0) return;
+
+    // Odometer step into the next row
+    index[0] = 0;
+    for (size_t k = 1; ++index[k] == traversal.shape[k]; ++k) index[k] = 0;
+    expand_pack({(cursors.seek(traversal, index.data()), 0)...});
+  }
+}
+
+/** Check that the view has the expected shape */
+template <typename T>
+int check_shape(const ArrayView<T>& view, span<const size_t> shape) {
+  pammap_throw(view.shape() == shape, ValueError,
+               "All ArrayViews passed to a parallel operation need to have the same "
+               "shape.");
+  return 0;
+}
+
+/** Does the view have the same strides as the first view */
+template <typename T>
+bool same_strides(const ArrayView<T>& view, span<const ptrdiff_t> strides) {
+  return view.strides() == strides;
+}
+
+/** Set up the cursor of a view, either treating it as one-dimensional or
+ *  walking the axes in the given order. */
+template <typename T>
+Cursor<T> make_cursor(ArrayView<T>& view, bool flat, const unsigned char* order) {
+  Cursor<T> ret;
+  ret.ptr  = view.data();
+  ret.data = view.data();
+  if (flat) {
+    ret.strides[0] = 1;
+  } else {
+    for (size_t k = 0; k < view.ndim(); ++k) ret.strides[k] = view.strides()[order[k]];
+  }
+  return ret;
+}
+
+/** Split the traversal into one chunk per worker of the global thread pool.
+ *  The chunk boundaries are rounded down to ``skew`` plus a multiple
+ *  of ``align``. */
+template <typename Function, typename... Cursors>
+void traverse_parallel(const Traversal& traversal, size_t size, size_t align, size_t skew,
+                       Function& function, Cursors... cursors) {
+  ThreadPool& pool    = ThreadPool::global();
+  const size_t chunks = size < parallel_min_size ? 1 : pool.size();
+  if (chunks == 1) {
+    traverse_range(traversal, 0, size, function, cursors...);
+    return;
+  }
+
+  auto boundary = [=](size_t chunk) -> size_t {
+    if (chunk == chunks) return size;
+    const size_t even = size / chunks * chunk + std::min(chunk, size % chunks);
+    return even < skew ? 0 : (even - skew) / align * align + skew;
+  };
+  pool.run([&](size_t chunk) {
+    traverse_range(traversal, boundary(chunk), boundary(chunk + 1), function, cursors...);
+  });
+}
+
+/** How the elements are traversed and split between the workers */
+struct TraversalPlan {
+  Traversal traversal;
+
+  /** The axes in traversal order */
+  std::array<unsigned char, max_dynamic_rank> order;
+
+  /** Are all views traversed as flat arrays (or zero-dimensional) */
+  bool one_axis;
+
+  /** Alignment of the chunk boundaries (see traverse_parallel) */
+  size_t align = 1;
+  size_t skew  = 0;
+};
+
+/** Plan the traversal in the order of the first view. If all other views
+ *  have the same strides and these are contiguous, the views are traversed
+ *  as flat arrays. */
+template <typename T>
+TraversalPlan plan_traversal(const ArrayView<T>& first, bool same_strides) {
+  // Views sharing the same contiguous layout are traversed as flat arrays
+  const bool flat =
+        same_strides && (first.is_c_contiguous() || first.is_fortran_contiguous());
+
+  TraversalPlan plan;
+  plan.order    = first.axis_order();
+  plan.one_axis = flat || first.ndim() == 0;
+  if (plan.one_axis) {
+    plan.traversal.shape[0]    = first.size();
+    plan.traversal.unit_stride = flat;
+  } else {
+    plan.traversal.ndim = first.ndim();
+    for (size_t k = 0; k < first.ndim(); ++k) {
+      plan.traversal.shape[k] = first.shape()[plan.order[k]];
+    }
+  }
+
+  // For contiguous data align the boundaries between the chunks
+  // to the cache lines of the first view.
+  constexpr size_t cache_line = 64;
+  const auto address          = reinterpret_cast<std::uintptr_t>(first.data());
+  if (flat && cache_line % sizeof(T) == 0 && address % sizeof(T) == 0) {
+    plan.align = cache_line / sizeof(T);
+    plan.skew  = ((cache_line - address % cache_line) % cache_line) / sizeof(T);
+  }
+  return plan;
+}
+
+/** Call function(elements...) on all elements of the views in parallel */
+template <typename Function, typename T, typename... Ts>
+void parallel_traverse(Function& function, ArrayView<T> first, ArrayView<Ts>... rest) {
+  expand_pack({check_shape(rest, first.shape())...});
+  bool same = true;
+  for (bool s : {true, same_strides(rest, first.strides())...}) same = same && s;
+
+  const TraversalPlan plan = plan_traversal(first, same);
+  traverse_parallel(plan.traversal, first.size(), plan.align, plan.skew, function,
+                    make_cursor(first, plan.one_axis, plan.order.data()),
+                    make_cursor(rest, plan.one_axis, plan.order.data())...);
+}
+}  // namespace detail
+
+/** Call ``function(a[i], b[i], ...)`` for all elements of the views
+ *  ``a``, ``b``, ... in parallel, where the elements are passed by reference. */
+template <typename Function, typename... Ts, size_t... Ns>
+void for_each(Function function, ArrayView<Ts, Ns>... views) {
+  detail::parallel_traverse(function, ArrayView<Ts>(views)...);
+}
+
+/** Set ``out[i] = function(in[i]...)`` for all elements in parallel */
+template <typename T, size_t N, typename Function, typename... Ts, size_t... Ns>
+void transform(ArrayView<T, N> out, Function function, ArrayView<Ts, Ns>... in) {
+  auto kernel = [&function](T& o, const Ts&... i) { o = function(i...); };
+  detail::parallel_traverse(kernel, ArrayView<T>(out), ArrayView<Ts>(in)...);
+}
+
+/** Set all elements of the view to the value in parallel */
+template <typename T, size_t N>
+void fill(ArrayView<T, N> view, const typename ArrayView<T, N>::value_type& value) {
+  auto kernel = [&value](T& o) { o = value; };
+  detail::parallel_traverse(kernel, ArrayView<T>(view));
+}
+
+/** Copy the elements of ``source`` to ``destination`` (which need to have the
+ *  same shape) in parallel. The elements are converted if the types differ.
+ *  Like transform and copy_into the destination comes first. */
+template <typename U, size_t M, typename T, size_t N>
+void copy(ArrayView<U, M> destination, ArrayView<T, N> source) {
+  auto kernel = [](U& o, const T& i) { o = static_cast<U>(i); };
+  detail::parallel_traverse(kernel, ArrayView<U>(destination), ArrayView<T>(source));
+}
+
+}  // namespace pammap
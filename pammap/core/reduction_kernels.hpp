@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "typedefs.hxx"
+#include <cstddef>
+#include <cstdint>
+
+namespace pammap {
+namespace detail {
+
+/** Table of the reduction kernels for contiguous data compiled for one
+ *  instruction set. See reductions.hpp for the user-facing functions. */
+struct ReductionKernels {
+  /** Name of the instruction set */
+  const char* isa;
+
+  Float (*sum_float)(const Float* x, size_t n);
+  Integer (*sum_integer)(const Integer* x, size_t n);
+
+  /** Sum of the even (real) and odd (imaginary) entries of x, n is even */
+  void (*sum_pairs)(const Float* x, size_t n, Float* result);
+
+  Float (*sum_squares)(const Float* x, size_t n);
+  Float (*min_float)(const Float* x, size_t n);
+  Float (*max_float)(const Float* x, size_t n);
+  Integer (*min_integer)(const Integer* x, size_t n);
+  Integer (*max_integer)(const Integer* x, size_t n);
+  size_t (*argmax_float)(const Float* x, size_t n);
+  size_t (*argmax_integer)(const Integer* x, size_t n);
+  Float (*dot_float)(const Float* x, const Float* y, size_t n);
+  Integer (*dot_integer)(const Integer* x, const Integer* y, size_t n);
+  bool (*any_bool)(const Bool* x, size_t n);
+  bool (*all_bool)(const Bool* x, size_t n);
+
+  /** Number of set bits in the n words of x */
+  size_t (*count_bits)(const uint64_t* x, size_t n);
+
+  /** Sum of the complex products of x and y, given in split layout,
+   *  i.e. with the real and imaginary parts in separate arrays */
+  void (*dot_split)(const Float* x_re, const Float* x_im, const Float* y_re,
+                    const Float* y_im, size_t n, Float* result);
+
+  /** y += alpha * x for complex numbers in split layout */
+  void (*axpy_split)(Float alpha_re, Float alpha_im, const Float* x_re,
+                     const Float* x_im, Float* y_re, Float* y_im, size_t n);
+};
+
+//@{
+/** Kernels for the instruction set the library is compiled for
+ *  and for the extended instruction sets (if enabled in config.hpp) */
+const ReductionKernels& reduction_kernels_baseline();
+const ReductionKernels& reduction_kernels_avx2();
+const ReductionKernels& reduction_kernels_avx512();
+//@}
+
+/** The kernels currently selected (see set_reduction_isa) */
+const ReductionKernels& active_reduction_kernels();
+
+}  // namespace detail
+}  // namespace pammap
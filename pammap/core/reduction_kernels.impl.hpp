@@ -0,0 +1,288 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "reduction_kernels.hpp"
+#include <limits>
+
+// This file is included by exactly one translation unit per instruction set,
+// each compiled with different architecture flags. All kernels therefore
+// live in an anonymous namespace and only use builtin operations, such that
+// no code compiled for an extended instruction set can leak into other
+// translation units via the linker's merging of inline functions.
+
+namespace pammap {
+namespace detail {
+namespace {
+
+// All kernels keep L independent accumulators, which the compiler maps onto
+// a few SIMD registers. L is chosen to be four times the number of doubles
+// per register such that the latency of the additions is hidden.
+
+/** Smallest value of a type for maximum searches */
+template <typename T>
+constexpr T lowest() {
+  return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                              : std::numeric_limits<T>::min();
+}
+
+/** Largest value of a type for minimum searches */
+template <typename T>
+constexpr T highest() {
+  return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                              : std::numeric_limits<T>::max();
+}
+
+/** Sum the accumulators pairwise down to the first ``keep`` ones */
+template <size_t L, typename T>
+void fold_sum(T (&acc)[L], size_t keep = 1) {
+  for (size_t w = L / 2; w >= keep; w /= 2) {
+    for (size_t j = 0; j < w; ++j) acc[j] += acc[j + w];
+  }
+}
+
+template <size_t L, typename T>
+T sum(const T* x, size_t n) {
+  T acc[L] = {};
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) acc[j] += x[i + j];
+  }
+  for (size_t j = 0; i < n; ++i, ++j) acc[j] += x[i];
+  fold_sum(acc);
+  return acc[0];
+}
+
+template <size_t L>
+void sum_pairs(const Float* x, size_t n, Float* result) {
+  // Since L is even, even entries always end up in even accumulators
+  Float acc[L] = {};
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) acc[j] += x[i + j];
+  }
+  for (size_t j = 0; i < n; ++i, ++j) acc[j] += x[i];
+  fold_sum(acc, 2);
+  result[0] = acc[0];
+  result[1] = acc[1];
+}
+
+template <size_t L>
+Float sum_squares(const Float* x, size_t n) {
+  Float acc[L] = {};
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) acc[j] += x[i + j] * x[i + j];
+  }
+  for (size_t j = 0; i < n; ++i, ++j) acc[j] += x[i] * x[i];
+  fold_sum(acc);
+  return acc[0];
+}
+
+template <size_t L, typename T>
+T dot(const T* x, const T* y, size_t n) {
+  T acc[L] = {};
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) acc[j] += x[i + j] * y[i + j];
+  }
+  for (size_t j = 0; i < n; ++i, ++j) acc[j] += x[i] * y[i];
+  fold_sum(acc);
+  return acc[0];
+}
+
+// The comparisons in min and max are chosen such that NaN entries are ignored.
+
+template <size_t L, typename T>
+T max(const T* x, size_t n) {
+  T acc[L];
+  for (size_t j = 0; j < L; ++j) acc[j] = lowest<T>();
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) acc[j] = x[i + j] > acc[j] ? x[i + j] : acc[j];
+  }
+  for (size_t j = 0; i < n; ++i, ++j) acc[j] = x[i] > acc[j] ? x[i] : acc[j];
+  for (size_t j = 1; j < L; ++j) acc[0] = acc[j] > acc[0] ? acc[j] : acc[0];
+  return acc[0];
+}
+
+template <size_t L, typename T>
+T min(const T* x, size_t n) {
+  T acc[L];
+  for (size_t j = 0; j < L; ++j) acc[j] = highest<T>();
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) acc[j] = x[i + j] < acc[j] ? x[i + j] : acc[j];
+  }
+  for (size_t j = 0; i < n; ++i, ++j) acc[j] = x[i] < acc[j] ? x[i] : acc[j];
+  for (size_t j = 1; j < L; ++j) acc[0] = acc[j] < acc[0] ? acc[j] : acc[0];
+  return acc[0];
+}
+
+template <size_t L, typename T>
+size_t argmax(const T* x, size_t n) {
+  T best[L];
+  size_t index[L];
+  for (size_t j = 0; j < L; ++j) {
+    best[j]  = lowest<T>();
+    index[j] = 0;
+  }
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) {
+      const bool greater = x[i + j] > best[j];
+      best[j]            = greater ? x[i + j] : best[j];
+      index[j]           = greater ? i + j : index[j];
+    }
+  }
+  for (size_t j = 0; i < n; ++i, ++j) {
+    if (x[i] > best[j]) {
+      best[j]  = x[i];
+      index[j] = i;
+    }
+  }
+
+  // Each lane holds the first occurrence of its maximum,
+  // among equal maxima we want the smallest index.
+  for (size_t j = 1; j < L; ++j) {
+    if (best[j] > best[0] || (best[j] == best[0] && index[j] < index[0])) {
+      best[0]  = best[j];
+      index[0] = index[j];
+    }
+  }
+  return index[0];
+}
+
+// Bools are inspected bytewise. Blocks of 8 * L bytes are combined
+// before checking for an early exit.
+
+template <size_t L>
+bool any_bool(const Bool* x, size_t n) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(x);
+  size_t i                   = 0;
+  for (; i + 8 * L <= n; i += 8 * L) {
+    unsigned char acc = 0;
+    for (size_t j = 0; j < 8 * L; ++j) acc |= bytes[i + j];
+    if (acc != 0) return true;
+  }
+  for (; i < n; ++i) {
+    if (bytes[i] != 0) return true;
+  }
+  return false;
+}
+
+template <size_t L>
+bool all_bool(const Bool* x, size_t n) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(x);
+  size_t i                   = 0;
+  for (; i + 8 * L <= n; i += 8 * L) {
+    unsigned char acc = 1;
+    for (size_t j = 0; j < 8 * L; ++j) acc &= bytes[i + j];
+    if (acc == 0) return false;
+  }
+  for (; i < n; ++i) {
+    if (bytes[i] == 0) return false;
+  }
+  return true;
+}
+
+// Bit counting uses the popcnt instruction where the instruction set has it
+// (the extended instruction sets are compiled with -mpopcnt)
+
+template <size_t L>
+size_t count_bits(const uint64_t* x, size_t n) {
+  size_t acc[L] = {};
+  size_t i      = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) {
+      acc[j] += static_cast<size_t>(__builtin_popcountll(x[i + j]));
+    }
+  }
+  for (size_t j = 0; i < n; ++i, ++j) {
+    acc[j] += static_cast<size_t>(__builtin_popcountll(x[i]));
+  }
+  fold_sum(acc);
+  return acc[0];
+}
+
+// Complex kernels for the split layout (see SplitComplexView), in which
+// the real and imaginary parts are vectorised independently without the
+// shuffles needed for interleaved std::complex data.
+
+template <size_t L>
+void dot_split(const Float* x_re, const Float* x_im, const Float* y_re,
+               const Float* y_im, size_t n, Float* result) {
+  Float acc_re[L] = {};
+  Float acc_im[L] = {};
+  size_t i        = 0;
+  for (; i + L <= n; i += L) {
+    for (size_t j = 0; j < L; ++j) {
+      acc_re[j] += x_re[i + j] * y_re[i + j] - x_im[i + j] * y_im[i + j];
+      acc_im[j] += x_re[i + j] * y_im[i + j] + x_im[i + j] * y_re[i + j];
+    }
+  }
+  for (size_t j = 0; i < n; ++i, ++j) {
+    acc_re[j] += x_re[i] * y_re[i] - x_im[i] * y_im[i];
+    acc_im[j] += x_re[i] * y_im[i] + x_im[i] * y_re[i];
+  }
+  fold_sum(acc_re);
+  fold_sum(acc_im);
+  result[0] = acc_re[0];
+  result[1] = acc_im[0];
+}
+
+template <size_t L>
+void axpy_split(Float alpha_re, Float alpha_im, const Float* x_re, const Float* x_im,
+                Float* y_re, Float* y_im, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    y_re[i] += alpha_re * x_re[i] - alpha_im * x_im[i];
+    y_im[i] += alpha_re * x_im[i] + alpha_im * x_re[i];
+  }
+}
+
+/** Assemble the table of kernels with L accumulators */
+template <size_t L>
+ReductionKernels make_reduction_kernels(const char* isa) {
+  static_assert(L % 2 == 0 && (L & (L - 1)) == 0,
+                "Number of accumulators needs to be a power of two.");
+  ReductionKernels ret;
+  ret.isa            = isa;
+  ret.sum_float      = &sum<L, Float>;
+  ret.sum_integer    = &sum<L, Integer>;
+  ret.sum_pairs      = &sum_pairs<L>;
+  ret.sum_squares    = &sum_squares<L>;
+  ret.min_float      = &min<L, Float>;
+  ret.max_float      = &max<L, Float>;
+  ret.min_integer    = &min<L, Integer>;
+  ret.max_integer    = &max<L, Integer>;
+  ret.argmax_float   = &argmax<L, Float>;
+  ret.argmax_integer = &argmax<L, Integer>;
+  ret.dot_float      = &dot<L, Float>;
+  ret.dot_integer    = &dot<L, Integer>;
+  ret.any_bool       = &any_bool<L>;
+  ret.all_bool       = &all_bool<L>;
+  ret.count_bits     = &count_bits<L>;
+  ret.dot_split      = &dot_split<L>;
+  ret.axpy_split     = &axpy_split<L>;
+  return ret;
+}
+
+}  // namespace
+}  // namespace detail
+}  // namespace pammap
@@ -17,11 +17,16 @@
 // along with pammap. If not, see <http://www.gnu.org/licenses/>.
 //
 
-#include "PamMapValue.hxx"
-#include "demangle.hpp"
+// Reduction kernels for AVX2
+#include "reduction_kernels.impl.hpp"
 
 namespace pammap {
+namespace detail {
 
-std::string PamMapValue::type_name() const { return demangle(any::type()); }
+const ReductionKernels& reduction_kernels_avx2() {
+  static const ReductionKernels kernels = make_reduction_kernels<16>("avx2");
+  return kernels;
+}
 
+}  // namespace detail
 }  // namespace pammap
@@ -0,0 +1,33 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+// Reduction kernels for the instruction set the library is compiled for,
+// e.g. SSE2 on x86-64
+#include "reduction_kernels.impl.hpp"
+
+namespace pammap {
+namespace detail {
+
+const ReductionKernels& reduction_kernels_baseline() {
+  static const ReductionKernels kernels = make_reduction_kernels<8>("baseline");
+  return kernels;
+}
+
+}  // namespace detail
+}  // namespace pammap
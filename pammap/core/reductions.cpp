@@ -0,0 +1,307 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "reductions.hpp"
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "reduction_kernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace pammap {
+
+namespace {
+using detail::ReductionKernels;
+
+/** Number of elements of strided views gathered at once */
+constexpr size_t block_size = 512;
+
+/** Kernels of all instruction sets available on this machine, best first */
+std::vector<const ReductionKernels*> available_kernels() {
+  std::vector<const ReductionKernels*> ret;
+#ifdef HAVE_AVX512_DISPATCH
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt")) {
+    ret.push_back(&detail::reduction_kernels_avx512());
+  }
+#endif
+#ifdef HAVE_AVX2_DISPATCH
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("popcnt")) {
+    ret.push_back(&detail::reduction_kernels_avx2());
+  }
+#endif
+  ret.push_back(&detail::reduction_kernels_baseline());
+  return ret;
+}
+
+/** The kernels currently in use */
+std::atomic<const ReductionKernels*>& active_kernels() {
+  static std::atomic<const ReductionKernels*> active{available_kernels().front()};
+  return active;
+}
+
+const ReductionKernels& kernels() {
+  return *active_kernels().load(std::memory_order_relaxed);
+}
+
+/** Is the view contiguous, such that memory order and linear index agree */
+template <typename T>
+bool is_contiguous(const ArrayView<T>& view) {
+  return view.is_c_contiguous() || view.is_fortran_contiguous();
+}
+
+/** Gather the elements of a strided view into contiguous buffers.
+ *
+ * The axes are walked in the given order. The rows along the fastest axis
+ * are copied by a plain strided loop, the remaining axes are traversed
+ * by an ArrayViewIterator over the row starts.
+ */
+template <typename T>
+class StridedGather {
+ public:
+  StridedGather(const ArrayView<T>& view, const unsigned char* order)
+        : m_row_length(view.ndim() > 0 ? view.shape()[order[0]] : 1),
+          m_stride(view.ndim() > 0 ? view.strides()[order[0]] : 0),
+          m_rows(view.data(), view.shape().data(), view.strides().data(), order + 1,
+                 view.ndim() > 0 ? view.ndim() - 1 : 0, false, 0),
+          m_row(view.data()) {}
+
+  /** Copy the next count elements into the buffer */
+  void next(T* buffer, size_t count) {
+    while (count > 0) {
+      if (m_position == m_row_length) {
+        ++m_rows;
+        m_row      = &*m_rows;
+        m_position = 0;
+      }
+      const size_t n = std::min(count, m_row_length - m_position);
+      const T* row   = m_row + static_cast<ptrdiff_t>(m_position) * m_stride;
+      for (size_t k = 0; k < n; ++k) {
+        buffer[k] = row[static_cast<ptrdiff_t>(k) * m_stride];
+      }
+      buffer += n;
+      count -= n;
+      m_position += n;
+    }
+  }
+
+ private:
+  size_t m_row_length;
+  ptrdiff_t m_stride;
+  typename ArrayView<T>::const_iterator m_rows;
+  const T* m_row;
+  size_t m_position = 0;
+};
+
+/** Call ``function(data, count, first)`` for contiguous blocks of ``count``
+ *  elements of the view, which start at linear index ``first``. */
+template <typename T, typename Function>
+void for_each_block(const ArrayView<T>& view, Function&& function) {
+  if (is_contiguous(view)) {
+    function(view.data(), view.size(), size_t(0));
+    return;
+  }
+
+  T buffer[block_size];
+  StridedGather<T> gather(view, view.axis_order().data());
+  for (size_t first = 0; first < view.size(); first += block_size) {
+    const size_t count = std::min(block_size, view.size() - first);
+    gather.next(buffer, count);
+    function(static_cast<const T*>(buffer), count, first);
+  }
+}
+
+template <typename T>
+T sum_view(const ArrayView<T>& view, T (*kernel)(const T*, size_t)) {
+  T ret = 0;
+  for_each_block(view, [&ret, kernel](const T* data, size_t count, size_t) {
+    ret += kernel(data, count);
+  });
+  return ret;
+}
+
+template <typename T>
+T extremum_view(const ArrayView<T>& view, T (*kernel)(const T*, size_t), bool is_max) {
+  pammap_throw(view.size() > 0, ValueError,
+               "Cannot determine the extremum of an empty ArrayView.");
+  T ret = kernel(nullptr, 0);  // The neutral element
+  for_each_block(view, [&ret, kernel, is_max](const T* data, size_t count, size_t) {
+    const T block = kernel(data, count);
+    ret           = (is_max ? block > ret : block < ret) ? block : ret;
+  });
+  return ret;
+}
+
+template <typename T>
+size_t argmax_view(const ArrayView<T>& view, size_t (*kernel)(const T*, size_t)) {
+  pammap_throw(view.size() > 0, ValueError,
+               "Cannot determine the argmax of an empty ArrayView.");
+  size_t ret = 0;
+  T best     = view[0];
+  for_each_block(view, [&](const T* data, size_t count, size_t first) {
+    const size_t index = kernel(data, count);
+    // Only later blocks with a strictly larger maximum win, but
+    // a NaN in the first position should be replaced by anything.
+    if (data[index] > best || (best != best && data[index] == data[index])) {
+      best = data[index];
+      ret  = first + index;
+    }
+  });
+  return ret;
+}
+
+template <typename T>
+T dot_view(const ArrayView<T>& lhs, const ArrayView<T>& rhs,
+           T (*kernel)(const T*, const T*, size_t)) {
+  pammap_throw(lhs.shape() == rhs.shape(), ValueError,
+               "The shapes of the ArrayViews passed to dot need to agree.");
+  if (lhs.strides() == rhs.strides() && is_contiguous(lhs)) {
+    return kernel(lhs.data(), rhs.data(), lhs.size());
+  }
+
+  // Walk both views in C order
+  std::array<unsigned char, max_dynamic_rank> order{};
+  for (size_t k = 0; k < lhs.ndim(); ++k) {
+    order[k] = static_cast<unsigned char>(lhs.ndim() - 1 - k);
+  }
+  StridedGather<T> gather_lhs(lhs, order.data());
+  StridedGather<T> gather_rhs(rhs, order.data());
+
+  T ret = 0;
+  T buffer_lhs[block_size];
+  T buffer_rhs[block_size];
+  for (size_t first = 0; first < lhs.size(); first += block_size) {
+    const size_t count = std::min(block_size, lhs.size() - first);
+    gather_lhs.next(buffer_lhs, count);
+    gather_rhs.next(buffer_rhs, count);
+    ret += kernel(buffer_lhs, buffer_rhs, count);
+  }
+  return ret;
+}
+
+/** Reinterpret complex numbers as pairs of real and imaginary part,
+ *  which std::complex<double> guarantees to be layout-compatible with. */
+const Float* as_floats(const Complex* data) {
+  return reinterpret_cast<const Float*>(data);
+}
+}  // namespace
+
+Float sum(const ArrayView<Float>& view) { return sum_view(view, kernels().sum_float); }
+Integer sum(const ArrayView<Integer>& view) {
+  return sum_view(view, kernels().sum_integer);
+}
+
+Complex sum(const ArrayView<Complex>& view) {
+  auto kernel  = kernels().sum_pairs;
+  Float ret[2] = {0, 0};
+  for_each_block(view, [&ret, kernel](const Complex* data, size_t count, size_t) {
+    Float block[2];
+    kernel(as_floats(data), 2 * count, block);
+    ret[0] += block[0];
+    ret[1] += block[1];
+  });
+  return {ret[0], ret[1]};
+}
+
+Float min(const ArrayView<Float>& view) {
+  return extremum_view(view, kernels().min_float, false);
+}
+Integer min(const ArrayView<Integer>& view) {
+  return extremum_view(view, kernels().min_integer, false);
+}
+Float max(const ArrayView<Float>& view) {
+  return extremum_view(view, kernels().max_float, true);
+}
+Integer max(const ArrayView<Integer>& view) {
+  return extremum_view(view, kernels().max_integer, true);
+}
+
+size_t argmax(const ArrayView<Float>& view) {
+  return argmax_view(view, kernels().argmax_float);
+}
+size_t argmax(const ArrayView<Integer>& view) {
+  return argmax_view(view, kernels().argmax_integer);
+}
+
+Float dot(const ArrayView<Float>& lhs, const ArrayView<Float>& rhs) {
+  return dot_view(lhs, rhs, kernels().dot_float);
+}
+Integer dot(const ArrayView<Integer>& lhs, const ArrayView<Integer>& rhs) {
+  return dot_view(lhs, rhs, kernels().dot_integer);
+}
+
+Float norm2(const ArrayView<Float>& view) {
+  return std::sqrt(sum_view(view, kernels().sum_squares));
+}
+Float norm2(const ArrayView<Complex>& view) {
+  auto kernel = kernels().sum_squares;
+  Float ret   = 0;
+  for_each_block(view, [&ret, kernel](const Complex* data, size_t count, size_t) {
+    ret += kernel(as_floats(data), 2 * count);
+  });
+  return std::sqrt(ret);
+}
+
+bool any_of(const ArrayView<Bool>& view) {
+  auto kernel = kernels().any_bool;
+  bool ret    = false;
+  for_each_block(view, [&ret, kernel](const Bool* data, size_t count, size_t) {
+    ret = ret || kernel(data, count);
+  });
+  return ret;
+}
+
+bool all_of(const ArrayView<Bool>& view) {
+  auto kernel = kernels().all_bool;
+  bool ret    = true;
+  for_each_block(view, [&ret, kernel](const Bool* data, size_t count, size_t) {
+    ret = ret && kernel(data, count);
+  });
+  return ret;
+}
+
+namespace detail {
+size_t count_bits(const uint64_t* words, size_t n) {
+  return kernels().count_bits(words, n);
+}
+
+const ReductionKernels& active_reduction_kernels() { return kernels(); }
+}  // namespace detail
+
+std::string reduction_isa() { return kernels().isa; }
+
+std::vector<std::string> available_reduction_isas() {
+  std::vector<std::string> ret;
+  for (const ReductionKernels* k : available_kernels()) ret.push_back(k->isa);
+  return ret;
+}
+
+void set_reduction_isa(const std::string& isa) {
+  for (const ReductionKernels* k : available_kernels()) {
+    if (isa == k->isa) {
+      active_kernels().store(k);
+      return;
+    }
+  }
+  pammap_throw(false, ValueError,
+               "Instruction set '" + isa + "' is not available for reductions.");
+}
+
+}  // namespace pammap
@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "ArrayView.hpp"
+#include "typedefs.hxx"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pammap {
+
+/** \file Reductions over all elements of an ArrayView.
+ *
+ * For C or Fortran contiguous views the data is processed directly by
+ * vectorised kernels. Views with other strides are gathered blockwise
+ * into a small buffer, on which the same kernels are run. The kernels
+ * are compiled for several instruction sets (AVX-512, AVX2 and the
+ * baseline of the build, i.e. SSE2 on x86-64) and the best one supported
+ * by the CPU is selected at runtime.
+ *
+ * Since the elements are summed in a different order than by a naive loop,
+ * the floating-point results may differ by rounding.
+ */
+
+//@{
+/** Sum of all elements (zero for an empty view) */
+Float sum(const ArrayView<Float>& view);
+Integer sum(const ArrayView<Integer>& view);
+Complex sum(const ArrayView<Complex>& view);
+//@}
+
+//@{
+/** Smallest or largest element. NaN entries are ignored.
+ *  Throws a ValueError if the view is empty. */
+Float min(const ArrayView<Float>& view);
+Integer min(const ArrayView<Integer>& view);
+Float max(const ArrayView<Float>& view);
+Integer max(const ArrayView<Integer>& view);
+//@}
+
+//@{
+/** Linear index (in the sense of ArrayView::operator[]) of the first
+ *  occurrence of the largest element. NaN entries are ignored.
+ *  Throws a ValueError if the view is empty. */
+size_t argmax(const ArrayView<Float>& view);
+size_t argmax(const ArrayView<Integer>& view);
+//@}
+
+//@{
+/** Sum of the products of the elements of two views with the same
+ *  shape, where elements with the same multi-index are multiplied.
+ *  Throws a ValueError if the shapes differ. */
+Float dot(const ArrayView<Float>& lhs, const ArrayView<Float>& rhs);
+Integer dot(const ArrayView<Integer>& lhs, const ArrayView<Integer>& rhs);
+//@}
+
+//@{
+/** Euclidean norm of all elements */
+Float norm2(const ArrayView<Float>& view);
+Float norm2(const ArrayView<Complex>& view);
+//@}
+
+/** Is any element true (false for an empty view) */
+bool any_of(const ArrayView<Bool>& view);
+
+/** Are all elements true (true for an empty view) */
+bool all_of(const ArrayView<Bool>& view);
+
+namespace detail {
+/** Number of set bits in ``n`` words (used by BitArrayView::count) */
+size_t count_bits(const uint64_t* words, size_t n);
+}  // namespace detail
+
+/** Name of the instruction set used by the reduction kernels,
+ *  i.e. one of "avx512", "avx2" or "baseline" */
+std::string reduction_isa();
+
+/** Names of the instruction sets supported by the CPU
+ *  and available in this build, best first */
+std::vector<std::string> available_reduction_isas();
+
+/** Use the reduction kernels of a particular instruction set (for testing and
+ *  benchmarking). Throws a ValueError if the instruction set is not available. */
+void set_reduction_isa(const std::string& isa);
+
+}  // namespace pammap
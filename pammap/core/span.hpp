@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace pammap {
+
+/** A minimal non-owning view of a contiguous range of objects
+ *  (similar to the C++20 std::span). */
+template <typename T>
+class span {
+ public:
+  typedef T element_type;
+  typedef typename std::remove_cv<T>::type value_type;
+  typedef T* iterator;
+
+  constexpr span() : m_data(nullptr), m_size(0) {}
+  constexpr span(T* data, size_t size) : m_data(data), m_size(size) {}
+
+  constexpr T* data() const { return m_data; }
+  constexpr size_t size() const { return m_size; }
+  constexpr bool empty() const { return m_size == 0; }
+  T* begin() const { return m_data; }
+  T* end() const { return m_data + m_size; }
+  constexpr T& operator[](size_t i) const { return m_data[i]; }
+
+  /** Copy the elements to a std::vector */
+  operator std::vector<value_type>() const {
+    return std::vector<value_type>(begin(), end());
+  }
+
+ private:
+  T* m_data;
+  size_t m_size;
+};
+
+/** Compare two spans elementwise */
+template <typename T, typename U>
+bool operator==(const span<T>& lhs, const span<U>& rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (lhs[i] != rhs[i]) return false;
+  }
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const span<T>& lhs, const span<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace pammap
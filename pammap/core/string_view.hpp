@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "config.hpp"
+
+#ifdef HAVE_CXX17_STRING_VIEW
+#include <string_view>
+
+namespace pammap {
+using std::string_view;
+}  // namespace pammap
+
+#else
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace pammap {
+
+/** A partial C++17 std::string_view implementation, i.e. a non-owning
+ *  view of a range of characters. */
+class string_view {
+ public:
+  typedef const char* iterator;
+  typedef const char* const_iterator;
+
+  constexpr string_view() : m_data(nullptr), m_size(0) {}
+  constexpr string_view(const char* data, size_t size) : m_data(data), m_size(size) {}
+  string_view(const char* str) : m_data(str), m_size(std::strlen(str)) {}
+  string_view(const std::string& str) : m_data(str.data()), m_size(str.size()) {}
+
+  constexpr const char* data() const { return m_data; }
+  constexpr size_t size() const { return m_size; }
+  constexpr size_t length() const { return m_size; }
+  constexpr bool empty() const { return m_size == 0; }
+  constexpr const char& operator[](size_t i) const { return m_data[i]; }
+  const char* begin() const { return m_data; }
+  const char* end() const { return m_data + m_size; }
+
+  /** Copy the characters into a std::string */
+  explicit operator std::string() const { return std::string(m_data, m_size); }
+
+  /** Lexicographical comparison like std::string::compare */
+  int compare(string_view other) const {
+    const size_t n = std::min(m_size, other.m_size);
+    const int cmp  = n == 0 ? 0 : std::memcmp(m_data, other.m_data, n);
+    if (cmp != 0) return cmp;
+    return m_size == other.m_size ? 0 : (m_size < other.m_size ? -1 : 1);
+  }
+
+ private:
+  const char* m_data;
+  size_t m_size;
+};
+
+inline bool operator==(string_view lhs, string_view rhs) {
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+inline bool operator!=(string_view lhs, string_view rhs) { return !(lhs == rhs); }
+inline bool operator<(string_view lhs, string_view rhs) { return lhs.compare(rhs) < 0; }
+
+inline std::ostream& operator<<(std::ostream& o, string_view view) {
+  return o.write(view.data(), static_cast<std::streamsize>(view.size()));
+}
+
+}  // namespace pammap
+
+#endif
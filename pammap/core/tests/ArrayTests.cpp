@@ -0,0 +1,235 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "PamMap.hpp"
+#include "typedefs.hxx"
+#include <catch2/catch.hpp>
+#include <cstdint>
+
+namespace pammap {
+namespace tests {
+
+namespace {
+bool is_aligned(const void* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % BufferPool::alignment == 0;
+}
+}  // namespace
+
+TEST_CASE("BufferPool", "[BufferPool]") {
+  SECTION("Size classes") {
+    CHECK(BufferPool::size_class_bytes(0) == 64);
+    CHECK(BufferPool::size_class_bytes(64) == 64);
+    CHECK(BufferPool::size_class_bytes(65) == 80);
+    CHECK(BufferPool::size_class_bytes(112) == 112);
+    CHECK(BufferPool::size_class_bytes(113) == 128);
+    CHECK(BufferPool::size_class_bytes(129) == 160);
+    CHECK(BufferPool::size_class_bytes(1000000) == 1048576);
+    CHECK(BufferPool::size_class_bytes(1048577) == 1310720);
+
+    for (size_t bytes = 1; bytes < 100000; bytes = bytes * 3 + 1) {
+      const size_t rounded = BufferPool::size_class_bytes(bytes);
+      CHECK(rounded >= bytes);
+      CHECK(4 * rounded <= 5 * std::max<size_t>(bytes, 64));
+    }
+
+    // Beyond the largest size class nothing is rounded
+    const size_t huge = size_t(1) << 30;
+    CHECK(BufferPool::size_class_bytes(huge + 1) == huge + 1);
+  }
+
+  SECTION("Buffers are reused") {
+    BufferPool pool;
+    void* first = pool.allocate(1000);
+    CHECK(is_aligned(first));
+    CHECK(pool.cached_bytes() == 0);
+
+    pool.deallocate(first, 1000);
+    CHECK(pool.cached_bytes() == BufferPool::size_class_bytes(1000));
+
+    // Same size class gives the same buffer, another one a new buffer
+    void* second = pool.allocate(1020);
+    CHECK(second == first);
+    CHECK(pool.cached_bytes() == 0);
+    void* third = pool.allocate(4000);
+    CHECK(is_aligned(third));
+    CHECK(third != first);
+
+    pool.deallocate(second, 1020);
+    pool.deallocate(third, 4000);
+    CHECK(pool.cached_bytes() > 0);
+    pool.release();
+    CHECK(pool.cached_bytes() == 0);
+  }
+
+  SECTION("Cache limit") {
+    BufferPool pool(1024);
+    void* small = pool.allocate(512);
+    void* large = pool.allocate(2048);
+    pool.deallocate(large, 2048);
+    CHECK(pool.cached_bytes() == 0);
+    pool.deallocate(small, 512);
+    CHECK(pool.cached_bytes() == 512);
+
+    pool.set_max_cached_bytes(0);
+    CHECK(pool.max_cached_bytes() == 0);
+    CHECK(pool.cached_bytes() == 512);
+  }
+
+  SECTION("Large buffers") {
+    BufferPool pool;
+    LargeBufferPolicy policy = pool.large_buffer_policy();
+    CHECK(policy.huge_pages);
+    CHECK(policy.numa == LargeBufferPolicy::FIRST_TOUCH);
+
+    for (auto numa : {LargeBufferPolicy::FIRST_TOUCH, LargeBufferPolicy::INTERLEAVE,
+                      LargeBufferPolicy::BIND}) {
+      policy.numa  = numa;
+      policy.nodes = numa == LargeBufferPolicy::BIND ? 1 : 0;
+      pool.set_large_buffer_policy(policy);
+      CHECK(pool.large_buffer_policy().numa == numa);
+
+      const size_t bytes = BufferPool::large_buffer_bytes + 12345;
+      auto* buffer       = static_cast<char*>(pool.allocate(bytes));
+      CHECK(is_aligned(buffer));
+      buffer[0]         = 1;
+      buffer[bytes - 1] = 2;
+      CHECK(buffer[0] + buffer[bytes - 1] == 3);
+      pool.deallocate(buffer, bytes);
+      pool.release();
+    }
+
+    // Beyond the largest size class
+    const size_t huge = size_t(1) << 30;
+    void* buffer      = pool.allocate(huge + 1);
+    CHECK(is_aligned(buffer));
+    pool.deallocate(buffer, huge + 1);
+    CHECK(pool.cached_bytes() == 0);
+  }
+}
+
+TEST_CASE("Array", "[Array]") {
+  SECTION("Construction") {
+    Array<Float> arr{{2, 3, 4}, 1.5};
+    REQUIRE(arr.ndim() == 3);
+    CHECK(arr.size() == 24);
+    CHECK(std::vector<size_t>(arr.shape().begin(), arr.shape().end()) ==
+          std::vector<size_t>{2, 3, 4});
+    CHECK(std::vector<ptrdiff_t>(arr.strides().begin(), arr.strides().end()) ==
+          std::vector<ptrdiff_t>{12, 4, 1});
+    CHECK(arr.view().is_c_contiguous());
+    CHECK(is_aligned(arr.data()));
+    CHECK(arr.use_count() == 1);
+    CHECK(arr.view().base_kind() == ArrayViewBase::ARRAY);
+
+    bool all_set = true;
+    for (size_t i = 0; i < arr.size(); ++i) all_set = all_set && arr[i] == 1.5;
+    CHECK(all_set);
+
+    arr(1, 2, 3) = 4.;
+    CHECK(arr[23] == 4.);
+
+    Array<Integer> empty;
+    CHECK(empty.use_count() == 0);
+    CHECK(empty.size() == empty.view().size());
+
+    Array<Integer> zeros({0, 5});
+    CHECK(zeros.size() == 0);
+  }
+
+  SECTION("Copies share the data") {
+    Array<Integer> arr({10});
+    {
+      Array<Integer> copy = arr;
+      CHECK(arr.use_count() == 2);
+      CHECK(copy.data() == arr.data());
+      copy[3] = 42;
+    }
+    CHECK(arr.use_count() == 1);
+    CHECK(arr[3] == 42);
+
+    Array<Integer> moved = std::move(arr);
+    CHECK(moved.use_count() == 1);
+    CHECK(moved[3] == 42);
+    CHECK(arr.use_count() == 0);
+
+    arr = moved;
+    CHECK(moved.use_count() == 2);
+  }
+
+  SECTION("Copy from a view") {
+    std::vector<Integer> data(12);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Integer>(i);
+    ArrayView<Integer> transposed(data.data(), {4, 3}, {1, 4});
+
+    Array<Integer> arr(transposed);
+    REQUIRE(arr.ndim() == 2);
+    CHECK(arr.strides()[0] == 3);
+    CHECK(arr.strides()[1] == 1);
+    bool agrees = true;
+    for (size_t i = 0; i < 4; ++i) {
+      for (size_t j = 0; j < 3; ++j) agrees = agrees && arr(i, j) == transposed(i, j);
+    }
+    CHECK(agrees);
+    CHECK(arr[1] == 4);
+    arr[0] = 100;
+    CHECK(data[0] == 0);
+  }
+
+  SECTION("Non-trivial types") {
+    Array<String> arr({3}, "abc");
+    CHECK(arr[2] == "abc");
+    arr[1] = std::string(100, 'x');
+
+    Array<String> copy(arr.view());
+    CHECK(copy[1] == std::string(100, 'x'));
+    CHECK(copy.data() != arr.data());
+  }
+
+  SECTION("Storage in PamMap") {
+    PamMap map;
+    {
+      Array<Float> arr({5}, 2.);
+      map.update("result", arr);
+      CHECK(arr.use_count() == 2);
+    }
+
+    // The map keeps the data alive
+    ArrayView<Float>& view = map.at<ArrayView<Float>>("result");
+    CHECK(view.size() == 5);
+    CHECK(view[4] == 2.);
+    view[4] = 3.;
+    CHECK(map.at<Array<Float>>("result")[4] == 3.);
+
+    const PamMap& cmap = map;
+    CHECK(cmap.at<ArrayView<Float>>("result")[4] == 3.);
+    CHECK(cmap.at<Array<Float>>("result").use_count() == 1);
+
+    PamMap copy(map);
+    CHECK(map.at<Array<Float>>("result").use_count() == 2);
+    map.erase("result");
+    CHECK(copy.at<ArrayView<Float>>("result")[4] == 3.);
+
+    CHECK_THROWS_AS(copy.at<ArrayView<Integer>>("result"), TypeError);
+    CHECK_THROWS_AS(copy.at<Float>("result"), TypeError);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -19,6 +19,7 @@
 
 #include "ArrayView.hpp"
 #include "exceptions.hpp"
+#include <algorithm>
 #include <catch2/catch.hpp>
 #include <numeric>
 
@@ -74,7 +75,10 @@ TEST_CASE("ArrayView", "[array]") {
   }
 
   SECTION("is_contiguous with non-unit stride") {
-    // TODO
+    ArrayView<value_type> every_other{data.data(), {500}, {2}};
+    CHECK_FALSE(every_other.is_c_contiguous());
+    CHECK_FALSE(every_other.is_fortran_contiguous());
+    CHECK_FALSE(cc.slice({All, {0, 50, 2}}).is_c_contiguous());
   }
 
   SECTION("Operator[] with unit stride") {
@@ -114,15 +118,369 @@ TEST_CASE("ArrayView", "[array]") {
   }
 
   SECTION("Operator[] with non-unit stride") {
-    // TODO
+    // Every other element
+    ArrayView<value_type> every_other{data.data(), {500}, {2}};
+    for (size_t i = 0; i < every_other.size(); ++i) {
+      CHECK(every_other[i] == data[2 * i]);
+    }
+
+    // Transposed view of the C-ordered data: The axis with the smallest
+    // stride varies fastest, i.e. memory order is retained.
+    ArrayView<value_type> transposed{data.data(), {10, 50, 2}, {1, 10, 500}};
+    bool transposed_agrees = true;
+    for (size_t i = 0; i < transposed.size(); ++i) {
+      if (transposed[i] != data[i]) transposed_agrees = false;
+    }
+    CHECK(transposed_agrees);
+
+    // Sliced view cc[1, 10:20:3, ::-1]: The last axis varies fastest.
+    ArrayView<value_type> sl = cc.slice({1, {10, 20, 3}, {Auto, Auto, -1}});
+    bool sliced_agrees = true;
+    for (size_t j = 0, cnt = 0; j < 4; ++j) {
+      for (size_t k = 0; k < 10; ++k, ++cnt) {
+        if (sl[cnt] != sl(0, j, k)) sliced_agrees = false;
+      }
+    }
+    CHECK(sliced_agrees);
+#ifndef NDEBUG
+    CHECK_THROWS_AS(sl[40], IndexError);
+#endif  // NDEBUG
+
+    // Broadcast axis of zero stride
+    ArrayView<value_type> expanded =
+          cc.slice({Slice::index(0), NewAxis, Slice::index(3)});
+    REQUIRE(std::vector<size_t>(expanded.shape()) == std::vector<size_t>{1, 10});
+    CHECK(expanded[7] == cc(0, 3, 7));
+  }
+
+  SECTION("Indexer agrees with operator[]") {
+    for (ArrayView<value_type> view :
+         {cc, fortran, cc.slice({{Auto, Auto, -1}, {10, 20, 3}, {1, 8, 3}}),
+          cc.slice({Slice::index(0), NewAxis, Slice::index(3)}),
+          ArrayView<value_type>(data.data(), {10, 50, 2}, {1, 10, 500})}) {
+      const auto idx = view.indexer();
+      bool agrees    = true;
+      for (size_t i = 0; i < view.size(); ++i) {
+        if (&idx[i] != &view[i]) agrees = false;
+      }
+      CHECK(agrees);
+    }
+
+    ArrayView<value_type> column = cc.slice({All, All, Slice::index(4)});
+    auto idx                     = column.indexer();
+    idx[3]                       = -1;
+    CHECK(cc(0, 3, 4) == -1);
+
+    const auto const_idx = fortran_const.indexer();
+    CHECK(const_idx[5] == fortran_const[5]);
   }
 
   SECTION("Setting values using operator[]") {
-    // TODO
+    ArrayView<value_type> column = cc.slice({All, All, Slice::index(4)});
+    for (size_t i = 0; i < column.size(); ++i) column[i] = -1;
+    CHECK(std::count(data.begin(), data.end(), -1) == 100);
+    CHECK(cc(1, 7, 4) == -1);
+    CHECK(cc(1, 7, 5) == 575);
+  }
+
+  SECTION("Iteration") {
+    CHECK(std::vector<value_type>(cc.begin(), cc.end()) == data);
+    CHECK(std::vector<value_type>(fortran_const.begin(), fortran_const.end()) == data);
+
+    ArrayView<value_type> sl = cc.slice({{Auto, Auto, -1}, {10, 20, 3}, {1, 8, 3}});
+    std::vector<value_type> by_index;
+    for (size_t i = 0; i < sl.size(); ++i) by_index.push_back(sl[i]);
+    CHECK(std::vector<value_type>(sl.cbegin(), sl.cend()) == by_index);
+    CHECK(std::distance(sl.begin(), sl.end()) == 2 * 4 * 3);
+
+    for (auto& v : sl) v = -1;
+    CHECK(std::count(data.begin(), data.end(), -1) == 2 * 4 * 3);
+
+    ArrayView<value_type> empty{data.data(), {2, 0}, {1, 2}};
+    CHECK(empty.size() == 0);
+    CHECK(empty.begin() == empty.end());
+  }
+
+  SECTION("Multi-dimensional indexing") {
+    CHECK(cc(1, 2, 3) == 523);
+    CHECK(cc_const(0, 49, 9) == 499);
+    CHECK(fortran(1, 2, 3) == 305);
+    CHECK(fortran_const(1, 49, 9) == 999);
+#ifndef NDEBUG
+    CHECK_THROWS_AS(cc(2, 0, 0), IndexError);
+    CHECK_THROWS_AS(cc(0, 0), IndexError);
+#endif  // NDEBUG
+
+    cc(0, 1, 2) = -1;
+    CHECK(data[12] == -1);
+  }
+
+  SECTION("Fixed-rank views") {
+    ArrayView<value_type, 3> fixed(data.data(), {2, 50, 10}, {500, 10, 1});
+    CHECK(fixed.ndim() == 3);
+    CHECK(fixed.size() == 1000);
+    CHECK(fixed.is_c_contiguous());
+    CHECK(fixed(1, 2, 3) == 523);
+    static_assert(ArrayView<value_type, 3>::ndim() == 3, "Rank known at compile time");
+
+    ArrayView<value_type, 2> matrix(data.data(), std::array<size_t, 2>{{10, 100}},
+                                    std::array<ptrdiff_t, 2>{{1, 10}});
+    CHECK(matrix(3, 4) == 43);
+    CHECK(matrix.is_fortran_contiguous());
+
+    // Conversion to and from dynamic rank
+    ArrayView<value_type> dynamic = fixed;
+    CHECK(dynamic.ndim() == 3);
+    CHECK(dynamic == cc);
+    ArrayView<value_type, 3> back(cc);
+    CHECK(back(1, 2, 3) == 523);
+    using matrix_type = ArrayView<value_type, 2>;
+    CHECK_THROWS_AS(matrix_type(cc), ValueError);
+    CHECK_THROWS_AS(matrix_type(data.data(), {10}, {1}), ValueError);
+  }
+
+  SECTION("Views are cheap to copy") {
+    static_assert(std::is_trivially_copyable<ArrayView<value_type>>::value,
+                  "ArrayView should be trivially copyable");
+    static_assert(std::is_trivially_copyable<ArrayView<value_type, 2>>::value,
+                  "ArrayView should be trivially copyable");
+
+    // Only the data pointer, shape, strides and a few scalars are stored
+    static_assert(sizeof(ArrayView<value_type, 1>) <= 8 * sizeof(void*),
+                  "ArrayView should not store more than the layout");
+    static_assert(sizeof(ArrayView<value_type>) <=
+                        (2 * max_dynamic_rank + 6) * sizeof(void*),
+                  "ArrayView should not store more than the layout");
+
+    ArrayView<value_type> copy(cc);
+    CHECK(copy == cc);
+    CHECK(copy.data() == cc.data());
+    CHECK(std::vector<size_t>(copy.shape()) == shape);
+    CHECK(std::vector<ptrdiff_t>(copy.strides()) == cc_strides);
+  }
+
+  SECTION("Maximal number of dimensions") {
+    std::vector<size_t> many_shape(max_dynamic_rank + 1, 1);
+    std::vector<ptrdiff_t> many_strides(max_dynamic_rank + 1, 1);
+    CHECK_THROWS_AS(ArrayView<value_type>(data.data(), many_shape, many_strides),
+                    ValueError);
+  }
+
+  SECTION("Slicing with ranges") {
+    // cc[1, 10:20:3, ::-1]
+    ArrayView<value_type> sl = cc.slice({1, {10, 20, 3}, {Auto, Auto, -1}});
+    REQUIRE(sl.ndim() == 3);
+    CHECK(std::vector<size_t>(sl.shape()) == std::vector<size_t>{1, 4, 10});
+    CHECK(std::vector<ptrdiff_t>(sl.strides()) == std::vector<ptrdiff_t>{500, 30, -1});
+    CHECK(sl.size() == 40);
+    for (size_t j = 0; j < 4; ++j) {
+      for (size_t k = 0; k < 10; ++k) {
+        CHECK(sl(0, j, k) == cc(1, 10 + 3 * j, 9 - k));
+      }
+    }
+
+    // Slices of slices compose the strides
+    ArrayView<value_type> sl2 = sl.slice({All, {3, Auto, -2}});
+    CHECK(std::vector<size_t>(sl2.shape()) == std::vector<size_t>{1, 2, 10});
+    CHECK(sl2(0, 0, 0) == cc(1, 19, 9));
+    CHECK(sl2(0, 1, 4) == cc(1, 13, 5));
+
+    // The same on Fortran-ordered data
+    ArrayView<value_type> fsl = fortran.slice({All, {49, 0, -7}});
+    CHECK(std::vector<size_t>(fsl.shape()) == std::vector<size_t>{2, 7, 10});
+    CHECK(fsl(1, 2, 3) == fortran(1, 35, 3));
+  }
+
+  SECTION("Slicing with indices and new axes") {
+    ArrayView<value_type> row = cc.slice({Slice::index(1), Slice::index(7)});
+    CHECK(row.ndim() == 1);
+    CHECK(row.shape()[0] == 10);
+    CHECK(row(4) == cc(1, 7, 4));
+
+    ArrayView<value_type> expanded = cc.slice({NewAxis, Slice::index(0), All, NewAxis});
+    CHECK(std::vector<size_t>(expanded.shape()) == std::vector<size_t>{1, 50, 1, 10});
+    CHECK(expanded(0, 3, 0, 2) == cc(0, 3, 2));
+
+    ArrayView<value_type, 3> fixed(cc);
+    ArrayView<value_type> scalar =
+          fixed.slice({Slice::index(1), Slice::index(2), Slice::index(3)});
+    CHECK(scalar.ndim() == 0);
+    CHECK(scalar.size() == 1);
+    CHECK(scalar() == 523);
+
+    // Views share the data
+    row(0) = -5;
+    CHECK(cc(1, 7, 0) == -5);
+  }
+
+  SECTION("Slicing errors") {
+    CHECK_THROWS_AS(cc.slice({All, All, All, All}), IndexError);
+    CHECK_THROWS_AS(cc.slice({Slice::index(2)}), IndexError);
+    CHECK_THROWS_AS(cc.slice({NewAxis, NewAxis, NewAxis, NewAxis, NewAxis, NewAxis}),
+                    ValueError);
+  }
+
+  SECTION("Slicing clips ranges to the axes") {
+    // cc[:, 40:100], cc[:, 60:70], cc[:, 30:20], cc[:, 100:40:-2]
+    ArrayView<value_type> tail = cc.slice({All, {40, 100}});
+    CHECK(std::vector<size_t>(tail.shape()) == std::vector<size_t>{2, 10, 10});
+    CHECK(tail(1, 9, 3) == cc(1, 49, 3));
+
+    for (const Slice& empty : {Slice(60, 70), Slice(30, 20), Slice(20, 30, -1),
+                               Slice(50, Auto, 1), Slice(Auto, 50, -1)}) {
+      ArrayView<value_type> sl = cc.slice({All, empty});
+      CHECK(std::vector<size_t>(sl.shape()) == std::vector<size_t>{2, 0, 10});
+      CHECK(sl.size() == 0);
+      CHECK(sl.data() == cc.data());
+    }
+
+    ArrayView<value_type> back = cc.slice({All, {100, 40, -2}});
+    CHECK(std::vector<size_t>(back.shape()) == std::vector<size_t>{2, 5, 10});
+    CHECK(back(0, 0, 0) == cc(0, 49, 0));
+    CHECK(back(1, 4, 2) == cc(1, 41, 2));
+
+    const SlicePlan plan({{5, 1000, 3}}, shape);
+    CHECK(std::vector<size_t>(plan.shape()) == std::vector<size_t>{0, 50, 10});
+  }
+
+  SECTION("Slicing with plans") {
+    // cc[1, 10:20:3, NewAxis, ::-1]
+    const SlicePlan plan({Slice::index(1), {10, 20, 3}, NewAxis, {Auto, Auto, -1}},
+                         shape);
+    CHECK(plan.ndim() == 3);
+    CHECK(std::vector<size_t>(plan.shape()) == std::vector<size_t>{4, 1, 10});
+    CHECK(plan.applies_to(cc.shape()));
+
+    // The plan applies to views of the same shape with any strides
+    for (const ArrayView<value_type>& view : {cc, fortran}) {
+      ArrayView<value_type> sl = view.slice(plan);
+      ArrayView<value_type> ref = view.slice({Slice::index(1), {10, 20, 3}, NewAxis,
+                                              {Auto, Auto, -1}});
+      CHECK(sl.data() == ref.data());
+      CHECK(std::vector<size_t>(sl.shape()) == std::vector<size_t>(ref.shape()));
+      CHECK(std::vector<ptrdiff_t>(sl.strides()) ==
+            std::vector<ptrdiff_t>(ref.strides()));
+      CHECK(sl(2, 0, 3) == view(1, 16, 6));
+    }
+
+    // Remaining axes are taken in full
+    const SlicePlan rows({{1, 2}}, shape);
+    CHECK(std::vector<size_t>(rows.shape()) == std::vector<size_t>{1, 50, 10});
+    CHECK(cc.slice(rows)(0, 2, 3) == cc(1, 2, 3));
+
+    CHECK_THROWS_AS(cc.slice(SlicePlan({All}, {2, 50})), ValueError);
+    CHECK_THROWS_AS(SlicePlan({All, All, All, All}, shape), IndexError);
+    CHECK_THROWS_AS(SlicePlan({All, Slice::index(50)}, shape), IndexError);
   }
 
-  // TODO test equality operators
-  // TODO test slice function
+  SECTION("Equality") {
+    std::vector<value_type> other_data(data);
+    ArrayView<value_type> other{other_data.data(), shape, cc_strides};
+    CHECK(cc == other);
+    CHECK(cc == cc_const);
+    CHECK(cc != fortran);
+
+    // Strided views compare elementwise
+    ArrayView<value_type> sl       = cc.slice({All, {Auto, Auto, 7}, {9, 0, -2}});
+    ArrayView<value_type> other_sl = other.slice({All, {Auto, Auto, 7}, {9, 0, -2}});
+    CHECK(sl == other_sl);
+    other_data[500 + 7 * 7 * 10 + 3] = -1;
+    CHECK(sl != other_sl);
+    CHECK(cc != other);
+  }
+
+  SECTION("Broadcasting") {
+    // A row of 10 and a column of 50 values broadcast to a 50x10 grid
+    ArrayView<value_type> row    = cc.slice({Slice::index(0), Slice::index(0)});
+    ArrayView<value_type> column = cc.slice({Slice::index(1), All, {0, 1}});
+    ArrayView<value_type> grid_row    = row.broadcast_to({50, 10});
+    ArrayView<value_type> grid_column = column.broadcast_to(grid_row.shape());
+    REQUIRE(std::vector<size_t>(grid_column.shape()) == std::vector<size_t>{50, 10});
+    CHECK(std::vector<ptrdiff_t>(grid_row.strides()) == std::vector<ptrdiff_t>{0, 1});
+    CHECK(std::vector<ptrdiff_t>(grid_column.strides()) ==
+          std::vector<ptrdiff_t>{10, 0});
+    CHECK(grid_row.data() == data.data());
+
+    bool agrees = true;
+    for (size_t i = 0; i < 50; ++i) {
+      for (size_t j = 0; j < 10; ++j) {
+        agrees = agrees && grid_row(i, j) == row(j) && grid_column(i, j) == cc(1, i, 0);
+      }
+    }
+    CHECK(agrees);
+
+    // Linear indexing and iteration visit all (repeated) elements
+    CHECK(grid_row.size() == 500);
+    CHECK(grid_column[12] == grid_column(1, 2));
+    CHECK(std::distance(grid_row.begin(), grid_row.end()) == 500);
+    CHECK(std::accumulate(grid_row.begin(), grid_row.end(), value_type(0)) ==
+          50 * std::accumulate(row.begin(), row.end(), value_type(0)));
+
+    CHECK_THROWS_AS(row.broadcast_to({50, 5}), ValueError);
+    CHECK_THROWS_AS(cc.broadcast_to({50, 10}), ValueError);
+    CHECK_THROWS_AS(column.broadcast_to({50, 10, 2}), ValueError);
+  }
+
+  SECTION("Reshaping") {
+    // Contiguous views can always be reshaped
+    ArrayView<value_type> flat = cc.reshape({1000});
+    CHECK(flat.is_c_contiguous());
+    CHECK(flat[123] == 123);
+    ArrayView<value_type> cube = cc.reshape({10, 1, 10, 10});
+    CHECK(cube.is_c_contiguous());
+    CHECK(cube(4, 0, 5, 6) == 456);
+    CHECK(cc.reshape({2, 500, 1})(1, 7, 0) == 507);
+
+    // Axes can be merged if their strides are compatible
+    ArrayView<value_type> sub    = cc.slice({All, {10, 30}});  // strides 500, 10, 1
+    ArrayView<value_type> merged = sub.reshape({2, 200});
+    CHECK(std::vector<ptrdiff_t>(merged.strides()) == std::vector<ptrdiff_t>{500, 1});
+    CHECK(merged(1, 57) == sub(1, 5, 7));
+    CHECK_THROWS_AS(sub.reshape({400}), ValueError);
+    ArrayView<value_type> split = sub.reshape({2, 4, 5, 10});
+    CHECK(std::vector<ptrdiff_t>(split.strides()) ==
+          std::vector<ptrdiff_t>{500, 50, 10, 1});
+    CHECK(split(1, 2, 3, 4) == sub(1, 13, 4));
+
+    // Strided axes can be split, but not merged with contiguous ones
+    ArrayView<value_type> sl     = cc.slice({All, {0, 50, 2}});  // strides 500, 20, 1
+    ArrayView<value_type> ssplit = sl.reshape({2, 5, 5, 10});
+    CHECK(std::vector<ptrdiff_t>(ssplit.strides()) ==
+          std::vector<ptrdiff_t>{500, 100, 20, 1});
+    CHECK(ssplit(1, 2, 3, 4) == sl(1, 13, 4));
+    CHECK(sl.reshape({50, 10})(31, 4) == sl(1, 6, 4));
+    CHECK_THROWS_AS(sl.reshape({500}), ValueError);
+    CHECK_THROWS_AS(fortran.reshape({1000}), ValueError);
+    CHECK_THROWS_AS(cc.reshape({999}), ValueError);
+
+    // Fortran-ordered axes can be split and merged in reverse
+    ArrayView<value_type> fsplit = fortran.reshape({2, 5, 10, 10});
+    CHECK(fsplit(1, 2, 3, 4) == fortran(1, 23, 4));
+
+    // Empty views
+    ArrayView<value_type> empty(data.data(), {2, 0, 10}, {500, 10, 1});
+    CHECK(empty.reshape({0, 7}).size() == 0);
+  }
+
+  SECTION("Transposing") {
+    ArrayView<value_type> t = cc.transpose();
+    REQUIRE(std::vector<size_t>(t.shape()) == std::vector<size_t>{10, 50, 2});
+    CHECK(t.is_fortran_contiguous());
+    CHECK(t(3, 7, 1) == cc(1, 7, 3));
+    CHECK(t.transpose() == cc);
+
+    ArrayView<value_type> p = cc.transpose({1, 2, 0});
+    CHECK(std::vector<ptrdiff_t>(p.strides()) == std::vector<ptrdiff_t>{10, 1, 500});
+    CHECK(p(7, 3, 1) == cc(1, 7, 3));
+
+    ArrayView<value_type, 3> fixed(cc);
+    ArrayView<value_type, 3> fixed_t = fixed.transpose({2, 0, 1});
+    CHECK(fixed_t(3, 1, 7) == cc(1, 7, 3));
+
+    CHECK_THROWS_AS(cc.transpose({0, 1}), ValueError);
+    CHECK_THROWS_AS(cc.transpose({0, 1, 1}), ValueError);
+    CHECK_THROWS_AS(cc.transpose({0, 1, 3}), ValueError);
+  }
 }
 
 }  // namespace tests
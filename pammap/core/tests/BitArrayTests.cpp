@@ -0,0 +1,184 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "BitArray.hpp"
+#include "PamMap.hpp"
+#include "typedefs.hxx"
+#include <catch2/catch.hpp>
+#include <random>
+
+namespace pammap {
+namespace tests {
+
+namespace {
+/** Random bits with about a fraction ``density`` set */
+Array<Bool> random_bools(size_t size, double density, unsigned seed) {
+  std::mt19937 engine(seed);
+  std::bernoulli_distribution distribution(density);
+  Array<Bool> ret({size});
+  for (size_t i = 0; i < size; ++i) ret[i] = distribution(engine);
+  return ret;
+}
+}  // namespace
+
+TEST_CASE("BitArray", "[BitArray]") {
+  SECTION("Construction and bit access") {
+    BitArray bits(130);
+    CHECK(bits.size() == 130);
+    CHECK(bits.view().n_words() == 3);
+    CHECK(bits.count() == 0);
+    CHECK(bits.view().none());
+    CHECK(bits.view().find_first() == BitArrayView::npos);
+
+    bits.set(0);
+    bits.set(64);
+    bits.set(129);
+    bits.flip(3);
+    CHECK(bits.count() == 4);
+    CHECK(bits[3]);
+    bits.reset(3);
+    CHECK(!bits.test(3));
+    CHECK(bits.view().words()[1] == 1);
+
+    BitArray ones(70, true);
+    CHECK(ones.count() == 70);
+    CHECK(ones.view().all());
+    ones.view().flip();
+    CHECK(ones.view().none());
+  }
+
+  SECTION("Word-level operations agree with bitwise reference") {
+    for (size_t size : {0u, 1u, 63u, 64u, 65u, 200u, 1000u}) {
+      Array<Bool> a   = random_bools(size, 0.3, 1);
+      Array<Bool> b   = random_bools(size, 0.6, 2);
+      BitArray bits_a = BitArray::from_bools(a.view());
+      BitArray bits_b = BitArray::from_bools(b.view());
+
+      size_t count = 0;
+      for (size_t i = 0; i < size; ++i) {
+        if (a[i]) ++count;
+      }
+      CHECK(bits_a.count() == count);
+
+      std::vector<size_t> set_bits;
+      for (size_t i = bits_a.view().find_first(); i != BitArrayView::npos;
+           i = bits_a.view().find_next(i + 1)) {
+        set_bits.push_back(i);
+      }
+      std::vector<size_t> reference;
+      for (size_t i = 0; i < size; ++i) {
+        if (a[i]) reference.push_back(i);
+      }
+      CHECK(set_bits == reference);
+
+      BitArray band(bits_a.view());
+      band.view() &= bits_b.view();
+      BitArray bor(bits_a.view());
+      bor.view() |= bits_b.view();
+      BitArray bxor(bits_a.view());
+      bxor.view() ^= bits_b.view();
+      BitArray bandnot(bits_a.view());
+      bandnot.view().and_not(bits_b.view());
+
+      bool agrees = true;
+      for (size_t i = 0; i < size; ++i) {
+        agrees = agrees && band[i] == (a[i] && b[i]);
+        agrees = agrees && bor[i] == (a[i] || b[i]);
+        agrees = agrees && bxor[i] == (a[i] != b[i]);
+        agrees = agrees && bandnot[i] == (a[i] && !b[i]);
+      }
+      CHECK(agrees);
+    }
+  }
+
+  SECTION("Unused bits of the last word are ignored and kept") {
+    BitArrayView::word_type words[2] = {0, ~BitArrayView::word_type(0)};
+    BitArrayView view(words, 70);
+    CHECK(view.count() == 6);
+    CHECK(!view.all());
+    view.fill(false);
+    CHECK(view.none());
+    CHECK(words[1] == ~BitArrayView::word_type(0) << 6);
+
+    BitArray other(70);
+    CHECK(view == other.view());
+    view.set(69);
+    CHECK(view != other.view());
+    CHECK(view.find_first() == 69);
+  }
+
+  SECTION("Conversion to and from Bools") {
+    Array<Bool> bools = random_bools(333, 0.5, 3);
+    BitArray bits     = BitArray::from_bools(bools.view());
+    Array<Bool> back({333});
+    bits.view().to_bools(back.view());
+    CHECK(back.view() == bools.view());
+
+    // Non-contiguous views are taken in index order
+    Array<Bool> strided({2 * 333});
+    ArrayView<Bool> every_second(strided.data(), {333}, {2});
+    bits.view().to_bools(every_second);
+    BitArray again = BitArray::from_bools(every_second);
+    CHECK(again.view() == bits.view());
+
+    CHECK_THROWS_AS(bits.view().to_bools(Array<Bool>({10}).view()), ValueError);
+    CHECK_THROWS_AS(bits.view() &= BitArray(10).view(), ValueError);
+  }
+
+  SECTION("Conversion to and from packbits") {
+    // numpy.packbits([1, 0, 1, 1, 0, 0, 0, 0, 1, 1]) == [176, 192]
+    BitArray bits(10);
+    for (size_t i : {0u, 2u, 3u, 8u, 9u}) bits.set(i);
+    uint8_t bytes[2] = {0xff, 0xff};
+    bits.view().to_packbits(bytes);
+    CHECK(bytes[0] == 176);
+    CHECK(bytes[1] == 192);
+
+    BitArray back = BitArray::from_packbits(bytes, 10);
+    CHECK(back.view() == bits.view());
+
+    Array<Bool> bools = random_bools(200, 0.5, 4);
+    BitArray large    = BitArray::from_bools(bools.view());
+    std::vector<uint8_t> packed(25);
+    large.view().to_packbits(packed.data());
+    CHECK(BitArray::from_packbits(packed.data(), 200).view() == large.view());
+  }
+
+  SECTION("Storage in PamMap") {
+    PamMap map;
+    {
+      BitArray mask(100);
+      mask.set(42);
+      map.update("mask", mask);
+      CHECK(mask.use_count() == 2);
+    }
+
+    BitArrayView& view = map.at<BitArrayView>("mask");
+    CHECK(view.find_first() == 42);
+    view.set(7);
+    CHECK(map.at<BitArray>("mask").count() == 2);
+
+    const PamMap& cmap = map;
+    CHECK(cmap.at<BitArrayView>("mask").count() == 2);
+    CHECK_THROWS_AS(cmap.at<ArrayView<Bool>>("mask"), TypeError);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -0,0 +1,216 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ChunkedArray.hpp"
+#include "PamMap.hpp"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+
+namespace pammap {
+namespace tests {
+
+namespace {
+/** Store computing the elements from their multi-index and counting reads */
+struct CountingStore : public ChunkStore<Integer> {
+  explicit CountingStore(std::vector<size_t> shape) : shape(std::move(shape)) {}
+
+  void read(span<const size_t> offset, ArrayView<Integer> block) const override {
+    ++reads;
+    {
+      // Reads starting in a row past open_rows wait until opened by the test
+      std::unique_lock<std::mutex> lock(mutex);
+      opened.wait(lock, [&] { return offset[0] < open_rows; });
+    }
+    pammap_throw(!fail, IOError, "Failure requested by the test.");
+    for (size_t i = 0; i < block.shape()[0]; ++i) {
+      for (size_t j = 0; j < block.shape()[1]; ++j) {
+        block(i, j) = static_cast<Integer>((offset[0] + i) * shape[1] + offset[1] + j);
+      }
+    }
+  }
+
+  /** Allow reads starting in the first ``rows`` rows to complete */
+  void open(size_t rows) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      open_rows = rows;
+    }
+    opened.notify_all();
+  }
+
+  std::vector<size_t> shape;
+  mutable std::atomic<int> reads{0};
+  bool fail = false;
+
+  mutable std::mutex mutex;
+  mutable std::condition_variable opened;
+  size_t open_rows = static_cast<size_t>(-1);
+};
+}  // namespace
+
+TEST_CASE("ChunkedArray", "[ChunkedArray]") {
+  // 10x7 array in tiles of 4x3, i.e. a 3x3 grid with smaller edge tiles
+  auto store = std::make_shared<CountingStore>(std::vector<size_t>{10, 7});
+  const size_t tile_bytes = 12 * sizeof(Integer);
+  ChunkedArray<Integer> array({10, 7}, {4, 3}, store, 2 * tile_bytes);
+
+  SECTION("Tiling") {
+    CHECK(array.size() == 70);
+    CHECK(array.n_tiles() == 9);
+    CHECK(std::vector<size_t>(array.tile_grid()) == std::vector<size_t>{3, 3});
+    CHECK(array.tile_offset(5) == std::vector<size_t>{4, 6});
+    CHECK(array.tile_extent(5) == std::vector<size_t>{4, 1});
+    CHECK(array.tile_extent(8) == std::vector<size_t>{2, 1});
+
+    const Array<Integer> tile = array.tile(5);
+    CHECK(std::vector<size_t>(tile.shape()) == std::vector<size_t>{4, 1});
+    CHECK(tile(2, 0) == 6 * 7 + 6);
+    CHECK_THROWS_AS(array.tile(9), IndexError);
+    CHECK_THROWS_AS(ChunkedArray<Integer>({10, 7}, {4, 0}, store), ValueError);
+    CHECK_THROWS_AS(ChunkedArray<Integer>({10, 7}, {4}, store), ValueError);
+  }
+
+  SECTION("Cache") {
+    array.tile(0);
+    array.tile(1);
+    array.tile(0);
+    CHECK(store->reads == 2);
+    CHECK(array.cached_bytes() == 2 * tile_bytes);
+
+    // The least recently used tiles are dropped, but the data handed out
+    // stays alive.
+    Array<Integer> tile3 = array.tile(3);
+    array.tile(4);
+    CHECK(array.cached_tiles() == 2);
+    CHECK(array.cached_bytes() <= array.memory_budget());
+    array.tile(0);
+    CHECK(store->reads == 5);
+    CHECK(tile3(0, 0) == 4 * 7);
+
+    // Failures are passed on and not cached
+    store->fail = true;
+    CHECK_THROWS_AS(array.tile(8), IOError);
+    store->fail = false;
+    CHECK(array.tile(8)(1, 0) == 9 * 7 + 6);
+  }
+
+  SECTION("Blocks and prefetching") {
+    Integer sum = 0;
+    size_t count = 0;
+    for (const auto& block : array.blocks(2)) {
+      CHECK(block.offset == array.tile_offset(block.tile));
+      for (size_t i = 0; i < block.view().size(); ++i) sum += block.view()[i];
+      ++count;
+    }
+    CHECK(count == 9);
+    CHECK(sum == 69 * 70 / 2);
+
+    array.set_memory_budget(10 * tile_bytes);
+    array.prefetch(7);
+    CHECK(array.tile(7)(0, 0) == 8 * 7 + 3);
+
+    const ChunkedArray<Integer> empty;
+    CHECK(empty.blocks().begin() == empty.blocks().end());
+  }
+
+  SECTION("Prefetching with a tight budget") {
+    // Prefetches neither drop tiles still being loaded nor exceed the
+    // budget, such that every tile is read exactly once. Each tile is one
+    // row and the background load of the next tile only completes once the
+    // current one has been processed, i.e. it is certainly still running
+    // when the tile after it is prefetched.
+    auto slow = std::make_shared<CountingStore>(std::vector<size_t>{8, 3});
+    slow->open(1);
+    ChunkedArray<Integer> tight({8, 3}, {1, 3}, slow, 3 * sizeof(Integer));
+
+    Integer sum = 0;
+    for (const auto& block : tight.blocks(2)) {
+      for (size_t i = 0; i < block.view().size(); ++i) sum += block.view()[i];
+      CHECK(tight.cached_tiles() == 1);
+      slow->open(block.tile + 2);
+    }
+    CHECK(sum == 23 * 24 / 2);
+    CHECK(slow->reads == 8);
+  }
+
+  SECTION("Storage in a PamMap") {
+    PamMap map{{"array", array}};
+    CHECK(map.at<ChunkedArray<Integer>>("array").tile(4)(1, 1) == 5 * 7 + 4);
+  }
+}
+
+TEST_CASE("FileChunkStore", "[ChunkedArray]") {
+  // A 6x5x4 array behind a header of 16 bytes
+  const std::string path = "FileChunkStoreTest.bin";
+  std::vector<Float> data(120);
+  std::iota(data.begin(), data.end(), 0.0);
+  {
+    std::ofstream file(path, std::ios::binary);
+    const char header[16] = "header";
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size() * sizeof(Float)));
+  }
+
+  for (auto access : {FileChunkStore<Float>::READ, FileChunkStore<Float>::MAP}) {
+    INFO("access = " << access);
+    auto store = std::make_shared<FileChunkStore<Float>>(
+          path, std::vector<size_t>{6, 5, 4}, 16, access);
+
+    // Tiles covering the trailing axes completely (one run per tile) and
+    // tiles needing one run per row
+    for (const std::vector<size_t>& tile_shape :
+         {std::vector<size_t>{2, 5, 4}, std::vector<size_t>{4, 2, 3}}) {
+      ChunkedArray<Float> array({6, 5, 4}, tile_shape, store);
+      bool agrees = true;
+      for (const auto& block : array.blocks()) {
+        const ArrayView<Float>& view = block.view();
+        for (size_t i = 0; i < view.shape()[0]; ++i) {
+          for (size_t j = 0; j < view.shape()[1]; ++j) {
+            for (size_t k = 0; k < view.shape()[2]; ++k) {
+              const size_t index = ((block.offset[0] + i) * 5 + block.offset[1] + j) * 4 +
+                                   block.offset[2] + k;
+              agrees = agrees && view(i, j, k) == data[index];
+            }
+          }
+        }
+      }
+      CHECK(agrees);
+    }
+
+    // Blocks beyond the stored array
+    std::vector<Float> out(8);
+    const std::vector<size_t> offset{5, 4, 0};
+    const span<const size_t> beyond(offset.data(), offset.size());
+    ArrayView<Float> block(out.data(), {2, 1, 4}, {4, 4, 1});
+    CHECK_THROWS_AS(store->read(beyond, block), IndexError);
+  }
+
+  CHECK_THROWS_AS(FileChunkStore<Float>(path, {7, 5, 4}, 16), IOError);
+  CHECK_THROWS_AS(FileChunkStore<Float>("does_not_exist.bin", {1}), IOError);
+  std::remove(path.c_str());
+}
+
+}  // namespace tests
+}  // namespace pammap
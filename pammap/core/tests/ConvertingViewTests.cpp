@@ -0,0 +1,176 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Array.hpp"
+#include "ConvertingView.hpp"
+#include "typedefs.hxx"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <numeric>
+
+namespace pammap {
+namespace tests {
+
+namespace {
+/** Reverse the bytes of each element (or each part of complex elements) */
+template <typename S>
+std::vector<char> swapped_bytes(const std::vector<S>& values, size_t part = sizeof(S)) {
+  std::vector<char> ret(values.size() * sizeof(S));
+  std::memcpy(ret.data(), values.data(), ret.size());
+  for (size_t i = 0; i < ret.size(); i += part) {
+    std::reverse(ret.begin() + static_cast<ptrdiff_t>(i),
+                 ret.begin() + static_cast<ptrdiff_t>(i + part));
+  }
+  return ret;
+}
+
+static_assert(detail::is_widening<int32_t, Integer>::value, "");
+static_assert(detail::is_widening<uint32_t, Integer>::value, "");
+static_assert(detail::is_widening<int32_t, Float>::value, "");
+static_assert(detail::is_widening<Float32, Complex>::value, "");
+static_assert(detail::is_widening<Complex64, Complex>::value, "");
+static_assert(detail::is_widening<bool, Float32>::value, "");
+static_assert(!detail::is_widening<Integer, Float>::value, "");
+static_assert(!detail::is_widening<int32_t, uint64_t>::value, "");
+static_assert(!detail::is_widening<uint32_t, int32_t>::value, "");
+static_assert(!detail::is_widening<Float, Float32>::value, "");
+static_assert(!detail::is_widening<Complex, Float>::value, "");
+static_assert(!detail::is_widening<Float32, Integer>::value, "");
+}  // namespace
+
+TEST_CASE("ConvertingView", "[ConvertingView]") {
+  std::vector<Integer32> data(12);
+  std::iota(data.begin(), data.end(), -5);
+
+  SECTION("Widening native elements") {
+    const ConvertingView<Integer> view(ArrayView<Integer32>(data.data(), {3, 4}, {4, 1}));
+    CHECK(view.source_kind() == SourceType::INT32);
+    CHECK_FALSE(view.swaps_bytes());
+    CHECK(view.size() == 12);
+    CHECK(std::vector<size_t>(view.shape()) == std::vector<size_t>{3, 4});
+    CHECK(std::vector<ptrdiff_t>(view.byte_strides()) == std::vector<ptrdiff_t>{16, 4});
+    CHECK(view(0, 0) == -5);
+    CHECK(view(2, 1) == 4);
+
+    const ConvertingView<Float> as_float(ArrayView<Integer32>(data.data(), {12}, {1}));
+    CHECK(as_float(11) == 6.);
+  }
+
+  SECTION("Byte-swapped elements") {
+    const std::vector<char> bytes = swapped_bytes(data);
+    const ConvertingView<Integer> view(bytes.data(), SourceType::INT32, true, {3, 4},
+                                       {16, 4});
+    CHECK(view.swaps_bytes());
+    CHECK(view(1, 2) == 1);
+
+    const std::vector<Float32> floats{1.5f, -2.25f, 1e30f};
+    const std::vector<char> float_bytes = swapped_bytes(floats);
+    const ConvertingView<Float> as_float(float_bytes.data(), SourceType::FLOAT32, true,
+                                         {3}, {4});
+    CHECK(as_float(1) == -2.25);
+    CHECK(as_float(2) == static_cast<Float>(1e30f));
+
+    const std::vector<Complex64> complexes{{1.f, -2.f}, {0.5f, 3.f}};
+    const std::vector<char> complex_bytes = swapped_bytes(complexes, sizeof(Float32));
+    const ConvertingView<Complex> as_complex(complex_bytes.data(), SourceType::COMPLEX64,
+                                             true, {2}, {8});
+    CHECK(as_complex(1) == Complex(0.5, 3.));
+
+    // Single bytes are never swapped
+    const std::vector<Integer8> small{-1, 2};
+    CHECK_FALSE(ConvertingView<Integer>(small.data(), SourceType::INT8, true, {2}, {1})
+                      .swaps_bytes());
+  }
+
+  SECTION("Unaligned elements") {
+    std::vector<char> bytes(1 + data.size() * sizeof(Integer32));
+    std::memcpy(bytes.data() + 1, data.data(), data.size() * sizeof(Integer32));
+    const ConvertingView<Integer> view(bytes.data() + 1, SourceType::INT32, false, {12},
+                                       {4});
+    CHECK(view(7) == 2);
+  }
+
+  SECTION("copy_to and slices") {
+    // Transposed view, such that rows are not contiguous
+    const ConvertingView<Integer> view(ArrayView<Integer32>(data.data(), {4, 3}, {1, 4}));
+    Array<Integer> out({4, 3});
+    view.copy_to(out.view());
+    bool agrees = true;
+    for (size_t i = 0; i < 4; ++i) {
+      for (size_t j = 0; j < 3; ++j) agrees = agrees && out(i, j) == data[4 * j + i];
+    }
+    CHECK(agrees);
+
+    const ConvertingView<Integer> sliced = view.slice({Slice(1, 4, 2), Slice::index(2)});
+    CHECK(sliced.ndim() == 1);
+    CHECK(sliced(1) == data[11]);
+
+    Array<Integer> wrong({3, 4});
+    CHECK_THROWS_AS(view.copy_to(wrong.view()), ValueError);
+  }
+
+  SECTION("Blocks") {
+    for (const ArrayView<Integer32>& source :
+         {ArrayView<Integer32>(data.data(), {3, 4}, {4, 1}),
+          ArrayView<Integer32>(data.data(), {4, 3}, {1, 4}),
+          ArrayView<Integer32>(data.data() + 11, {2, 6}, {-6, -1})}) {
+      const ConvertingView<Integer> view(source);
+      std::vector<Integer> values;
+      std::vector<size_t> counts;
+      view.for_each_block(
+            [&](const Integer* block, size_t count) {
+              values.insert(values.end(), block, block + count);
+              counts.push_back(count);
+            },
+            5);
+      CHECK(counts == std::vector<size_t>{5, 5, 2});
+
+      std::vector<Integer> expected;
+      for (size_t i = 0; i < source.shape()[0]; ++i) {
+        for (size_t j = 0; j < source.shape()[1]; ++j) expected.push_back(source(i, j));
+      }
+      CHECK(values == expected);
+    }
+
+    const Integer32 scalar = 7;
+    const ConvertingView<Float> zero_dim(&scalar, SourceType::INT32, false, {}, {});
+    Float total = 0;
+    zero_dim.for_each_block([&](const Float* block, size_t count) {
+      total += std::accumulate(block, block + count, 0.);
+    });
+    CHECK(total == 7.);
+  }
+
+  SECTION("Lossy conversions") {
+    std::vector<Float> floats(3);
+    std::vector<Integer> integers(3);
+    CHECK_THROWS_AS(ConvertingView<Float32>(ArrayView<Float>(floats)), TypeError);
+    CHECK_THROWS_AS(ConvertingView<Float>(ArrayView<Integer>(integers)), TypeError);
+    CHECK_THROWS_AS(ConvertingView<Integer32>(integers.data(), SourceType::UINT32, false,
+                                              {3}, {8}),
+                    TypeError);
+    CHECK_THROWS_AS(ConvertingView<Float>(integers.data(), SourceType::COMPLEX64, false,
+                                          {3}, {8}),
+                    TypeError);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -0,0 +1,163 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "copy_into.hpp"
+#include "typedefs.hxx"
+#include <catch2/catch.hpp>
+#include <numeric>
+
+namespace pammap {
+namespace tests {
+
+namespace {
+/** Check that two 3D views agree elementwise */
+template <typename T>
+bool agree(const ArrayView<T>& a, const ArrayView<T>& b) {
+  for (size_t i = 0; i < a.shape()[0]; ++i) {
+    for (size_t j = 0; j < a.shape()[1]; ++j) {
+      for (size_t k = 0; k < a.shape()[2]; ++k) {
+        if (a(i, j, k) != b(i, j, k)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+/** An element type without default constructor */
+struct Tagged {
+  explicit Tagged(int value) : value(value) {}
+  bool operator!=(const Tagged& other) const { return value != other.value; }
+  int value;
+};
+
+/** Strides of a C-contiguous array */
+std::vector<ptrdiff_t> c_strides(const std::vector<size_t>& shape) {
+  std::vector<ptrdiff_t> ret(shape.size(), 1);
+  for (size_t d = shape.size() - 1; d-- > 0;) {
+    ret[d] = ret[d + 1] * static_cast<ptrdiff_t>(shape[d + 1]);
+  }
+  return ret;
+}
+
+/** Strides of a Fortran-contiguous array */
+std::vector<ptrdiff_t> f_strides(const std::vector<size_t>& shape) {
+  std::vector<ptrdiff_t> ret(shape.size(), 1);
+  for (size_t d = 1; d < shape.size(); ++d) {
+    ret[d] = ret[d - 1] * static_cast<ptrdiff_t>(shape[d - 1]);
+  }
+  return ret;
+}
+}  // namespace
+
+TEST_CASE("copy_into", "[array]") {
+  // Shapes with extents not divisible by the tile sizes
+  for (const std::vector<size_t>& shape : std::vector<std::vector<size_t>>{
+             {3, 5, 7}, {1, 67, 45}, {130, 1, 33}, {41, 37, 2}, {1, 1, 1}}) {
+    const size_t size = shape[0] * shape[1] * shape[2];
+    INFO("shape = " << shape[0] << " x " << shape[1] << " x " << shape[2]);
+
+    std::vector<Float> cdata(size), fdata(size, -1), tdata(size, -1);
+    std::iota(cdata.begin(), cdata.end(), 0.0);
+    ArrayView<Float> c(cdata.data(), shape, c_strides(shape));
+    ArrayView<Float> f(fdata.data(), shape, f_strides(shape));
+
+    // C to Fortran and back
+    copy_into(f, c);
+    CHECK(agree(f, c));
+    std::fill(cdata.begin(), cdata.end(), -1);
+    copy_into(c, f, false);
+    CHECK(agree(c, f));
+
+    // Axes permuted in the destination: (k, i, j) is C-contiguous
+    const std::vector<size_t> perm_shape{shape[2], shape[0], shape[1]};
+    std::vector<ptrdiff_t> perm = c_strides(perm_shape);
+    ArrayView<Float> t(tdata.data(), shape, {perm[1], perm[2], perm[0]});
+    copy_into(t, c);
+    CHECK(agree(t, c));
+
+    // Complex numbers
+    std::vector<Complex> zc(size), zf(size);
+    for (size_t i = 0; i < size; ++i) zc[i] = Complex(cdata[i], -cdata[i]);
+    ArrayView<Complex> zcv(zc.data(), shape, c_strides(shape));
+    ArrayView<Complex> zfv(zf.data(), shape, f_strides(shape));
+    copy_into(zfv, zcv);
+    CHECK(agree(zfv, zcv));
+  }
+
+  SECTION("Strided and reversed views") {
+    std::vector<Integer> data(60 * 70);
+    std::iota(data.begin(), data.end(), 0);
+    ArrayView<Integer> matrix(data.data(), {60, 70}, {70, 1});
+    ArrayView<Integer> src = matrix.slice({{Auto, Auto, -2}, {3, 64, 3}});
+
+    std::vector<Integer> out(src.size(), 0);
+    ArrayView<Integer> dst(out.data(), {src.shape()[0], src.shape()[1]},
+                           {1, static_cast<ptrdiff_t>(src.shape()[0])});
+    copy_into(dst, src);
+    bool agrees = true;
+    for (size_t i = 0; i < src.shape()[0]; ++i) {
+      for (size_t j = 0; j < src.shape()[1]; ++j) {
+        agrees = agrees && dst(i, j) == src(i, j);
+      }
+    }
+    CHECK(agrees);
+
+    std::vector<Integer> wrong(10);
+    CHECK_THROWS_AS(copy_into(ArrayView<Integer>(wrong), src), ValueError);
+  }
+
+  SECTION("Transposes of other element types") {
+    const std::vector<size_t> shape{30, 20, 3};
+    std::vector<Tagged> tc, tf;
+    std::vector<String> sc, sf(1800);
+    for (int i = 0; i < 1800; ++i) {
+      tc.emplace_back(i);
+      tf.emplace_back(-1);
+      sc.push_back(std::to_string(i));
+    }
+    ArrayView<Tagged> tcv(tc.data(), shape, c_strides(shape));
+    ArrayView<Tagged> tfv(tf.data(), shape, f_strides(shape));
+    copy_into(tfv, tcv);
+    CHECK(agree(tfv, tcv));
+
+    ArrayView<String> scv(sc.data(), shape, c_strides(shape));
+    ArrayView<String> sfv(sf.data(), shape, f_strides(shape));
+    copy_into(sfv, scv);
+    CHECK(agree(sfv, scv));
+  }
+
+  SECTION("Large parallel transpose") {
+    const size_t n = 300, m = 257;
+    std::vector<Float> data(n * m), out(n * m);
+    std::iota(data.begin(), data.end(), 0.0);
+    ArrayView<Float, 2> src(data.data(), std::array<size_t, 2>{{n, m}},
+                            std::array<ptrdiff_t, 2>{{ptrdiff_t(m), 1}});
+    ArrayView<Float, 2> dst(out.data(), std::array<size_t, 2>{{n, m}},
+                            std::array<ptrdiff_t, 2>{{1, ptrdiff_t(n)}});
+    copy_into(dst, src);
+    bool agrees = true;
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < m; ++j) agrees = agrees && dst(i, j) == src(i, j);
+    }
+    CHECK(agrees);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
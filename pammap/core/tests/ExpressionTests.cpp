@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "expressions.hpp"
+#include "typedefs.hxx"
+#include <catch2/catch.hpp>
+#include <numeric>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("Expressions", "[expressions]") {
+  // Large enough to be split between threads
+  const size_t n = 2 * parallel_min_size + 7;
+  std::vector<Float> a(n), b(n), c(n), out(n, -1);
+  std::iota(a.begin(), a.end(), 0.0);
+  for (size_t i = 0; i < n; ++i) {
+    b[i] = 1.0 / static_cast<Float>(i + 1);
+    c[i] = static_cast<Float>(i % 17) - 8;
+  }
+  ArrayView<Float> va(a), vb(b), vc(c), vout(out);
+
+  SECTION("Contiguous views") {
+    assign(vout, va * 2.0 + vb * vc - va / 4.0);
+    bool agrees = true;
+    for (size_t i = 0; i < n; ++i) {
+      agrees = agrees && out[i] == a[i] * 2.0 + b[i] * c[i] - a[i] / 4.0;
+    }
+    CHECK(agrees);
+
+    // Scalars on the left, negation and the destination within the expression
+    assign(vout, 1.0 - (-vout) * 0.5 + 3 * va);
+    CHECK(out[10] == Approx(1.0 + 0.5 * (a[10] * 1.75 + b[10] * c[10]) + 3 * a[10]));
+  }
+
+  SECTION("Strided and multi-dimensional views") {
+    // Every second element of a against b in Fortran order
+    const size_t rows = 3, cols = n / 6;
+    ArrayView<Float> strided(a.data(), {rows, cols}, {2, 6});
+    ArrayView<Float> fortran(b.data(), {rows, cols}, {1, 3});
+    ArrayView<Float> result(out.data(), {rows, cols}, {static_cast<ptrdiff_t>(cols), 1});
+    assign(result, strided - fortran * 3.0);
+
+    bool agrees = true;
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t j = 0; j < cols; ++j) {
+        agrees = agrees && result(i, j) == strided(i, j) - fortran(i, j) * 3.0;
+      }
+    }
+    CHECK(agrees);
+
+    // Broadcasting a row over all rows
+    ArrayView<Float> row(c.data(), {cols}, {1});
+    assign(result, fortran + row.broadcast_to({rows, cols}));
+    CHECK(result(2, 5) == fortran(2, 5) + c[5]);
+  }
+
+  SECTION("Types") {
+    std::vector<Integer> ints{1, 2, 3, 4};
+    std::vector<Float> reals(4);
+    assign(ArrayView<Float>(reals), ArrayView<Integer>(ints) * 0.5);
+    CHECK(reals == std::vector<Float>{0.5, 1.0, 1.5, 2.0});
+
+    std::vector<Complex> z{{1, 1}, {2, -1}, {0, 3}, {-1, 0}}, w(4);
+    assign(ArrayView<Complex>(w), 2 * ArrayView<Complex>(z) + ArrayView<Float>(reals));
+    CHECK(w[1] == Complex(5, -2));
+    CHECK(w[3] == Complex(0, 0));
+  }
+
+  SECTION("Shape mismatch") {
+    ArrayView<Float> shorter(a.data(), {n - 1}, {1});
+    CHECK_THROWS_AS(assign(vout, va + shorter), ValueError);
+    CHECK_THROWS_AS(assign(shorter, va * 2.0), ValueError);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -0,0 +1,59 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "FastDivisor.hpp"
+#include <catch2/catch.hpp>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("FastDivisor", "[array]") {
+  const size_t max = std::numeric_limits<size_t>::max();
+  std::vector<size_t> divisors{
+        1,   2,       3,       5,       7,          10, 50, 64, 1000, 12345, 65536,
+        max, max - 1, max / 2, max / 3, max / 2 + 1};
+  std::vector<size_t> numerators{0,       1,           2,       3,  63, 64, 65, 999, 1000,
+                                 max / 2, max / 2 + 1, max - 1, max};
+
+  std::mt19937_64 rng(42);
+  for (size_t i = 0; i < 100; ++i) numerators.push_back(rng());
+  for (size_t i = 0; i < 64; ++i) divisors.push_back(rng() >> i);
+
+  bool all_agree = true;
+  for (size_t d : divisors) {
+    if (d == 0) continue;
+    const FastDivisor fast(d);
+    for (size_t n : numerators) {
+      if (fast.divide(n) != n / d) {
+        all_agree = false;
+        FAIL_CHECK(n << " / " << d << ": " << fast.divide(n) << " != " << n / d);
+      }
+    }
+  }
+  CHECK(all_agree);
+
+  // Zero is treated like one
+  CHECK(FastDivisor(0).divide(17) == 17);
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -0,0 +1,147 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "GlobPattern.hpp"
+#include "PamMap.hpp"
+#include "exceptions.hpp"
+#include <catch2/catch.hpp>
+
+namespace pammap {
+
+TEST_CASE("GlobPattern", "[glob]") {
+  SECTION("Matching of single components") {
+    CHECK(glob_match_component("tol", "tol"));
+    CHECK_FALSE(glob_match_component("tol", "tolerance"));
+    CHECK(glob_match_component("*", "anything"));
+    CHECK(glob_match_component("*", ""));
+    CHECK(glob_match_component("tol*", "tolerance"));
+    CHECK(glob_match_component("*ance", "tolerance"));
+    CHECK(glob_match_component("t*r*e", "tolerance"));
+    CHECK_FALSE(glob_match_component("t*x*e", "tolerance"));
+    CHECK(glob_match_component("?ol", "tol"));
+    CHECK_FALSE(glob_match_component("?ol", "ol"));
+    CHECK(glob_match_component("[st]cf", "scf"));
+    CHECK_FALSE(glob_match_component("[!st]cf", "scf"));
+    CHECK(glob_match_component("x[0-9]", "x5"));
+    CHECK_FALSE(glob_match_component("x[0-9]", "xa"));
+    CHECK(glob_match_component("[]]", "]"));
+    CHECK(glob_match_component("a[b", "a[b"));
+  }
+
+  SECTION("Matching of full paths") {
+    GlobPattern pattern("/solvers/*/tol");
+    CHECK(pattern.matches("/solvers/scf/tol"));
+    CHECK(pattern.matches("solvers/scf/tol/"));
+    CHECK_FALSE(pattern.matches("/solvers/tol"));
+    CHECK_FALSE(pattern.matches("/solvers/scf/diis/tol"));
+
+    GlobPattern recursive("**/basis");
+    CHECK(recursive.matches("/basis"));
+    CHECK(recursive.matches("/atoms/1/basis"));
+    CHECK_FALSE(recursive.matches("/atoms/1/basis/name"));
+
+    GlobPattern middle("/a/**/z");
+    CHECK(middle.matches("/a/z"));
+    CHECK(middle.matches("/a/b/c/z"));
+    CHECK_FALSE(middle.matches("/b/z"));
+
+    GlobPattern root("/");
+    CHECK(root.matches("/"));
+    CHECK_FALSE(root.matches("/a"));
+  }
+
+  SECTION("Too many components") {
+    std::string long_pattern;
+    for (int i = 0; i < 80; ++i) long_pattern += "/a";
+    CHECK_THROWS_AS(GlobPattern(long_pattern), ValueError);
+  }
+}
+
+TEST_CASE("PamMap find", "[glob][pammap]") {
+  PamMap map{
+        {"/solvers/scf/tol", 1e-6},
+        {"/solvers/scf/maxiter", 100},
+        {"/solvers/scf/diis/tol", 1e-3},
+        {"/solvers/cc/tol", 1e-8},
+        {"/solvers-old/scf/tol", 1e-2},
+        {"/atoms/1/basis", std::string("sto-3g")},
+        {"/atoms/2/basis", std::string("cc-pvdz")},
+        {"/atoms/2/charge", 1},
+        {"/basis", std::string("def2-svp")},
+  };
+
+  auto keys_of = [](IteratorRange<PamMapFindIterator<true>> range) {
+    std::vector<std::string> ret;
+    for (const auto& acc : range) ret.push_back(acc.key());
+    return ret;
+  };
+  const PamMap& cmap = map;
+
+  SECTION("Wildcard in the middle") {
+    std::vector<std::string> ref{"/solvers/cc/tol", "/solvers/scf/tol"};
+    CHECK(keys_of(cmap.find("/solvers/*/tol")) == ref);
+  }
+
+  SECTION("Recursive wildcard") {
+    std::vector<std::string> ref{"/atoms/1/basis", "/atoms/2/basis", "/basis"};
+    CHECK(keys_of(cmap.find("**/basis")) == ref);
+
+    std::vector<std::string> tols{"/solvers/cc/tol", "/solvers/scf/diis/tol",
+                                  "/solvers/scf/tol"};
+    CHECK(keys_of(cmap.find("/solvers/**/tol")) == tols);
+  }
+
+  SECTION("Pattern without wildcards") {
+    std::vector<std::string> ref{"/atoms/2/charge"};
+    CHECK(keys_of(cmap.find("atoms/2/charge")) == ref);
+    CHECK(keys_of(cmap.find("/atoms/3/charge")).empty());
+  }
+
+  SECTION("Patterns relative to a submap") {
+    const PamMap sub = cmap.submap("solvers");
+    std::vector<std::string> ref{"/cc/tol", "/scf/tol"};
+    CHECK(keys_of(sub.find("*/tol")) == ref);
+
+    std::vector<std::string> all{"/cc/tol", "/scf/diis/tol", "/scf/maxiter",
+                                 "/scf/tol"};
+    CHECK(keys_of(sub.find("**")) == all);
+  }
+
+  SECTION("Modify values found") {
+    for (auto& acc : map.find("/solvers/*/tol")) acc.value<double>() = 0.5;
+    CHECK(map.at<double>("/solvers/scf/tol") == 0.5);
+    CHECK(map.at<double>("/solvers/cc/tol") == 0.5);
+    CHECK(map.at<double>("/solvers/scf/diis/tol") == 1e-3);
+    CHECK(map.at<double>("/solvers-old/scf/tol") == 1e-2);
+  }
+
+  SECTION("Comparison to a full scan") {
+    for (const std::string pattern :
+         {"*", "**", "/s*/*/tol", "/*/[12]/*", "/atoms/?/b*", "/**/scf/**"}) {
+      GlobPattern compiled(pattern);
+      std::vector<std::string> ref;
+      for (const auto& acc : cmap) {
+        if (compiled.matches(acc.key())) ref.push_back(acc.key());
+      }
+      CHECK(keys_of(cmap.find(pattern)) == ref);
+    }
+  }
+}
+
+}  // namespace pammap
@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "InternedKeyMap.hpp"
+#include <catch2/catch.hpp>
+
+namespace pammap {
+
+TEST_CASE("InternedKeyMap", "[interned]") {
+  InternedKeyMap map;
+  for (const std::string key :
+       {"/ab", "/a/c", "/a", "", "/a-b", "/a/b/x", "/a/b", "/b/a/b"}) {
+    map[key] = Integer(1);
+  }
+
+  SECTION("Components are stored once") {
+    // "a", "b", "c", "x", "a-b", "ab"
+    CHECK(map.table().size() == 6);
+    CHECK(map.size() == 8);
+  }
+
+  SECTION("Key order keeps subtrees contiguous") {
+    std::vector<std::string> ref{"",     "/a",   "/a/b",  "/a/b/x",
+                                 "/a/c", "/a-b", "/ab",   "/b/a/b"};
+    std::vector<std::string> keys;
+    for (const auto& kv : map) keys.push_back(map.key_string(kv.first));
+    CHECK(keys == ref);
+  }
+
+  SECTION("Lookup does not modify the table") {
+    CHECK(map.find("/a/b") != map.end());
+    CHECK(map.find("/a/d") == map.end());
+    CHECK(map.find("/a/b/c/d") == map.end());
+    CHECK(map.erase("/unknown") == 0);
+    CHECK(map.table().size() == 6);
+
+    InternedKey key;
+    CHECK(map.lookup_key("/b/a", key));
+    CHECK(key.size() == 2);
+    CHECK(map.key_string(key) == "/b/a");
+    CHECK(map.key_string(key, 1) == "/a");
+    CHECK_FALSE(map.lookup_key("/b/unknown", key));
+  }
+
+  SECTION("Subtree ranges") {
+    auto count = [&map](const std::string& path) {
+      return std::distance(map.subtree_begin(path), map.subtree_end(path));
+    };
+    CHECK(count("") == 8);
+    CHECK(count("/a") == 4);
+    CHECK(count("/a/b") == 2);
+    CHECK(count("/a-b") == 1);
+    CHECK(count("/b") == 1);
+    CHECK(count("/unknown") == 0);
+    CHECK(count("/c") == 0);
+  }
+
+  SECTION("Copies are independent") {
+    InternedKeyMap copy(map);
+    copy["/new/key"] = Integer(2);
+    CHECK(copy.size() == 9);
+    CHECK(copy.table().size() == 8);
+    CHECK(map.size() == 8);
+    CHECK(map.table().size() == 6);
+    CHECK(map.find("/new/key") == map.end());
+    CHECK(copy.find("/a/b/x") != copy.end());
+  }
+
+  SECTION("Clear resets the table") {
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.table().size() == 0);
+    map["/z"] = Integer(3);
+    CHECK(map.find("/z") != map.end());
+    CHECK(map.table().size() == 1);
+  }
+}
+
+}  // namespace pammap
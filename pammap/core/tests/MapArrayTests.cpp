@@ -0,0 +1,183 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PamMap.hpp"
+#include "map_array.hpp"
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace pammap {
+namespace tests {
+
+namespace {
+/** Write a .npy file (version 1.0) holding the given elements */
+template <typename T>
+void write_npy(const std::string& path, const std::string& descr, bool fortran_order,
+               const std::string& shape, const std::vector<T>& data) {
+  std::string header = "{'descr': '" + descr + "', 'fortran_order': " +
+                       (fortran_order ? "True" : "False") + ", 'shape': " + shape + ", }";
+  // The data starts at a multiple of 64 bytes and the header ends with a newline
+  header.append(63 - (10 + header.size()) % 64, ' ');
+  header += '\n';
+
+  std::ofstream file(path, std::ios::binary);
+  file.write("\x93NUMPY\x01\x00", 8);
+  const char length[2] = {static_cast<char>(header.size() & 0xff),
+                          static_cast<char>(header.size() >> 8)};
+  file.write(length, 2);
+  file.write(header.data(), static_cast<std::streamsize>(header.size()));
+  file.write(reinterpret_cast<const char*>(data.data()),
+             static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+/** Read all bytes of a file */
+std::string read_file(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::ostringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+}  // namespace
+
+TEST_CASE("map_array of raw files", "[map_array]") {
+  // A 3x4 array of doubles behind a header of 16 bytes
+  const std::string path = "MapArrayTest.bin";
+  std::vector<Float> data(12);
+  std::iota(data.begin(), data.end(), 0.0);
+  {
+    std::ofstream file(path, std::ios::binary);
+    const char header[16] = "header";
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size() * sizeof(Float)));
+  }
+
+  SECTION("Read-only mapping") {
+    Array<Float> array = map_array<Float>(path, {3, 4}, 16);
+    CHECK(std::vector<size_t>(array.shape()) == std::vector<size_t>{3, 4});
+    CHECK(array.view().base_kind() == ArrayViewBase::MMAP);
+    CHECK(array.use_count() == 1);
+    CHECK(array(0, 0) == 0.);
+    CHECK(array(2, 1) == 9.);
+
+    // Copies share the mapping
+    const Array<Float> copy = array;
+    CHECK(array.use_count() == 2);
+    CHECK(copy.data() == array.data());
+
+    advise(array.view(), MappedFile::WILLNEED);
+    advise(array.view().slice({Slice(1, 3), Slice(0, 4, 2)}), MappedFile::SEQUENTIAL);
+    CHECK(array(1, 3) == 7.);
+  }
+
+  SECTION("Copy-on-write mapping") {
+    const std::string before = read_file(path);
+    {
+      Array<Float> array = map_array<Float>(path, {3, 4}, 16, MappedFile::COPY_ON_WRITE);
+      array(1, 1) = -1.;
+      CHECK(array(1, 1) == -1.);
+      CHECK(map_array<Float>(path, {3, 4}, 16)(1, 1) == 5.);
+    }
+    CHECK(read_file(path) == before);
+  }
+
+  SECTION("Storage in a PamMap") {
+    const std::string before = read_file(path);
+    {
+      PamMap map{{"mapped", map_array<Float>(path, {12}, 16)}};
+      ArrayView<Float>& view = map.at<ArrayView<Float>>("mapped");
+      CHECK(view.base_kind() == ArrayViewBase::MMAP);
+      CHECK(view[11] == 11.);
+
+      // Writing to read-only mappings only changes the mapped copy
+      view[11] = -11.;
+      fill(view, 2.);
+      CHECK(view[11] == 2.);
+    }
+    CHECK(read_file(path) == before);
+  }
+
+  SECTION("Errors") {
+    CHECK(map_array<Float>(path, {0, 4}).size() == 0);
+    CHECK_THROWS_AS(map_array<Float>(path, {4, 4}, 16), IOError);
+    CHECK_THROWS_AS(map_array<Float>(path, {3}, 4), ValueError);
+    CHECK_THROWS_AS(map_array<Float>("does_not_exist.bin", {1}), IOError);
+    CHECK_THROWS_AS(map_array<Float>(path), ValueError);
+
+    Array<Float> allocated({3, 4});
+    CHECK_THROWS_AS(advise(allocated.view(), MappedFile::NORMAL), ValueError);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("map_array of .npy files", "[map_array]") {
+  const std::string path = "MapArrayTest.npy";
+  std::vector<Integer> data(24);
+  std::iota(data.begin(), data.end(), 0);
+  const std::string descr = detail::npy_descr<Integer>();
+
+  SECTION("C order") {
+    write_npy(path, descr, false, "(2, 3, 4)", data);
+    const Array<Integer> array = map_array<Integer>(path);
+    CHECK(std::vector<size_t>(array.shape()) == std::vector<size_t>{2, 3, 4});
+    CHECK(array.view().base_kind() == ArrayViewBase::MMAP);
+    CHECK(array(1, 2, 3) == 23);
+    CHECK(array(0, 1, 2) == 6);
+  }
+
+  SECTION("Fortran order") {
+    write_npy(path, descr, true, "(2, 3, 4)", data);
+    const Array<Integer> array = map_array<Integer>(path);
+    CHECK(std::vector<ptrdiff_t>(array.view().strides()) ==
+          std::vector<ptrdiff_t>{1, 2, 6});
+    CHECK(array(1, 2, 3) == 23);
+    CHECK(array(0, 1, 2) == 14);
+  }
+
+  SECTION("Vectors and scalars") {
+    write_npy(path, "=" + descr.substr(1), false, "(24,)", data);
+    CHECK(map_array<Integer>(path)(5) == 5);
+
+    write_npy(path, descr, false, "()", std::vector<Integer>{42});
+    const Array<Integer> scalar = map_array<Integer>(path);
+    CHECK(scalar.ndim() == 0);
+    CHECK(scalar[0] == 42);
+  }
+
+  SECTION("Errors") {
+    write_npy(path, descr, false, "(2, 3, 4)", data);
+    CHECK_THROWS_AS(map_array<Float>(path), TypeError);
+    CHECK_THROWS_AS(map_array<int>(path), TypeError);
+
+    write_npy(path, descr, false, "(5, 5)", data);
+    CHECK_THROWS_AS(map_array<Integer>(path), IOError);
+
+    write_npy(path, descr, false, "(2, x)", data);
+    CHECK_THROWS_AS(map_array<Integer>(path), ValueError);
+  }
+
+  std::remove(path.c_str());
+}
+
+}  // namespace tests
+}  // namespace pammap
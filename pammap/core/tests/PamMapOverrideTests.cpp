@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PamMapOverride.hpp"
+#include "exceptions.hpp"
+#include <catch2/catch.hpp>
+#include <thread>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("PamMapOverride", "[pammap]") {
+  PamMap shared{{"solver/tol", 1e-6}, {"solver/maxiter", 100}, {"seed", 0}};
+
+  SECTION("Override layer shadows the shared value") {
+    {
+      PamMapOverride local(shared);
+      local.update("seed", 42);
+      local.update("solver/extra", "yes");
+
+      CHECK(shared.at<Integer>("seed") == 42);
+      CHECK(shared.at<Float>("solver/tol") == 1e-6);
+      CHECK(shared.exists("solver/extra"));
+      CHECK(shared.at<String>("solver/extra") == "yes");
+      CHECK(local.exists("seed"));
+      CHECK_FALSE(local.exists("solver/tol"));
+
+      // Shared container is untouched
+      Integer count = 0;
+      for (auto it = shared.begin(); it != shared.end(); ++it) ++count;
+      CHECK(count == 3);
+    }
+
+    // Original state restored
+    CHECK(shared.at<Integer>("seed") == 0);
+    CHECK_FALSE(shared.exists("solver/extra"));
+    CHECK_THROWS_AS(shared.at<String>("solver/extra"), KeyError);
+  }
+
+  SECTION("Keys are relative to the map passed and visible to submaps") {
+    PamMap solver = shared.submap("solver");
+    PamMapOverride local(solver, {{"tol", 1e-3}});
+
+    CHECK(shared.at<Float>("solver/tol") == 1e-3);
+    CHECK(solver.at<Float>("tol") == 1e-3);
+    CHECK(solver.at<Integer>("maxiter") == 100);
+
+    CHECK(shared.at<Float>("solver/tol", 1.0) == 1e-3);
+
+    local.erase("tol");
+    CHECK(shared.at<Float>("solver/tol") == 1e-6);
+  }
+
+  SECTION("Nested layers and copies") {
+    PamMapOverride outer(shared, {{"seed", 1}, {"solver/maxiter", 5}});
+    {
+      PamMapOverride inner(shared, {{"seed", 2}});
+      CHECK(shared.at<Integer>("seed") == 2);
+      CHECK(shared.at<Integer>("solver/maxiter") == 5);
+    }
+    CHECK(shared.at<Integer>("seed") == 1);
+
+    // Deep copies have their own container and see the shared state
+    PamMap copy(shared);
+    CHECK(copy.at<Integer>("seed") == 0);
+  }
+
+  SECTION("Layers are private to their thread") {
+    std::vector<Integer> seen(4, -1);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < seen.size(); ++t) {
+      workers.emplace_back([&shared, &seen, t] {
+        PamMapOverride local(shared, {{"seed", static_cast<Integer>(t + 10)}});
+        seen[t] = shared.at<Integer>("seed");
+      });
+    }
+    for (auto& worker : workers) worker.join();
+
+    for (size_t t = 0; t < seen.size(); ++t) {
+      CHECK(seen[t] == static_cast<Integer>(t + 10));
+    }
+    CHECK(shared.at<Integer>("seed") == 0);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
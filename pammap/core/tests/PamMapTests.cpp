@@ -25,6 +25,12 @@
 namespace pammap {
 namespace tests {
 
+namespace {
+/** Type with a size_t template argument to test the type names */
+template <size_t N>
+struct RankTag {};
+}  // namespace
+
 TEST_CASE("PamMap", "[pammap]") {
   // Some data:
   Integer i = 5;
@@ -53,6 +59,24 @@ TEST_CASE("PamMap", "[pammap]") {
     //
     CHECK(integer_typename == demangle(typeid(Integer)));
     CHECK(float_typename == demangle(typeid(Float)));
+
+    // Views of dynamic rank are named without it, other types are unchanged
+    CHECK(TypeName<ArrayView<Integer>>::get() == "pammap::ArrayView<" + integer_typename + ">");
+    CHECK(TypeName<ArrayView<const Float>>::get() ==
+          "pammap::ArrayView<" + float_typename + " const>");
+    CHECK(TypeName<ArrayView<Float, 2>>::get() == demangle(typeid(ArrayView<Float, 2>)));
+    CHECK(demangle(typeid(RankTag<DynamicRank>)).find(std::to_string(DynamicRank)) !=
+          std::string::npos);
+
+    PamMap m{{"iarr", iarr}};
+    CHECK(m.type_name_of("iarr") == "pammap::ArrayView<" + integer_typename + ">");
+    try {
+      m.at<ArrayView<Float>>("iarr");
+      FAIL("No TypeError thrown");
+    } catch (const TypeError& e) {
+      CHECK(e.extra.find("'pammap::ArrayView<" + float_typename + ">'") !=
+            std::string::npos);
+    }
   }
 
   //
@@ -93,6 +117,28 @@ TEST_CASE("PamMap", "[pammap]") {
   // ---------------------------------------------------------------
   //
 
+  SECTION("Check array-only dtypes") {
+    std::vector<Float32> f32vec{1.f, 2.f, 3.5f};
+    std::vector<Unsigned8> u8vec{0, 128, 255};
+    ArrayView<Float32> f32arr(f32vec);
+
+    PamMap m{};
+    m.update("f32", f32arr);
+    m.update("u8", ArrayView<Unsigned8>(u8vec));
+    m.update("c64", Array<Complex64>({2}, Complex64(1.f, -1.f)));
+
+    // Stored without a copy and not convertible to the 64-bit types
+    CHECK(m.at<ArrayView<Float32>>("f32").data() == f32vec.data());
+    CHECK(m.at<ArrayView<Unsigned8>>("u8")[2] == 255);
+    CHECK(m.at<ArrayView<Complex64>>("c64")[1] == Complex64(1.f, -1.f));
+    CHECK_THROWS_AS(m.at<ArrayView<Float>>("f32"), TypeError);
+    CHECK_THROWS_AS(m.at<ArrayView<Integer8>>("u8"), TypeError);
+  }
+
+  //
+  // ---------------------------------------------------------------
+  //
+
   SECTION("Check for KeyError") {
     PamMap m{};
     m.update("i", i);
@@ -448,6 +494,59 @@ TEST_CASE("PamMap", "[pammap]") {
   // ---------------------------------------------------------------
   //
 
+  SECTION("Check iterators do not leak into sibling paths") {
+    PamMap m{{"/zz", "mend"}, {"/zz/a", 1}, {"/zz-b", 2}, {"/zzz", "end"}};
+
+    std::vector<String> ref{"/", "/a"};
+    auto itref = std::begin(ref);
+    for (auto& kv : m.submap("zz")) {
+      REQUIRE(itref != std::end(ref));
+      CHECK(*itref == kv.key());
+      ++itref;
+    }
+    CHECK(itref == std::end(ref));
+
+    m.erase_recursive("zz");
+    CHECK_FALSE(m.exists("zz"));
+    CHECK_FALSE(m.exists("zz/a"));
+    CHECK(m.exists("zz-b"));
+    CHECK(m.exists("zzz"));
+  }
+
+  //
+  // ---------------------------------------------------------------
+  //
+
+  SECTION("Check enumeration of children") {
+    PamMap m{{"/", "god"},       {"tree", "root"},        {"tree/sub", s},
+             {"tree/i", i},      {"tree/deep/a", 1},      {"tree/deep/b/c", 2},
+             {"farr", farr},     {"tree-other/x", 3},     {"zz/y/z", 4}};
+
+    using names = std::vector<std::string>;
+    CHECK(m.children() == (names{"farr", "tree", "tree-other", "zz"}));
+    CHECK(m.children("tree") == (names{"deep", "i", "sub"}));
+    CHECK(m.children("/tree/./deep") == (names{"a", "b"}));
+    CHECK(m.children("tree/deep/b") == (names{"c"}));
+    CHECK(m.children("tree/sub").empty());
+    CHECK(m.children("nonexisting").empty());
+
+    // Submaps work relative to their location
+    PamMap sub = m.submap("tree");
+    CHECK(sub.children() == (names{"deep", "i", "sub"}));
+    CHECK(sub.children("deep") == (names{"a", "b"}));
+
+    // Lazy iteration
+    names lazy;
+    for (auto it = m.child_begin("zz"); it != m.child_end("zz"); ++it) {
+      lazy.push_back(*it);
+    }
+    CHECK(lazy == names{"y"});
+  }
+
+  //
+  // ---------------------------------------------------------------
+  //
+
   SECTION("Check accessor interface of the iterator") {
     const Float pi = 3.14159265;
     PamMap map;
@@ -635,8 +734,209 @@ TEST_CASE("PamMap", "[pammap]") {
   // ---------------------------------------------------------------
   //
 
+  SECTION("Check mounting of maps") {
+    PamMap basis{{"cutoff", 1e-8}, {"shells/s", 1}, {"shells/p", 2}};
+    PamMap m{{"tree/value", 9}, {"system/old", 3}};
+
+    m.mount("system/basis", basis);
+    CHECK(m.is_mount("system/basis"));
+    CHECK_FALSE(m.is_mount("system"));
+    CHECK(m.exists("system/old"));
+    CHECK(m.exists("system/basis/cutoff"));
+    CHECK(m.at<Float>("system/basis/cutoff") == 1e-8);
+    CHECK(m.at<Integer>("/system/basis/shells/p") == 2);
+    CHECK_FALSE(m.exists("system/basis/shells/d"));
+    CHECK_THROWS_AS(m.at<Integer>("system/basis/shells/d"), KeyError);
+
+    // Lookups through submaps and relative paths
+    PamMap sub = m.submap("system/basis/shells");
+    CHECK(sub.at<Integer>("s") == 1);
+    CHECK(m.at<Integer>("system/basis/shells/../shells/s") == 1);
+
+    // Modifications go to the mounted map and back
+    m.at<Integer>("system/basis/shells/s") = 5;
+    CHECK(basis.at<Integer>("shells/s") == 5);
+    m.update("system/basis/shells/d", 3);
+    CHECK(basis.at<Integer>("shells/d") == 3);
+    basis.update("cutoff", 1e-10);
+    CHECK(m.at<Float>("system/basis/cutoff") == 1e-10);
+    CHECK(m.erase("system/basis/shells/d") == 1);
+    CHECK_FALSE(basis.exists("shells/d"));
+
+    // Defaults are not inserted if the mounted map has the key
+    m.insert_default("system/basis/cutoff", 1.0);
+    m.insert_default("system/basis/thresh", 2.0);
+    CHECK(basis.at<Float>("cutoff") == 1e-10);
+    CHECK(basis.at<Float>("thresh") == 2.0);
+
+    // Copies of the map share the mount
+    PamMap copy(m);
+    copy.at<Integer>("system/basis/shells/p") = 7;
+    CHECK(basis.at<Integer>("shells/p") == 7);
+
+    // Iteration only visits the mount point
+    std::vector<std::string> keys;
+    for (auto it = m.begin("system"); it != m.end("system"); ++it) {
+      keys.push_back(it->key());
+    }
+    CHECK(keys == std::vector<std::string>{"/basis", "/old"});
+
+    // Mounting over a path replaces it
+    PamMap other{{"cutoff", 3.0}};
+    m.mount("tree", other);
+    CHECK_FALSE(m.exists("tree/value"));
+    CHECK(m.at<Float>("tree/cutoff") == 3.0);
+
+    // Mounts inside mounted maps
+    m.mount("system/basis/extra", other);
+    CHECK(basis.is_mount("extra"));
+    CHECK(m.at<Float>("system/basis/extra/cutoff") == 3.0);
+
+    m.unmount("system/basis");
+    CHECK_FALSE(m.exists("system/basis/cutoff"));
+    CHECK(basis.exists("cutoff"));
+    CHECK_THROWS_AS(m.unmount("system/old"), KeyError);
+    CHECK_THROWS_AS(m.mount("/", other), ValueError);
+    CHECK_THROWS_AS(m.mount("self", m), ValueError);
+
+    // Cycles through other maps are rejected as well
+    PamMap a{{"x", 1}};
+    PamMap b{{"y", 2}};
+    PamMap c;
+    a.mount("b", b);
+    b.mount("deeper/c", c);
+    CHECK_THROWS_AS(b.mount("a", a), ValueError);
+    CHECK_THROWS_AS(c.mount("a", a), ValueError);
+    CHECK_THROWS_AS(a.mount("b/a", a), ValueError);
+    CHECK_FALSE(b.exists("a"));
+    c.mount("other", other);
+    CHECK(a.at<Float>("b/deeper/c/other/cutoff") == 3.0);
+
+    // Once unmounted or replaced, the mount no longer counts as a cycle
+    b.unmount("deeper/c");
+    c.mount("a", a);
+    CHECK(c.at<Integer>("a/x") == 1);
+    PamMap d;
+    d.update("a", a);
+    CHECK(d.is_mount("a/b"));
+    CHECK(d.at<Integer>("a/b/y") == 2);
+    CHECK_THROWS_AS(b.update("a", a), ValueError);
+    c.update("a", Integer{5});
+    CHECK_FALSE(c.is_mount("a"));
+    b.mount("deeper/c", c);
+    CHECK(a.at<Integer>("b/deeper/c/a") == 5);
+
+    // A map mounted at several places is searched below each of them
+    PamMap y{{"a/val", 1}, {"b/val", 2}};
+    PamMap z;
+    PamMap e;
+    y.mount("b/m", e);
+    z.mount("1", y.submap("a"));
+    z.mount("2", y.submap("b"));
+    CHECK_THROWS_AS(e.mount("x", z), ValueError);
+    CHECK_FALSE(e.exists("x/2/val"));
+  }
+
+  //
+  // ---------------------------------------------------------------
+  //
+
   // TODO Test mass update from initialiser list
 
 }  // TEST_CASE
+
+TEST_CASE("PamMap gather and scatter", "[pammap]") {
+  PamMap map{{"model/weights/a", 1.5},        {"model/weights/b", -2.},
+             {"model/weights/c", 4.},         {"model/weights/D", 8.},
+             {"model/weights/n", Integer(3)}, {"model/bias", 0.5}};
+
+  SECTION("Gather values matching a pattern") {
+    Gathered<Float> weights = map.gather<Float>("model/weights/[a-z]*");
+    CHECK(weights.index.size() == 3);
+    CHECK(weights.index.keys() ==
+          std::vector<std::string>{"/model/weights/a", "/model/weights/b",
+                                   "/model/weights/c"});
+    CHECK(std::vector<size_t>(weights.values.shape()) == std::vector<size_t>{3});
+    CHECK(weights.values[0] == 1.5);
+    CHECK(weights.values[1] == -2.);
+    CHECK(weights.values[2] == 4.);
+
+    Gathered<Integer> integers = map.gather<Integer>("model/weights/*");
+    CHECK(integers.index.keys() == std::vector<std::string>{"/model/weights/n"});
+    CHECK(integers.values[0] == 3);
+
+    CHECK(map.gather<Float>("model/other/*").index.size() == 0);
+  }
+
+  SECTION("Scatter values back") {
+    Gathered<Float> weights = map.gather<Float>("model/weights/[a-z]*");
+    for (size_t i = 0; i < weights.values.size(); ++i) weights.values[i] *= 2;
+    map.scatter(weights.index, weights.values.view());
+    CHECK(map.at<Float>("model/weights/a") == 3.);
+    CHECK(map.at<Float>("model/weights/b") == -4.);
+    CHECK(map.at<Float>("model/weights/c") == 8.);
+    CHECK(map.at<Float>("model/weights/D") == 8.);
+
+    // Modifying values in place keeps the index valid
+    map.at<Float>("model/weights/b") = 1.;
+    Array<Float> strided({3, 2});
+    map.gather(weights.index, strided.view().slice({Slice(0, 3), Slice::index(1)}));
+    CHECK(strided(0, 1) == 3.);
+    CHECK(strided(1, 1) == 1.);
+    CHECK(strided(2, 1) == 8.);
+  }
+
+  SECTION("Invalid indices") {
+    Gathered<Float> weights = map.gather<Float>("model/weights/[a-z]*");
+    Array<Float> wrong({2});
+    CHECK_THROWS_AS(map.scatter(weights.index, wrong.view()), ValueError);
+    Array<Float> matrix({3, 1});
+    CHECK_THROWS_AS(map.gather(weights.index, matrix.view()), ValueError);
+
+    PamMap copy(map);
+    CHECK_THROWS_AS(copy.scatter(weights.index, weights.values.view()),
+                    InvalidStateError);
+
+    map.update("model/bias", 1.);
+    CHECK_THROWS_AS(map.scatter(weights.index, weights.values.view()),
+                    InvalidStateError);
+
+    weights = map.gather<Float>("model/weights/[a-z]*");
+    map.erase("model/weights/a");
+    CHECK_THROWS_AS(map.gather(weights.index, weights.values.view()),
+                    InvalidStateError);
+
+    weights = map.gather<Float>("model/weights/[a-z]*");
+    map.erase("model/weights/x");  // No such entry, the index stays valid
+    CHECK_NOTHROW(map.scatter(weights.index, weights.values.view()));
+  }
+
+  SECTION("Raw values invalidate indices") {
+    // Gathering and modifying values through accessors keeps the index valid
+    Gathered<Float> weights = map.gather<Float>("model/weights/[a-z]*");
+    map.gather<Integer>("model/weights/*");
+    for (auto& entry : map.find("model/weights/a")) entry.value<Float>() = 2.;
+    CHECK_NOTHROW(map.scatter(weights.index, weights.values.view()));
+
+    // Raw values may be replaced
+    for (auto& entry : map.find("model/weights/a")) entry.value_raw() = Integer(1);
+    CHECK_THROWS_AS(map.scatter(weights.index, weights.values.view()),
+                    InvalidStateError);
+
+    weights = map.gather<Float>("model/weights/[a-z]*");
+    map.at_raw_value("model/weights/b") = std::string("replaced");
+    CHECK_THROWS_AS(map.scatter(weights.index, weights.values.view()),
+                    InvalidStateError);
+
+    // Also when replaced through a map, into which this one is mounted
+    PamMap outer;
+    outer.mount("inner", map);
+    weights = map.gather<Float>("model/weights/[a-z]*");
+    outer.at_raw_value("inner/model/weights/c") = Integer(2);
+    CHECK_THROWS_AS(map.gather(weights.index, weights.values.view()),
+                    InvalidStateError);
+  }
+}
+
 }  // namespace tests
 }  // namespace pammap
@@ -0,0 +1,189 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "parallel.hpp"
+#include "typedefs.hxx"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <stdexcept>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("ThreadPool", "[parallel]") {
+  ThreadPool pool(4);
+  REQUIRE(pool.size() == 4);
+
+  SECTION("Each worker runs its task once") {
+    std::vector<int> count(pool.size(), 0);
+    pool.run([&count](size_t i) { count[i] += 1; });
+    pool.run([&count](size_t i) { count[i] += 10; });
+    CHECK(count == std::vector<int>(4, 11));
+  }
+
+  SECTION("Nested runs are sequential") {
+    std::atomic<int> total{0};
+    pool.run([&](size_t) { pool.run([&](size_t) { total += 1; }); });
+    CHECK(total == 16);
+  }
+
+  SECTION("Exceptions are passed on") {
+    CHECK_THROWS_AS(pool.run([](size_t i) {
+      if (i == 2) throw std::runtime_error("Test");
+    }),
+                    std::runtime_error);
+    CHECK_THROWS_AS(pool.run([](size_t i) {
+      if (i == 0) throw std::out_of_range("Test");
+    }),
+                    std::out_of_range);
+
+    // The pool is still usable
+    std::atomic<int> total{0};
+    pool.run([&total](size_t) { total += 1; });
+    CHECK(total == 4);
+  }
+
+  SECTION("Single worker") {
+    ThreadPool serial(1);
+    size_t called = 42;
+    serial.run([&called](size_t i) { called = i; });
+    CHECK(called == 0);
+  }
+}
+
+TEST_CASE("Parallel operations", "[parallel]") {
+  // Large enough to be split into chunks
+  const size_t n = 4 * parallel_min_size + 13;
+  std::vector<double> data(2 * n);
+  std::iota(data.begin(), data.end(), 0.0);
+  std::vector<double> out(2 * n, -1.0);
+
+  ArrayView<double> contiguous(data.data(), {n}, {1});
+  ArrayView<double> strided(data.data(), {n}, {2});
+  ArrayView<double> out_view(out.data(), {n}, {1});
+
+  SECTION("fill") {
+    fill(out_view, 3);
+    CHECK(std::count(out.begin(), out.begin() + static_cast<ptrdiff_t>(n), 3.0) ==
+          static_cast<ptrdiff_t>(n));
+    CHECK(out[n] == -1);
+  }
+
+  SECTION("copy") {
+    copy(out_view, strided);
+    bool agrees = true;
+    for (size_t i = 0; i < n; ++i) agrees = agrees && out[i] == data[2 * i];
+    CHECK(agrees);
+
+    // Into a strided destination with conversion
+    std::vector<Integer> integers(2 * n, 0);
+    ArrayView<Integer> int_view(integers.data() + 2 * n - 1, {n}, {-2});
+    copy(int_view, contiguous);
+    CHECK(integers[2 * n - 1] == 0);
+    CHECK(integers[1] == static_cast<Integer>(n - 1));
+    CHECK(integers[0] == 0);
+  }
+
+  SECTION("transform") {
+    transform(out_view, [](double a, double b) { return a * b; }, contiguous, strided);
+    bool agrees = true;
+    for (size_t i = 0; i < n; ++i) agrees = agrees && out[i] == data[i] * data[2 * i];
+    CHECK(agrees);
+
+    std::vector<double> small(3);
+    CHECK_THROWS_AS(transform(ArrayView<double>(small), [](double a) { return a; },
+                              contiguous),
+                    ValueError);
+  }
+
+  SECTION("for_each on multi-dimensional views") {
+    // A transposed view of a 3D C-contiguous array and a sliced view
+    const size_t a = 40, b = 30, c = 50;
+    std::vector<double> cube(a * b * c);
+    std::iota(cube.begin(), cube.end(), 0.0);
+    ArrayView<double> cc(cube.data(), {a, b, c}, {ptrdiff_t(b * c), ptrdiff_t(c), 1});
+    ArrayView<double> tr(cube.data(), {c, b, a}, {1, ptrdiff_t(c), ptrdiff_t(b * c)});
+
+    std::vector<double> result(a * b * c, 0);
+    ArrayView<double> res(result.data(), {c, b, a}, {ptrdiff_t(a * b), ptrdiff_t(a), 1});
+    for_each([](double& r, const double& t) { r = 2 * t; }, res, tr);
+
+    bool agrees = true;
+    for (size_t i = 0; i < a; ++i) {
+      for (size_t j = 0; j < b; ++j) {
+        for (size_t k = 0; k < c; ++k) {
+          agrees = agrees && res(k, j, i) == 2 * cc(i, j, k);
+        }
+      }
+    }
+    CHECK(agrees);
+
+    std::atomic<size_t> count{0};
+    ArrayView<double> sl = cc.slice({{1, Auto, 3}, All, {Auto, Auto, -1}});
+    for_each([&count](double& x) {
+      x = -1;
+      ++count;
+    },
+             sl);
+    CHECK(count == sl.size());
+    const auto n_set = std::count(cube.begin(), cube.end(), -1.0);
+    CHECK(static_cast<size_t>(n_set) == sl.size());
+    CHECK(cc(1, 0, 0) == -1);
+    CHECK(cc(2, 0, 0) == 2 * b * c);
+  }
+
+  SECTION("transform with broadcast views") {
+    // Evaluate a function of a parameter and a grid point on all pairs
+    // without expanding parameters or grid into temporaries
+    const size_t n_params = 300, n_grid = 500;
+    std::vector<double> grid_values(out.begin(), out.begin() + n_params * n_grid);
+    ArrayView<double> grid_view(grid_values.data(), {n_params, n_grid},
+                                {ptrdiff_t(n_grid), 1});
+    ArrayView<double> params = contiguous.slice({{0, n_params}, NewAxis});
+    ArrayView<double> points = strided.slice({{0, n_grid}});
+    transform(grid_view, [](double p, double x) { return p + x; },
+              params.broadcast_to(grid_view.shape()),
+              points.broadcast_to(grid_view.shape()));
+
+    bool agrees = true;
+    for (size_t i = 0; i < n_params; ++i) {
+      for (size_t j = 0; j < n_grid; ++j) {
+        agrees = agrees && grid_view(i, j) == data[i] + data[2 * j];
+      }
+    }
+    CHECK(agrees);
+  }
+
+  SECTION("Chunk boundaries and small views") {
+    // Every element visited exactly once
+    std::vector<int> visits(n, 0);
+    ArrayView<int> vview(visits.data(), {n}, {1});
+    for_each([](int& v) { v += 1; }, vview);
+    CHECK(std::count(visits.begin(), visits.end(), 1) == static_cast<ptrdiff_t>(n));
+
+    std::vector<double> tiny{1, 2, 3};
+    ArrayView<double> tiny_view(tiny);
+    fill(tiny_view, 0.5);
+    CHECK(tiny == std::vector<double>(3, 0.5));
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
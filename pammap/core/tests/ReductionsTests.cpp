@@ -0,0 +1,193 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "reductions.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("Reductions", "[array]") {
+  const std::string default_isa = reduction_isa();
+  const std::vector<std::string> isas = available_reduction_isas();
+  REQUIRE(isas.front() == default_isa);
+  REQUIRE(isas.back() == "baseline");
+  CHECK_THROWS_AS(set_reduction_isa("mmx"), ValueError);
+
+  // Sizes chosen to exercise the unrolled loops, their remainders
+  // and the blocking of strided views.
+  for (const std::string& isa : isas) {
+    set_reduction_isa(isa);
+    CHECK(reduction_isa() == isa);
+
+    for (size_t n : std::vector<size_t>{1, 7, 33, 100, 1031, 5000}) {
+      INFO("isa = " << isa << ", n = " << n);
+      std::vector<Float> floats(2 * n);
+      std::vector<Integer> integers(2 * n);
+      for (size_t i = 0; i < 2 * n; ++i) {
+        floats[i]   = std::sin(static_cast<Float>(i));
+        integers[i] = static_cast<Integer>((i * 7919) % 1009) - 500;
+      }
+      ArrayView<Float> fview(floats);
+      ArrayView<Integer> iview(integers);
+      ArrayView<Float> fstrided  = fview.slice({{Auto, Auto, 2}});
+      ArrayView<Integer> istride = iview.slice({{Auto, Auto, -2}});
+
+      // Reference results by naive loops
+      Float fsum = 0, fsum_strided = 0, fsq = 0;
+      Integer isum = 0, isum_strided = 0;
+      for (size_t i = 0; i < 2 * n; ++i) {
+        fsum += floats[i];
+        fsq += floats[i] * floats[i];
+        isum += integers[i];
+      }
+      for (size_t i = 0; i < n; ++i) {
+        fsum_strided += fstrided[i];
+        isum_strided += istride[i];
+      }
+
+      CHECK(sum(fview) == Approx(fsum).margin(1e-12));
+      CHECK(sum(fstrided) == Approx(fsum_strided).margin(1e-12));
+      CHECK(sum(iview) == isum);
+      CHECK(sum(istride) == isum_strided);
+      CHECK(norm2(fview) == Approx(std::sqrt(fsq)));
+      CHECK(dot(fview, fview) == Approx(fsq));
+
+      const auto fmax = std::max_element(fstrided.begin(), fstrided.end());
+      const auto imin = std::min_element(iview.begin(), iview.end());
+      const auto imax = std::max_element(istride.begin(), istride.end());
+      CHECK(max(fstrided) == *fmax);
+      CHECK(min(iview) == *imin);
+      CHECK(max(istride) == *imax);
+      CHECK(min(fview) == *std::min_element(floats.begin(), floats.end()));
+      CHECK(argmax(fstrided) ==
+            static_cast<size_t>(std::distance(fstrided.begin(), fmax)));
+      CHECK(argmax(istride) == static_cast<size_t>(std::distance(istride.begin(), imax)));
+      CHECK(argmax(iview) == static_cast<size_t>(std::distance(
+                                   integers.begin(),
+                                   std::max_element(integers.begin(), integers.end()))));
+
+      // Dot products pair the elements by multi-index
+      ArrayView<Integer> iforward = iview.slice({{1, Auto, 2}});
+      Integer idot               = 0;
+      for (size_t i = 0; i < n; ++i) idot += istride[i] * iforward[i];
+      CHECK(dot(istride, iforward) == idot);
+    }
+  }
+  set_reduction_isa(default_isa);
+
+  SECTION("Empty views") {
+    std::vector<Float> floats;
+    std::vector<Integer> integers;
+    ArrayView<Float> fview(floats);
+    ArrayView<Integer> iview(integers);
+    CHECK(sum(fview) == 0);
+    CHECK(sum(iview) == 0);
+    CHECK(dot(fview, fview) == 0);
+    CHECK_THROWS_AS(max(fview), ValueError);
+    CHECK_THROWS_AS(min(iview), ValueError);
+    CHECK_THROWS_AS(argmax(iview), ValueError);
+  }
+
+  SECTION("Multi-dimensional views") {
+    std::vector<Float> data(6 * 50);
+    std::iota(data.begin(), data.end(), 1.0);
+    ArrayView<Float> cc(data.data(), {6, 50}, {50, 1});
+    ArrayView<Float> transposed(data.data(), {50, 6}, {1, 50});
+    CHECK(sum(cc) == 300. * 301. / 2.);
+    CHECK(sum(transposed) == sum(cc));
+    CHECK(argmax(transposed) == 299);
+    CHECK(max(cc.slice({{1, 3}, {Auto, Auto, -7}})) == 150);
+
+    // transposed(i, j) == cc(j, i)
+    ArrayView<Float> cc_t = cc.slice({All, All});
+    Float ref             = 0;
+    for (size_t i = 0; i < 6; ++i) {
+      for (size_t j = 0; j < 50; ++j) ref += cc(i, j) * cc_t(i, j);
+    }
+    CHECK(dot(cc, cc_t) == Approx(ref));
+    CHECK_THROWS_AS(dot(cc, transposed), ValueError);
+  }
+
+  SECTION("NaN entries and ties") {
+    const Float nan = std::numeric_limits<Float>::quiet_NaN();
+    std::vector<Float> data{nan, 1, 3, nan, 3, -2};
+    ArrayView<Float> view(data);
+    CHECK(max(view) == 3);
+    CHECK(min(view) == -2);
+    CHECK(argmax(view) == 2);
+
+    std::vector<Integer> ties(100, 4);
+    ties[37] = 5;
+    ties[80] = 5;
+    CHECK(argmax(ArrayView<Integer>(ties)) == 37);
+  }
+
+  SECTION("Complex") {
+    std::vector<Complex> data;
+    for (size_t i = 0; i < 301; ++i) {
+      data.push_back({static_cast<Float>(i), -0.5 * static_cast<Float>(i)});
+    }
+    ArrayView<Complex> view(data);
+    CHECK(sum(view) == Complex(300. * 301. / 2., -300. * 301. / 4.));
+    ArrayView<Complex> reversed = view.slice({{Auto, Auto, -3}});
+    Complex ref_sum             = 0;
+    Float ref_sq                = 0;
+    for (size_t i = 0; i < reversed.size(); ++i) {
+      ref_sum += reversed[i];
+      ref_sq += std::norm(reversed[i]);
+    }
+    CHECK(sum(reversed) == ref_sum);
+    CHECK(norm2(reversed) == Approx(std::sqrt(ref_sq)));
+
+    // Broadcast axis of zero stride in front of the pairs
+    ArrayView<Complex> repeated(data.data() + 3, {5}, {0});
+    CHECK(sum(repeated) == 5. * data[3]);
+  }
+
+  SECTION("Bool") {
+    std::vector<char> storage(1000, 1);
+    Bool* bools = reinterpret_cast<Bool*>(storage.data());
+    ArrayView<Bool> view(bools, {1000}, {1});
+    ArrayView<Bool> strided(bools, {100, 5}, {10, 1});
+    CHECK(all_of(view));
+    CHECK(any_of(view));
+
+    storage[999] = 0;
+    CHECK_FALSE(all_of(view));
+    CHECK(all_of(strided));
+    storage[5] = 0;
+    CHECK(all_of(strided));
+    storage[4] = 0;
+    CHECK_FALSE(all_of(strided));
+
+    std::fill(storage.begin(), storage.end(), 0);
+    CHECK_FALSE(any_of(view));
+    storage[996] = 1;
+    CHECK(any_of(view));
+    CHECK_FALSE(any_of(strided));
+    CHECK(all_of(ArrayView<Bool>(bools, {0}, {1})));
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -110,6 +110,18 @@ TEST_CASE("Slice", "[slice]") {
     }
   }
 
+  SECTION("Index and new axis slices") {
+    Slice idx = Slice::index(3);
+    CHECK(idx.kind == Slice::INDEX);
+    CHECK(idx.begin == 3);
+    CHECK(to_string(idx) == "3");
+
+    CHECK(NewAxis.kind == Slice::NEWAXIS);
+    CHECK(to_string(NewAxis) == "NewAxis");
+    CHECK(All.kind == Slice::RANGE);
+    CHECK(Slice(3).kind == Slice::RANGE);
+  }
+
 #ifndef NDEBUG
   SECTION("Empty ranges throw errors") {
     using Catch::Matchers::Contains;
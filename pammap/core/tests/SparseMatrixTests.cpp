@@ -0,0 +1,155 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PamMap.hpp"
+#include "SparseMatrixView.hpp"
+#include <catch2/catch.hpp>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("SparseMatrixView", "[SparseMatrixView]") {
+  // The matrix
+  //   [ 1  0  2 ]
+  //   [ 0  0  0 ]
+  //   [ 0  3  0 ]
+  //   [ 4  0  5 ]
+  std::vector<Integer32> indptr{0, 2, 2, 3, 5};
+  std::vector<Integer32> indices{0, 2, 1, 0, 2};
+  std::vector<Float> data{1, 2, 3, 4, 5};
+  std::vector<Integer32> rows{0, 0, 2, 3, 3};
+
+  SECTION("CSR construction and access") {
+    CsrMatrixView<Float, Integer32> csr(4, 3, indptr, indices, data);
+    CHECK(csr.n_rows() == 4);
+    CHECK(csr.n_cols() == 3);
+    CHECK(csr.nnz() == 5);
+    CHECK(csr(0, 2) == 2);
+    CHECK(csr(2, 1) == 3);
+    CHECK(csr(1, 1) == 0);
+    CHECK(csr(3, 1) == 0);
+    CHECK_THROWS_AS(csr(4, 0), IndexError);
+    CHECK_NOTHROW(csr.validate());
+
+    // The view does not copy the data
+    CHECK(csr.data().data() == data.data());
+    csr.data()[1] = 7;
+    CHECK(data[1] == 7);
+
+    std::vector<Integer32> short_ptr{0, 2, 5};
+    CHECK_THROWS_AS((CsrMatrixView<Float, Integer32>(4, 3, short_ptr, indices, data)),
+                    ValueError);
+    std::vector<Integer32> bad_ptr{0, 2, 2, 3, 4};
+    CHECK_THROWS_AS((CsrMatrixView<Float, Integer32>(4, 3, bad_ptr, indices, data)),
+                    ValueError);
+    CsrMatrixView<Float, Integer32> narrow(4, 2, indptr, indices, data);
+    CHECK_THROWS_AS(narrow.validate(), ValueError);
+  }
+
+  SECTION("COO construction") {
+    CooMatrixView<Float, Integer32> coo(4, 3, rows, indices, data);
+    CHECK(coo.nnz() == 5);
+    CHECK_NOTHROW(coo.validate());
+    CooMatrixView<Float, Integer32> flat(3, 3, rows, indices, data);
+    CHECK_THROWS_AS(flat.validate(), ValueError);
+
+    std::vector<Float> few{1, 2};
+    CHECK_THROWS_AS((CooMatrixView<Float, Integer32>(4, 3, rows, indices, few)),
+                    ValueError);
+  }
+
+  SECTION("Products with vectors and matrices") {
+    CsrMatrixView<Float, Integer32> csr(4, 3, indptr, indices, data);
+    CooMatrixView<Float, Integer32> coo(4, 3, rows, indices, data);
+
+    std::vector<Float> x{1, 2, 3};
+    std::vector<Float> expected{7, 0, 6, 19};
+    std::vector<Float> y(4, -1);
+    multiply(csr, ArrayView<Float>(x), ArrayView<Float>(y));
+    CHECK(y == expected);
+    std::fill(y.begin(), y.end(), -1);
+    multiply(coo, ArrayView<Float>(x), ArrayView<Float>(y));
+    CHECK(y == expected);
+
+    // y = 2 * A * x + 1 * y
+    multiply(csr, ArrayView<Float>(x), ArrayView<Float>(y), 2.0, 1.0);
+    CHECK(y == std::vector<Float>{21, 0, 18, 57});
+
+    // Matrix of two columns, where the first column of X is x, the second
+    // is 1 and Y is stored in Fortran order
+    std::vector<Float> X{1, 1, 2, 1, 3, 1};
+    std::vector<Float> Y(8, -1);
+    ArrayView<Float> Xv(X.data(), {3, 2}, {2, 1});
+    ArrayView<Float> Yv(Y.data(), {4, 2}, {1, 4});
+    multiply(csr, Xv, Yv);
+    CHECK(Y == std::vector<Float>{7, 0, 6, 19, 3, 0, 3, 9});
+    std::fill(Y.begin(), Y.end(), -1);
+    multiply(coo, Xv, Yv);
+    CHECK(Y == std::vector<Float>{7, 0, 6, 19, 3, 0, 3, 9});
+
+    std::vector<Float> wrong(3);
+    CHECK_THROWS_AS(multiply(csr, ArrayView<Float>(x), ArrayView<Float>(wrong)),
+                    ValueError);
+    CHECK_THROWS_AS(multiply(csr, ArrayView<Float>(x), Yv), ValueError);
+  }
+
+  SECTION("Parallel product agrees with serial product") {
+    // Banded matrix with more rows than parallel_min_size
+    const size_t n = 50000;
+    std::vector<Integer> ptr{0}, idx;
+    std::vector<Complex> val;
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = i < 2 ? 0 : i - 2; j < std::min(n, i + 3); ++j) {
+        idx.push_back(static_cast<Integer>(j));
+        val.push_back(Complex(static_cast<Float>(j % 7), static_cast<Float>(i % 3)));
+      }
+      ptr.push_back(static_cast<Integer>(idx.size()));
+    }
+    CsrMatrixView<Complex, Integer> csr(n, n, ptr, idx, val);
+
+    std::vector<Complex> x(n), y(n), reference(n);
+    for (size_t i = 0; i < n; ++i) x[i] = Complex(static_cast<Float>(i % 11), 1.0);
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t p = static_cast<size_t>(ptr[i]); p < static_cast<size_t>(ptr[i + 1]);
+           ++p) {
+        reference[i] += val[p] * x[static_cast<size_t>(idx[p])];
+      }
+    }
+
+    multiply(csr, ArrayView<Complex>(x), ArrayView<Complex>(y));
+    bool agrees = true;
+    for (size_t i = 0; i < n; ++i) agrees = agrees && y[i] == reference[i];
+    CHECK(agrees);
+  }
+
+  SECTION("Storage in PamMap") {
+    PamMap map;
+    map.update("csr", CsrMatrixView<Float, Integer32>(4, 3, indptr, indices, data));
+    map.update("coo", CooMatrixView<Float, Integer32>(4, 3, rows, indices, data));
+
+    auto& csr = map.at<CsrMatrixView<Float, Integer32>>("csr");
+    CHECK(csr.nnz() == 5);
+    CHECK(csr.indptr().data() == indptr.data());
+    CHECK(map.at<CooMatrixView<Float, Integer32>>("coo").row().data() == rows.data());
+    CHECK_THROWS_AS((map.at<CsrMatrixView<Float, Integer>>("csr")), TypeError);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -0,0 +1,123 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SplitComplexView.hpp"
+#include "reductions.hpp"
+#include <catch2/catch.hpp>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("SplitComplexView", "[SplitComplexView]") {
+  const size_t n = 1001;
+  std::vector<Complex> a(n), b(n);
+  for (size_t i = 0; i < n; ++i) {
+    const Float x = static_cast<Float>(i);
+    a[i]          = Complex(x / 7, 1 - x / 13);
+    b[i]          = Complex(2 - x / 11, x / 5);
+  }
+  Complex ref_dot = 0;
+  Float ref_abs2  = 0;
+  for (size_t i = 0; i < n; ++i) {
+    ref_dot += a[i] * b[i];
+    ref_abs2 += std::norm(a[i]);
+  }
+
+  std::vector<Float> a_re(n), a_im(n), b_re(n), b_im(n);
+  SplitComplexView sa(a_re, a_im);
+  SplitComplexView sb(b_re, b_im);
+  sa.copy_from(ArrayView<Complex>(a));
+  sb.copy_from(ArrayView<Complex>(b));
+
+  SECTION("Layout conversion") {
+    CHECK(sa.size() == n);
+    CHECK(sa.is_contiguous());
+    CHECK(a_re[5] == a[5].real());
+    CHECK(a_im[5] == a[5].imag());
+    CHECK(sa(7) == a[7]);
+    sa.set(Complex(3, 4), 7);
+    CHECK(a_re[7] == 3);
+    CHECK(a_im[7] == 4);
+
+    std::vector<Complex> back(n);
+    sb.copy_to(ArrayView<Complex>(back));
+    CHECK(back == b);
+
+    // Viewing the interleaved data needs no copy
+    SplitComplexView view = SplitComplexView::of(ArrayView<Complex>(a));
+    CHECK_FALSE(view.is_contiguous());
+    CHECK(view(3) == a[3]);
+    view.set(Complex(-1, 2), 3);
+    CHECK(a[3] == Complex(-1, 2));
+
+    std::vector<Float> short_im(n - 1);
+    CHECK_THROWS_AS(SplitComplexView(a_re, short_im), ValueError);
+    CHECK_THROWS_AS(sa.copy_to(ArrayView<Complex>(back.data(), {n - 1}, {1})),
+                    ValueError);
+  }
+
+  SECTION("Multi-dimensional views") {
+    // 3x2 parts in C and Fortran order
+    std::vector<Float> re{1, 2, 3, 4, 5, 6}, im{6, 5, 4, 3, 2, 1};
+    SplitComplexView c_order(ArrayView<Float>(re.data(), {3, 2}, {2, 1}),
+                             ArrayView<Float>(im.data(), {3, 2}, {2, 1}));
+    CHECK(c_order(2, 1) == Complex(6, 1));
+
+    std::vector<Complex> interleaved(6);
+    ArrayView<Complex> fortran(interleaved.data(), {3, 2}, {1, 3});
+    c_order.copy_to(fortran);
+    CHECK(fortran(2, 1) == Complex(6, 1));
+    CHECK(interleaved[1] == Complex(3, 4));
+    CHECK(dot(c_order, SplitComplexView::of(fortran)) == dot(c_order, c_order));
+  }
+
+  SECTION("Kernels") {
+    for (const std::string& isa : available_reduction_isas()) {
+      set_reduction_isa(isa);
+      INFO("isa = " << isa);
+      CHECK(std::abs(dot(sa, sb) - ref_dot) < 1e-10 * std::abs(ref_dot));
+      CHECK(sum_abs2(sa) == Approx(ref_abs2));
+
+      // Strided views give the same result
+      SplitComplexView strided_a = SplitComplexView::of(ArrayView<Complex>(a));
+      CHECK(std::abs(dot(strided_a, sb) - ref_dot) < 1e-10 * std::abs(ref_dot));
+      CHECK(sum_abs2(strided_a) == Approx(ref_abs2));
+
+      std::vector<Float> y_re(b_re), y_im(b_im);
+      std::vector<Complex> y(b);
+      const Complex alpha(0.5, -2);
+      axpy(alpha, sa, SplitComplexView(y_re, y_im));
+      axpy(alpha, strided_a, SplitComplexView::of(ArrayView<Complex>(y)));
+      bool agrees = true;
+      for (size_t i = 0; i < n; ++i) {
+        const Complex ref = b[i] + alpha * a[i];
+        agrees = agrees && std::abs(Complex(y_re[i], y_im[i]) - ref) < 1e-12 &&
+                 std::abs(y[i] - ref) < 1e-12;
+      }
+      CHECK(agrees);
+    }
+    set_reduction_isa(available_reduction_isas().front());
+
+    std::vector<Float> short_re(5), short_im(5);
+    CHECK_THROWS_AS(dot(sa, SplitComplexView(short_re, short_im)), ValueError);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
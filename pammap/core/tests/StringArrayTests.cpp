@@ -0,0 +1,153 @@
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PamMap.hpp"
+#include "StringArray.hpp"
+#include "typedefs.hxx"
+#include <catch2/catch.hpp>
+
+namespace pammap {
+namespace tests {
+
+TEST_CASE("StringArray", "[StringArray]") {
+  const std::vector<std::string> labels{"C", "H", "", "Na", "1s", "2p_x"};
+
+  SECTION("Construction and access") {
+    StringArray arr(labels);
+    REQUIRE(arr.size() == 6);
+    CHECK(arr.view().total_chars() == 10);
+    CHECK(arr.view().max_length() == 4);
+    CHECK(arr.view().offsets()[0] == 0);
+    CHECK(arr.view().offsets()[6] == 10);
+
+    bool agrees = true;
+    for (size_t i = 0; i < labels.size(); ++i) {
+      agrees = agrees && std::string(arr[i]) == labels[i];
+    }
+    CHECK(agrees);
+    CHECK(arr[2].empty());
+
+    std::vector<std::string> iterated;
+    for (string_view s : arr.view()) iterated.push_back(std::string(s));
+    CHECK(iterated == labels);
+
+    // Construction from an ArrayView<String> gives the same result
+    std::vector<String> data(labels);
+    StringArray from_view(ArrayView<String>(data.data(), {data.size()}, {1}));
+    CHECK(from_view.view() == arr.view());
+    CHECK(StringArray().view().empty());
+  }
+
+  SECTION("Slices and copies") {
+    StringArray arr(labels);
+    StringArrayView slice = arr.view().slice(3, 5);
+    REQUIRE(slice.size() == 2);
+    CHECK(slice[0] == "Na");
+    CHECK(slice[1] == "1s");
+    CHECK(slice.total_chars() == 4);
+    CHECK(slice.chars() == arr.view().chars());
+    CHECK_THROWS_AS(arr.view().slice(4, 7), IndexError);
+
+    StringArray copy(slice);
+    CHECK(copy.view() == slice);
+    CHECK(copy.view().offsets()[0] == 0);
+    CHECK(copy.view().chars() != arr.view().chars());
+
+    StringArray shared = arr;
+    CHECK(arr.use_count() == 2);
+    CHECK(shared.view().chars() == arr.view().chars());
+
+    // Acquiring the base of the view keeps offsets and characters alive
+    auto* buffer = static_cast<detail::ArrayBuffer*>(slice.base());
+    REQUIRE(slice.base_kind() == ArrayViewBase::ARRAY);
+    const char* begin = reinterpret_cast<const char*>(buffer) + sizeof(*buffer);
+    const char* end   = reinterpret_cast<const char*>(buffer) + buffer->bytes;
+    CHECK(reinterpret_cast<const char*>(slice.offsets()) >= begin);
+    CHECK(slice.chars() >= begin);
+    CHECK(slice.chars() + arr.view().total_chars() <= end);
+  }
+
+  SECTION("Fixed-width byte strings") {
+    const char data[] = "ab\0\0abcdx\0\0\0\0\0\0\0";
+    StringArray arr   = StringArray::from_fixed_width(data, 4, 4);
+    REQUIRE(arr.size() == 4);
+    CHECK(arr[0] == "ab");
+    CHECK(arr[1] == "abcd");
+    CHECK(arr[2] == "x");
+    CHECK(arr[3] == "");
+
+    std::vector<char> out(16, 'z');
+    arr.view().to_fixed_width(out.data(), 4);
+    CHECK(std::string(out.data(), 16) == std::string(data, 16));
+    CHECK_THROWS_AS(arr.view().to_fixed_width(out.data(), 3), ValueError);
+  }
+
+  SECTION("UCS4 strings") {
+    // "Å", "ab", "€x", "😀" as UCS4 of width 2
+    const std::vector<uint32_t> ucs4{0xC5, 0, 'a', 'b', 0x20AC, 'x', 0x1F600, 0};
+    StringArray arr = StringArray::from_ucs4(ucs4.data(), 4, 2);
+    REQUIRE(arr.size() == 4);
+    CHECK(arr[0] == "\xC3\x85");
+    CHECK(arr[1] == "ab");
+    CHECK(arr[2] == "\xE2\x82\xAC" "x");
+    CHECK(arr[3] == "\xF0\x9F\x98\x80");
+    CHECK(arr.view().max_length() == 4);
+    CHECK(arr.view().max_code_points() == 2);
+
+    std::vector<uint32_t> back(8, 7);
+    arr.view().to_ucs4(back.data(), 2);
+    CHECK(back == ucs4);
+    CHECK_THROWS_AS(arr.view().to_ucs4(back.data(), 1), ValueError);
+
+    const std::vector<uint32_t> invalid{0xD800};
+    CHECK_THROWS_AS(StringArray::from_ucs4(invalid.data(), 1, 1), ValueError);
+    StringArray bad(std::vector<std::string>{"\xFF"});
+    CHECK_THROWS_AS(bad.view().to_ucs4(back.data(), 2), ValueError);
+
+    // Overlong encodings, surrogates and values beyond U+10FFFF
+    for (const char* str :
+         {"\xC0\x80", "\xE0\x80\xAF", "\xF0\x82\x82\xAC", "\xED\xA0\x80",
+          "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xF7\xBF\xBF\xBF"}) {
+      StringArray invalid_utf8(std::vector<std::string>{str});
+      CHECK_THROWS_AS(invalid_utf8.view().to_ucs4(back.data(), 2), ValueError);
+    }
+    StringArray limits(std::vector<std::string>{"\xF4\x8F\xBF\xBF", "\xEE\x80\x80"});
+    limits.view().to_ucs4(back.data(), 1);
+    CHECK(back[0] == 0x10FFFF);
+    CHECK(back[1] == 0xE000);
+  }
+
+  SECTION("Storage in PamMap") {
+    PamMap map;
+    map.update("labels", StringArray(labels));
+
+    const StringArrayView& view = map.at<StringArrayView>("labels");
+    CHECK(view.size() == 6);
+    CHECK(view[5] == "2p_x");
+    CHECK(map.at<StringArray>("labels").use_count() == 1);
+
+    PamMap copy(map);
+    map.erase("labels");
+    CHECK(copy.at<StringArrayView>("labels")[3] == "Na");
+    CHECK_THROWS_AS(copy.at<ArrayView<String>>("labels"), TypeError);
+  }
+}
+
+}  // namespace tests
+}  // namespace pammap
@@ -36,5 +36,10 @@ typedef int64_t Integer;
 typedef double Float;
 typedef std::string String;
 typedef bool Bool;
+typedef float Float32;
+typedef std::complex<float> Complex64;
+typedef int32_t Integer32;
+typedef int8_t Integer8;
+typedef uint8_t Unsigned8;
 
 }  // namespace pammap
@@ -37,7 +37,7 @@ def generate():
     ]
 
     output += NAMESPACE_OPEN
-    for dtype in constants.DTYPES:
+    for dtype in constants.DTYPES + constants.ARRAY_DTYPES:
         underlying_type = constants.cpp.underlying_type[dtype]
         output += ["typedef " + underlying_type + " " + to_cpp_type(dtype) + ";"]
     output += NAMESPACE_CLOSE
@@ -18,55 +18,148 @@
 //
 
 #pragma once
+#include "Array.hpp"
+#include "BitArray.hpp"
 #include "PamMapValue.hxx"
+#include "StringArray.hpp"
 #include "demangle.hpp"
 #include "exceptions.hpp"
+#include <type_traits>
 
 namespace pammap {
 
 namespace detail {
 inline void throw_value_cast_type_error(const std::string& key,
                                         const PamMapValue& operand,
-                                        const std::type_info& reqtype) {
+                                        const std::string& reqtype) {
   pammap_throw(false, TypeError,
                "Key '" + key + "' points to a value of type '" + operand.type_name() +
                      "', which cannot be converted to the requested type '" +
-                     demangle(reqtype) + "'.");
+                     reqtype + "'.");
 }
+
+//@{
+/** The owning type of the data behind a view type, e.g. Array<T> for
+ *  ArrayView<T>. Not defined for other types. */
+template <typename View>
+struct OwnerOf {};
+
+template <typename T>
+struct OwnerOf<ArrayView<T>> {
+  typedef Array<T> type;
+};
+
+template <>
+struct OwnerOf<BitArrayView> {
+  typedef BitArray type;
+};
+
+template <>
+struct OwnerOf<StringArrayView> {
+  typedef StringArray type;
+};
+//@}
+
+/** Void if the view type has an owning type, else substitution fails */
+template <typename View>
+using if_has_owner = typename std::conditional<true, void,
+                                               typename OwnerOf<View>::type>::type;
+
+//@{
+/** Fallback of value_cast if the requested type is not the type of the value.
+ *
+ * Throws a TypeError unless a view type is requested and the value is of
+ * the corresponding owning type (e.g. ArrayView<T> and Array<T> or
+ * BitArrayView and BitArray, see OwnerOf), in which case the view of the
+ * owning object is returned.
+ */
+template <typename ValueType, typename = void>
+struct ValueCastFallback {
+  template <typename Operand>
+  static ValueType cast(const std::string& key, Operand& operand) {
+    typedef typename std::decay<ValueType>::type type;
+    throw_value_cast_type_error(key, operand, TypeName<type>::get());
+    throw;
+  }
+};
+
+template <typename View>
+struct ValueCastFallback<View&, if_has_owner<View>> {
+  static View& cast(const std::string& key, PamMapValue& operand) {
+    typedef typename OwnerOf<View>::type Owner;
+    Owner* owner = any_cast<Owner>(&operand);
+    if (owner == nullptr) throw_value_cast_type_error(key, operand, TypeName<View>::get());
+    return owner->view();
+  }
+};
+
+template <typename View>
+struct ValueCastFallback<const View&, if_has_owner<View>> {
+  static const View& cast(const std::string& key, const PamMapValue& operand) {
+    typedef typename OwnerOf<View>::type Owner;
+    const Owner* owner = any_cast<Owner>(&operand);
+    if (owner == nullptr) throw_value_cast_type_error(key, operand, TypeName<View>::get());
+    return owner->view();
+  }
+};
+
+template <typename View>
+struct ValueCastFallback<View, if_has_owner<View>> {
+  static View cast(const std::string& key, const PamMapValue& operand) {
+    return ValueCastFallback<const View&>::cast(key, operand);
+  }
+};
+//@}
+
+/** Is the requested type a PamMap (which may only be mounted, not obtained
+ *  as a value, see PamMap::mount) */
+template <typename ValueType>
+struct IsPamMap
+      : public std::is_same<typename std::remove_cv<
+                                  typename std::remove_reference<ValueType>::type>::type,
+                            PamMap> {};
 }  // namespace detail
 
 //@{
 /** Perform type-safe access into object contained in PamMapValue.
  *
- * If this access is not possible throws a TypeError
+ * If this access is not possible throws a TypeError. Values of type
+ * Array<T> may be accessed as ArrayView<T> as well, values of type
+ * BitArray as BitArrayView and values of type StringArray as StringArrayView.
  */
 template <typename ValueType>
 ValueType value_cast(const std::string& key, const PamMapValue& operand) {
+  static_assert(!detail::IsPamMap<ValueType>::value,
+                "Mounted maps cannot be obtained as values. Access their entries "
+                "through the path of the mount instead.");
   try {
     return any_cast<ValueType>(operand);
   } catch (const bad_any_cast& e) {
-    detail::throw_value_cast_type_error(key, operand, typeid(ValueType));
-    throw;
+    return detail::ValueCastFallback<ValueType>::cast(key, operand);
   }
 }
 
 template <typename ValueType>
 ValueType value_cast(const std::string& key, PamMapValue& operand) {
+  static_assert(!detail::IsPamMap<ValueType>::value,
+                "Mounted maps cannot be obtained as values. Access their entries "
+                "through the path of the mount instead.");
   try {
     return any_cast<ValueType>(operand);
   } catch (const bad_any_cast& e) {
-    detail::throw_value_cast_type_error(key, operand, typeid(ValueType));
-    throw;
+    return detail::ValueCastFallback<ValueType>::cast(key, operand);
   }
 }
 
 template <typename ValueType>
 ValueType value_cast(const std::string& key, PamMapValue&& operand) {
+  static_assert(!detail::IsPamMap<ValueType>::value,
+                "Mounted maps cannot be obtained as values. Access their entries "
+                "through the path of the mount instead.");
   try {
     return any_cast<ValueType>(operand);
   } catch (const bad_any_cast& e) {
-    detail::throw_value_cast_type_error(key, operand, typeid(ValueType));
-    throw;
+    return detail::ValueCastFallback<ValueType>::cast(key, operand);
   }
 }
 //@}
@@ -19,12 +19,52 @@
 //
 
 %{
+#include "Array.hpp"
 #include "ArrayView.hpp"
 #include "typedefs.hxx"
 %}
 
 %include "numpy.i"
 
+%{
+namespace pammap {
+namespace detail {
+/** Wrap the elements viewed by an ArrayView, whose base is the buffer of
+ *  an Array, into a numpy array. The numpy array keeps the buffer alive.
+ *  Returns nullptr and sets a Python exception on failure. */
+inline PyObject* array_buffer_to_numpy(void* data, const size_t* shape,
+                                       const ptrdiff_t* strides, size_t ndim,
+                                       size_t typebytes, int typecode,
+                                       ArrayBuffer* buffer) {
+  npy_intp dims[max_dynamic_rank];
+  npy_intp byte_strides[max_dynamic_rank];
+  for (size_t i = 0; i < ndim; ++i) {
+    dims[i]         = static_cast<npy_intp>(shape[i]);
+    byte_strides[i] = static_cast<npy_intp>(strides[i] * static_cast<ptrdiff_t>(typebytes));
+  }
+  PyObject* array = PyArray_New(&PyArray_Type, static_cast<int>(ndim), dims, typecode,
+                                byte_strides, data, 0, NPY_ARRAY_WRITEABLE, NULL);
+  if (!array) return NULL;
+
+  PyObject* capsule = PyCapsule_New(buffer, NULL, [](PyObject* obj) {
+    static_cast<ArrayBuffer*>(PyCapsule_GetPointer(obj, NULL))->release();
+  });
+  if (!capsule) {
+    Py_DECREF(array);
+    return NULL;
+  }
+  buffer->acquire();
+  if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array), capsule) != 0) {
+    Py_DECREF(capsule);
+    Py_DECREF(array);
+    return NULL;
+  }
+  return array;
+}
+}  // namespace detail
+}  // namespace pammap
+%}
+
 /*
  *  ArrayView typemaps
  */
@@ -46,17 +86,26 @@
   if (!array || !require_c_or_f_contiguous(array)
       || !require_native(array)) SWIG_fail;
 
-  std::vector<size_t> shape(array_numdims(array));
-  std::vector<ptrdiff_t> strides(array_numdims(array));
+  const int ndim = array_numdims(array);
+  if (ndim > static_cast<int>(pammap::max_dynamic_rank)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "Numpy array has too many dimensions to be passed as an ArrayView.");
+    SWIG_fail;
+  }
+
+  // Shape and strides are stored inline in the ArrayView, so no
+  // allocation is needed here.
+  size_t shape[pammap::max_dynamic_rank];
+  ptrdiff_t strides[pammap::max_dynamic_rank];
   const size_t typebytes = sizeof(DATA_TYPE::value_type);
-  for (int i=0; i < array_numdims(array); ++i) {
+  for (int i=0; i < ndim; ++i) {
     shape[i] = array_size(array, i);
     strides[i] = array_stride(array, i) / typebytes;
   }
 
   $1 = DATA_TYPE(
     static_cast<typename DATA_TYPE::value_type*>(array_data(array)),
-    shape, strides);
+    shape, strides, static_cast<size_t>(ndim));
   $1.reset_base(static_cast<void*>(array), pammap::ArrayViewBase::NUMPY);
 }
 
@@ -64,41 +113,52 @@
   (DATA_TYPE)
   (PyArrayObject* array = NULL)
 {
-  // Need to be build from numpy
-  if (!$1.base() || $1.base_kind() != pammap::ArrayViewBase::NUMPY) {
-    PyErr_SetString(PyExc_RuntimeError,
-                    "Cannot return ArrayView object, which is not originating from "
-                    "a numpy array.");
-    return NULL;
-  }
-  PyObject* obj = static_cast<PyObject*>($1.base());
-  array = obj_to_array_no_conversion(obj, DATA_TYPECODE);
-
-  // Need to be a proper numpy array
-  if (!array || !require_native(array)) {
-    PyErr_SetString(PyExc_RuntimeError,
-                    "Cannot return ArrayView object, where the base() is not a valid "
-                    "numpy array.");
-    return NULL;
-  }
-
-  // Shape and strides need to agree
-  const size_t typebytes = sizeof(DATA_TYPE::value_type);
-  for (int i=0; i < array_numdims(array); ++i) {
-    if ($1.shape()[i] != array_size(array, i)) {
+  // Arrays owned by pammap are handed out as numpy arrays sharing their buffer
+  if ($1.base() && ($1.base_kind() == pammap::ArrayViewBase::ARRAY ||
+                    $1.base_kind() == pammap::ArrayViewBase::MMAP)) {
+    PyObject* owned = pammap::detail::array_buffer_to_numpy(
+          const_cast<void*>(static_cast<const void*>($1.data())), $1.shape().data(),
+          $1.strides().data(), $1.ndim(), sizeof(DATA_TYPE::value_type), DATA_TYPECODE,
+          static_cast<pammap::detail::ArrayBuffer*>($1.base()));
+    if (!owned) return NULL;
+    $result = SWIG_Python_AppendOutput($result, owned);
+  } else {
+    // Otherwise need to be build from numpy
+    if (!$1.base() || $1.base_kind() != pammap::ArrayViewBase::NUMPY) {
       PyErr_SetString(PyExc_RuntimeError,
-                      "Cannot return ArrayView object, where shape has been changed.");
+                      "Cannot return ArrayView object, which is not originating from "
+                      "a numpy array or a pammap Array.");
       return NULL;
     }
-    if ($1.strides()[i] * typebytes != array_stride(array, i)) {
+    PyObject* obj = static_cast<PyObject*>($1.base());
+    array = obj_to_array_no_conversion(obj, DATA_TYPECODE);
+
+    // Need to be a proper numpy array
+    if (!array || !require_native(array)) {
       PyErr_SetString(PyExc_RuntimeError,
-                      "Cannot return ArrayView object, where strides have been changed.");
+                      "Cannot return ArrayView object, where the base() is not a valid "
+                      "numpy array.");
       return NULL;
     }
-  }
 
-  // All fine, append as output
-  $result = SWIG_Python_AppendOutput($result,(PyObject*)array);
+    // Shape and strides need to agree
+    const size_t typebytes = sizeof(DATA_TYPE::value_type);
+    for (int i=0; i < array_numdims(array); ++i) {
+      if ($1.shape()[i] != array_size(array, i)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Cannot return ArrayView object, where shape has been changed.");
+        return NULL;
+      }
+      if ($1.strides()[i] * typebytes != array_stride(array, i)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Cannot return ArrayView object, where strides have been changed.");
+        return NULL;
+      }
+    }
+
+    // All fine, append as output
+    $result = SWIG_Python_AppendOutput($result,(PyObject*)array);
+  }
 }
 %enddef
 
@@ -115,6 +175,11 @@
 %arrayview_typemaps(pammap::ArrayView<pammap::Integer>, NPY_LONGLONG)
 %arrayview_typemaps(pammap::ArrayView<pammap::Float>, NPY_DOUBLE)
 %arrayview_typemaps(pammap::ArrayView<pammap::Bool>, NPY_BOOL)
+%arrayview_typemaps(pammap::ArrayView<pammap::Float32>, NPY_FLOAT)
+%arrayview_typemaps(pammap::ArrayView<pammap::Complex64>, NPY_CFLOAT)
+%arrayview_typemaps(pammap::ArrayView<pammap::Integer32>, NPY_INT32)
+%arrayview_typemaps(pammap::ArrayView<pammap::Integer8>, NPY_INT8)
+%arrayview_typemaps(pammap::ArrayView<pammap::Unsigned8>, NPY_UINT8)
 
 //
 // Apply typemaps
@@ -122,4 +187,9 @@
 %apply (pammap::ArrayView<pammap::Complex> ARRAYVIEW) {(pammap::ArrayView<pammap::Complex>)}
 %apply (pammap::ArrayView<pammap::Integer> ARRAYVIEW) {(pammap::ArrayView<pammap::Integer>)}
 %apply (pammap::ArrayView<pammap::Float> ARRAYVIEW) {(pammap::ArrayView<pammap::Float>)}
-%apply (pammap::ArrayView<pammap::Bool> ARRAYVIEW) {(pammap::ArrayView<pammap::Bool>)}
\ No newline at end of file
+%apply (pammap::ArrayView<pammap::Bool> ARRAYVIEW) {(pammap::ArrayView<pammap::Bool>)}
+%apply (pammap::ArrayView<pammap::Float32> ARRAYVIEW) {(pammap::ArrayView<pammap::Float32>)}
+%apply (pammap::ArrayView<pammap::Complex64> ARRAYVIEW) {(pammap::ArrayView<pammap::Complex64>)}
+%apply (pammap::ArrayView<pammap::Integer32> ARRAYVIEW) {(pammap::ArrayView<pammap::Integer32>)}
+%apply (pammap::ArrayView<pammap::Integer8> ARRAYVIEW) {(pammap::ArrayView<pammap::Integer8>)}
+%apply (pammap::ArrayView<pammap::Unsigned8> ARRAYVIEW) {(pammap::ArrayView<pammap::Unsigned8>)}
\ No newline at end of file
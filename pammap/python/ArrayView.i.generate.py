@@ -33,7 +33,7 @@ def generate():
         original = f.readlines()
 
     output = ["", "//", "// Define typemaps", "//"]
-    for dtype in constants.DTYPES:
+    for dtype in constants.DTYPES + constants.ARRAY_DTYPES:
         if dtype not in constants.python.underlying_numpy_type:
             continue
         nptype = constants.python.underlying_numpy_type[dtype]
@@ -43,7 +43,7 @@ def generate():
         ]
 
     output += ["", "//", "// Apply typemaps", "//"]
-    for dtype in constants.DTYPES:
+    for dtype in constants.DTYPES + constants.ARRAY_DTYPES:
         if dtype not in constants.python.underlying_numpy_type:
             continue
         dbtype = to_cpp_arraytype(dtype, full=True)
@@ -0,0 +1,103 @@
+// vi: syntax=c
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+%{
+#include "BitArray.hpp"
+%}
+
+%include "numpy.i"
+
+/*
+ *  BitArray typemaps
+ *
+ *  Unlike ArrayViews the bits cannot be shared with numpy, since numpy
+ *  stores one byte per boolean. Both directions therefore copy the bits,
+ *  using the word-wise conversions of BitArrayView.
+ */
+
+%typecheck(SWIG_TYPECHECK_BOOL_ARRAY,fragment="NumPy_Macros")
+  (pammap::BitArray)
+{
+  $1 = is_array($input) && PyArray_EquivTypenums(array_type($input), NPY_BOOL);
+}
+
+/** Typemap to pass a numpy array of dtype bool (of any shape, taken in
+  * C order) to C++ as a BitArray */
+%typemap(in,fragment="NumPy_Fragments")
+  (pammap::BitArray)
+  (PyArrayObject* array=NULL, int is_new_object=0)
+{
+  array = obj_to_array_contiguous_allow_conversion($input, NPY_BOOL, &is_new_object);
+  if (!array) SWIG_fail;
+
+  const size_t size = static_cast<size_t>(PyArray_SIZE(array));
+  pammap::ArrayView<pammap::Bool> bools(
+    static_cast<pammap::Bool*>(array_data(array)), {size});
+  $1 = pammap::BitArray::from_bools(bools);
+  if (is_new_object) { Py_DECREF(array); }
+}
+
+/** Typemap to return a BitArray as a one-dimensional numpy array
+  * of dtype bool */
+%typemap(out,fragment="NumPy_Fragments")
+  (pammap::BitArray)
+{
+  npy_intp dims[1] = {static_cast<npy_intp>($1.size())};
+  PyObject* array = PyArray_SimpleNew(1, dims, NPY_BOOL);
+  if (!array) SWIG_fail;
+
+  pammap::ArrayView<pammap::Bool> bools(
+    static_cast<pammap::Bool*>(array_data(array)), {$1.size()});
+  $1.view().to_bools(bools);
+  $result = SWIG_Python_AppendOutput($result, array);
+}
+
+%{
+namespace pammap {
+namespace detail {
+/** Build a BitArray of size bits from the uint8 result of numpy.packbits */
+inline BitArray bit_array_from_packbits(PyObject* packed, size_t size) {
+  int is_new_object = 0;
+  PyArrayObject* array =
+        obj_to_array_contiguous_allow_conversion(packed, NPY_UBYTE, &is_new_object);
+  pammap_throw(array != NULL, ValueError,
+               "Packed bits need to be convertible to a uint8 array.");
+
+  const size_t nbytes = static_cast<size_t>(PyArray_SIZE(array));
+  if (nbytes != (size + 7) / 8 && is_new_object) { Py_DECREF(array); }
+  pammap_throw(nbytes == (size + 7) / 8, ValueError,
+               "Number of packed bytes does not agree with the number of bits.");
+  BitArray ret = BitArray::from_packbits(
+        static_cast<const uint8_t*>(array_data(array)), size);
+  if (is_new_object) { Py_DECREF(array); }
+  return ret;
+}
+
+/** Return the bits in the layout of numpy.packbits as a uint8 numpy array */
+inline PyObject* bit_array_to_packbits(const BitArrayView& bits) {
+  npy_intp dims[1] = {static_cast<npy_intp>((bits.size() + 7) / 8)};
+  PyObject* array = PyArray_SimpleNew(1, dims, NPY_UBYTE);
+  if (!array) return NULL;
+  bits.to_packbits(static_cast<uint8_t*>(array_data(array)));
+  return array;
+}
+}  // namespace detail
+}  // namespace pammap
+%}
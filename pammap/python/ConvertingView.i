@@ -0,0 +1,125 @@
+// vi: syntax=c
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+%{
+#include "ConvertingView.hpp"
+%}
+
+%include "numpy.i"
+
+/*
+ *  ConvertingView typemaps
+ *
+ *  Unlike ArrayView, which needs numpy arrays of exactly the element type
+ *  in native byte order, a ConvertingView accepts numpy arrays of any dtype,
+ *  which can be converted to the element type without loss, in either byte
+ *  order and with arbitrary strides. The elements are converted on access,
+ *  such that no converted copy is made in Python.
+ */
+
+%{
+namespace pammap {
+namespace detail {
+/** The SourceType of the elements of a numpy array.
+ *  Returns false if the dtype is not supported. */
+inline bool source_kind_from_numpy(PyArrayObject* array, SourceType::KIND& kind) {
+  const PyArray_Descr* descr = PyArray_DESCR(array);
+  const int size             = descr->elsize;
+  switch (descr->kind) {
+    case 'b':
+      kind = SourceType::BOOL;
+      return size == 1;
+    case 'i':
+    case 'u': {
+      const int first = descr->kind == 'i' ? SourceType::INT8 : SourceType::UINT8;
+      kind = static_cast<SourceType::KIND>(first + integer_size_index(size_t(size)));
+      return size == 1 || size == 2 || size == 4 || size == 8;
+    }
+    case 'f':
+      kind = size == 4 ? SourceType::FLOAT32 : SourceType::FLOAT64;
+      return size == 4 || size == 8;
+    case 'c':
+      kind = size == 8 ? SourceType::COMPLEX64 : SourceType::COMPLEX128;
+      return size == 8 || size == 16;
+    default:
+      return false;
+  }
+}
+
+/** View a numpy array as a ConvertingView.
+ *  Returns false and sets a Python exception on failure. */
+template <typename T>
+bool converting_view_from_numpy(PyObject* obj, ConvertingView<T>& view) {
+  if (!is_array(obj)) {
+    PyErr_SetString(PyExc_TypeError, "A numpy array is required.");
+    return false;
+  }
+  PyArrayObject* array = reinterpret_cast<PyArrayObject*>(obj);
+  SourceType::KIND kind;
+  if (!source_kind_from_numpy(array, kind)) {
+    PyErr_SetString(PyExc_TypeError, "Unsupported dtype of the numpy array.");
+    return false;
+  }
+
+  const int ndim = array_numdims(array);
+  std::vector<size_t> shape(static_cast<size_t>(ndim));
+  std::vector<ptrdiff_t> strides(static_cast<size_t>(ndim));
+  for (int i = 0; i < ndim; ++i) {
+    shape[static_cast<size_t>(i)]   = static_cast<size_t>(array_size(array, i));
+    strides[static_cast<size_t>(i)] = static_cast<ptrdiff_t>(array_stride(array, i));
+  }
+
+  try {
+    view = ConvertingView<T>(array_data(array), kind, PyArray_ISBYTESWAPPED(array),
+                             shape, strides);
+  } catch (const TypeError& e) {
+    // Typemaps are not covered by the %exception handler
+    PyErr_SetString(PyExc_TypeError, e.extra.c_str());
+    return false;
+  } catch (const ValueError& e) {
+    PyErr_SetString(PyExc_ValueError, e.extra.c_str());
+    return false;
+  }
+  return true;
+}
+}  // namespace detail
+}  // namespace pammap
+%}
+
+%define %converting_view_typemaps(DATA_TYPE)
+%typecheck(SWIG_TYPECHECK_DOUBLE_ARRAY,fragment="NumPy_Macros")
+  (pammap::ConvertingView<DATA_TYPE>)
+{
+  pammap::SourceType::KIND kind;
+  $1 = is_array($input) && pammap::detail::source_kind_from_numpy(
+                                 reinterpret_cast<PyArrayObject*>($input), kind);
+}
+
+/** Typemap to pass a numpy array to C++ as a ConvertingView */
+%typemap(in,fragment="NumPy_Fragments")
+  (pammap::ConvertingView<DATA_TYPE>)
+{
+  if (!pammap::detail::converting_view_from_numpy($input, $1)) SWIG_fail;
+}
+%enddef
+
+%converting_view_typemaps(pammap::Complex)
+%converting_view_typemaps(pammap::Integer)
+%converting_view_typemaps(pammap::Float)
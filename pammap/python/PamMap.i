@@ -30,6 +30,10 @@
 
 %include "pammap_exceptions.i"
 %include "ArrayView.i"
+%include "BitArray.i"
+%include "ConvertingView.i"
+%include "SparseMatrix.i"
+%include "StringArray.i"
 %include "std_string.i"
 %include "stdint.i"
 %include "typedefs.hxx"
@@ -99,4 +103,133 @@
   pammap::ArrayView<pammap::Bool> get_bool_array(std::string key) {
     return $self->at<pammap::ArrayView<pammap::Bool>>(key);  }
 
+  void update_float32_array(std::string key, pammap::ArrayView<pammap::Float32> view) {
+    $self->update(key, std::move(view));
+  }
+
+  pammap::ArrayView<pammap::Float32> get_float32_array(std::string key) {
+    return $self->at<pammap::ArrayView<pammap::Float32>>(key);  }
+
+  void update_complex64_array(std::string key, pammap::ArrayView<pammap::Complex64> view) {
+    $self->update(key, std::move(view));
+  }
+
+  pammap::ArrayView<pammap::Complex64> get_complex64_array(std::string key) {
+    return $self->at<pammap::ArrayView<pammap::Complex64>>(key);  }
+
+  void update_integer32_array(std::string key, pammap::ArrayView<pammap::Integer32> view) {
+    $self->update(key, std::move(view));
+  }
+
+  pammap::ArrayView<pammap::Integer32> get_integer32_array(std::string key) {
+    return $self->at<pammap::ArrayView<pammap::Integer32>>(key);  }
+
+  void update_integer8_array(std::string key, pammap::ArrayView<pammap::Integer8> view) {
+    $self->update(key, std::move(view));
+  }
+
+  pammap::ArrayView<pammap::Integer8> get_integer8_array(std::string key) {
+    return $self->at<pammap::ArrayView<pammap::Integer8>>(key);  }
+
+  void update_unsigned8_array(std::string key, pammap::ArrayView<pammap::Unsigned8> view) {
+    $self->update(key, std::move(view));
+  }
+
+  pammap::ArrayView<pammap::Unsigned8> get_unsigned8_array(std::string key) {
+    return $self->at<pammap::ArrayView<pammap::Unsigned8>>(key);  }
+
+  void update_converted_complex_array(std::string key, pammap::ConvertingView<pammap::Complex> view) {
+    pammap::Array<pammap::Complex> array(view.shape());
+    view.copy_to(array.view());
+    $self->update(key, std::move(array));
+  }
+
+  void update_converted_integer_array(std::string key, pammap::ConvertingView<pammap::Integer> view) {
+    pammap::Array<pammap::Integer> array(view.shape());
+    view.copy_to(array.view());
+    $self->update(key, std::move(array));
+  }
+
+  void update_converted_float_array(std::string key, pammap::ConvertingView<pammap::Float> view) {
+    pammap::Array<pammap::Float> array(view.shape());
+    view.copy_to(array.view());
+    $self->update(key, std::move(array));
+  }
+
+  void update_bit_array(std::string key, pammap::BitArray bits) {
+    $self->update(key, std::move(bits));
+  }
+  pammap::BitArray get_bit_array(std::string key) {
+    return pammap::BitArray($self->at<pammap::BitArrayView>(key));
+  }
+  void update_packed_bit_array(std::string key, PyObject* packed, size_t size) {
+    $self->update(key, pammap::detail::bit_array_from_packbits(packed, size));
+  }
+  PyObject* get_packed_bit_array(std::string key) {
+    return pammap::detail::bit_array_to_packbits($self->at<pammap::BitArrayView>(key));
+  }
+
+  void update_string_array(std::string key, pammap::StringArray strings) {
+    $self->update(key, std::move(strings));
+  }
+  pammap::StringArrayView get_string_array(std::string key) {
+    return $self->at<pammap::StringArrayView>(key);
+  }
+
+  void update_csr_matrix_float_integer32(std::string key, pammap::CsrMatrixView<pammap::Float, pammap::Integer32> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CsrMatrixView<pammap::Float, pammap::Integer32> get_csr_matrix_float_integer32(std::string key) {
+    return $self->at<pammap::CsrMatrixView<pammap::Float, pammap::Integer32>>(key);
+  }
+
+  void update_csr_matrix_float_integer(std::string key, pammap::CsrMatrixView<pammap::Float, pammap::Integer> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CsrMatrixView<pammap::Float, pammap::Integer> get_csr_matrix_float_integer(std::string key) {
+    return $self->at<pammap::CsrMatrixView<pammap::Float, pammap::Integer>>(key);
+  }
+
+  void update_csr_matrix_complex_integer32(std::string key, pammap::CsrMatrixView<pammap::Complex, pammap::Integer32> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CsrMatrixView<pammap::Complex, pammap::Integer32> get_csr_matrix_complex_integer32(std::string key) {
+    return $self->at<pammap::CsrMatrixView<pammap::Complex, pammap::Integer32>>(key);
+  }
+
+  void update_csr_matrix_complex_integer(std::string key, pammap::CsrMatrixView<pammap::Complex, pammap::Integer> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CsrMatrixView<pammap::Complex, pammap::Integer> get_csr_matrix_complex_integer(std::string key) {
+    return $self->at<pammap::CsrMatrixView<pammap::Complex, pammap::Integer>>(key);
+  }
+
+  void update_coo_matrix_float_integer32(std::string key, pammap::CooMatrixView<pammap::Float, pammap::Integer32> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CooMatrixView<pammap::Float, pammap::Integer32> get_coo_matrix_float_integer32(std::string key) {
+    return $self->at<pammap::CooMatrixView<pammap::Float, pammap::Integer32>>(key);
+  }
+
+  void update_coo_matrix_float_integer(std::string key, pammap::CooMatrixView<pammap::Float, pammap::Integer> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CooMatrixView<pammap::Float, pammap::Integer> get_coo_matrix_float_integer(std::string key) {
+    return $self->at<pammap::CooMatrixView<pammap::Float, pammap::Integer>>(key);
+  }
+
+  void update_coo_matrix_complex_integer32(std::string key, pammap::CooMatrixView<pammap::Complex, pammap::Integer32> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CooMatrixView<pammap::Complex, pammap::Integer32> get_coo_matrix_complex_integer32(std::string key) {
+    return $self->at<pammap::CooMatrixView<pammap::Complex, pammap::Integer32>>(key);
+  }
+
+  void update_coo_matrix_complex_integer(std::string key, pammap::CooMatrixView<pammap::Complex, pammap::Integer> matrix) {
+    $self->update(key, std::move(matrix));
+  }
+  pammap::CooMatrixView<pammap::Complex, pammap::Integer> get_coo_matrix_complex_integer(std::string key) {
+    return $self->at<pammap::CooMatrixView<pammap::Complex, pammap::Integer>>(key);
+  }
+
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 ## ---------------------------------------------------------------------
 
 from common import licence_header_cpp, to_cpp_type, to_cpp_arraytype
+from common import SPARSE_VALUE_TYPES, SPARSE_INDEX_TYPES
 import constants
 
 
@@ -36,6 +37,10 @@ def generate():
         "",
         '%include "pammap_exceptions.i"',
         '%include "ArrayView.i"',
+        '%include "BitArray.i"',
+        '%include "ConvertingView.i"',
+        '%include "SparseMatrix.i"',
+        '%include "StringArray.i"',
         '%include "std_string.i"',
         '%include "stdint.i"',
         '%include "typedefs.hxx"',
@@ -58,7 +63,7 @@ def generate():
             ""
         ]
 
-    for dtype in constants.DTYPES:
+    for dtype in constants.DTYPES + constants.ARRAY_DTYPES:
         if dtype not in constants.python.underlying_numpy_type:
             continue
         dbtype = to_cpp_arraytype(dtype, full=True)
@@ -79,6 +84,68 @@ def generate():
             ""
         ]
 
+    # Arrays of any dtype and byte order, which can be converted without loss.
+    # These are converted into a copy owned by the PamMap.
+    for dtype in ["complex", "integer", "float"]:
+        cpptype = to_cpp_type(dtype, full=True)
+        output += [
+            "  void update_converted_" + dtype + "_array(std::string key, "
+            "pammap::ConvertingView<" + cpptype + "> view) {",
+            "    pammap::Array<" + cpptype + "> array(view.shape());",
+            "    view.copy_to(array.view());",
+            "    $self->update(key, std::move(array));",
+            "  }",
+            ""
+        ]
+
+    # Bit-packed boolean arrays, which are copied in both directions
+    output += [
+        "  void update_bit_array(std::string key, pammap::BitArray bits) {",
+        "    $self->update(key, std::move(bits));",
+        "  }",
+        "  pammap::BitArray get_bit_array(std::string key) {",
+        "    return pammap::BitArray($self->at<pammap::BitArrayView>(key));",
+        "  }",
+        "  void update_packed_bit_array(std::string key, PyObject* packed, "
+        "size_t size) {",
+        "    $self->update(key, pammap::detail::bit_array_from_packbits(packed, size));",
+        "  }",
+        "  PyObject* get_packed_bit_array(std::string key) {",
+        "    return pammap::detail::bit_array_to_packbits("
+        "$self->at<pammap::BitArrayView>(key));",
+        "  }",
+        ""
+    ]
+
+    # String arrays, which are converted from and to fixed-width numpy strings
+    output += [
+        "  void update_string_array(std::string key, pammap::StringArray strings) {",
+        "    $self->update(key, std::move(strings));",
+        "  }",
+        "  pammap::StringArrayView get_string_array(std::string key) {",
+        "    return $self->at<pammap::StringArrayView>(key);",
+        "  }",
+        ""
+    ]
+
+    # Sparse matrices, which are exchanged with scipy.sparse without copying
+    for fmt in ["csr", "coo"]:
+        for cpptype in SPARSE_VALUE_TYPES:
+            for index in SPARSE_INDEX_TYPES:
+                sptype = "pammap::{}MatrixView<pammap::{}, pammap::{}>".format(
+                    fmt.capitalize(), cpptype, index)
+                suffix = "_".join([fmt, "matrix", cpptype.lower(), index.lower()])
+                output += [
+                    "  void update_" + suffix + "(std::string key, " + sptype +
+                    " matrix) {",
+                    "    $self->update(key, std::move(matrix));",
+                    "  }",
+                    "  " + sptype + " get_" + suffix + "(std::string key) {",
+                    "    return $self->at<" + sptype + ">(key);",
+                    "  }",
+                    ""
+                ]
+
     output += ["}"]
     return "\n".join(output)
 
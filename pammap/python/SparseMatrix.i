@@ -0,0 +1,251 @@
+// vi: syntax=c
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+%{
+#include "SparseMatrixView.hpp"
+%}
+
+%include "numpy.i"
+
+/*
+ *  Sparse matrix typemaps
+ *
+ *  CsrMatrixView and CooMatrixView are exchanged with scipy.sparse.csr_matrix
+ *  and scipy.sparse.coo_matrix without copying: The component arrays of the
+ *  scipy matrix are viewed like any other ArrayView and the returned scipy
+ *  matrix is built from the numpy arrays the views originate from. Since
+ *  scipy may narrow the index arrays on construction, these are set on the
+ *  matrix afterwards.
+ */
+
+%{
+namespace pammap {
+namespace detail {
+/** View the numpy array in the attribute ``name`` of a scipy.sparse matrix.
+ *  Returns false and sets a Python exception on failure. */
+template <typename T>
+bool sparse_component_from_scipy(PyObject* matrix, const char* name, int typecode,
+                                 ArrayView<T>& view) {
+  PyObject* attr = PyObject_GetAttrString(matrix, name);
+  if (!attr) return false;
+  PyArrayObject* array = obj_to_array_no_conversion(attr, typecode);
+  Py_DECREF(attr);  // The matrix keeps its arrays alive
+  if (!array || !require_dimensions(array, 1) || !require_contiguous(array) ||
+      !require_native(array)) {
+    return false;
+  }
+
+  view = ArrayView<T>(static_cast<T*>(array_data(array)),
+                      {static_cast<size_t>(array_size(array, 0))}, {1});
+  view.reset_base(static_cast<void*>(array), ArrayViewBase::NUMPY);
+  return true;
+}
+
+/** Read the shape of a scipy.sparse matrix.
+ *  Returns false and sets a Python exception on failure. */
+inline bool sparse_shape_from_scipy(PyObject* matrix, size_t& n_rows, size_t& n_cols) {
+  PyObject* shape = PyObject_GetAttrString(matrix, "shape");
+  if (!shape) return false;
+  Py_ssize_t rows = 0, cols = 0;
+  const bool ok = PyArg_ParseTuple(shape, "nn", &rows, &cols) != 0;
+  Py_DECREF(shape);
+  n_rows = static_cast<size_t>(rows);
+  n_cols = static_cast<size_t>(cols);
+  return ok;
+}
+
+/** The numpy array an ArrayView originates from (as a new reference).
+ *  Returns NULL and sets a Python exception if there is none. */
+template <typename T>
+PyObject* sparse_component_to_numpy(const ArrayView<T>& view) {
+  if (!view.base() || view.base_kind() != ArrayViewBase::NUMPY) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "Cannot return a sparse matrix, whose arrays do not originate "
+                    "from numpy arrays.");
+    return NULL;
+  }
+  PyObject* obj = static_cast<PyObject*>(view.base());
+  Py_INCREF(obj);
+  return obj;
+}
+
+/** Call the constructor ``name`` of scipy.sparse with the argument
+ *  tuple ``arrays`` (which is consumed), the shape and ``copy=False``.
+ *  Returns NULL and sets a Python exception on failure. */
+inline PyObject* sparse_to_scipy(const char* name, PyObject* arrays, size_t n_rows,
+                                 size_t n_cols) {
+  PyObject* module = PyImport_ImportModule("scipy.sparse");
+  PyObject* constructor = module ? PyObject_GetAttrString(module, name) : NULL;
+  PyObject* args   = arrays ? Py_BuildValue("(N)", arrays) : NULL;
+  PyObject* kwargs = Py_BuildValue("{s:(nn),s:O}", "shape",
+                                   static_cast<Py_ssize_t>(n_rows),
+                                   static_cast<Py_ssize_t>(n_cols), "copy", Py_False);
+  PyObject* ret = (constructor && args && kwargs)
+                        ? PyObject_Call(constructor, args, kwargs) : NULL;
+  Py_XDECREF(kwargs);
+  Py_XDECREF(args);
+  Py_XDECREF(constructor);
+  Py_XDECREF(module);
+  return ret;
+}
+
+/** scipy.sparse replaces index arrays by copies of a smaller integer type
+ *  if their contents fit, even with ``copy=False``. Set the attribute
+ *  ``name`` of ``matrix`` back to the index array ``value``.
+ *  Returns false and sets a Python exception on failure. */
+inline bool sparse_restore_indices(PyObject* matrix, const char* name, PyObject* value) {
+  PyObject* current = PyObject_GetAttrString(matrix, name);
+  if (!current) return false;
+  const bool same = current == value;
+  Py_DECREF(current);
+  return same || PyObject_SetAttrString(matrix, name, value) == 0;
+}
+
+/** Like sparse_restore_indices for the row and column indices of a coo_matrix,
+ *  which newer versions of scipy keep in the tuple ``coords``. */
+inline bool sparse_restore_coords(PyObject* matrix, PyObject* row, PyObject* col) {
+  if (!PyObject_HasAttrString(matrix, "coords")) {
+    return sparse_restore_indices(matrix, "row", row) &&
+           sparse_restore_indices(matrix, "col", col);
+  }
+  PyObject* coords = PyTuple_Pack(2, row, col);
+  const bool ok = coords && PyObject_SetAttrString(matrix, "coords", coords) == 0;
+  Py_XDECREF(coords);
+  return ok;
+}
+}  // namespace detail
+}  // namespace pammap
+%}
+
+%define %sparse_matrix_typemaps(DATA_TYPE, INDEX_TYPE, DATA_TYPECODE, INDEX_TYPECODE)
+%typecheck(SWIG_TYPECHECK_POINTER,fragment="NumPy_Macros")
+  (pammap::CsrMatrixView<DATA_TYPE, INDEX_TYPE>)
+{
+  $1 = PyObject_HasAttrString($input, "indptr") &&
+       PyObject_HasAttrString($input, "indices");
+}
+
+/** Typemap to pass a scipy.sparse.csr_matrix to C++ as a CsrMatrixView */
+%typemap(in,fragment="NumPy_Fragments")
+  (pammap::CsrMatrixView<DATA_TYPE, INDEX_TYPE>)
+{
+  size_t n_rows = 0, n_cols = 0;
+  pammap::ArrayView<INDEX_TYPE> indptr, indices;
+  pammap::ArrayView<DATA_TYPE> data;
+  if (!pammap::detail::sparse_shape_from_scipy($input, n_rows, n_cols) ||
+      !pammap::detail::sparse_component_from_scipy($input, "indptr", INDEX_TYPECODE,
+                                                   indptr) ||
+      !pammap::detail::sparse_component_from_scipy($input, "indices", INDEX_TYPECODE,
+                                                   indices) ||
+      !pammap::detail::sparse_component_from_scipy($input, "data", DATA_TYPECODE,
+                                                   data)) {
+    SWIG_fail;
+  }
+  try {
+    $1 = pammap::CsrMatrixView<DATA_TYPE, INDEX_TYPE>(n_rows, n_cols, indptr, indices,
+                                                      data);
+  } catch (const pammap::ValueError& e) {
+    // Typemaps are not covered by the %exception handler
+    PyErr_SetString(PyExc_ValueError, e.extra.c_str());
+    SWIG_fail;
+  }
+}
+
+/** Typemap to return a CsrMatrixView as a scipy.sparse.csr_matrix */
+%typemap(out,fragment="NumPy_Fragments")
+  (pammap::CsrMatrixView<DATA_TYPE, INDEX_TYPE>)
+{
+  PyObject* data    = pammap::detail::sparse_component_to_numpy($1.data());
+  PyObject* indices = pammap::detail::sparse_component_to_numpy($1.indices());
+  PyObject* indptr  = pammap::detail::sparse_component_to_numpy($1.indptr());
+  PyObject* arrays  = (data && indices && indptr)
+                           ? Py_BuildValue("(OOO)", data, indices, indptr) : NULL;
+  PyObject* matrix  = arrays ? pammap::detail::sparse_to_scipy(
+                                     "csr_matrix", arrays, $1.n_rows(), $1.n_cols())
+                             : NULL;
+  if (matrix && !(pammap::detail::sparse_restore_indices(matrix, "indices", indices) &&
+                  pammap::detail::sparse_restore_indices(matrix, "indptr", indptr))) {
+    Py_DECREF(matrix);
+    matrix = NULL;
+  }
+  Py_XDECREF(data);
+  Py_XDECREF(indices);
+  Py_XDECREF(indptr);
+  if (!matrix) SWIG_fail;
+  $result = SWIG_Python_AppendOutput($result, matrix);
+}
+
+%typecheck(SWIG_TYPECHECK_POINTER,fragment="NumPy_Macros")
+  (pammap::CooMatrixView<DATA_TYPE, INDEX_TYPE>)
+{
+  $1 = PyObject_HasAttrString($input, "row") && PyObject_HasAttrString($input, "col");
+}
+
+/** Typemap to pass a scipy.sparse.coo_matrix to C++ as a CooMatrixView */
+%typemap(in,fragment="NumPy_Fragments")
+  (pammap::CooMatrixView<DATA_TYPE, INDEX_TYPE>)
+{
+  size_t n_rows = 0, n_cols = 0;
+  pammap::ArrayView<INDEX_TYPE> row, col;
+  pammap::ArrayView<DATA_TYPE> data;
+  if (!pammap::detail::sparse_shape_from_scipy($input, n_rows, n_cols) ||
+      !pammap::detail::sparse_component_from_scipy($input, "row", INDEX_TYPECODE, row) ||
+      !pammap::detail::sparse_component_from_scipy($input, "col", INDEX_TYPECODE, col) ||
+      !pammap::detail::sparse_component_from_scipy($input, "data", DATA_TYPECODE,
+                                                   data)) {
+    SWIG_fail;
+  }
+  try {
+    $1 = pammap::CooMatrixView<DATA_TYPE, INDEX_TYPE>(n_rows, n_cols, row, col, data);
+  } catch (const pammap::ValueError& e) {
+    // Typemaps are not covered by the %exception handler
+    PyErr_SetString(PyExc_ValueError, e.extra.c_str());
+    SWIG_fail;
+  }
+}
+
+/** Typemap to return a CooMatrixView as a scipy.sparse.coo_matrix */
+%typemap(out,fragment="NumPy_Fragments")
+  (pammap::CooMatrixView<DATA_TYPE, INDEX_TYPE>)
+{
+  PyObject* data   = pammap::detail::sparse_component_to_numpy($1.data());
+  PyObject* row    = pammap::detail::sparse_component_to_numpy($1.row());
+  PyObject* col    = pammap::detail::sparse_component_to_numpy($1.col());
+  PyObject* arrays = (data && row && col)
+                          ? Py_BuildValue("(O(OO))", data, row, col) : NULL;
+  PyObject* matrix = arrays ? pammap::detail::sparse_to_scipy(
+                                    "coo_matrix", arrays, $1.n_rows(), $1.n_cols())
+                            : NULL;
+  if (matrix && !pammap::detail::sparse_restore_coords(matrix, row, col)) {
+    Py_DECREF(matrix);
+    matrix = NULL;
+  }
+  Py_XDECREF(data);
+  Py_XDECREF(row);
+  Py_XDECREF(col);
+  if (!matrix) SWIG_fail;
+  $result = SWIG_Python_AppendOutput($result, matrix);
+}
+%enddef
+
+%sparse_matrix_typemaps(pammap::Float, pammap::Integer32, NPY_DOUBLE, NPY_INT32)
+%sparse_matrix_typemaps(pammap::Float, pammap::Integer, NPY_DOUBLE, NPY_INT64)
+%sparse_matrix_typemaps(pammap::Complex, pammap::Integer32, NPY_CDOUBLE, NPY_INT32)
+%sparse_matrix_typemaps(pammap::Complex, pammap::Integer, NPY_CDOUBLE, NPY_INT64)
@@ -0,0 +1,104 @@
+// vi: syntax=c
+//
+// Copyright (C) 2018 by Michael F. Herbst and contributors
+//
+// This file is part of pammap.
+//
+// pammap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// pammap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with pammap. If not, see <http://www.gnu.org/licenses/>.
+//
+
+%{
+#include "StringArray.hpp"
+#include <limits>
+%}
+
+%include "numpy.i"
+
+/*
+ *  StringArray typemaps
+ *
+ *  numpy stores strings with a fixed width per element, either as bytes
+ *  (dtype "S", taken as UTF-8) or as UCS4 code points (dtype "U"). Both
+ *  directions convert in a single sweep over the data without creating
+ *  Python string objects.
+ */
+
+%typecheck(SWIG_TYPECHECK_STRING_ARRAY,fragment="NumPy_Macros")
+  (pammap::StringArray)
+{
+  $1 = is_array($input) && (array_type($input) == NPY_STRING ||
+                            array_type($input) == NPY_UNICODE);
+}
+
+/** Typemap to pass a numpy array of dtype "S" or "U" (of any shape,
+  * taken in C order) to C++ as a StringArray */
+%typemap(in,fragment="NumPy_Fragments")
+  (pammap::StringArray)
+  (PyArrayObject* array=NULL, int is_new_object=0)
+{
+  const int typecode = is_array($input) ? array_type($input) : NPY_NOTYPE;
+  if (typecode != NPY_STRING && typecode != NPY_UNICODE) {
+    PyErr_SetString(PyExc_TypeError,
+                    "Only numpy arrays of dtype 'S' or 'U' can be passed "
+                    "as StringArray.");
+    SWIG_fail;
+  }
+  array = obj_to_array_contiguous_allow_conversion($input, typecode, &is_new_object);
+  if (!array || !require_native(array)) SWIG_fail;
+
+  const size_t size = static_cast<size_t>(PyArray_SIZE(array));
+  const size_t itemsize = static_cast<size_t>(PyArray_ITEMSIZE(array));
+  try {
+    if (typecode == NPY_STRING) {
+      $1 = pammap::StringArray::from_fixed_width(
+            static_cast<const char*>(array_data(array)), size, itemsize);
+    } else {
+      $1 = pammap::StringArray::from_ucs4(
+            static_cast<const uint32_t*>(array_data(array)), size, itemsize / 4);
+    }
+  } catch (const pammap::ValueError& e) {
+    // Typemaps are not covered by the %exception handler
+    if (is_new_object) { Py_DECREF(array); }
+    PyErr_SetString(PyExc_ValueError, e.extra.c_str());
+    SWIG_fail;
+  }
+  if (is_new_object) { Py_DECREF(array); }
+}
+
+/** Typemap to return the strings of a StringArrayView as a one-dimensional
+  * numpy array of dtype "U", just wide enough for the longest string */
+%typemap(out,fragment="NumPy_Fragments")
+  (pammap::StringArrayView)
+{
+  const size_t width = std::max<size_t>(1, $1.max_code_points());
+  if (width > static_cast<size_t>(std::numeric_limits<int>::max() / 4)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "Strings are too long to be returned as a numpy array.");
+    SWIG_fail;
+  }
+
+  npy_intp dims[1] = {static_cast<npy_intp>($1.size())};
+  PyObject* array = PyArray_New(&PyArray_Type, 1, dims, NPY_UNICODE, NULL, NULL,
+                                static_cast<int>(4 * width), 0, NULL);
+  if (!array) SWIG_fail;
+  try {
+    $1.to_ucs4(static_cast<uint32_t*>(array_data(array)), width);
+  } catch (const pammap::ValueError& e) {
+    // Typemaps are not covered by the %exception handler
+    Py_DECREF(array);
+    PyErr_SetString(PyExc_ValueError, e.extra.c_str());
+    SWIG_fail;
+  }
+  $result = SWIG_Python_AppendOutput($result, array);
+}
@@ -40,6 +40,9 @@
   } catch (const pammap::IndexError& e) {
     PyErr_SetString(PyExc_IndexError, e.extra.c_str());
     return NULL;
+  } catch (const pammap::IOError& e) {
+    PyErr_SetString(PyExc_IOError, e.extra.c_str());
+    return NULL;
   } catch (const pammap::PamMapError& e) {
     PyErr_SetString(PyExc_RuntimeError, e.what());
     return NULL;
@@ -30,22 +30,12 @@ Integer num_entries(pammap::PamMap map) {
 
 Float max_value_float(pammap::ArrayView<Float> array) {
   if (array.size() == 0) return 0.;
-
-  Float max = array[0];
-  for (size_t i = 0; i < array.size(); ++i) {
-    max = std::max(max, array[i]);
-  }
-  return max;
+  return pammap::max(array);
 }
 
 Integer max_value_integer(pammap::ArrayView<Integer> array) {
   if (array.size() == 0) return 0;
-
-  Integer max = array[0];
-  for (size_t i = 0; i < array.size(); ++i) {
-    max = std::max(max, array[i]);
-  }
-  return max;
+  return pammap::max(array);
 }
 
 }  // namespace swiginterface_test
@@ -54,3 +54,164 @@ class SwigInterfaceTests(unittest.TestCase):
 
         self.assertEqual(swiginterface.max_value_float(aflt), 5.)
         self.assertEqual(swiginterface.max_value_integer(aint), 2)
+
+    def test_converted_arrays(self):
+        m = swiginterface.PamMap()
+
+        aint32 = np.array([[1, -2, 3], [4, 5, -6]], dtype=np.int32)
+        m.update_converted_integer_array("int", aint32)
+        res = m.get_integer_array("int")
+        self.assertEqual(res.dtype, np.int64)
+        self.assertTrue(np.array_equal(res, aint32))
+
+        # The converted copy is owned by the map and shared with the result
+        res[0, 0] = 10
+        self.assertEqual(m.get_integer_array("int")[0, 0], 10)
+        self.assertEqual(aint32[0, 0], 1)
+
+        # Big-endian doubles with non-unit strides
+        abig = np.arange(10, dtype=">f8")[::2]
+        m.update_converted_float_array("flt", abig)
+        res = m.get_float_array("flt")
+        self.assertEqual(res.dtype, np.float64)
+        self.assertTrue(np.array_equal(res, [0., 2., 4., 6., 8.]))
+
+        aflt32 = np.array([1.5, -2.25], dtype=np.float32)
+        m.update_converted_complex_array("cpx", aflt32)
+        self.assertTrue(np.array_equal(m.get_complex_array("cpx"), [1.5, -2.25]))
+
+        # Lossy conversions are refused
+        with self.assertRaises(TypeError):
+            m.update_converted_integer_array("bad", np.array([1.5]))
+        with self.assertRaises(TypeError):
+            m.update_converted_float_array("bad", np.array(["a"]))
+
+    def test_bit_arrays(self):
+        m = swiginterface.PamMap()
+        rng = np.random.default_rng(42)
+
+        # Include sizes, which do not fill the last byte or word
+        for size in [0, 1, 5, 8, 13, 64, 70, 129]:
+            bools = rng.random(size) < 0.5
+
+            m.update_bit_array("bits", bools)
+            res = m.get_bit_array("bits")
+            self.assertEqual(res.dtype, np.bool_)
+            self.assertTrue(np.array_equal(res, bools))
+
+            packed = m.get_packed_bit_array("bits")
+            self.assertEqual(packed.dtype, np.uint8)
+            self.assertTrue(np.array_equal(packed, np.packbits(bools)))
+
+            m.update_packed_bit_array("packed", np.packbits(bools), size)
+            self.assertTrue(np.array_equal(m.get_bit_array("packed"), bools))
+            self.assertTrue(np.array_equal(np.unpackbits(packed, count=size), bools))
+
+        # Multi-dimensional arrays are taken in C order
+        bools = rng.random((3, 5)) < 0.5
+        m.update_bit_array("matrix", bools)
+        self.assertTrue(np.array_equal(m.get_bit_array("matrix"), bools.ravel()))
+
+        # Padding bits of the last packed byte are ignored
+        m.update_packed_bit_array("padded", np.array([0xff, 0xff], dtype=np.uint8), 9)
+        self.assertTrue(np.array_equal(m.get_bit_array("padded"), np.ones(9, dtype=bool)))
+        self.assertTrue(np.array_equal(m.get_packed_bit_array("padded"), [0xff, 0x80]))
+
+        with self.assertRaises(ValueError):
+            m.update_packed_bit_array("bad", np.packbits(np.ones(9, dtype=bool)), 20)
+
+    def test_string_arrays(self):
+        m = swiginterface.PamMap()
+
+        labels = np.array([b"H", b"He", b"Li", b""], dtype="S")
+        m.update_string_array("bytes", labels)
+        res = m.get_string_array("bytes")
+        self.assertEqual(res.dtype, np.dtype("U2"))
+        self.assertTrue(np.array_equal(res, labels.astype("U")))
+
+        # Non-ASCII labels, also outside the basic multilingual plane,
+        # multi-dimensional arrays are taken in C order
+        labels = np.array([["α", "Ψ₁"], ["Å", "😀x"]])
+        m.update_string_array("unicode", labels)
+        res = m.get_string_array("unicode")
+        self.assertEqual(res.dtype, np.dtype("U2"))
+        self.assertTrue(np.array_equal(res, labels.ravel()))
+
+        # Byte strings are taken as UTF-8
+        m.update_string_array("utf8", np.array(["Å".encode(), b"ab"]))
+        self.assertTrue(np.array_equal(m.get_string_array("utf8"), ["Å", "ab"]))
+
+        # Empty arrays and arrays of empty strings
+        m.update_string_array("empty", np.array([], dtype="U1"))
+        self.assertEqual(m.get_string_array("empty").size, 0)
+        m.update_string_array("blank", np.array(["", ""]))
+        self.assertTrue(np.array_equal(m.get_string_array("blank"), ["", ""]))
+
+        # Invalid code points (here a lone surrogate) and invalid UTF-8
+        with self.assertRaises(ValueError):
+            m.update_string_array("bad", np.array(["a\ud800"]))
+        self.assertFalse(m.exists("bad"))
+        m.update_string_array("latin1", np.array([b"\xff"]))
+        with self.assertRaises(ValueError):
+            m.get_string_array("latin1")
+
+        with self.assertRaises(TypeError):
+            m.update_string_array("numbers", np.array([1, 2]))
+
+    def test_sparse_matrices(self):
+        import scipy.sparse
+
+        dense = np.array([[1., 0., 2., 0.], [0., 0., 3., 0.], [4., 5., 0., 6.]])
+        m = swiginterface.PamMap()
+
+        for index_dtype, suffix in [(np.int32, "integer32"), (np.int64, "integer")]:
+            # scipy picks the smallest index type itself, so set the indices
+            csr = scipy.sparse.csr_matrix(dense)
+            csr.indices = csr.indices.astype(index_dtype)
+            csr.indptr = csr.indptr.astype(index_dtype)
+            getattr(m, "update_csr_matrix_float_" + suffix)("csr", csr)
+            res = getattr(m, "get_csr_matrix_float_" + suffix)("csr")
+            self.assertTrue(scipy.sparse.isspmatrix_csr(res))
+            self.assertEqual(res.shape, dense.shape)
+            self.assertEqual(res.indices.dtype, index_dtype)
+            self.assertTrue(np.array_equal(res.toarray(), dense))
+            self.assertTrue(np.shares_memory(res.data, csr.data))
+            self.assertTrue(np.shares_memory(res.indices, csr.indices))
+            self.assertTrue(np.shares_memory(res.indptr, csr.indptr))
+
+            coo = scipy.sparse.coo_matrix(dense * (1 + 1j))
+            row = coo.row.astype(index_dtype)
+            col = coo.col.astype(index_dtype)
+            coo = scipy.sparse.coo_matrix((coo.data, (row, col)), shape=dense.shape)
+            coo.row = row
+            coo.col = col
+            if hasattr(coo, "coords"):
+                coo.coords = (row, col)
+            getattr(m, "update_coo_matrix_complex_" + suffix)("coo", coo)
+            res = getattr(m, "get_coo_matrix_complex_" + suffix)("coo")
+            self.assertTrue(scipy.sparse.isspmatrix_coo(res))
+            self.assertEqual(res.row.dtype, index_dtype)
+            self.assertTrue(np.array_equal(res.toarray(), dense * (1 + 1j)))
+            self.assertTrue(np.shares_memory(res.data, coo.data))
+            self.assertTrue(np.shares_memory(res.row, coo.row))
+            self.assertTrue(np.shares_memory(res.col, coo.col))
+
+            # Modifications are visible on both sides
+            res.data[0] = 10
+            self.assertEqual(coo.data[0], 10)
+
+        # Index arrays of the wrong type are not converted
+        csr = scipy.sparse.csr_matrix(dense)
+        csr.indices = csr.indices.astype(np.int64)
+        csr.indptr = csr.indptr.astype(np.int64)
+        with self.assertRaises(TypeError):
+            m.update_csr_matrix_float_integer32("csr", csr)
+
+        # Inconsistent matrices raise a ValueError
+        csr.data = np.append(csr.data, 7.)
+        with self.assertRaises(ValueError):
+            m.update_csr_matrix_float_integer("csr", csr)
+        coo = scipy.sparse.coo_matrix(dense)
+        coo.data = np.append(coo.data, 7.)
+        with self.assertRaises(ValueError):
+            m.update_coo_matrix_float_integer32("coo", coo)